@@ -19,6 +19,7 @@
         ['component!="shared_library"', {
           'dependencies': [
             '../tools/parser-shell.gyp:parser-shell',
+            '../tools/utf8-bench.gyp:utf8-bench',
           ],
         }],
         ['enable_test==1', {
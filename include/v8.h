@@ -67,6 +67,7 @@ namespace v8 {
 
 class AccessorSignature;
 class Array;
+class ArrayBuffer;
 class Boolean;
 class BooleanObject;
 class Context;
@@ -89,6 +90,7 @@ class NumberObject;
 class Object;
 class ObjectOperationDescriptor;
 class ObjectTemplate;
+class OutputStream;
 class Platform;
 class Primitive;
 class Promise;
@@ -1424,6 +1426,41 @@ class V8_EXPORT ScriptCompiler {
 };
 
 
+/**
+ * A persistent store for the code cache of top-level scripts, e.g. backed by
+ * a file on disk, that survives the isolate and the process.
+ *
+ * If an isolate is created with a persistent compilation cache, V8 looks up
+ * every top-level script in it before compiling the script, and stores the
+ * code cache of every script it compiles in it. The keys are opaque byte
+ * strings that cover the source, the origin, the V8 version and the flags,
+ * so that stale entries are never found. Entries are also validated when
+ * they are deserialized.
+ *
+ * The cache may be shared between isolates on different threads, in which
+ * case the implementation has to synchronize accesses itself.
+ */
+class V8_EXPORT PersistentCompilationCache {
+ public:
+  virtual ~PersistentCompilationCache() {}
+
+  /**
+   * Returns the data stored for |key|, or NULL if there is none. V8 takes
+   * ownership of the returned object. If its buffer is not owned, it has to
+   * stay valid as long as the cache is alive.
+   */
+  virtual ScriptCompiler::CachedData* Lookup(const uint8_t* key,
+                                             int key_length) = 0;
+
+  /**
+   * Stores |data| for |key|, replacing any previous entry. Neither buffer is
+   * valid after the call returns.
+   */
+  virtual void Store(const uint8_t* key, int key_length, const uint8_t* data,
+                     int length) = 0;
+};
+
+
 /**
  * An error message.
  */
@@ -1656,6 +1693,148 @@ class V8_EXPORT JSON {
                            Local<Value> Parse(Local<String> json_string));
   static V8_WARN_UNUSED_RESULT MaybeLocal<Value> Parse(
       Isolate* isolate, Local<String> json_string);
+
+  /**
+   * Parses JSON text pulled in chunks from |source_stream|, allocating the
+   * result as the input arrives. Unlike script streaming, GetMoreData is
+   * called synchronously on the calling thread and must not call into V8.
+   * Each chunk is released as soon as it has been consumed, so the source
+   * is never held in memory as a whole.
+   *
+   * \param source_stream The stream providing the JSON text.
+   * \param encoding The encoding of the chunks.
+   * \return The corresponding value if successfully parsed.
+   */
+  static V8_WARN_UNUSED_RESULT MaybeLocal<Value> Parse(
+      Isolate* isolate, ScriptCompiler::ExternalSourceStream* source_stream,
+      ScriptCompiler::StreamedSource::Encoding encoding);
+
+  /**
+   * Serializes |value| like JSON.stringify(value) and writes the result to
+   * |stream| as UTF-8 in chunks of the stream's preferred size, without
+   * creating the result string. EndOfStream is called once everything has
+   * been written.
+   *
+   * \param value The value to serialize.
+   * \param stream The stream receiving the JSON text.
+   * \return False if |value| has no JSON representation (e.g. undefined)
+   *   or the stream aborted writing, true otherwise.
+   */
+  static V8_WARN_UNUSED_RESULT Maybe<bool> StringifyToStream(
+      Local<Context> context, Local<Value> value, OutputStream* stream);
+};
+
+
+/**
+ * Value serialization compatible with the HTML structured clone algorithm.
+ * The format is compact and binary. Objects reachable several times, also
+ * through cycles, are written once and read back as a single object.
+ *
+ * Primitive values, plain objects, arrays, Date objects, ArrayBuffers,
+ * typed arrays, DataViews and transferred SharedArrayBuffers can be
+ * serialized. Other objects throw an Error.
+ */
+class V8_EXPORT ValueSerializer {
+ public:
+  explicit ValueSerializer(Isolate* isolate);
+  ~ValueSerializer();
+
+  /**
+   * Writes out a header, which includes the format version.
+   */
+  void WriteHeader();
+
+  /**
+   * Serializes a JavaScript value into the buffer.
+   */
+  V8_WARN_UNUSED_RESULT Maybe<bool> WriteValue(Local<Context> context,
+                                               Local<Value> value);
+
+  /**
+   * Returns the stored data and stores its size in |size|. The caller takes
+   * ownership of the buffer and must release it with FreeBuffer. The
+   * serializer is left empty.
+   */
+  uint8_t* ReleaseBuffer(size_t* size);
+
+  /**
+   * Frees a buffer returned by ReleaseBuffer.
+   */
+  static void FreeBuffer(uint8_t* buffer);
+
+  /**
+   * Marks an ArrayBuffer as having its contents transferred out of band.
+   * Only |transfer_id| is written for it. Pass the corresponding ArrayBuffer
+   * in the deserializing context to ValueDeserializer::TransferArrayBuffer.
+   * Moving the contents, e.g. by externalizing and neutering the buffer once
+   * serialization is done, is up to the embedder, so nothing is copied.
+   */
+  void TransferArrayBuffer(uint32_t transfer_id,
+                           Local<ArrayBuffer> array_buffer);
+
+  /**
+   * Similar to TransferArrayBuffer, but for a SharedArrayBuffer whose
+   * contents are shared rather than moved. A SharedArrayBuffer that was not
+   * passed here can't be serialized. Transfer ids are shared with
+   * TransferArrayBuffer.
+   */
+  void TransferSharedArrayBuffer(uint32_t transfer_id,
+                                 Local<SharedArrayBuffer> shared_array_buffer);
+
+ private:
+  ValueSerializer(const ValueSerializer&) = delete;
+  void operator=(const ValueSerializer&) = delete;
+
+  struct PrivateData;
+  PrivateData* private_;
+};
+
+
+/**
+ * Deserializes values from data written with ValueSerializer. The data must
+ * stay alive as long as the deserializer.
+ */
+class V8_EXPORT ValueDeserializer {
+ public:
+  ValueDeserializer(Isolate* isolate, const uint8_t* data, size_t size);
+  ~ValueDeserializer();
+
+  /**
+   * Reads and validates a header (including the format version).
+   * May, for example, reject an invalid or unsupported wire format.
+   */
+  V8_WARN_UNUSED_RESULT Maybe<bool> ReadHeader(Local<Context> context);
+
+  /**
+   * Deserializes a JavaScript value from the buffer.
+   */
+  V8_WARN_UNUSED_RESULT MaybeLocal<Value> ReadValue(Local<Context> context);
+
+  /**
+   * Accepts the array buffer corresponding to the one passed previously to
+   * ValueSerializer::TransferArrayBuffer.
+   */
+  void TransferArrayBuffer(uint32_t transfer_id,
+                           Local<ArrayBuffer> array_buffer);
+
+  /**
+   * Similar to TransferArrayBuffer, but for SharedArrayBuffer.
+   */
+  void TransferSharedArrayBuffer(uint32_t transfer_id,
+                                 Local<SharedArrayBuffer> shared_array_buffer);
+
+  /**
+   * Reads the underlying wire format version. Must be called after
+   * ReadHeader.
+   */
+  uint32_t GetWireFormatVersion() const;
+
+ private:
+  ValueDeserializer(const ValueDeserializer&) = delete;
+  void operator=(const ValueDeserializer&) = delete;
+
+  struct PrivateData;
+  PrivateData* private_;
 };
 
 
@@ -3380,6 +3559,8 @@ class V8_EXPORT ArrayBuffer : public Object {
     /**
      * Free the memory block of size |length|, pointed to by |data|.
      * That memory is guaranteed to be previously allocated by |Allocate|.
+     * Backing stores of dead ArrayBuffers are released by the garbage
+     * collector, which may call this method on a background thread.
      */
     virtual void Free(void* data, size_t length) = 0;
   };
@@ -5162,6 +5343,33 @@ enum JitCodeEventOptions {
 typedef void (*JitCodeEventHandler)(const JitCodeEvent* event);
 
 
+/**
+ * Callback used by SnapshotCreator to serialize the internal field |index|
+ * of |holder| when the field holds an aligned pointer rather than a V8
+ * value. The returned data is stored in the snapshot and handed to the
+ * DeserializeInternalFieldsCallback of isolates created from it. If the
+ * callback returns { NULL, 0 }, the field is NULL in isolates created from
+ * the snapshot and is not handed to the DeserializeInternalFieldsCallback.
+ * An internal field that holds a Smi is treated like an aligned pointer.
+ * The embedder owns the returned data, which must stay alive until
+ * SnapshotCreator::CreateBlob returns. The callback must not allocate on
+ * the V8 heap.
+ */
+typedef StartupData (*SerializeInternalFieldsCallback)(Local<Object> holder,
+                                                       int index);
+
+/**
+ * Callback used to restore an internal field that was serialized with a
+ * SerializeInternalFieldsCallback. It is called once the context has been
+ * deserialized, with the field set to NULL until the callback sets it.
+ * The payload points into the snapshot blob. The callback must not run
+ * JavaScript.
+ */
+typedef void (*DeserializeInternalFieldsCallback)(Local<Object> holder,
+                                                  int index,
+                                                  StartupData payload);
+
+
 /**
  * Interface for iterating through all external resources in the heap.
  */
@@ -5204,7 +5412,10 @@ class V8_EXPORT Isolate {
           counter_lookup_callback(NULL),
           create_histogram_callback(NULL),
           add_histogram_sample_callback(NULL),
-          array_buffer_allocator(NULL) {}
+          array_buffer_allocator(NULL),
+          persistent_compilation_cache(NULL),
+          external_references(NULL),
+          deserialize_internal_fields_callback(NULL) {}
 
     /**
      * The optional entry_hook allows the host application to provide the
@@ -5252,6 +5463,28 @@ class V8_EXPORT Isolate {
      * store of ArrayBuffers.
      */
     ArrayBuffer::Allocator* array_buffer_allocator;
+
+    /**
+     * An optional persistent store for the code cache of top-level scripts.
+     * The embedder owns the cache, which has to outlive the isolate.
+     */
+    PersistentCompilationCache* persistent_compilation_cache;
+
+    /**
+     * Addresses of embedder functions and data that are referenced from a
+     * snapshot created with SnapshotCreator, such as function template
+     * callbacks. The array is terminated by a zero entry and has to list
+     * the same addresses, in the same order, as the one that was passed to
+     * the SnapshotCreator. The embedder owns the array, which has to
+     * outlive the isolate.
+     */
+    const intptr_t* external_references;
+
+    /**
+     * Restores internal fields that were serialized by the
+     * SerializeInternalFieldsCallback passed to SnapshotCreator::CreateBlob.
+     */
+    DeserializeInternalFieldsCallback deserialize_internal_fields_callback;
   };
 
 
@@ -6004,6 +6237,9 @@ class V8_EXPORT V8 {
    * Create a new isolate and context for the purpose of capturing a snapshot
    * Returns { NULL, 0 } on failure.
    * The caller owns the data array in the return value.
+   *
+   * Embedders that need to set up the context with their own templates and
+   * native callbacks should use SnapshotCreator instead.
    */
   static StartupData CreateSnapshotDataBlob(const char* custom_source = NULL);
 
@@ -6254,6 +6490,8 @@ class V8_EXPORT V8 {
    *   and "snapshot_blob.bin" - which is what the default build calls them.
    * - InitializeExternalStartupData(const char*, const char*)
    *   As above, but will directly use the two given file names.
+   *   In both cases, the files are mapped into memory read-only rather
+   *   than read, so only the parts that V8 uses are paged in.
    * - Call SetNativesDataBlob, SetNativesDataBlob.
    *   This will read the blobs from the given data structures and will
    *   not perform any file IO.
@@ -6315,6 +6553,64 @@ class V8_EXPORT V8 {
 };
 
 
+/**
+ * Helper class to create a snapshot data blob from a context that the
+ * embedder has set up, for example by installing templates with native
+ * callbacks and running bootstrap scripts. Isolates created with the blob
+ * as CreateParams::snapshot_blob get a copy of that context from
+ * Context::New, without running the setup again.
+ *
+ * The isolate of the creator is entered while the creator is alive. It
+ * must only be used to set up the default context, and must not be
+ * disposed by the embedder.
+ */
+class V8_EXPORT SnapshotCreator {
+ public:
+  /**
+   * Creates and enters an isolate for serialization.
+   * \param external_references a zero-terminated array of the addresses of
+   *   embedder functions and data that the context refers to. Isolates
+   *   using the resulting blob need the same array in
+   *   CreateParams::external_references. The embedder owns the array.
+   */
+  explicit SnapshotCreator(const intptr_t* external_references = NULL);
+
+  /**
+   * Exits and disposes the isolate.
+   */
+  ~SnapshotCreator();
+
+  /**
+   * \returns the isolate prepared by the snapshot creator.
+   */
+  Isolate* GetIsolate();
+
+  /**
+   * Sets the context that Context::New creates in isolates that use the
+   * snapshot. Must be called exactly once, before CreateBlob.
+   */
+  void SetDefaultContext(Local<Context> context);
+
+  /**
+   * Creates a snapshot data blob. This must not be called from within a
+   * handle scope, and can only be called once.
+   * \param callback serializes internal fields that hold aligned pointers.
+   *   Without a callback, all such fields are NULL in isolates created from
+   *   the snapshot.
+   * \returns { NULL, 0 } on failure. The caller owns the data array in the
+   *   return value.
+   */
+  StartupData CreateBlob(SerializeInternalFieldsCallback callback = NULL);
+
+ private:
+  void* data_;
+
+  // Disallow copying and assigning.
+  SnapshotCreator(const SnapshotCreator&);
+  void operator=(const SnapshotCreator&);
+};
+
+
 /**
  * A simple Maybe type, representing an object which may or may not have a
  * value, see https://hackage.haskell.org/package/base/docs/Data-Maybe.html.
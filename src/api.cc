@@ -34,6 +34,8 @@
 #include "src/icu_util.h"
 #include "src/isolate-inl.h"
 #include "src/json-parser.h"
+#include "src/json-stream-parser.h"
+#include "src/json-stringifier.h"
 #include "src/messages.h"
 #include "src/parser.h"
 #include "src/pending-compilation-error-handler.h"
@@ -55,6 +57,7 @@
 #include "src/unicode-inl.h"
 #include "src/v8.h"
 #include "src/v8threads.h"
+#include "src/value-serializer.h"
 #include "src/version.h"
 #include "src/vm-state-inl.h"
 
@@ -361,6 +364,52 @@ class ArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
 }  // namespace
 
 
+// Serializes the heap of |isolate| together with |context|, which is reset.
+static StartupData SerializeIsolateAndContext(
+    i::Isolate* isolate, Persistent<Context>* context,
+    const i::Snapshot::Metadata& metadata,
+    SerializeInternalFieldsCallback callback) {
+  // If we don't do this then we end up with a stray root pointing at the
+  // context even after we have disposed of the context.
+  isolate->heap()->CollectAllAvailableGarbage("mksnapshot");
+
+  // GC may have cleared weak cells, so compact any WeakFixedArrays
+  // found on the heap.
+  i::HeapIterator iterator(isolate->heap(),
+                           i::HeapIterator::kFilterUnreachable);
+  for (i::HeapObject* o = iterator.next(); o != NULL; o = iterator.next()) {
+    if (o->IsPrototypeInfo()) {
+      i::Object* prototype_users =
+          i::PrototypeInfo::cast(o)->prototype_users();
+      if (prototype_users->IsWeakFixedArray()) {
+        i::WeakFixedArray* array = i::WeakFixedArray::cast(prototype_users);
+        array->Compact<i::JSObject::PrototypeRegistryCompactionCallback>();
+      }
+    } else if (o->IsScript()) {
+      i::Object* shared_list = i::Script::cast(o)->shared_function_infos();
+      if (shared_list->IsWeakFixedArray()) {
+        i::WeakFixedArray* array = i::WeakFixedArray::cast(shared_list);
+        array->Compact<i::WeakFixedArray::NullCallback>();
+      }
+    }
+  }
+
+  i::Object* raw_context = *v8::Utils::OpenPersistent(*context);
+  context->Reset();
+
+  i::SnapshotByteSink snapshot_sink;
+  i::StartupSerializer ser(isolate, &snapshot_sink);
+  ser.SerializeStrongReferences();
+
+  i::SnapshotByteSink context_sink;
+  i::PartialSerializer context_ser(isolate, &ser, &context_sink, callback);
+  context_ser.Serialize(&raw_context);
+  ser.SerializeWeakReferencesAndDeferred();
+
+  return i::Snapshot::CreateSnapshotBlob(ser, context_ser, metadata);
+}
+
+
 StartupData V8::CreateSnapshotDataBlob(const char* custom_source) {
   i::Isolate* internal_isolate = new i::Isolate(true);
   ArrayBufferAllocator allocator;
@@ -385,44 +434,8 @@ StartupData V8::CreateSnapshotDataBlob(const char* custom_source) {
       }
     }
     if (!context.IsEmpty()) {
-      // If we don't do this then we end up with a stray root pointing at the
-      // context even after we have disposed of the context.
-      internal_isolate->heap()->CollectAllAvailableGarbage("mksnapshot");
-
-      // GC may have cleared weak cells, so compact any WeakFixedArrays
-      // found on the heap.
-      i::HeapIterator iterator(internal_isolate->heap(),
-                               i::HeapIterator::kFilterUnreachable);
-      for (i::HeapObject* o = iterator.next(); o != NULL; o = iterator.next()) {
-        if (o->IsPrototypeInfo()) {
-          i::Object* prototype_users =
-              i::PrototypeInfo::cast(o)->prototype_users();
-          if (prototype_users->IsWeakFixedArray()) {
-            i::WeakFixedArray* array = i::WeakFixedArray::cast(prototype_users);
-            array->Compact<i::JSObject::PrototypeRegistryCompactionCallback>();
-          }
-        } else if (o->IsScript()) {
-          i::Object* shared_list = i::Script::cast(o)->shared_function_infos();
-          if (shared_list->IsWeakFixedArray()) {
-            i::WeakFixedArray* array = i::WeakFixedArray::cast(shared_list);
-            array->Compact<i::WeakFixedArray::NullCallback>();
-          }
-        }
-      }
-
-      i::Object* raw_context = *v8::Utils::OpenPersistent(context);
-      context.Reset();
-
-      i::SnapshotByteSink snapshot_sink;
-      i::StartupSerializer ser(internal_isolate, &snapshot_sink);
-      ser.SerializeStrongReferences();
-
-      i::SnapshotByteSink context_sink;
-      i::PartialSerializer context_ser(internal_isolate, &ser, &context_sink);
-      context_ser.Serialize(&raw_context);
-      ser.SerializeWeakReferencesAndDeferred();
-
-      result = i::Snapshot::CreateSnapshotBlob(ser, context_ser, metadata);
+      result = SerializeIsolateAndContext(internal_isolate, &context, metadata,
+                                          NULL);
     }
     if (i::FLAG_profile_deserialization) {
       i::PrintF("Creating snapshot took %0.3f ms\n",
@@ -435,6 +448,91 @@ StartupData V8::CreateSnapshotDataBlob(const char* custom_source) {
 }
 
 
+namespace {
+
+struct SnapshotCreatorData {
+  explicit SnapshotCreatorData(Isolate* isolate)
+      : isolate_(isolate), created_(false) {}
+
+  ArrayBufferAllocator allocator_;
+  Isolate* isolate_;
+  Persistent<Context> default_context_;
+  bool created_;
+};
+
+}  // namespace
+
+
+SnapshotCreator::SnapshotCreator(const intptr_t* external_references) {
+  i::Isolate* internal_isolate = new i::Isolate(true);
+  Isolate* isolate = reinterpret_cast<Isolate*>(internal_isolate);
+  SnapshotCreatorData* data = new SnapshotCreatorData(isolate);
+  internal_isolate->set_array_buffer_allocator(&data->allocator_);
+  internal_isolate->set_api_external_references(external_references);
+  isolate->Enter();
+  internal_isolate->Init(NULL);
+  data_ = data;
+}
+
+
+SnapshotCreator::~SnapshotCreator() {
+  SnapshotCreatorData* data = static_cast<SnapshotCreatorData*>(data_);
+  Isolate* isolate = data->isolate_;
+  data->default_context_.Reset();
+  isolate->Exit();
+  isolate->Dispose();
+  delete data;
+}
+
+
+Isolate* SnapshotCreator::GetIsolate() {
+  return static_cast<SnapshotCreatorData*>(data_)->isolate_;
+}
+
+
+void SnapshotCreator::SetDefaultContext(Local<Context> context) {
+  SnapshotCreatorData* data = static_cast<SnapshotCreatorData*>(data_);
+  Utils::ApiCheck(data->default_context_.IsEmpty(),
+                  "v8::SnapshotCreator::SetDefaultContext",
+                  "The default context has already been set");
+  Utils::ApiCheck(context->GetIsolate() == data->isolate_,
+                  "v8::SnapshotCreator::SetDefaultContext",
+                  "The context belongs to a different isolate");
+  data->default_context_.Reset(data->isolate_, context);
+}
+
+
+StartupData SnapshotCreator::CreateBlob(
+    SerializeInternalFieldsCallback callback) {
+  SnapshotCreatorData* data = static_cast<SnapshotCreatorData*>(data_);
+  i::Isolate* isolate = reinterpret_cast<i::Isolate*>(data->isolate_);
+  StartupData result = {NULL, 0};
+  if (!Utils::ApiCheck(!data->created_, "v8::SnapshotCreator::CreateBlob",
+                       "CreateBlob can only be called once") ||
+      !Utils::ApiCheck(!data->default_context_.IsEmpty(),
+                       "v8::SnapshotCreator::CreateBlob",
+                       "SetDefaultContext has not been called")) {
+    return result;
+  }
+  data->created_ = true;
+
+  base::ElapsedTimer timer;
+  timer.Start();
+  // The embedder may have run any code to set up the context, so isolates
+  // using the blob cannot fall back to bootstrapping from scratch.
+  i::Snapshot::Metadata metadata;
+  metadata.set_embeds_script(true);
+  result = SerializeIsolateAndContext(isolate, &data->default_context_,
+                                      metadata, callback);
+  if (i::FLAG_profile_deserialization) {
+    i::PrintF("Creating snapshot took %0.3f ms\n",
+              timer.Elapsed().InMillisecondsF());
+  }
+  timer.Stop();
+  return result;
+}
+
+
 void V8::SetFlagsFromString(const char* str, int length) {
   i::FlagList::SetFlagsFromString(str, length);
 }
@@ -2653,6 +2751,31 @@ MaybeLocal<Value> JSON::Parse(Isolate* v8_isolate, Local<String> json_string) {
 }
 
 
+MaybeLocal<Value> JSON::Parse(
+    Isolate* v8_isolate, ScriptCompiler::ExternalSourceStream* source_stream,
+    ScriptCompiler::StreamedSource::Encoding encoding) {
+  auto isolate = reinterpret_cast<i::Isolate*>(v8_isolate);
+  PREPARE_FOR_EXECUTION_WITH_ISOLATE(isolate, "JSON::Parse", Value);
+  auto maybe = i::JsonStreamParser::Parse(isolate, source_stream, encoding);
+  Local<Value> result;
+  has_pending_exception = !ToLocal<Value>(maybe, &result);
+  RETURN_ON_FAILED_EXECUTION(Value);
+  RETURN_ESCAPED(result);
+}
+
+
+Maybe<bool> JSON::StringifyToStream(Local<Context> context, Local<Value> value,
+                                    OutputStream* stream) {
+  PREPARE_FOR_EXECUTION_PRIMITIVE(context, "JSON::StringifyToStream", bool);
+  i::BasicJsonStringifier stringifier(isolate);
+  auto result =
+      stringifier.StringifyToStream(Utils::OpenHandle(*value), stream);
+  has_pending_exception = result.IsNothing();
+  RETURN_ON_FAILED_EXECUTION_PRIMITIVE(bool);
+  return result;
+}
+
+
 Local<Value> JSON::Parse(Local<String> json_string) {
   auto isolate = reinterpret_cast<v8::Isolate*>(
       Utils::OpenHandle(*json_string)->GetIsolate());
@@ -2660,6 +2783,125 @@ Local<Value> JSON::Parse(Local<String> json_string) {
 }
 
 
+// --- V a l u e   S e r i a l i z a t i o n ---
+
+struct ValueSerializer::PrivateData {
+  explicit PrivateData(i::Isolate* i) : isolate(i), serializer(i) {}
+  i::Isolate* isolate;
+  i::ValueSerializer serializer;
+};
+
+
+ValueSerializer::ValueSerializer(Isolate* isolate)
+    : private_(new PrivateData(reinterpret_cast<i::Isolate*>(isolate))) {}
+
+
+ValueSerializer::~ValueSerializer() { delete private_; }
+
+
+void ValueSerializer::WriteHeader() { private_->serializer.WriteHeader(); }
+
+
+Maybe<bool> ValueSerializer::WriteValue(Local<Context> context,
+                                        Local<Value> value) {
+  PREPARE_FOR_EXECUTION_PRIMITIVE(context, "v8::ValueSerializer::WriteValue",
+                                  bool);
+  i::Handle<i::Object> object = Utils::OpenHandle(*value);
+  Maybe<bool> result = private_->serializer.WriteObject(object);
+  has_pending_exception = result.IsNothing();
+  RETURN_ON_FAILED_EXECUTION_PRIMITIVE(bool);
+  return result;
+}
+
+
+uint8_t* ValueSerializer::ReleaseBuffer(size_t* size) {
+  return private_->serializer.ReleaseBuffer(size);
+}
+
+
+void ValueSerializer::FreeBuffer(uint8_t* buffer) { free(buffer); }
+
+
+void ValueSerializer::TransferArrayBuffer(uint32_t transfer_id,
+                                          Local<ArrayBuffer> array_buffer) {
+  private_->serializer.TransferArrayBuffer(transfer_id,
+                                           Utils::OpenHandle(*array_buffer));
+}
+
+
+void ValueSerializer::TransferSharedArrayBuffer(
+    uint32_t transfer_id, Local<SharedArrayBuffer> shared_array_buffer) {
+  private_->serializer.TransferArrayBuffer(
+      transfer_id, Utils::OpenHandle(*shared_array_buffer));
+}
+
+
+struct ValueDeserializer::PrivateData {
+  PrivateData(i::Isolate* i, i::Vector<const uint8_t> data)
+      : isolate(i), deserializer(i, data) {}
+  i::Isolate* isolate;
+  i::ValueDeserializer deserializer;
+};
+
+
+ValueDeserializer::ValueDeserializer(Isolate* isolate, const uint8_t* data,
+                                     size_t size) {
+  CHECK_LE(size, static_cast<size_t>(i::kMaxInt));
+  private_ = new PrivateData(
+      reinterpret_cast<i::Isolate*>(isolate),
+      i::Vector<const uint8_t>(data, static_cast<int>(size)));
+}
+
+
+ValueDeserializer::~ValueDeserializer() { delete private_; }
+
+
+Maybe<bool> ValueDeserializer::ReadHeader(Local<Context> context) {
+  PREPARE_FOR_EXECUTION_PRIMITIVE(context, "v8::ValueDeserializer::ReadHeader",
+                                  bool);
+  Maybe<bool> result = private_->deserializer.ReadHeader();
+  has_pending_exception = result.IsNothing();
+  RETURN_ON_FAILED_EXECUTION_PRIMITIVE(bool);
+  return result;
+}
+
+
+uint32_t ValueDeserializer::GetWireFormatVersion() const {
+  return private_->deserializer.GetWireFormatVersion();
+}
+
+
+MaybeLocal<Value> ValueDeserializer::ReadValue(Local<Context> context) {
+  PREPARE_FOR_EXECUTION(context, "v8::ValueDeserializer::ReadValue", Value);
+  i::MaybeHandle<i::Object> result = private_->deserializer.ReadObject();
+  Local<Value> value;
+  if (!ToLocal(result, &value)) {
+    // Malformed data fails without an exception; report it as one.
+    if (!isolate->has_pending_exception()) {
+      isolate->Throw(*isolate->factory()->NewError(
+          i::MessageTemplate::kDataCloneDeserializationError));
+    }
+    has_pending_exception = true;
+    RETURN_ON_FAILED_EXECUTION(Value);
+  }
+  RETURN_ESCAPED(value);
+}
+
+
+void ValueDeserializer::TransferArrayBuffer(uint32_t transfer_id,
+                                            Local<ArrayBuffer> array_buffer) {
+  private_->deserializer.TransferArrayBuffer(transfer_id,
+                                             Utils::OpenHandle(*array_buffer));
+}
+
+
+void ValueDeserializer::TransferSharedArrayBuffer(
+    uint32_t transfer_id, Local<SharedArrayBuffer> shared_array_buffer) {
+  private_->deserializer.TransferArrayBuffer(
+      transfer_id, Utils::OpenHandle(*shared_array_buffer));
+}
+
+
 // --- D a t a ---
 
 bool Value::FullIsUndefined() const {
@@ -5285,9 +5527,6 @@ void v8::V8::ShutdownPlatform() {
 
 bool v8::V8::Initialize() {
   i::V8::Initialize();
-#ifdef V8_USE_EXTERNAL_STARTUP_DATA
-  i::ReadNatives();
-#endif
   return true;
 }
 
@@ -7035,6 +7274,11 @@ Isolate* Isolate::New(const Isolate::CreateParams& params) {
   Isolate* v8_isolate = reinterpret_cast<Isolate*>(isolate);
   CHECK(params.array_buffer_allocator != NULL);
   isolate->set_array_buffer_allocator(params.array_buffer_allocator);
+  isolate->set_persistent_compilation_cache(
+      params.persistent_compilation_cache);
+  isolate->set_api_external_references(params.external_references);
+  isolate->set_deserialize_internal_fields_callback(
+      params.deserialize_internal_fields_callback);
   if (params.snapshot_blob != NULL) {
     isolate->set_snapshot_blob(params.snapshot_blob);
   } else {
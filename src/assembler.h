@@ -901,6 +901,10 @@ class ExternalReference BASE_EMBEDDED {
   static ExternalReference get_date_field_function(Isolate* isolate);
   static ExternalReference date_cache_stamp(Isolate* isolate);
 
+  // Table of bytecode dispatch counters of the interpreter, only allocated
+  // with --trace-ignition-dispatches.
+  static ExternalReference interpreter_dispatch_counters(Isolate* isolate);
+
   static ExternalReference get_make_code_young_function(Isolate* isolate);
   static ExternalReference get_mark_code_as_executed_function(Isolate* isolate);
 
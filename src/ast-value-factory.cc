@@ -28,6 +28,7 @@
 #include "src/ast-value-factory.h"
 
 #include "src/api.h"
+#include "src/conversions-inl.h"
 #include "src/objects.h"
 
 namespace v8 {
@@ -160,6 +161,26 @@ bool AstValue::BooleanValue() const {
 }
 
 
+bool AstValue::IsSmi() const {
+  switch (type_) {
+    case SMI:
+      return true;
+    case NUMBER_WITH_DOT:
+    case NUMBER:
+      // Factory::NewNumber canonicalizes these numbers to Smis.
+      return IsSmiDouble(number_);
+    default:
+      return false;
+  }
+}
+
+
+int AstValue::AsSmi() const {
+  DCHECK(IsSmi());
+  return type_ == SMI ? smi_ : FastD2I(number_);
+}
+
+
 void AstValue::Internalize(Isolate* isolate) {
   switch (type_) {
     case STRING:
@@ -173,6 +173,19 @@ class AstValue : public ZoneObject {
 
   bool IsTheHole() const { return type_ == THE_HOLE; }
 
+  bool IsUndefined() const { return type_ == UNDEFINED; }
+
+  bool IsNull() const { return type_ == NULL_TYPE; }
+
+  bool IsTrue() const { return type_ == BOOLEAN && bool_; }
+
+  bool IsFalse() const { return type_ == BOOLEAN && !bool_; }
+
+  // Returns true if the value internalizes to a Smi. Does not require the
+  // value to be internalized.
+  bool IsSmi() const;
+  int AsSmi() const;
+
   void Internalize(Isolate* isolate);
 
   // Can be called after Internalize has been called.
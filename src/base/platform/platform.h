@@ -210,11 +210,16 @@ class OS {
 
   class MemoryMappedFile {
    public:
+    // Files opened read-only are mapped privately, so that their pages can
+    // be shared with other processes and are only read in on first access.
+    enum FileMode { kReadOnly, kReadWrite };
+
     virtual ~MemoryMappedFile() {}
     virtual void* memory() const = 0;
     virtual size_t size() const = 0;
 
-    static MemoryMappedFile* open(const char* name);
+    static MemoryMappedFile* open(const char* name,
+                                  FileMode mode = kReadWrite);
     static MemoryMappedFile* create(const char* name, size_t size,
                                     void* initial);
   };
@@ -1242,7 +1242,8 @@ void Genesis::InitializeGlobal(Handle<GlobalObject> global_object,
     Map::SetPrototype(initial_map, proto);
     factory->SetRegExpIrregexpData(Handle<JSRegExp>::cast(proto),
                                    JSRegExp::IRREGEXP, factory->empty_string(),
-                                   JSRegExp::Flags(0), 0);
+                                   JSRegExp::Flags(0), 0,
+                                   factory->undefined_value());
   }
 
   // Initialize the embedder data slot.
@@ -5,9 +5,15 @@
 #include "src/compilation-cache.h"
 
 #include "src/assembler.h"
+#include "src/base/smart-pointers.h"
+#include "src/bootstrapper.h"
 #include "src/counters.h"
+#include "src/debug/debug.h"
 #include "src/factory.h"
 #include "src/objects-inl.h"
+#include "src/preparse-data.h"
+#include "src/snapshot/serialize.h"
+#include "src/version.h"
 
 namespace v8 {
 namespace internal {
@@ -26,7 +32,8 @@ CompilationCache::CompilationCache(Isolate* isolate)
       eval_global_(isolate, 1),
       eval_contextual_(isolate, 1),
       reg_exp_(isolate, kRegExpGenerations),
-      enabled_(true) {
+      enabled_(true),
+      aged_in_idle_time_(false) {
   CompilationSubCache* subcaches[kSubCacheCount] =
     {&script_, &eval_global_, &eval_contextual_, &reg_exp_};
   for (int i = 0; i < kSubCacheCount; ++i) {
@@ -137,6 +144,65 @@ bool CompilationCacheScript::HasOrigin(Handle<SharedFunctionInfo> function_info,
 }
 
 
+// The key of a script in the persistent cache. Unlike String::Hash(), the
+// hashes of the source and the name do not depend on the per-process hash
+// seed, so that keys are stable across processes.
+class PersistentScriptKey {
+ public:
+  PersistentScriptKey(Handle<String> source, Handle<Object> name,
+                      int line_offset, int column_offset,
+                      ScriptOriginOptions resource_options,
+                      LanguageMode language_mode) {
+    uint64_t source_hash = ContentHash(source);
+    uint64_t name_hash = 0;
+    if (!name.is_null() && name->IsString()) {
+      name_hash = ContentHash(Handle<String>::cast(name));
+    }
+    words_[0] = Version::Hash();
+    words_[1] = FlagList::Hash();
+    words_[2] = static_cast<uint32_t>(CpuFeatures::SupportedFeatures());
+    words_[3] = static_cast<uint32_t>(source->length());
+    words_[4] = static_cast<uint32_t>(source_hash);
+    words_[5] = static_cast<uint32_t>(source_hash >> 32);
+    words_[6] = static_cast<uint32_t>(name_hash);
+    words_[7] = static_cast<uint32_t>(name_hash >> 32);
+    words_[8] = static_cast<uint32_t>(line_offset);
+    words_[9] = static_cast<uint32_t>(column_offset);
+    words_[10] = static_cast<uint32_t>(resource_options.Flags());
+    words_[11] = static_cast<uint32_t>(language_mode);
+  }
+
+  const uint8_t* data() const {
+    return reinterpret_cast<const uint8_t*>(words_);
+  }
+  int length() const { return static_cast<int>(sizeof(words_)); }
+
+ private:
+  static const int kWordCount = 12;
+
+  // 64-bit FNV-1a hash of the characters.
+  template <typename Char>
+  static uint64_t ContentHash(Vector<const Char> chars) {
+    uint64_t hash = V8_UINT64_C(14695981039346656037);
+    for (int i = 0; i < chars.length(); i++) {
+      hash = (hash ^ chars[i]) * V8_UINT64_C(1099511628211);
+    }
+    return hash;
+  }
+
+  static uint64_t ContentHash(Handle<String> string) {
+    string = String::Flatten(string);
+    DisallowHeapAllocation no_gc;
+    String::FlatContent content = string->GetFlatContent();
+    DCHECK(content.IsFlat());
+    return content.IsOneByte() ? ContentHash(content.ToOneByteVector())
+                               : ContentHash(content.ToUC16Vector());
+  }
+
+  uint32_t words_[kWordCount];
+};
+
+
 // TODO(245): Need to allow identical code from different contexts to
 // be cached in the same script generation. Currently the first use
 // will be cached, but subsequent code from different source / line
@@ -293,8 +359,17 @@ MaybeHandle<SharedFunctionInfo> CompilationCache::LookupScript(
     Handle<Context> context, LanguageMode language_mode) {
   if (!IsEnabled()) return MaybeHandle<SharedFunctionInfo>();
 
-  return script_.Lookup(source, name, line_offset, column_offset,
-                        resource_options, context, language_mode);
+  Handle<SharedFunctionInfo> result =
+      script_.Lookup(source, name, line_offset, column_offset,
+                     resource_options, context, language_mode);
+  if (result.is_null() && UsePersistentCache() &&
+      LookupPersistentScript(source, name, line_offset, column_offset,
+                             resource_options, language_mode)
+          .ToHandle(&result)) {
+    // Promote to the per-isolate cache.
+    script_.Put(source, context, language_mode, result);
+  }
+  return result;
 }
 
 
@@ -334,6 +409,54 @@ void CompilationCache::PutScript(Handle<String> source,
 }
 
 
+void CompilationCache::PutPersistentScript(
+    Handle<String> source, Handle<Object> name, int line_offset,
+    int column_offset, ScriptOriginOptions resource_options,
+    LanguageMode language_mode, ScriptData* data) {
+  DCHECK(UsePersistentCache());
+  PersistentScriptKey key(source, name, line_offset, column_offset,
+                          resource_options, language_mode);
+  isolate()->persistent_compilation_cache()->Store(
+      key.data(), key.length(), data->data(), data->length());
+}
+
+
+bool CompilationCache::UsePersistentCache() {
+  // Natives and snapshots are never cached, and the debugger has to see the
+  // scripts being compiled.
+  return IsEnabled() && isolate()->persistent_compilation_cache() != NULL &&
+         FLAG_serialize_toplevel &&
+         !isolate()->serializer_enabled() &&
+         !isolate()->bootstrapper()->IsActive() &&
+         !isolate()->debug()->is_loaded();
+}
+
+
+MaybeHandle<SharedFunctionInfo> CompilationCache::LookupPersistentScript(
+    Handle<String> source, Handle<Object> name, int line_offset,
+    int column_offset, ScriptOriginOptions resource_options,
+    LanguageMode language_mode) {
+  PersistentScriptKey key(source, name, line_offset, column_offset,
+                          resource_options, language_mode);
+  base::SmartPointer<ScriptCompiler::CachedData> cached_data(
+      isolate()->persistent_compilation_cache()->Lookup(key.data(),
+                                                         key.length()));
+  Handle<SharedFunctionInfo> result;
+  if (!cached_data.is_empty()) {
+    HistogramTimerScope timer(isolate()->counters()->compile_deserialize());
+    // The deserializer checks the source, the version and the flags again.
+    ScriptData script_data(cached_data->data, cached_data->length);
+    if (CodeSerializer::Deserialize(isolate(), &script_data, source)
+            .ToHandle(&result)) {
+      isolate()->counters()->persistent_compilation_cache_hits()->Increment();
+      return result;
+    }
+  }
+  isolate()->counters()->persistent_compilation_cache_misses()->Increment();
+  return MaybeHandle<SharedFunctionInfo>();
+}
+
+
 void CompilationCache::PutEval(Handle<String> source,
                                Handle<SharedFunctionInfo> outer_info,
                                Handle<Context> context,
@@ -385,9 +508,22 @@ void CompilationCache::IterateFunctions(ObjectVisitor* v) {
 
 
 void CompilationCache::MarkCompactPrologue() {
+  if (aged_in_idle_time_) {
+    aged_in_idle_time_ = false;
+    return;
+  }
+  for (int i = 0; i < kSubCacheCount; i++) {
+    subcaches_[i]->Age();
+  }
+}
+
+
+void CompilationCache::AgeInIdleTime() {
+  DCHECK(!aged_in_idle_time_);
   for (int i = 0; i < kSubCacheCount; i++) {
     subcaches_[i]->Age();
   }
+  aged_in_idle_time_ = true;
 }
 
 
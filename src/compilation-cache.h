@@ -12,6 +12,8 @@
 namespace v8 {
 namespace internal {
 
+class ScriptData;
+
 // The compilation cache consists of several generational sub-caches which uses
 // this class as a base class. A sub-cache contains a compilation cache tables
 // for each generation of the sub-cache. Since the same source code string has
@@ -149,7 +151,9 @@ class CompilationCache {
  public:
   // Finds the script shared function info for a source
   // string. Returns an empty handle if the cache doesn't contain a
-  // script for the given source string with the right origin.
+  // script for the given source string with the right origin. Scripts
+  // that are not in the per-isolate cache are looked up in the persistent
+  // cache, if there is one.
   MaybeHandle<SharedFunctionInfo> LookupScript(
       Handle<String> source, Handle<Object> name, int line_offset,
       int column_offset, ScriptOriginOptions resource_options,
@@ -174,6 +178,18 @@ class CompilationCache {
                  LanguageMode language_mode,
                  Handle<SharedFunctionInfo> function_info);
 
+  // Stores the code cache of a top-level script in the persistent cache,
+  // keyed by the source, the origin, the V8 version and the flags.
+  void PutPersistentScript(Handle<String> source, Handle<Object> name,
+                           int line_offset, int column_offset,
+                           ScriptOriginOptions resource_options,
+                           LanguageMode language_mode, ScriptData* data);
+
+  // Returns true if top-level scripts should be looked up in and stored into
+  // the persistent cache. The code of such scripts has to be prepared for
+  // serialization.
+  bool UsePersistentCache();
+
   // Associate the (source, context->closure()->shared(), kind) triple
   // with the shared function info. This may overwrite an existing mapping.
   void PutEval(Handle<String> source, Handle<SharedFunctionInfo> outer_info,
@@ -201,6 +217,11 @@ class CompilationCache {
   // avoid keeping them alive too long without using them.
   void MarkCompactPrologue();
 
+  // Retires entries ahead of the next mark-sweep garbage collection while
+  // the embedder is idle. That collection then leaves the cache alone.
+  void AgeInIdleTime();
+  bool NeedsAgingInIdleTime() { return !aged_in_idle_time_; }
+
   // Enable/disable compilation cache. Used by debugger to disable compilation
   // cache during debugging to make sure new scripts are always compiled.
   void Enable();
@@ -212,6 +233,11 @@ class CompilationCache {
 
   HashMap* EagerOptimizingSet();
 
+  MaybeHandle<SharedFunctionInfo> LookupPersistentScript(
+      Handle<String> source, Handle<Object> name, int line_offset,
+      int column_offset, ScriptOriginOptions resource_options,
+      LanguageMode language_mode);
+
   // The number of sub caches covering the different types to cache.
   static const int kSubCacheCount = 4;
 
@@ -230,6 +256,10 @@ class CompilationCache {
   // Current enable state of the compilation cache.
   bool enabled_;
 
+  // Whether the cache has been aged in idle time since the last mark-sweep
+  // garbage collection.
+  bool aged_in_idle_time_;
+
   friend class Isolate;
 
   DISALLOW_COPY_AND_ASSIGN(CompilationCache);
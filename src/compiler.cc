@@ -396,6 +396,25 @@ OptimizedCompileJob::Status OptimizedCompileJob::CreateGraph() {
     return AbortOptimization(kOptimizedTooManyTimes);
   }
 
+  // Interpreted functions are optimized by TurboFan straight from their
+  // bytecode and the call feedback the interpreter collected. There is no
+  // full-codegen code to deoptimize to, hence the graph is built without
+  // deoptimization support.
+  if (info()->shared_info()->HasBytecodeArray()) {
+    if (FLAG_trace_opt) {
+      OFStream os(stdout);
+      os << "[compiling method " << Brief(*info()->closure())
+         << " using TurboFan from bytecode]" << std::endl;
+    }
+    Timer t(this, &time_taken_to_create_graph_);
+    compiler::Pipeline pipeline(info());
+    pipeline.GenerateCode();
+    if (info()->code().is_null()) {
+      return AbortOptimization(kBytecodeGraphBuildingFailed);
+    }
+    return SetLastStatus(SUCCEEDED);
+  }
+
   // Check the whitelist for Crankshaft.
   if (!info()->closure()->PassesFilter(FLAG_hydrogen_filter)) {
     return AbortOptimization(kHydrogenFilter);
@@ -733,6 +752,8 @@ MUST_USE_RESULT static MaybeHandle<Code> GetUnoptimizedCodeCommon(
   if (FLAG_ignition && info->closure()->PassesFilter(FLAG_ignition_filter)) {
     // Compile bytecode for the interpreter.
     if (!GenerateBytecode(info)) return MaybeHandle<Code>();
+    DCHECK(shared->function_data()->IsUndefined());
+    shared->set_function_data(*info->bytecode_array());
   } else {
     // Compile unoptimized code.
     if (!CompileUnoptimizedCode(info)) return MaybeHandle<Code>();
@@ -1358,6 +1379,12 @@ Handle<SharedFunctionInfo> Compiler::CompileScript(
       construct_language_mode(FLAG_use_strict, use_strong);
 
   CompilationCache* compilation_cache = isolate->compilation_cache();
+  bool use_persistent_cache = extension == NULL &&
+                              natives == NOT_NATIVES_CODE &&
+                              compilation_cache->UsePersistentCache();
+  bool serialize = FLAG_serialize_toplevel &&
+                   (compile_options == ScriptCompiler::kProduceCodeCache ||
+                    use_persistent_cache);
 
   // Do a lookup in the compilation cache but not for extensions.
   MaybeHandle<SharedFunctionInfo> maybe_result;
@@ -1384,10 +1411,7 @@ Handle<SharedFunctionInfo> Compiler::CompileScript(
   }
 
   base::ElapsedTimer timer;
-  if (FLAG_profile_deserialization && FLAG_serialize_toplevel &&
-      compile_options == ScriptCompiler::kProduceCodeCache) {
-    timer.Start();
-  }
+  if (FLAG_profile_deserialization && serialize) timer.Start();
 
   if (!maybe_result.ToHandle(&result)) {
     // No cache entry found. Compile the script.
@@ -1423,25 +1447,34 @@ Handle<SharedFunctionInfo> Compiler::CompileScript(
     parse_info.set_compile_options(compile_options);
     parse_info.set_extension(extension);
     parse_info.set_context(context);
-    if (FLAG_serialize_toplevel &&
-        compile_options == ScriptCompiler::kProduceCodeCache) {
-      info.PrepareForSerializing();
-    }
+    if (serialize) info.PrepareForSerializing();
 
     parse_info.set_language_mode(
         static_cast<LanguageMode>(info.language_mode() | language_mode));
     result = CompileToplevel(&info);
     if (extension == NULL && !result.is_null()) {
       compilation_cache->PutScript(source, context, language_mode, result);
-      if (FLAG_serialize_toplevel &&
-          compile_options == ScriptCompiler::kProduceCodeCache) {
-        HistogramTimerScope histogram_timer(
-            isolate->counters()->compile_serialize());
-        *cached_data = CodeSerializer::Serialize(isolate, result, source);
+      if (serialize) {
+        ScriptData* script_data;
+        {
+          HistogramTimerScope histogram_timer(
+              isolate->counters()->compile_serialize());
+          script_data = CodeSerializer::Serialize(isolate, result, source);
+        }
         if (FLAG_profile_deserialization) {
           PrintF("[Compiling and serializing took %0.3f ms]\n",
                  timer.Elapsed().InMillisecondsF());
         }
+        if (use_persistent_cache) {
+          compilation_cache->PutPersistentScript(
+              source, script_name, line_offset, column_offset,
+              resource_options, language_mode, script_data);
+        }
+        if (compile_options == ScriptCompiler::kProduceCodeCache) {
+          *cached_data = script_data;
+        } else {
+          delete script_data;
+        }
       }
     }
 
@@ -1557,6 +1590,16 @@ Handle<SharedFunctionInfo> Compiler::GetSharedFunctionInfo(
     // called.
     info.EnsureFeedbackVector();
     scope_info = Handle<ScopeInfo>(ScopeInfo::Empty(isolate));
+  } else if (FLAG_ignition &&
+             SharedFunctionInfo::PassesFilter(*literal->debug_name(),
+                                              FLAG_ignition_filter)) {
+    // Compile bytecode for the interpreter. Like the code of eagerly compiled
+    // functions, the bytecode is included in the code cache.
+    if (!Renumber(info.parse_info()) ||
+        !interpreter::Interpreter::MakeBytecode(&info)) {
+      return Handle<SharedFunctionInfo>::null();
+    }
+    scope_info = ScopeInfo::Create(info.isolate(), info.zone(), info.scope());
   } else if (Renumber(info.parse_info()) &&
              FullCodeGenerator::MakeCode(&info)) {
     // MakeCode will ensure that the feedback vector is present and
@@ -1581,6 +1624,9 @@ Handle<SharedFunctionInfo> Compiler::GetSharedFunctionInfo(
     SharedFunctionInfo::InitFromFunctionLiteral(result, literal);
     SharedFunctionInfo::SetScript(result, script);
     result->set_is_toplevel(false);
+    if (info.has_bytecode_array()) {
+      result->set_function_data(*info.bytecode_array());
+    }
     // If the outer function has been compiled before, we cannot be sure that
     // shared function info for this function literal has been created for the
     // first time. It may have already been compiled previously.
@@ -1599,6 +1645,9 @@ Handle<SharedFunctionInfo> Compiler::GetSharedFunctionInfo(
   } else if (!lazy) {
     // Assert that we are not overwriting (possibly patched) debug code.
     DCHECK(!existing->HasDebugCode());
+    if (info.has_bytecode_array()) {
+      existing->set_function_data(*info.bytecode_array());
+    }
     existing->ReplaceCode(*info.code());
     existing->set_scope_info(*scope_info);
     existing->set_feedback_vector(*info.feedback_vector());
@@ -280,6 +280,12 @@ class CompilationInfo {
   }
   void SetCode(Handle<Code> code) { code_ = code; }
 
+  bool has_bytecode_array() const { return !bytecode_array_.is_null(); }
+  Handle<BytecodeArray> bytecode_array() const { return bytecode_array_; }
+  void SetBytecodeArray(Handle<BytecodeArray> bytecode_array) {
+    bytecode_array_ = bytecode_array;
+  }
+
   bool ShouldTrapOnDeopt() const {
     return (FLAG_trap_on_deopt && IsOptimizing()) ||
         (FLAG_trap_on_stub_deopt && IsStub());
@@ -467,6 +473,10 @@ class CompilationInfo {
   // The compiled code.
   Handle<Code> code_;
 
+  // The bytecode generated for the interpreter, installed on the
+  // SharedFunctionInfo by the compiler.
+  Handle<BytecodeArray> bytecode_array_;
+
   // Used by codegen, ultimately kept rooted by the SharedFunctionInfo.
   Handle<TypeFeedbackVector> feedback_vector_;
 
@@ -7,6 +7,7 @@
 #include "src/compiler/linkage.h"
 #include "src/compiler/operator-properties.h"
 #include "src/interpreter/bytecode-array-iterator.h"
+#include "src/type-feedback-vector.h"
 
 namespace v8 {
 namespace internal {
@@ -106,7 +107,8 @@ BytecodeGraphBuilder::BytecodeGraphBuilder(Zone* local_zone,
       jsgraph_(jsgraph),
       input_buffer_size_(0),
       input_buffer_(nullptr),
-      exit_controls_(local_zone) {
+      exit_controls_(local_zone),
+      bailed_out_(false) {
   bytecode_array_ = handle(info()->shared_info()->bytecode_array());
 }
 
@@ -139,11 +141,12 @@ bool BytecodeGraphBuilder::CreateGraph(bool stack_check) {
 
   // Build function context only if there are context allocated variables.
   if (info()->num_heap_slots() > 0) {
-    UNIMPLEMENTED();  // TODO(oth): Write ast-graph-builder equivalent.
+    Bailout();  // TODO(oth): Write ast-graph-builder equivalent.
   } else {
     // Simply use the outer function context in building the graph.
     CreateGraphBody(stack_check);
   }
+  if (bailed_out()) return false;
 
   // Finish the basic structure of the graph.
   DCHECK_NE(0u, exit_controls_.size());
@@ -165,7 +168,7 @@ void BytecodeGraphBuilder::CreateGraphBody(bool stack_check) {
 
 void BytecodeGraphBuilder::VisitBytecodes() {
   interpreter::BytecodeArrayIterator iterator(bytecode_array());
-  while (!iterator.done()) {
+  while (!iterator.done() && !bailed_out()) {
     switch (iterator.current_bytecode()) {
 #define BYTECODE_CASE(name, ...)       \
   case interpreter::Bytecode::k##name: \
@@ -179,6 +182,20 @@ void BytecodeGraphBuilder::VisitBytecodes() {
 }
 
 
+void BytecodeGraphBuilder::VisitWide(
+    const interpreter::BytecodeArrayIterator& iterator) {
+  // Prefixes are consumed by the iterator.
+  UNREACHABLE();
+}
+
+
+void BytecodeGraphBuilder::VisitExtraWide(
+    const interpreter::BytecodeArrayIterator& iterator) {
+  // Prefixes are consumed by the iterator.
+  UNREACHABLE();
+}
+
+
 void BytecodeGraphBuilder::VisitLdaZero(
     const interpreter::BytecodeArrayIterator& iterator) {
   Node* node = jsgraph()->ZeroConstant();
@@ -249,39 +266,72 @@ void BytecodeGraphBuilder::VisitStar(
 }
 
 
+void BytecodeGraphBuilder::VisitLdarAddStar(
+    const interpreter::BytecodeArrayIterator& iterator) {
+  Node* right = environment()->LookupRegister(iterator.GetRegisterOperand(0));
+  Node* left = environment()->LookupRegister(iterator.GetRegisterOperand(1));
+  BuildBinaryOp(javascript()->Add(language_mode()), left, right);
+  environment()->BindRegister(iterator.GetRegisterOperand(2),
+                              environment()->LookupAccumulator());
+}
+
+
 void BytecodeGraphBuilder::VisitLdaGlobal(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitLoadIC(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitKeyedLoadIC(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitStoreIC(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitKeyedStoreIC(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitCall(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  // The receiver and the arguments are in consecutive registers.
+  interpreter::Register receiver = iterator.GetRegisterOperand(1);
+  int arg_count = iterator.GetCountOperand(2);
+  int arity = arg_count + 2;
+  Node** all = local_zone()->NewArray<Node*>(arity);
+  all[0] = environment()->LookupRegister(iterator.GetRegisterOperand(0));
+  for (int i = 0; i < arg_count + 1; i++) {
+    all[i + 1] = environment()->LookupRegister(
+        interpreter::Register(receiver.index() + i));
+  }
+  VectorSlotPair feedback = CreateVectorSlotPair(iterator.GetIndexOperand(3));
+  const Operator* call = javascript()->CallFunction(
+      arity, NO_CALL_FUNCTION_FLAGS, language_mode(), feedback);
+  Node* value = MakeNode(call, arity, all, false);
+  AddEmptyFrameStates(value);
+  environment()->BindAccumulator(value);
+}
+
+
+VectorSlotPair BytecodeGraphBuilder::CreateVectorSlotPair(int slot_index) {
+  Handle<TypeFeedbackVector> feedback_vector(
+      info()->shared_info()->feedback_vector());
+  return VectorSlotPair(feedback_vector,
+                        feedback_vector->ToICSlot(slot_index));
 }
 
 
@@ -289,8 +339,19 @@ void BytecodeGraphBuilder::BuildBinaryOp(
     const Operator* js_op, const interpreter::BytecodeArrayIterator& iterator) {
   Node* left = environment()->LookupRegister(iterator.GetRegisterOperand(0));
   Node* right = environment()->LookupAccumulator();
+  BuildBinaryOp(js_op, left, right);
+}
+
+
+void BytecodeGraphBuilder::BuildBinaryOp(const Operator* js_op, Node* left,
+                                         Node* right) {
   Node* node = NewNode(js_op, left, right);
+  AddEmptyFrameStates(node);
+  environment()->BindAccumulator(node);
+}
 
+
+void BytecodeGraphBuilder::AddEmptyFrameStates(Node* node) {
   // TODO(oth): Real frame state and environment check pointing.
   int frame_state_count =
       OperatorProperties::GetFrameStateInputCount(node->op());
@@ -298,7 +359,6 @@ void BytecodeGraphBuilder::BuildBinaryOp(
     NodeProperties::ReplaceFrameStateInput(node, i,
                                            jsgraph()->EmptyFrameState());
   }
-  environment()->BindAccumulator(node);
 }
 
 
@@ -334,103 +394,115 @@ void BytecodeGraphBuilder::VisitMod(
 
 void BytecodeGraphBuilder::VisitTestEqual(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitTestNotEqual(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitTestEqualStrict(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitTestNotEqualStrict(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitTestLessThan(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitTestGreaterThan(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitTestLessThanOrEqual(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitTestGreaterThanOrEqual(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitTestIn(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitTestInstanceOf(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitToBoolean(
     const interpreter::BytecodeArrayIterator& ToBoolean) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitJump(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitJumpConstant(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitJumpIfTrue(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitJumpIfTrueConstant(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitJumpIfFalse(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
 }
 
 
 void BytecodeGraphBuilder::VisitJumpIfFalseConstant(
     const interpreter::BytecodeArrayIterator& iterator) {
-  UNIMPLEMENTED();
+  Bailout();
+}
+
+
+void BytecodeGraphBuilder::VisitTestLessThanJumpIfFalse(
+    const interpreter::BytecodeArrayIterator& iterator) {
+  Bailout();
+}
+
+
+void BytecodeGraphBuilder::VisitTestLessThanJumpIfFalseConstant(
+    const interpreter::BytecodeArrayIterator& iterator) {
+  Bailout();
 }
 
 
@@ -32,6 +32,11 @@ class BytecodeGraphBuilder {
   void CreateGraphBody(bool stack_check);
   void VisitBytecodes();
 
+  // Stops building the graph on bytecodes which are not supported yet. The
+  // function then keeps running in the interpreter.
+  void Bailout() { bailed_out_ = true; }
+  bool bailed_out() const { return bailed_out_; }
+
   Node* LoadAccumulator(Node* value);
 
   Node* GetFunctionContext();
@@ -66,6 +71,13 @@ class BytecodeGraphBuilder {
 
   void BuildBinaryOp(const Operator* op,
                      const interpreter::BytecodeArrayIterator& iterator);
+  void BuildBinaryOp(const Operator* op, Node* left, Node* right);
+
+  // Replaces the frame state inputs of |node| by the empty frame state.
+  void AddEmptyFrameStates(Node* node);
+
+  // Returns the feedback in the IC slot at vector index |slot_index|.
+  VectorSlotPair CreateVectorSlotPair(int slot_index);
 
   // Growth increment for the temporary buffer used to construct input lists to
   // new nodes.
@@ -108,6 +120,9 @@ class BytecodeGraphBuilder {
   // Control nodes that exit the function body.
   ZoneVector<Node*> exit_controls_;
 
+  // Whether a bytecode which is not supported yet has been visited.
+  bool bailed_out_;
+
   DISALLOW_COPY_AND_ASSIGN(BytecodeGraphBuilder);
 };
 
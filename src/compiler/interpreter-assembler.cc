@@ -17,7 +17,9 @@
 #include "src/frames.h"
 #include "src/interface-descriptors.h"
 #include "src/interpreter/bytecodes.h"
+#include "src/interpreter/interpreter.h"
 #include "src/macro-assembler.h"
+#include "src/type-feedback-vector.h"
 #include "src/zone.h"
 
 namespace v8 {
@@ -25,9 +27,11 @@ namespace internal {
 namespace compiler {
 
 
-InterpreterAssembler::InterpreterAssembler(Isolate* isolate, Zone* zone,
-                                           interpreter::Bytecode bytecode)
+InterpreterAssembler::InterpreterAssembler(
+    Isolate* isolate, Zone* zone, interpreter::Bytecode bytecode,
+    interpreter::OperandScale operand_scale)
     : bytecode_(bytecode),
+      operand_scale_(operand_scale),
       raw_assembler_(new RawMachineAssembler(
           isolate, new (zone) Graph(zone),
           Linkage::GetInterpreterDispatchDescriptor(zone), kMachPtr,
@@ -124,19 +128,87 @@ Node* InterpreterAssembler::StoreRegister(Node* value, Node* reg_index) {
 }
 
 
+// Returns true if the target can load 16-bit and 32-bit words from unaligned
+// addresses in little-endian order, the order in which operands are encoded.
+static bool TargetSupportsUnalignedAccess() {
+#if V8_TARGET_ARCH_IA32 || V8_TARGET_ARCH_X64 || V8_TARGET_ARCH_X87 || \
+    V8_TARGET_ARCH_ARM64
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+Node* InterpreterAssembler::BytecodeOperandReadUnaligned(int operand_index,
+                                                         MachineType rep) {
+  int operand_offset = interpreter::Bytecodes::GetOperandOffset(
+      bytecode_, operand_index, operand_scale_);
+  if (TargetSupportsUnalignedAccess()) {
+    return raw_assembler_->Load(
+        rep, BytecodeArrayTaggedPointer(),
+        IntPtrAdd(BytecodeOffset(), Int32Constant(operand_offset)));
+  }
+
+  // Assemble the operand from single bytes, starting with the most
+  // significant one which carries the sign of signed operands.
+  int count = (rep == kMachInt16 || rep == kMachUint16) ? 2 : 4;
+  bool is_signed = (rep == kMachInt16 || rep == kMachInt32);
+  Node* result = nullptr;
+  for (int i = count - 1; i >= 0; i--) {
+    MachineType byte_rep =
+        (i == count - 1 && is_signed) ? kMachInt8 : kMachUint8;
+    Node* byte = raw_assembler_->Load(
+        byte_rep, BytecodeArrayTaggedPointer(),
+        IntPtrAdd(BytecodeOffset(), Int32Constant(operand_offset + i)));
+    if (result == nullptr) {
+      result = byte;
+    } else {
+      result = raw_assembler_->Word32Or(
+          raw_assembler_->Word32Shl(result, Int32Constant(kBitsPerByte)),
+          byte);
+    }
+  }
+  return result;
+}
+
+
 Node* InterpreterAssembler::BytecodeOperand(int operand_index) {
   DCHECK_LT(operand_index, interpreter::Bytecodes::NumberOfOperands(bytecode_));
-  return raw_assembler_->Load(
-      kMachUint8, BytecodeArrayTaggedPointer(),
-      IntPtrAdd(BytecodeOffset(), Int32Constant(1 + operand_index)));
+  switch (operand_scale_) {
+    case interpreter::OperandScale::kSingle:
+      return raw_assembler_->Load(
+          kMachUint8, BytecodeArrayTaggedPointer(),
+          IntPtrAdd(BytecodeOffset(), Int32Constant(1 + operand_index)));
+    case interpreter::OperandScale::kDouble:
+      return BytecodeOperandReadUnaligned(operand_index, kMachUint16);
+    case interpreter::OperandScale::kQuadruple:
+      return BytecodeOperandReadUnaligned(operand_index, kMachUint32);
+  }
+  UNREACHABLE();
+  return nullptr;
 }
 
 
 Node* InterpreterAssembler::BytecodeOperandSignExtended(int operand_index) {
   DCHECK_LT(operand_index, interpreter::Bytecodes::NumberOfOperands(bytecode_));
-  Node* load = raw_assembler_->Load(
-      kMachInt8, BytecodeArrayTaggedPointer(),
-      IntPtrAdd(BytecodeOffset(), Int32Constant(1 + operand_index)));
+  Node* load;
+  switch (operand_scale_) {
+    case interpreter::OperandScale::kSingle:
+      load = raw_assembler_->Load(
+          kMachInt8, BytecodeArrayTaggedPointer(),
+          IntPtrAdd(BytecodeOffset(), Int32Constant(1 + operand_index)));
+      break;
+    case interpreter::OperandScale::kDouble:
+      load = BytecodeOperandReadUnaligned(operand_index, kMachInt16);
+      break;
+    case interpreter::OperandScale::kQuadruple:
+      load = BytecodeOperandReadUnaligned(operand_index, kMachInt32);
+      break;
+    default:
+      UNREACHABLE();
+      return nullptr;
+  }
   // Ensure that we sign extend to full pointer size
   if (kPointerSize == 8) {
     load = raw_assembler_->ChangeInt32ToInt64(load);
@@ -231,10 +303,15 @@ Node* InterpreterAssembler::WordShl(Node* value, int shift) {
 Node* InterpreterAssembler::LoadConstantPoolEntry(Node* index) {
   Node* constant_pool = LoadObjectField(BytecodeArrayTaggedPointer(),
                                         BytecodeArray::kConstantPoolOffset);
+  return LoadFixedArrayElement(constant_pool, index);
+}
+
+
+Node* InterpreterAssembler::LoadFixedArrayElement(Node* array, Node* index) {
   Node* entry_offset =
       IntPtrAdd(IntPtrConstant(FixedArray::kHeaderSize - kHeapObjectTag),
                 WordShl(index, kPointerSizeLog2));
-  return raw_assembler_->Load(kMachAnyTagged, constant_pool, entry_offset);
+  return raw_assembler_->Load(kMachAnyTagged, array, entry_offset);
 }
 
 
@@ -255,10 +332,15 @@ Node* InterpreterAssembler::LoadContextSlot(int slot_index) {
 }
 
 
-Node* InterpreterAssembler::LoadTypeFeedbackVector() {
-  Node* function = raw_assembler_->Load(
+Node* InterpreterAssembler::LoadFunctionClosure() {
+  return raw_assembler_->Load(
       kMachAnyTagged, RegisterFileRawPointer(),
       IntPtrConstant(InterpreterFrameConstants::kFunctionFromRegisterPointer));
+}
+
+
+Node* InterpreterAssembler::LoadTypeFeedbackVector() {
+  Node* function = LoadFunctionClosure();
   Node* shared_info =
       LoadObjectField(function, JSFunction::kSharedFunctionInfoOffset);
   Node* vector =
@@ -267,6 +349,62 @@ Node* InterpreterAssembler::LoadTypeFeedbackVector() {
 }
 
 
+void InterpreterAssembler::RecordCallFeedback(Node* function,
+                                              Node* slot_index) {
+  RawMachineAssembler::Label check_target, update, done;
+  Node* feedback =
+      LoadFixedArrayElement(LoadTypeFeedbackVector(), slot_index);
+  Handle<HeapObject> megamorphic_sentinel = Handle<HeapObject>::cast(
+      TypeFeedbackVector::MegamorphicSentinel(isolate()));
+  raw_assembler_->Branch(
+      raw_assembler_->WordEqual(feedback, HeapConstant(megamorphic_sentinel)),
+      &done, &check_target);
+  raw_assembler_->Bind(&check_target);
+  // The value of a WeakCell aliases a field of every other object that can be
+  // stored in a CallIC slot, see the asserts in type-feedback-vector.h.
+  Node* target = LoadObjectField(feedback, WeakCell::kValueOffset);
+  raw_assembler_->Branch(raw_assembler_->WordEqual(target, function), &done,
+                         &update);
+  raw_assembler_->Bind(&update);
+  CallRuntime(Runtime::kInterpreterRecordCallFeedback, LoadFunctionClosure(),
+              SmiTag(slot_index), function);
+  raw_assembler_->Goto(&done);
+  raw_assembler_->Bind(&done);
+}
+
+
+void InterpreterAssembler::UpdateInterruptBudget(Node* weight) {
+  RawMachineAssembler::Label ok, interrupt, done;
+  Node* budget_offset =
+      IntPtrConstant(BytecodeArray::kInterruptBudgetOffset - kHeapObjectTag);
+  Node* old_budget = raw_assembler_->Load(
+      kMachInt32, BytecodeArrayTaggedPointer(), budget_offset);
+  if (kPointerSize == 8) {
+    weight = raw_assembler_->TruncateInt64ToInt32(weight);
+  }
+  Node* new_budget = raw_assembler_->Int32Sub(old_budget, weight);
+  raw_assembler_->Branch(
+      raw_assembler_->Int32LessThan(new_budget, Int32Constant(0)), &interrupt,
+      &ok);
+  raw_assembler_->Bind(&interrupt);
+  // The runtime resets the budget.
+  CallRuntime(Runtime::kInterpreterProfilerTick, LoadFunctionClosure());
+  raw_assembler_->Goto(&done);
+  raw_assembler_->Bind(&ok);
+  raw_assembler_->Store(kMachInt32, BytecodeArrayTaggedPointer(),
+                        budget_offset, new_budget);
+  raw_assembler_->Goto(&done);
+  raw_assembler_->Bind(&done);
+}
+
+
+void InterpreterAssembler::UpdateInterruptBudgetOnReturn() {
+  // The bytecode offset of the return approximates the size of the bytecode
+  // executed since the function was entered.
+  UpdateInterruptBudget(BytecodeOffset());
+}
+
+
 Node* InterpreterAssembler::CallJS(Node* function, Node* first_arg,
                                    Node* arg_count) {
   Callable builtin = CodeFactory::PushArgsAndCall(isolate());
@@ -334,6 +472,13 @@ Node* InterpreterAssembler::CallRuntime(Runtime::FunctionId function_id,
 }
 
 
+Node* InterpreterAssembler::CallRuntime(Runtime::FunctionId function_id,
+                                        Node* arg1, Node* arg2, Node* arg3) {
+  return raw_assembler_->CallRuntime3(function_id, arg1, arg2, arg3,
+                                      ContextTaggedPointer());
+}
+
+
 void InterpreterAssembler::Return() {
   Node* exit_trampoline_code_object =
       HeapConstant(isolate()->builtins()->InterpreterExitTrampoline());
@@ -367,7 +512,17 @@ Node* InterpreterAssembler::Advance(Node* delta) {
 }
 
 
-void InterpreterAssembler::Jump(Node* delta) { DispatchTo(Advance(delta)); }
+Node* InterpreterAssembler::JumpWeight(Node* delta) {
+  // Backward jumps are charged with the size of the bytecode they jump over,
+  // forward jumps give back the budget of the bytecode they skip.
+  return IntPtrSub(IntPtrConstant(0), delta);
+}
+
+
+void InterpreterAssembler::Jump(Node* delta) {
+  UpdateInterruptBudget(JumpWeight(delta));
+  DispatchTo(Advance(delta));
+}
 
 
 void InterpreterAssembler::JumpIfWordEqual(Node* lhs, Node* rhs, Node* delta) {
@@ -375,6 +530,7 @@ void InterpreterAssembler::JumpIfWordEqual(Node* lhs, Node* rhs, Node* delta) {
   Node* condition = raw_assembler_->WordEqual(lhs, rhs);
   raw_assembler_->Branch(condition, &match, &no_match);
   raw_assembler_->Bind(&match);
+  UpdateInterruptBudget(JumpWeight(delta));
   DispatchTo(Advance(delta));
   raw_assembler_->Bind(&no_match);
   Dispatch();
@@ -382,13 +538,15 @@ void InterpreterAssembler::JumpIfWordEqual(Node* lhs, Node* rhs, Node* delta) {
 
 
 void InterpreterAssembler::Dispatch() {
-  DispatchTo(Advance(interpreter::Bytecodes::Size(bytecode_)));
+  DispatchTo(
+      Advance(interpreter::Bytecodes::Size(bytecode_, operand_scale_)));
 }
 
 
 void InterpreterAssembler::DispatchTo(Node* new_bytecode_offset) {
   Node* target_bytecode = raw_assembler_->Load(
       kMachUint8, BytecodeArrayTaggedPointer(), new_bytecode_offset);
+  if (FLAG_trace_ignition_dispatches) TraceBytecodeDispatch(target_bytecode);
 
   // TODO(rmcilroy): Create a code target dispatch table to avoid conversion
   // from code object on every dispatch.
@@ -396,7 +554,50 @@ void InterpreterAssembler::DispatchTo(Node* new_bytecode_offset) {
       kMachPtr, DispatchTableRawPointer(),
       raw_assembler_->Word32Shl(target_bytecode,
                                 Int32Constant(kPointerSizeLog2)));
+  DispatchToBytecodeHandler(target_code_object, new_bytecode_offset);
+}
+
+
+void InterpreterAssembler::DispatchWide(
+    interpreter::OperandScale operand_scale) {
+  // The prefixed bytecode directly follows the prefix. Its handler is called
+  // with the offset of the bytecode rather than of the prefix.
+  Node* next_bytecode_offset = Advance(1);
+  Node* next_bytecode = raw_assembler_->Load(
+      kMachUint8, BytecodeArrayTaggedPointer(), next_bytecode_offset);
+  if (FLAG_trace_ignition_dispatches) TraceBytecodeDispatch(next_bytecode);
+
+  int table_start = interpreter::Interpreter::GetDispatchTableIndex(
+      interpreter::Bytecodes::FromByte(0), operand_scale);
+  Node* target_index =
+      raw_assembler_->Int32Add(next_bytecode, Int32Constant(table_start));
+  Node* target_code_object = raw_assembler_->Load(
+      kMachPtr, DispatchTableRawPointer(),
+      raw_assembler_->Word32Shl(target_index,
+                                Int32Constant(kPointerSizeLog2)));
+  DispatchToBytecodeHandler(target_code_object, next_bytecode_offset);
+}
+
+
+void InterpreterAssembler::TraceBytecodeDispatch(Node* target_bytecode) {
+  Node* counters_table = raw_assembler_->ExternalConstant(
+      ExternalReference::interpreter_dispatch_counters(isolate()));
+  int source_index = static_cast<int>(bytecode_) *
+                     interpreter::Interpreter::kEntriesPerOperandScale;
+  Node* counter_index =
+      raw_assembler_->Int32Add(target_bytecode, Int32Constant(source_index));
+  Node* counter_offset = raw_assembler_->Word32Shl(
+      counter_index, Int32Constant(kPointerSizeLog2));
+  Node* old_counter =
+      raw_assembler_->Load(kMachUintPtr, counters_table, counter_offset);
+  Node* new_counter = IntPtrAdd(old_counter, IntPtrConstant(1));
+  raw_assembler_->Store(kMachUintPtr, counters_table, counter_offset,
+                        new_counter);
+}
+
 
+void InterpreterAssembler::DispatchToBytecodeHandler(
+    Node* target_code_object, Node* new_bytecode_offset) {
   // If the order of the parameters you need to change the call signature below.
   STATIC_ASSERT(0 == Linkage::kInterpreterAccumulatorParameter);
   STATIC_ASSERT(1 == Linkage::kInterpreterRegisterFileParameter);
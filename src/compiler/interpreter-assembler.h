@@ -24,6 +24,7 @@ class Zone;
 
 namespace compiler {
 
+enum MachineType : uint16_t;
 class CallDescriptor;
 class Graph;
 class Node;
@@ -34,7 +35,9 @@ class Schedule;
 class InterpreterAssembler {
  public:
   InterpreterAssembler(Isolate* isolate, Zone* zone,
-                       interpreter::Bytecode bytecode);
+                       interpreter::Bytecode bytecode,
+                       interpreter::OperandScale operand_scale =
+                           interpreter::OperandScale::kSingle);
   virtual ~InterpreterAssembler();
 
   Handle<Code> GenerateCode();
@@ -83,6 +86,9 @@ class InterpreterAssembler {
   // Load constant at |index| in the constant pool.
   Node* LoadConstantPoolEntry(Node* index);
 
+  // Load the element at |index| of the FixedArray |array|.
+  Node* LoadFixedArrayElement(Node* array, Node* index);
+
   // Load a field from an object on the heap.
   Node* LoadObjectField(Node* object, int offset);
 
@@ -92,9 +98,24 @@ class InterpreterAssembler {
   // Load |slot_index| from the current context.
   Node* LoadContextSlot(int slot_index);
 
+  // Load the JSFunction which is being interpreted.
+  Node* LoadFunctionClosure();
+
   // Load the TypeFeedbackVector for the current function.
   Node* LoadTypeFeedbackVector();
 
+  // Record the call target |function| in the CallIC slot at |slot_index| of
+  // the TypeFeedbackVector. Calls into the runtime only if the feedback
+  // changes.
+  void RecordCallFeedback(Node* function, Node* slot_index);
+
+  // Decrement the interrupt budget of the current function by |weight| and
+  // call into the runtime profiler once the budget is exhausted.
+  void UpdateInterruptBudget(Node* weight);
+
+  // Charge the interrupt budget for the bytecodes executed before a return.
+  void UpdateInterruptBudgetOnReturn();
+
   // Call JSFunction or Callable |function| with |arg_count| (not including
   // receiver) and the first argument located at |first_arg|.
   Node* CallJS(Node* function, Node* first_arg, Node* arg_count);
@@ -108,8 +129,11 @@ class InterpreterAssembler {
   // Call runtime function.
   Node* CallRuntime(Runtime::FunctionId function_id, Node* arg1);
   Node* CallRuntime(Runtime::FunctionId function_id, Node* arg1, Node* arg2);
+  Node* CallRuntime(Runtime::FunctionId function_id, Node* arg1, Node* arg2,
+                    Node* arg3);
 
-  // Jump relative to the current bytecode by |jump_offset|.
+  // Jump relative to the current bytecode by |jump_offset|. Taken jumps are
+  // charged to the interrupt budget.
   void Jump(Node* jump_offset);
 
   // Jump relative to the current bytecode by |jump_offset| if the
@@ -122,6 +146,10 @@ class InterpreterAssembler {
   // Dispatch to the bytecode.
   void Dispatch();
 
+  // Dispatch to the handler of the bytecode following a prefix for the
+  // operand scale |operand_scale|.
+  void DispatchWide(interpreter::OperandScale operand_scale);
+
  protected:
   // Close the graph.
   void End();
@@ -148,6 +176,9 @@ class InterpreterAssembler {
   Node* SmiShiftBitsConstant();
   Node* BytecodeOperand(int operand_index);
   Node* BytecodeOperandSignExtended(int operand_index);
+  // Loads the operand at |operand_index| with the machine type |rep| from a
+  // possibly unaligned offset.
+  Node* BytecodeOperandReadUnaligned(int operand_index, MachineType rep);
 
   Node* CallIC(CallInterfaceDescriptor descriptor, Node* target, Node** args);
   Node* CallJSBuiltin(int context_index, Node* receiver, Node** js_args,
@@ -158,9 +189,22 @@ class InterpreterAssembler {
   Node* Advance(int delta);
   Node* Advance(Node* delta);
 
+  // Returns the weight with which a jump by |delta| is charged to the
+  // interrupt budget.
+  Node* JumpWeight(Node* delta);
+
   // Starts next instruction dispatch at |new_bytecode_offset|.
   void DispatchTo(Node* new_bytecode_offset);
 
+  // Tail calls the handler |target_code_object| for the bytecode at
+  // |new_bytecode_offset|.
+  void DispatchToBytecodeHandler(Node* target_code_object,
+                                 Node* new_bytecode_offset);
+
+  // Counts the dispatch from the current bytecode to |target_bytecode| with
+  // --trace-ignition-dispatches.
+  void TraceBytecodeDispatch(Node* target_bytecode);
+
   // Adds an end node of the graph.
   void AddEndInput(Node* input);
 
@@ -170,6 +214,7 @@ class InterpreterAssembler {
   Zone* zone();
 
   interpreter::Bytecode bytecode_;
+  interpreter::OperandScale operand_scale_;
   base::SmartPointer<RawMachineAssembler> raw_assembler_;
   ZoneVector<Node*> end_nodes_;
   Node* accumulator_;
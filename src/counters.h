@@ -571,6 +571,10 @@ double AggregatedMemoryHistogram<Histogram>::Aggregate(double current_ms,
   SC(arguments_adaptors, V8.ArgumentsAdaptors)                        \
   SC(compilation_cache_hits, V8.CompilationCacheHits)                 \
   SC(compilation_cache_misses, V8.CompilationCacheMisses)             \
+  SC(persistent_compilation_cache_hits,                               \
+     V8.PersistentCompilationCacheHits)                               \
+  SC(persistent_compilation_cache_misses,                             \
+     V8.PersistentCompilationCacheMisses)                             \
   /* Amount of evaled source code. */                                 \
   SC(total_eval_size, V8.TotalEvalSize)                               \
   /* Amount of loaded source code. */                                 \
@@ -668,6 +672,7 @@ double AggregatedMemoryHistogram<Histogram>::Aggregate(double current_ms,
   SC(string_compare_runtime, V8.StringCompareRuntime)                          \
   SC(regexp_entry_runtime, V8.RegExpEntryRuntime)                              \
   SC(regexp_entry_native, V8.RegExpEntryNative)                                \
+  SC(regexp_required_literal_misses, V8.RegExpRequiredLiteralMisses)          \
   SC(number_to_string_native, V8.NumberToStringNative)                         \
   SC(number_to_string_runtime, V8.NumberToStringRuntime)                       \
   SC(math_acos, V8.MathAcos)                                                   \
@@ -19,6 +19,8 @@
 
 #ifndef V8_SHARED
 #include <algorithm>
+#include <map>
+#include <string>
 #include <vector>
 #endif  // !V8_SHARED
 
@@ -42,6 +44,7 @@
 #include "src/base/cpu.h"
 #include "src/base/logging.h"
 #include "src/base/platform/platform.h"
+#include "src/base/smart-pointers.h"
 #include "src/base/sys-info.h"
 #include "src/basic-block-profiler.h"
 #include "src/snapshot/natives.h"
@@ -101,6 +104,91 @@ class MockArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
 };
 
 
+#ifndef V8_SHARED
+// A persistent compilation cache in a file. The entries that exist when the
+// cache is opened are memory mapped. New entries are appended to the file and
+// are found by processes that open the cache later.
+//
+// Each entry consists of a header with the magic number and the lengths of
+// the key and the data, followed by the key and the data, each padded to
+// kAlignment so that the data can be deserialized in place.
+class PersistentCacheFile : public v8::PersistentCompilationCache {
+ public:
+  explicit PersistentCacheFile(const char* name) : name_(name) {
+    file_ = base::OS::MemoryMappedFile::open(name);
+    if (file_ == NULL) return;
+    const uint8_t* start = static_cast<const uint8_t*>(file_->memory());
+    size_t size = file_->size();
+    size_t offset = 0;
+    // A truncated entry at the end is left over from a process that died
+    // while storing it, and is ignored.
+    while (size - offset >= kHeaderSize) {
+      const uint32_t* header =
+          reinterpret_cast<const uint32_t*>(start + offset);
+      if (header[0] != kMagicNumber) break;
+      size_t key_size = RoundUp(header[1], kAlignment);
+      size_t data_size = RoundUp(header[2], kAlignment);
+      if (size - offset - kHeaderSize < key_size + data_size) break;
+      const uint8_t* key = start + offset + kHeaderSize;
+      Entry entry = {key + key_size, static_cast<int>(header[2])};
+      // Later entries replace earlier ones with the same key.
+      entries_[std::string(reinterpret_cast<const char*>(key), header[1])] =
+          entry;
+      offset += kHeaderSize + key_size + data_size;
+    }
+  }
+
+  ~PersistentCacheFile() override { delete file_; }
+
+  v8::ScriptCompiler::CachedData* Lookup(const uint8_t* key,
+                                         int key_length) override {
+    base::LockGuard<base::Mutex> lock_guard(&mutex_);
+    std::map<std::string, Entry>::const_iterator it = entries_.find(
+        std::string(reinterpret_cast<const char*>(key), key_length));
+    if (it == entries_.end()) return NULL;
+    return new v8::ScriptCompiler::CachedData(it->second.data,
+                                              it->second.length);
+  }
+
+  void Store(const uint8_t* key, int key_length, const uint8_t* data,
+             int length) override {
+    size_t key_size = RoundUp(key_length, kAlignment);
+    size_t data_size = RoundUp(length, kAlignment);
+    std::vector<uint8_t> entry(kHeaderSize + key_size + data_size, 0);
+    uint32_t* header = reinterpret_cast<uint32_t*>(&entry[0]);
+    header[0] = kMagicNumber;
+    header[1] = static_cast<uint32_t>(key_length);
+    header[2] = static_cast<uint32_t>(length);
+    memcpy(&entry[kHeaderSize], key, key_length);
+    memcpy(&entry[kHeaderSize + key_size], data, length);
+    // Append the whole entry with a single write, so that processes sharing
+    // the file do not interleave their entries.
+    base::LockGuard<base::Mutex> lock_guard(&mutex_);
+    FILE* file = base::OS::FOpen(name_, "ab");
+    if (file == NULL) return;
+    fwrite(&entry[0], 1, entry.size(), file);
+    fclose(file);
+  }
+
+ private:
+  struct Entry {
+    const uint8_t* data;
+    int length;
+  };
+
+  static const uint32_t kMagicNumber = 0x43503856;  // "V8PC"
+  // Magic number, key length, data length and padding.
+  static const size_t kHeaderSize = 4 * sizeof(uint32_t);
+  static const size_t kAlignment = 8;
+
+  const char* name_;
+  base::OS::MemoryMappedFile* file_;
+  std::map<std::string, Entry> entries_;
+  base::Mutex mutex_;
+};
+#endif  // !V8_SHARED
+
+
 v8::Platform* g_platform = NULL;
 
 
@@ -112,16 +200,6 @@ static Local<Value> Throw(Isolate* isolate, const char* message) {
 
 
 #ifndef V8_SHARED
-bool FindInObjectList(Local<Object> object, const Shell::ObjectList& list) {
-  for (int i = 0; i < list.length(); ++i) {
-    if (list[i]->StrictEquals(object)) {
-      return true;
-    }
-  }
-  return false;
-}
-
-
 Worker* GetWorkerFromInternalField(Isolate* isolate, Local<Object> object) {
   if (object->InternalFieldCount() != 1) {
     Throw(isolate, "this is not a Worker");
@@ -734,7 +812,6 @@ void Shell::WorkerNew(const v8::FunctionCallbackInfo<v8::Value>& args) {
 void Shell::WorkerPostMessage(const v8::FunctionCallbackInfo<v8::Value>& args) {
   Isolate* isolate = args.GetIsolate();
   HandleScope handle_scope(isolate);
-  Local<Context> context = isolate->GetCurrentContext();
 
   if (args.Length() < 1) {
     Throw(isolate, "Invalid argument");
@@ -747,37 +824,10 @@ void Shell::WorkerPostMessage(const v8::FunctionCallbackInfo<v8::Value>& args) {
   }
 
   Local<Value> message = args[0];
-  ObjectList to_transfer;
-  if (args.Length() >= 2) {
-    if (!args[1]->IsArray()) {
-      Throw(isolate, "Transfer list must be an Array");
-      return;
-    }
-
-    Local<Array> transfer = Local<Array>::Cast(args[1]);
-    uint32_t length = transfer->Length();
-    for (uint32_t i = 0; i < length; ++i) {
-      Local<Value> element;
-      if (transfer->Get(context, i).ToLocal(&element)) {
-        if (!element->IsArrayBuffer() && !element->IsSharedArrayBuffer()) {
-          Throw(isolate,
-                "Transfer array elements must be an ArrayBuffer or "
-                "SharedArrayBuffer.");
-          break;
-        }
-
-        to_transfer.Add(Local<Object>::Cast(element));
-      }
-    }
-  }
-
-  ObjectList seen_objects;
-  SerializationData* data = new SerializationData;
-  if (SerializeValue(isolate, message, to_transfer, &seen_objects, data)) {
-    worker->PostMessage(data);
-  } else {
-    delete data;
-  }
+  Local<Value> transfer =
+      args.Length() >= 2 ? args[1] : Local<Value>::Cast(Undefined(isolate));
+  SerializationData* data = SerializeValue(isolate, message, transfer);
+  if (data) worker->PostMessage(data);
 }
 
 
@@ -791,9 +841,8 @@ void Shell::WorkerGetMessage(const v8::FunctionCallbackInfo<v8::Value>& args) {
 
   SerializationData* data = worker->GetMessage();
   if (data) {
-    int offset = 0;
     Local<Value> data_value;
-    if (Shell::DeserializeValue(isolate, *data, &offset).ToLocal(&data_value)) {
+    if (Shell::DeserializeValue(isolate, data).ToLocal(&data_value)) {
       args.GetReturnValue().Set(data_value);
     }
     delete data;
@@ -1556,7 +1605,7 @@ void SourceGroup::JoinThread() {
 
 SerializationData::~SerializationData() {
   // Any ArrayBuffer::Contents are owned by this SerializationData object if
-  // ownership hasn't been transferred out via ReadArrayBufferContents.
+  // ownership hasn't been transferred out via ReleaseArrayBufferContents.
   // SharedArrayBuffer::Contents may be used by multiple threads, so must be
   // cleaned up by the main thread in Shell::CleanupWorkers().
   for (int i = 0; i < array_buffer_contents_.length(); ++i) {
@@ -1566,68 +1615,36 @@ SerializationData::~SerializationData() {
                                           contents.ByteLength());
     }
   }
+  if (data_) ValueSerializer::FreeBuffer(data_);
 }
 
 
-void SerializationData::WriteTag(SerializationTag tag) { data_.Add(tag); }
-
-
-void SerializationData::WriteMemory(const void* p, int length) {
-  if (length > 0) {
-    i::Vector<uint8_t> block = data_.AddBlock(0, length);
-    memcpy(&block[0], p, length);
-  }
+void SerializationData::SetData(uint8_t* data, size_t size) {
+  DCHECK(data_ == NULL);
+  data_ = data;
+  size_ = size;
 }
 
 
-void SerializationData::WriteArrayBufferContents(
+void SerializationData::AddArrayBufferContents(
     const ArrayBuffer::Contents& contents) {
   array_buffer_contents_.Add(contents);
-  WriteTag(kSerializationTagTransferredArrayBuffer);
-  int index = array_buffer_contents_.length() - 1;
-  Write(index);
 }
 
 
-void SerializationData::WriteSharedArrayBufferContents(
+void SerializationData::AddSharedArrayBufferContents(
     const SharedArrayBuffer::Contents& contents) {
   shared_array_buffer_contents_.Add(contents);
-  WriteTag(kSerializationTagTransferredSharedArrayBuffer);
-  int index = shared_array_buffer_contents_.length() - 1;
-  Write(index);
-}
-
-
-SerializationTag SerializationData::ReadTag(int* offset) const {
-  return static_cast<SerializationTag>(Read<uint8_t>(offset));
 }
 
 
-void SerializationData::ReadMemory(void* p, int length, int* offset) const {
-  if (length > 0) {
-    memcpy(p, &data_[*offset], length);
-    (*offset) += length;
-  }
-}
-
-
-void SerializationData::ReadArrayBufferContents(ArrayBuffer::Contents* contents,
-                                                int* offset) const {
-  int index = Read<int>(offset);
-  DCHECK(index < array_buffer_contents_.length());
-  *contents = array_buffer_contents_[index];
-  // Ownership of this ArrayBuffer::Contents is passed to the caller. Neuter
-  // our copy so it won't be double-free'd when this SerializationData is
-  // destroyed.
+ArrayBuffer::Contents SerializationData::ReleaseArrayBufferContents(
+    int index) {
+  ArrayBuffer::Contents contents = array_buffer_contents_[index];
+  // Clear our copy so it won't be double-free'd when this SerializationData
+  // is destroyed.
   array_buffer_contents_[index] = ArrayBuffer::Contents();
-}
-
-
-void SerializationData::ReadSharedArrayBufferContents(
-    SharedArrayBuffer::Contents* contents, int* offset) const {
-  int index = Read<int>(offset);
-  DCHECK(index < shared_array_buffer_contents_.length());
-  *contents = shared_array_buffer_contents_[index];
+  return contents;
 }
 
 
@@ -1770,10 +1787,8 @@ void Worker::ExecuteInThread() {
               if (data == NULL) {
                 break;
               }
-              int offset = 0;
               Local<Value> data_value;
-              if (Shell::DeserializeValue(isolate, *data, &offset)
-                      .ToLocal(&data_value)) {
+              if (Shell::DeserializeValue(isolate, data).ToLocal(&data_value)) {
                 Local<Value> argv[] = {data_value};
                 (void)onmessage_fun->Call(context, global, 1, argv);
               }
@@ -1804,21 +1819,276 @@ void Worker::PostMessageOut(const v8::FunctionCallbackInfo<v8::Value>& args) {
 
   Local<Value> message = args[0];
 
-  // TODO(binji): Allow transferring from worker to main thread?
-  Shell::ObjectList to_transfer;
-
-  Shell::ObjectList seen_objects;
-  SerializationData* data = new SerializationData;
-  if (Shell::SerializeValue(isolate, message, to_transfer, &seen_objects,
-                            data)) {
+  Local<Value> transfer =
+      args.Length() >= 2 ? args[1] : Local<Value>::Cast(Undefined(isolate));
+  SerializationData* data = Shell::SerializeValue(isolate, message, transfer);
+  if (data) {
     DCHECK(args.Data()->IsExternal());
     Local<External> this_value = Local<External>::Cast(args.Data());
     Worker* worker = static_cast<Worker*>(this_value->Value());
     worker->out_queue_.Enqueue(data);
     worker->out_semaphore_.Signal();
+  }
+}
+
+
+void TaskQueueTimingPlatform::CallOnBackgroundThread(
+    Task* task, ExpectedRuntime expected_runtime) {
+  base::TimeTicks start = base::TimeTicks::HighResolutionNow();
+  platform_->CallOnBackgroundThread(task, expected_runtime);
+  RecordPost(start);
+}
+
+
+void TaskQueueTimingPlatform::CallOnForegroundThread(Isolate* isolate,
+                                                     Task* task) {
+  base::TimeTicks start = base::TimeTicks::HighResolutionNow();
+  platform_->CallOnForegroundThread(isolate, task);
+  RecordPost(start);
+}
+
+
+void TaskQueueTimingPlatform::CallDelayedOnForegroundThread(
+    Isolate* isolate, Task* task, double delay_in_seconds) {
+  base::TimeTicks start = base::TimeTicks::HighResolutionNow();
+  platform_->CallDelayedOnForegroundThread(isolate, task, delay_in_seconds);
+  RecordPost(start);
+}
+
+
+void TaskQueueTimingPlatform::CallIdleOnForegroundThread(Isolate* isolate,
+                                                         IdleTask* task) {
+  base::TimeTicks start = base::TimeTicks::HighResolutionNow();
+  platform_->CallIdleOnForegroundThread(isolate, task);
+  RecordPost(start);
+}
+
+
+bool TaskQueueTimingPlatform::IdleTasksEnabled(Isolate* isolate) {
+  return platform_->IdleTasksEnabled(isolate);
+}
+
+
+double TaskQueueTimingPlatform::MonotonicallyIncreasingTime() {
+  return platform_->MonotonicallyIncreasingTime();
+}
+
+
+void TaskQueueTimingPlatform::RecordPost(base::TimeTicks start) {
+  intptr_t time = static_cast<intptr_t>(
+      (base::TimeTicks::HighResolutionNow() - start).InMicroseconds());
+  post_count_.Increment(1);
+  post_time_.Increment(time);
+  intptr_t max_time = max_post_time_.Value();
+  while (time > max_time && !max_post_time_.TrySetValue(max_time, time)) {
+    max_time = max_post_time_.Value();
+  }
+}
+
+
+void TaskQueueTimingPlatform::ResetStats() {
+  post_count_.SetValue(0);
+  post_time_.SetValue(0);
+  max_post_time_.SetValue(0);
+}
+
+
+int TaskQueueTimingPlatform::post_count() { return post_count_.Value(); }
+
+
+base::TimeDelta TaskQueueTimingPlatform::post_time() {
+  return base::TimeDelta::FromMicroseconds(post_time_.Value());
+}
+
+
+base::TimeDelta TaskQueueTimingPlatform::max_post_time() {
+  return base::TimeDelta::FromMicroseconds(max_post_time_.Value());
+}
+
+
+// PerIsolateData uses slot 0.
+static const uint32_t kIsolateBenchmarkDataSlot = 1;
+
+
+// Returns the resident set size of the process in kilobytes, or -1 if it is
+// not known on this platform.
+static int64_t ResidentMemoryKB() {
+#if V8_OS_LINUX
+  FILE* file = fopen("/proc/self/statm", "r");
+  if (file == NULL) return -1;
+  long pages = 0;  // NOLINT(runtime/int)
+  long resident = 0;  // NOLINT(runtime/int)
+  int fields = fscanf(file, "%ld %ld", &pages, &resident);
+  fclose(file);
+  if (fields != 2) return -1;
+  return static_cast<int64_t>(resident) * sysconf(_SC_PAGESIZE) / i::KB;
+#else
+  return -1;
+#endif
+}
+
+
+bool IsolateBenchmark::Run(const char* isolate_counts) {
+  std::vector<int> counts;
+  const char* position = isolate_counts;
+  while (true) {
+    char* end;
+    long count = strtol(position, &end, 10);  // NOLINT(runtime/int)
+    if (end == position || count <= 0 || count > 1024) return false;
+    counts.push_back(static_cast<int>(count));
+    if (*end == '\0') break;
+    if (*end != ',') return false;
+    position = end + 1;
+  }
+
+  double base_throughput = 0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    double throughput = RunIsolates(counts[i]);
+    if (i == 0) {
+      base_throughput = throughput / counts[0];
+    } else if (base_throughput > 0) {
+      double speedup = throughput / (base_throughput * counts[0]);
+      printf("Scaling: %.2fx the throughput of %d isolate%s "
+             "(%.1f%% efficiency)\n",
+             speedup, counts[0], counts[0] == 1 ? "" : "s",
+             100.0 * throughput / (base_throughput * counts[i]));
+    }
+  }
+  return true;
+}
+
+
+double IsolateBenchmark::RunIsolates(int count) {
+  std::vector<IsolateStats> stats(count);
+  std::vector<BenchmarkThread*> threads(count);
+  platform_->ResetStats();
+  int64_t resident_before = ResidentMemoryKB();
+  for (int i = 0; i < count; ++i) {
+    threads[i] = new BenchmarkThread(this, &stats[i]);
+    threads[i]->Start();
+  }
+  // Set up all isolates before any of them runs, so that they all run
+  // concurrently.
+  for (int i = 0; i < count; ++i) ready_semaphore_.Wait();
+  int64_t resident_after = ResidentMemoryKB();
+  base::TimeTicks start = base::TimeTicks::HighResolutionNow();
+  for (int i = 0; i < count; ++i) start_semaphore_.Signal();
+  for (int i = 0; i < count; ++i) {
+    threads[i]->Join();
+    delete threads[i];
+  }
+
+  base::TimeTicks end = start;
+  int total_runs = 0;
+  int total_gc_count = 0;
+  base::TimeDelta total_run_time;
+  base::TimeDelta total_gc_time;
+  base::TimeDelta total_setup_time;
+  base::TimeDelta max_setup_time;
+  printf("Isolates: %d, runs per isolate: %d\n", count, runs_);
+  printf("  Isolate   Runs/s  Setup ms    Run ms     GC ms    GCs\n");
+  for (int i = 0; i < count; ++i) {
+    const IsolateStats& isolate_stats = stats[i];
+    double run_ms = isolate_stats.run_time.InMillisecondsF();
+    printf("  %7d %8.2f %9.2f %9.2f %9.2f %6d\n", i,
+           run_ms > 0 ? isolate_stats.runs * 1000.0 / run_ms : 0.0,
+           isolate_stats.setup_time.InMillisecondsF(), run_ms,
+           isolate_stats.gc_time.InMillisecondsF(), isolate_stats.gc_count);
+    if (isolate_stats.run_end > end) end = isolate_stats.run_end;
+    total_runs += isolate_stats.runs;
+    total_gc_count += isolate_stats.gc_count;
+    total_run_time += isolate_stats.run_time;
+    total_gc_time += isolate_stats.gc_time;
+    total_setup_time += isolate_stats.setup_time;
+    if (isolate_stats.setup_time > max_setup_time) {
+      max_setup_time = isolate_stats.setup_time;
+    }
+  }
+
+  double wall_ms = (end - start).InMillisecondsF();
+  double throughput = wall_ms > 0 ? total_runs * 1000.0 / wall_ms : 0.0;
+  double total_run_ms = total_run_time.InMillisecondsF();
+  int post_count = platform_->post_count();
+  printf("Aggregate: %.2f runs/s over %.2f ms\n", throughput, wall_ms);
+  printf("GC: %.2f ms in %d GCs (%.1f%% of run time)\n",
+         total_gc_time.InMillisecondsF(), total_gc_count,
+         total_run_ms > 0
+             ? 100.0 * total_gc_time.InMillisecondsF() / total_run_ms
+             : 0.0);
+  printf("Setup: %.2f ms average, %.2f ms max\n",
+         total_setup_time.InMillisecondsF() / count,
+         max_setup_time.InMillisecondsF());
+  if (resident_before >= 0 && resident_after >= 0) {
+    printf("Resident memory: %.1f KB per isolate after setup\n",
+           static_cast<double>(resident_after - resident_before) / count);
   } else {
-    delete data;
+    printf("Resident memory: n/a\n");
   }
+  printf("Task queue: %d tasks posted, %.2f us average, %.2f us max\n",
+         post_count,
+         post_count > 0 ? static_cast<double>(
+                              platform_->post_time().InMicroseconds()) /
+                              post_count
+                        : 0.0,
+         static_cast<double>(platform_->max_post_time().InMicroseconds()));
+  return throughput;
+}
+
+
+void IsolateBenchmark::RunIsolate(IsolateStats* stats) {
+  // Setting up an isolate includes reserving its code range and building its
+  // external reference table, which is where isolates started at the same
+  // time contend.
+  base::TimeTicks start = base::TimeTicks::HighResolutionNow();
+  Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = Shell::array_buffer_allocator;
+  Isolate* isolate = Isolate::New(create_params);
+  stats->setup_time = base::TimeTicks::HighResolutionNow() - start;
+  isolate->SetData(kIsolateBenchmarkDataSlot, stats);
+  isolate->AddGCPrologueCallback(GCPrologue);
+  isolate->AddGCEpilogueCallback(GCEpilogue);
+
+  ready_semaphore_.Signal();
+  start_semaphore_.Wait();
+
+  start = base::TimeTicks::HighResolutionNow();
+  {
+    Isolate::Scope iscope(isolate);
+    for (int i = 0; i < runs_; ++i) {
+      {
+        HandleScope scope(isolate);
+        PerIsolateData data(isolate);
+        Local<Context> context = Shell::CreateEvaluationContext(isolate);
+        {
+          Context::Scope cscope(context);
+          PerIsolateData::RealmScope realm_scope(PerIsolateData::Get(isolate));
+          group_->Execute(isolate);
+        }
+      }
+      Shell::EmptyMessageQueues(isolate);
+      stats->runs++;
+    }
+  }
+  stats->run_end = base::TimeTicks::HighResolutionNow();
+  stats->run_time = stats->run_end - start;
+  isolate->Dispose();
+}
+
+
+void IsolateBenchmark::GCPrologue(Isolate* isolate, GCType type,
+                                  GCCallbackFlags flags) {
+  IsolateStats* stats = reinterpret_cast<IsolateStats*>(
+      isolate->GetData(kIsolateBenchmarkDataSlot));
+  stats->gc_start = base::TimeTicks::HighResolutionNow();
+}
+
+
+void IsolateBenchmark::GCEpilogue(Isolate* isolate, GCType type,
+                                  GCCallbackFlags flags) {
+  IsolateStats* stats = reinterpret_cast<IsolateStats*>(
+      isolate->GetData(kIsolateBenchmarkDataSlot));
+  stats->gc_time += base::TimeTicks::HighResolutionNow() - stats->gc_start;
+  stats->gc_count++;
 }
 #endif  // !V8_SHARED
 
@@ -1881,6 +2151,21 @@ bool Shell::SetOptions(int argc, char* argv[]) {
       return false;
 #endif  // V8_SHARED
       options.num_isolates++;
+    } else if (strncmp(argv[i], "--isolate-benchmark=", 20) == 0) {
+#ifdef V8_SHARED
+      printf("D8 with shared library does not support multi-threading\n");
+      return false;
+#else
+      options.isolate_benchmark = argv[i] + 20;
+      argv[i] = NULL;
+#endif  // V8_SHARED
+    } else if (strncmp(argv[i], "--isolate-benchmark-runs=", 25) == 0) {
+      options.isolate_benchmark_runs = atoi(argv[i] + 25);
+      if (options.isolate_benchmark_runs <= 0) {
+        printf("--isolate-benchmark-runs must be positive\n");
+        return false;
+      }
+      argv[i] = NULL;
     } else if (strcmp(argv[i], "--dump-heap-constants") == 0) {
 #ifdef V8_SHARED
       printf("D8 with shared library does not support constant dumping\n");
@@ -1899,6 +2184,13 @@ bool Shell::SetOptions(int argc, char* argv[]) {
     } else if (strcmp(argv[i], "--dump-counters") == 0) {
       printf("D8 with shared library does not include counters\n");
       return false;
+    } else if (strncmp(argv[i], "--persistent-cache=", 19) == 0) {
+      printf("D8 with shared library does not include a persistent cache\n");
+      return false;
+#else
+    } else if (strncmp(argv[i], "--persistent-cache=", 19) == 0) {
+      options.persistent_cache_file = argv[i] + 19;
+      argv[i] = NULL;
 #endif  // V8_SHARED
 #ifdef V8_USE_EXTERNAL_STARTUP_DATA
     } else if (strncmp(argv[i], "--natives_blob=", 15) == 0) {
@@ -1953,6 +2245,11 @@ bool Shell::SetOptions(int argc, char* argv[]) {
   }
   current->End(argc);
 
+  if (options.isolate_benchmark != NULL && !options.script_executed) {
+    printf("--isolate-benchmark needs scripts to run\n");
+    return false;
+  }
+
   if (!logfile_per_isolate && options.num_isolates) {
     SetFlagsFromString("--nologfile_per_isolate");
   }
@@ -2021,96 +2318,82 @@ void Shell::EmptyMessageQueues(Isolate* isolate) {
 
 
 #ifndef V8_SHARED
-bool Shell::SerializeValue(Isolate* isolate, Local<Value> value,
-                           const ObjectList& to_transfer,
-                           ObjectList* seen_objects,
-                           SerializationData* out_data) {
-  DCHECK(out_data);
-  Local<Context> context = isolate->GetCurrentContext();
+static void ThrowDataCloneError(Isolate* isolate, Local<Value> value) {
+  i::Isolate* i_isolate = reinterpret_cast<i::Isolate*>(isolate);
+  i_isolate->Throw(*i_isolate->factory()->NewError(
+      i::MessageTemplate::kDataCloneError, Utils::OpenHandle(*value)));
+}
 
-  if (value->IsUndefined()) {
-    out_data->WriteTag(kSerializationTagUndefined);
-  } else if (value->IsNull()) {
-    out_data->WriteTag(kSerializationTagNull);
-  } else if (value->IsTrue()) {
-    out_data->WriteTag(kSerializationTagTrue);
-  } else if (value->IsFalse()) {
-    out_data->WriteTag(kSerializationTagFalse);
-  } else if (value->IsNumber()) {
-    Local<Number> num = Local<Number>::Cast(value);
-    double value = num->Value();
-    out_data->WriteTag(kSerializationTagNumber);
-    out_data->Write(value);
-  } else if (value->IsString()) {
-    v8::String::Utf8Value str(value);
-    out_data->WriteTag(kSerializationTagString);
-    out_data->Write(str.length());
-    out_data->WriteMemory(*str, str.length());
-  } else if (value->IsArray()) {
-    Local<Array> array = Local<Array>::Cast(value);
-    if (FindInObjectList(array, *seen_objects)) {
-      Throw(isolate, "Duplicated arrays not supported");
-      return false;
+
+SerializationData* Shell::SerializeValue(Isolate* isolate,
+                                         Local<Value> value,
+                                         Local<Value> transfer) {
+  Local<Context> context = isolate->GetCurrentContext();
+  i::List<Local<ArrayBuffer>> array_buffers;
+  i::List<Local<SharedArrayBuffer>> shared_array_buffers;
+  if (!transfer->IsUndefined()) {
+    if (!transfer->IsArray()) {
+      Throw(isolate, "Transfer list must be an Array");
+      return NULL;
     }
-    seen_objects->Add(array);
-    out_data->WriteTag(kSerializationTagArray);
-    uint32_t length = array->Length();
-    out_data->Write(length);
+
+    Local<Array> transfer_array = Local<Array>::Cast(transfer);
+    uint32_t length = transfer_array->Length();
     for (uint32_t i = 0; i < length; ++i) {
-      Local<Value> element_value;
-      if (array->Get(context, i).ToLocal(&element_value)) {
-        if (!SerializeValue(isolate, element_value, to_transfer, seen_objects,
-                            out_data))
-          return false;
+      Local<Value> element;
+      if (!transfer_array->Get(context, i).ToLocal(&element)) return NULL;
+      if (element->IsArrayBuffer()) {
+        Local<ArrayBuffer> array_buffer = Local<ArrayBuffer>::Cast(element);
+        if (!array_buffer->IsNeuterable()) {
+          Throw(isolate, "Attempting to transfer an un-neuterable ArrayBuffer");
+          return NULL;
+        }
+        // A buffer can only be transferred once.
+        if (array_buffers.Contains(array_buffer)) {
+          ThrowDataCloneError(isolate, array_buffer);
+          return NULL;
+        }
+        array_buffers.Add(array_buffer);
+      } else if (element->IsSharedArrayBuffer()) {
+        Local<SharedArrayBuffer> sab = Local<SharedArrayBuffer>::Cast(element);
+        if (shared_array_buffers.Contains(sab)) {
+          ThrowDataCloneError(isolate, sab);
+          return NULL;
+        }
+        shared_array_buffers.Add(sab);
       } else {
-        Throw(isolate, "Failed to serialize array element.");
-        return false;
+        Throw(isolate,
+              "Transfer array elements must be an ArrayBuffer or "
+              "SharedArrayBuffer.");
+        return NULL;
       }
     }
-  } else if (value->IsArrayBuffer()) {
-    Local<ArrayBuffer> array_buffer = Local<ArrayBuffer>::Cast(value);
-    if (FindInObjectList(array_buffer, *seen_objects)) {
-      Throw(isolate, "Duplicated array buffers not supported");
-      return false;
-    }
-    seen_objects->Add(array_buffer);
-    if (FindInObjectList(array_buffer, to_transfer)) {
-      // Transfer ArrayBuffer
-      if (!array_buffer->IsNeuterable()) {
-        Throw(isolate, "Attempting to transfer an un-neuterable ArrayBuffer");
-        return false;
-      }
-
-      ArrayBuffer::Contents contents = array_buffer->IsExternal()
-                                           ? array_buffer->GetContents()
-                                           : array_buffer->Externalize();
-      array_buffer->Neuter();
-      out_data->WriteArrayBufferContents(contents);
-    } else {
-      ArrayBuffer::Contents contents = array_buffer->GetContents();
-      // Clone ArrayBuffer
-      if (contents.ByteLength() > i::kMaxInt) {
-        Throw(isolate, "ArrayBuffer is too big to clone");
-        return false;
-      }
+  }
 
-      int32_t byte_length = static_cast<int32_t>(contents.ByteLength());
-      out_data->WriteTag(kSerializationTagArrayBuffer);
-      out_data->Write(byte_length);
-      out_data->WriteMemory(contents.Data(), byte_length);
-    }
-  } else if (value->IsSharedArrayBuffer()) {
-    Local<SharedArrayBuffer> sab = Local<SharedArrayBuffer>::Cast(value);
-    if (FindInObjectList(sab, *seen_objects)) {
-      Throw(isolate, "Duplicated shared array buffers not supported");
-      return false;
-    }
-    seen_objects->Add(sab);
-    if (!FindInObjectList(sab, to_transfer)) {
-      Throw(isolate, "SharedArrayBuffer must be transferred");
-      return false;
-    }
+  ValueSerializer serializer(isolate);
+  for (int i = 0; i < array_buffers.length(); ++i) {
+    serializer.TransferArrayBuffer(i, array_buffers[i]);
+  }
+  for (int i = 0; i < shared_array_buffers.length(); ++i) {
+    serializer.TransferSharedArrayBuffer(array_buffers.length() + i,
+                                         shared_array_buffers[i]);
+  }
+  serializer.WriteHeader();
+  if (serializer.WriteValue(context, value).IsNothing()) return NULL;
 
+  // Only move the contents once the value has been written, so that a failed
+  // postMessage leaves the transferred buffers intact.
+  SerializationData* data = new SerializationData;
+  for (int i = 0; i < array_buffers.length(); ++i) {
+    Local<ArrayBuffer> array_buffer = array_buffers[i];
+    ArrayBuffer::Contents contents = array_buffer->IsExternal()
+                                         ? array_buffer->GetContents()
+                                         : array_buffer->Externalize();
+    array_buffer->Neuter();
+    data->AddArrayBufferContents(contents);
+  }
+  for (int i = 0; i < shared_array_buffers.length(); ++i) {
+    Local<SharedArrayBuffer> sab = shared_array_buffers[i];
     SharedArrayBuffer::Contents contents;
     if (sab->IsExternal()) {
       contents = sab->GetContents();
@@ -2119,136 +2402,42 @@ bool Shell::SerializeValue(Isolate* isolate, Local<Value> value,
       base::LockGuard<base::Mutex> lock_guard(workers_mutex_.Pointer());
       externalized_shared_contents_.Add(contents);
     }
-    out_data->WriteSharedArrayBufferContents(contents);
-  } else if (value->IsObject()) {
-    Local<Object> object = Local<Object>::Cast(value);
-    if (FindInObjectList(object, *seen_objects)) {
-      Throw(isolate, "Duplicated objects not supported");
-      return false;
-    }
-    seen_objects->Add(object);
-    Local<Array> property_names;
-    if (!object->GetOwnPropertyNames(context).ToLocal(&property_names)) {
-      Throw(isolate, "Unable to get property names");
-      return false;
-    }
-
-    uint32_t length = property_names->Length();
-    out_data->WriteTag(kSerializationTagObject);
-    out_data->Write(length);
-    for (uint32_t i = 0; i < length; ++i) {
-      Local<Value> name;
-      Local<Value> property_value;
-      if (property_names->Get(context, i).ToLocal(&name) &&
-          object->Get(context, name).ToLocal(&property_value)) {
-        if (!SerializeValue(isolate, name, to_transfer, seen_objects, out_data))
-          return false;
-        if (!SerializeValue(isolate, property_value, to_transfer, seen_objects,
-                            out_data))
-          return false;
-      } else {
-        Throw(isolate, "Failed to serialize property.");
-        return false;
-      }
-    }
-  } else {
-    Throw(isolate, "Don't know how to serialize object");
-    return false;
+    data->AddSharedArrayBufferContents(contents);
   }
-
-  return true;
+  size_t size;
+  uint8_t* buffer = serializer.ReleaseBuffer(&size);
+  data->SetData(buffer, size);
+  return data;
 }
 
 
 MaybeLocal<Value> Shell::DeserializeValue(Isolate* isolate,
-                                          const SerializationData& data,
-                                          int* offset) {
-  DCHECK(offset);
+                                          SerializationData* data) {
   EscapableHandleScope scope(isolate);
   // This function should not use utility_context_ because it is running on a
   // different thread.
+  Local<Context> context = isolate->GetCurrentContext();
+  ValueDeserializer deserializer(isolate, data->data(), data->size());
+  int array_buffer_count = data->array_buffer_count();
+  for (int i = 0; i < array_buffer_count; ++i) {
+    ArrayBuffer::Contents contents = data->ReleaseArrayBufferContents(i);
+    deserializer.TransferArrayBuffer(
+        i, ArrayBuffer::New(isolate, contents.Data(), contents.ByteLength(),
+                            ArrayBufferCreationMode::kInternalized));
+  }
+  for (int i = 0; i < data->shared_array_buffer_count(); ++i) {
+    const SharedArrayBuffer::Contents& contents =
+        data->shared_array_buffer_contents(i);
+    deserializer.TransferSharedArrayBuffer(
+        array_buffer_count + i,
+        SharedArrayBuffer::New(isolate, contents.Data(),
+                               contents.ByteLength()));
+  }
   Local<Value> result;
-  SerializationTag tag = data.ReadTag(offset);
-
-  switch (tag) {
-    case kSerializationTagUndefined:
-      result = Undefined(isolate);
-      break;
-    case kSerializationTagNull:
-      result = Null(isolate);
-      break;
-    case kSerializationTagTrue:
-      result = True(isolate);
-      break;
-    case kSerializationTagFalse:
-      result = False(isolate);
-      break;
-    case kSerializationTagNumber:
-      result = Number::New(isolate, data.Read<double>(offset));
-      break;
-    case kSerializationTagString: {
-      int length = data.Read<int>(offset);
-      CHECK(length >= 0);
-      std::vector<char> buffer(length + 1);  // + 1 so it is never empty.
-      data.ReadMemory(&buffer[0], length, offset);
-      MaybeLocal<String> str =
-          String::NewFromUtf8(isolate, &buffer[0], NewStringType::kNormal,
-                              length).ToLocalChecked();
-      if (!str.IsEmpty()) result = str.ToLocalChecked();
-      break;
-    }
-    case kSerializationTagArray: {
-      uint32_t length = data.Read<uint32_t>(offset);
-      Local<Array> array = Array::New(isolate, length);
-      for (uint32_t i = 0; i < length; ++i) {
-        Local<Value> element_value;
-        CHECK(DeserializeValue(isolate, data, offset).ToLocal(&element_value));
-        array->Set(isolate->GetCurrentContext(), i, element_value).FromJust();
-      }
-      result = array;
-      break;
-    }
-    case kSerializationTagObject: {
-      int length = data.Read<int>(offset);
-      Local<Object> object = Object::New(isolate);
-      for (int i = 0; i < length; ++i) {
-        Local<Value> property_name;
-        CHECK(DeserializeValue(isolate, data, offset).ToLocal(&property_name));
-        Local<Value> property_value;
-        CHECK(DeserializeValue(isolate, data, offset).ToLocal(&property_value));
-        object->Set(isolate->GetCurrentContext(), property_name, property_value)
-            .FromJust();
-      }
-      result = object;
-      break;
-    }
-    case kSerializationTagArrayBuffer: {
-      int32_t byte_length = data.Read<int32_t>(offset);
-      Local<ArrayBuffer> array_buffer = ArrayBuffer::New(isolate, byte_length);
-      ArrayBuffer::Contents contents = array_buffer->GetContents();
-      DCHECK(static_cast<size_t>(byte_length) == contents.ByteLength());
-      data.ReadMemory(contents.Data(), byte_length, offset);
-      result = array_buffer;
-      break;
-    }
-    case kSerializationTagTransferredArrayBuffer: {
-      ArrayBuffer::Contents contents;
-      data.ReadArrayBufferContents(&contents, offset);
-      result = ArrayBuffer::New(isolate, contents.Data(), contents.ByteLength(),
-                                ArrayBufferCreationMode::kInternalized);
-      break;
-    }
-    case kSerializationTagTransferredSharedArrayBuffer: {
-      SharedArrayBuffer::Contents contents;
-      data.ReadSharedArrayBufferContents(&contents, offset);
-      result = SharedArrayBuffer::New(isolate, contents.Data(),
-                                      contents.ByteLength());
-      break;
-    }
-    default:
-      UNREACHABLE();
+  if (deserializer.ReadHeader(context).IsNothing() ||
+      !deserializer.ReadValue(context).ToLocal(&result)) {
+    return MaybeLocal<Value>();
   }
-
   return scope.Escape(result);
 }
 
@@ -2359,7 +2548,19 @@ int Shell::Main(int argc, char* argv[]) {
   if (!SetOptions(argc, argv)) return 1;
   v8::V8::InitializeICU(options.icu_data_file);
   g_platform = v8::platform::CreateDefaultPlatform();
+#ifndef V8_SHARED
+  // Isolates post their tasks through the timing platform, while d8 keeps
+  // pumping the message loops of the default platform directly.
+  base::SmartPointer<TaskQueueTimingPlatform> timing_platform;
+  if (options.isolate_benchmark != NULL) {
+    timing_platform.Reset(new TaskQueueTimingPlatform(g_platform));
+  }
+  v8::V8::InitializePlatform(timing_platform.is_empty()
+                                 ? g_platform
+                                 : timing_platform.get());
+#else
   v8::V8::InitializePlatform(g_platform);
+#endif  // !V8_SHARED
   v8::V8::Initialize();
   if (options.natives_blob || options.snapshot_blob) {
     v8::V8::InitializeExternalStartupData(options.natives_blob,
@@ -2399,6 +2600,13 @@ int Shell::Main(int argc, char* argv[]) {
     create_params.create_histogram_callback = CreateHistogram;
     create_params.add_histogram_sample_callback = AddHistogramSample;
   }
+
+  base::SmartPointer<PersistentCacheFile> persistent_cache;
+  if (options.persistent_cache_file != NULL) {
+    persistent_cache.Reset(
+        new PersistentCacheFile(options.persistent_cache_file));
+    create_params.persistent_compilation_cache = persistent_cache.get();
+  }
 #endif
   Isolate* isolate = Isolate::New(create_params);
   {
@@ -2428,6 +2636,14 @@ int Shell::Main(int argc, char* argv[]) {
       printf("======== Full Deoptimization =======\n");
       Testing::DeoptimizeAll();
 #if !defined(V8_SHARED)
+    } else if (options.isolate_benchmark != NULL) {
+      IsolateBenchmark benchmark(&options.isolate_sources[0],
+                                 timing_platform.get(),
+                                 options.isolate_benchmark_runs);
+      if (!benchmark.Run(options.isolate_benchmark)) {
+        printf("Invalid isolate counts '%s'\n", options.isolate_benchmark);
+        result = 1;
+      }
     } else if (i::FLAG_stress_runs > 0) {
       options.stress_runs = i::FLAG_stress_runs;
       for (int i = 0; i < options.stress_runs && result == 0; i++) {
@@ -6,7 +6,9 @@
 #define V8_D8_H_
 
 #ifndef V8_SHARED
+#include "include/v8-platform.h"
 #include "src/allocation.h"
+#include "src/atomic-utils.h"
 #include "src/base/platform/time.h"
 #include "src/hashmap.h"
 #include "src/list.h"
@@ -152,53 +154,38 @@ class SourceGroup {
 };
 
 #ifndef V8_SHARED
-enum SerializationTag {
-  kSerializationTagUndefined,
-  kSerializationTagNull,
-  kSerializationTagTrue,
-  kSerializationTagFalse,
-  kSerializationTagNumber,
-  kSerializationTagString,
-  kSerializationTagArray,
-  kSerializationTagObject,
-  kSerializationTagArrayBuffer,
-  kSerializationTagTransferredArrayBuffer,
-  kSerializationTagTransferredSharedArrayBuffer,
-};
-
-
+// A message passed between workers, written with v8::ValueSerializer. The
+// contents of transferred ArrayBuffers and SharedArrayBuffers travel next to
+// the data; ArrayBuffers get transfer ids 0..n-1 and SharedArrayBuffers the
+// ids following them.
 class SerializationData {
  public:
-  SerializationData() {}
+  SerializationData() : data_(NULL), size_(0) {}
   ~SerializationData();
 
-  void WriteTag(SerializationTag tag);
-  void WriteMemory(const void* p, int length);
-  void WriteArrayBufferContents(const ArrayBuffer::Contents& contents);
-  void WriteSharedArrayBufferContents(
+  void SetData(uint8_t* data, size_t size);
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  void AddArrayBufferContents(const ArrayBuffer::Contents& contents);
+  void AddSharedArrayBufferContents(
       const SharedArrayBuffer::Contents& contents);
 
-  template <typename T>
-  void Write(const T& data) {
-    WriteMemory(&data, sizeof(data));
+  int array_buffer_count() const { return array_buffer_contents_.length(); }
+  int shared_array_buffer_count() const {
+    return shared_array_buffer_contents_.length();
   }
 
-  SerializationTag ReadTag(int* offset) const;
-  void ReadMemory(void* p, int length, int* offset) const;
-  void ReadArrayBufferContents(ArrayBuffer::Contents* contents,
-                               int* offset) const;
-  void ReadSharedArrayBufferContents(SharedArrayBuffer::Contents* contents,
-                                     int* offset) const;
-
-  template <typename T>
-  T Read(int* offset) const {
-    T value;
-    ReadMemory(&value, sizeof(value), offset);
-    return value;
+  // Ownership of the ArrayBuffer::Contents is passed to the caller.
+  ArrayBuffer::Contents ReleaseArrayBufferContents(int index);
+  const SharedArrayBuffer::Contents& shared_array_buffer_contents(
+      int index) const {
+    return shared_array_buffer_contents_[index];
   }
 
  private:
-  i::List<uint8_t> data_;
+  uint8_t* data_;
+  size_t size_;
   i::List<ArrayBuffer::Contents> array_buffer_contents_;
   i::List<SharedArrayBuffer::Contents> shared_array_buffer_contents_;
 };
@@ -267,6 +254,99 @@ class Worker {
   char* script_;
   base::Atomic32 running_;
 };
+
+
+// Forwards to another platform and records how long posting a task takes,
+// which includes waiting for the lock of the platform's task queue.
+class TaskQueueTimingPlatform : public v8::Platform {
+ public:
+  explicit TaskQueueTimingPlatform(v8::Platform* platform)
+      : platform_(platform) {}
+
+  void CallOnBackgroundThread(Task* task,
+                              ExpectedRuntime expected_runtime) override;
+  void CallOnForegroundThread(Isolate* isolate, Task* task) override;
+  void CallDelayedOnForegroundThread(Isolate* isolate, Task* task,
+                                     double delay_in_seconds) override;
+  void CallIdleOnForegroundThread(Isolate* isolate, IdleTask* task) override;
+  bool IdleTasksEnabled(Isolate* isolate) override;
+  double MonotonicallyIncreasingTime() override;
+
+  void ResetStats();
+  int post_count();
+  base::TimeDelta post_time();
+  base::TimeDelta max_post_time();
+
+ private:
+  void RecordPost(base::TimeTicks start);
+
+  v8::Platform* platform_;
+  // Tasks are posted from many threads, so the stats are kept without a lock.
+  // Times are in microseconds.
+  i::AtomicNumber<int> post_count_;
+  i::AtomicNumber<intptr_t> post_time_;
+  i::AtomicValue<intptr_t> max_post_time_;
+};
+
+
+// Runs a source group on several isolates at once, each on its own thread,
+// and reports how throughput, GC time and the time it takes to set up an
+// isolate scale with the number of isolates in the process.
+class IsolateBenchmark {
+ public:
+  IsolateBenchmark(SourceGroup* group, TaskQueueTimingPlatform* platform,
+                   int runs)
+      : group_(group),
+        platform_(platform),
+        runs_(runs),
+        ready_semaphore_(0),
+        start_semaphore_(0) {}
+
+  // Runs the source group |runs| times on each isolate, once for every
+  // isolate count in |isolate_counts|, a comma separated list. Returns false
+  // if the list is malformed.
+  bool Run(const char* isolate_counts);
+
+ private:
+  struct IsolateStats {
+    IsolateStats() : runs(0), gc_count(0) {}
+
+    int runs;
+    int gc_count;
+    base::TimeDelta setup_time;
+    base::TimeDelta run_time;
+    base::TimeDelta gc_time;
+    base::TimeTicks gc_start;
+    base::TimeTicks run_end;
+  };
+
+  class BenchmarkThread : public base::Thread {
+   public:
+    BenchmarkThread(IsolateBenchmark* benchmark, IsolateStats* stats)
+        : base::Thread(base::Thread::Options("IsolateBenchmark", 2 * i::MB)),
+          benchmark_(benchmark),
+          stats_(stats) {}
+
+    virtual void Run() { benchmark_->RunIsolate(stats_); }
+
+   private:
+    IsolateBenchmark* benchmark_;
+    IsolateStats* stats_;
+  };
+
+  // Returns the aggregate number of runs per second.
+  double RunIsolates(int count);
+  void RunIsolate(IsolateStats* stats);
+
+  static void GCPrologue(Isolate* isolate, GCType type, GCCallbackFlags flags);
+  static void GCEpilogue(Isolate* isolate, GCType type, GCCallbackFlags flags);
+
+  SourceGroup* group_;
+  TaskQueueTimingPlatform* platform_;
+  int runs_;
+  base::Semaphore ready_semaphore_;
+  base::Semaphore start_semaphore_;
+};
 #endif  // !V8_SHARED
 
 
@@ -286,11 +366,14 @@ class ShellOptions {
         expected_to_throw(false),
         mock_arraybuffer_allocator(false),
         num_isolates(1),
+        isolate_benchmark(NULL),
+        isolate_benchmark_runs(5),
         compile_options(v8::ScriptCompiler::kNoCompileOptions),
         isolate_sources(NULL),
         icu_data_file(NULL),
         natives_blob(NULL),
-        snapshot_blob(NULL) {}
+        snapshot_blob(NULL),
+        persistent_cache_file(NULL) {}
 
   ~ShellOptions() {
     delete[] isolate_sources;
@@ -313,11 +396,14 @@ class ShellOptions {
   bool expected_to_throw;
   bool mock_arraybuffer_allocator;
   int num_isolates;
+  const char* isolate_benchmark;
+  int isolate_benchmark_runs;
   v8::ScriptCompiler::CompileOptions compile_options;
   SourceGroup* isolate_sources;
   const char* icu_data_file;
   const char* natives_blob;
   const char* snapshot_blob;
+  const char* persistent_cache_file;
 };
 
 #ifdef V8_SHARED
@@ -349,16 +435,14 @@ class Shell : public i::AllStatic {
   static void EmptyMessageQueues(Isolate* isolate);
 
 #ifndef V8_SHARED
-  // TODO(binji): stupid implementation for now. Is there an easy way to hash an
-  // object for use in i::HashMap? By pointer?
-  typedef i::List<Local<Object>> ObjectList;
-  static bool SerializeValue(Isolate* isolate, Local<Value> value,
-                             const ObjectList& to_transfer,
-                             ObjectList* seen_objects,
-                             SerializationData* out_data);
+  // Returns NULL, with an exception scheduled, if |value| can't be
+  // serialized. |transfer| is undefined or an Array of ArrayBuffers and
+  // SharedArrayBuffers.
+  static SerializationData* SerializeValue(Isolate* isolate,
+                                           Local<Value> value,
+                                           Local<Value> transfer);
   static MaybeLocal<Value> DeserializeValue(Isolate* isolate,
-                                            const SerializationData& data,
-                                            int* offset);
+                                            SerializationData* data);
   static void CleanupWorkers();
   static int* LookupCounter(const char* name);
   static void* CreateHistogram(const char* name,
@@ -282,6 +282,18 @@ MaybeHandle<String> Factory::NewStringFromUtf8(Vector<const char> string,
                  length - non_ascii_start);
   int utf16_length = static_cast<int>(decoder->Utf16Length());
   DCHECK(utf16_length > 0);
+  if (decoder->IsOneByte()) {
+    // Latin-1 only, so the result fits in a one-byte string.
+    Handle<SeqOneByteString> result;
+    ASSIGN_RETURN_ON_EXCEPTION(
+        isolate(), result,
+        NewRawOneByteString(non_ascii_start + utf16_length, pretenure),
+        String);
+    uint8_t* data = result->GetChars();
+    CopyChars(data, reinterpret_cast<const uint8_t*>(start), non_ascii_start);
+    decoder->WriteOneByte(data + non_ascii_start, utf16_length);
+    return result;
+  }
   // Allocate string.
   Handle<SeqTwoByteString> result;
   ASSIGN_RETURN_ON_EXCEPTION(
@@ -2369,7 +2381,8 @@ void Factory::SetRegExpIrregexpData(Handle<JSRegExp> regexp,
                                     JSRegExp::Type type,
                                     Handle<String> source,
                                     JSRegExp::Flags flags,
-                                    int capture_count) {
+                                    int capture_count,
+                                    Handle<Object> required_literal) {
   Handle<FixedArray> store = NewFixedArray(JSRegExp::kIrregexpDataSize);
   Smi* uninitialized = Smi::FromInt(JSRegExp::kUninitializedValue);
   store->set(JSRegExp::kTagIndex, Smi::FromInt(type));
@@ -2382,6 +2395,7 @@ void Factory::SetRegExpIrregexpData(Handle<JSRegExp> regexp,
   store->set(JSRegExp::kIrregexpMaxRegisterCountIndex, Smi::FromInt(0));
   store->set(JSRegExp::kIrregexpCaptureCountIndex,
              Smi::FromInt(capture_count));
+  store->set(JSRegExp::kIrregexpRequiredLiteralIndex, *required_literal);
   regexp->set_data(*store);
 }
 
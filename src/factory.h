@@ -661,7 +661,8 @@ class Factory final {
                              JSRegExp::Type type,
                              Handle<String> source,
                              JSRegExp::Flags flags,
-                             int capture_count);
+                             int capture_count,
+                             Handle<Object> required_literal);
 
   // Returns the value for a known global constant (a property of the global
   // object which is neither configurable nor writable) like 'undefined'.
@@ -254,6 +254,9 @@ DEFINE_BOOL(compiled_keyed_generic_loads, false,
             "use optimizing compiler to generate keyed generic load stubs")
 DEFINE_BOOL(allocation_site_pretenuring, true,
             "pretenure with allocation sites")
+DEFINE_BOOL(adaptive_pretenuring, true,
+            "adapt pretenuring thresholds to the survival rate of the young "
+            "generation")
 DEFINE_BOOL(trace_pretenuring, false,
             "trace pretenuring decisions of HAllocate instructions")
 DEFINE_BOOL(trace_pretenuring_statistics, false,
@@ -289,6 +292,14 @@ DEFINE_BOOL(print_bytecode, false,
             "print bytecode generated by ignition interpreter")
 DEFINE_BOOL(trace_ignition_codegen, false,
             "trace the codegen of ignition interpreter bytecode handlers")
+DEFINE_BOOL(ignition_fuse_bytecodes, true,
+            "fuse frequent bytecode sequences into superinstructions")
+DEFINE_BOOL(trace_ignition_dispatches, false,
+            "count the dispatches between pairs of bytecodes and print the "
+            "histogram on isolate teardown")
+DEFINE_BOOL(ignition_tier_up, false,
+            "optimize hot interpreted functions with TurboFan from bytecode")
+DEFINE_IMPLICATION(ignition_tier_up, ignition)
 
 // Flags for Crankshaft.
 DEFINE_BOOL(crankshaft, true, "use crankshaft")
@@ -656,6 +667,10 @@ DEFINE_BOOL(age_code, true,
             "track un-executed functions to age code and flush only "
             "old code (required for code flushing)")
 DEFINE_BOOL(incremental_marking, true, "use incremental marking")
+DEFINE_BOOL(concurrent_marking, false,
+            "mark immutable old space objects on a background thread during "
+            "incremental marking")
+DEFINE_BOOL(trace_concurrent_marking, false, "trace concurrent marking")
 DEFINE_BOOL(overapproximate_weak_closure, true,
             "overapproximate weak closer to reduce atomic pause time")
 DEFINE_INT(min_progress_during_object_groups_marking, 128,
@@ -664,7 +679,20 @@ DEFINE_INT(min_progress_during_object_groups_marking, 128,
 DEFINE_INT(max_object_groups_marking_rounds, 3,
            "at most try this many times to over approximate the weak closure")
 DEFINE_BOOL(concurrent_sweeping, true, "use concurrent sweeping")
-DEFINE_BOOL(parallel_compaction, false, "use parallel compaction")
+DEFINE_BOOL(concurrent_array_buffer_freeing, true,
+            "free dead ArrayBuffer backing stores on a background thread")
+DEFINE_BOOL(parallel_compaction, true,
+            "evacuate pages and update pointers in parallel")
+DEFINE_INT(parallel_compaction_tasks, 0,
+           "number of parallel compaction tasks (0 = based on number of cores)")
+DEFINE_BOOL(parallel_global_handles, true,
+            "visit global handles in parallel during mark-compact")
+DEFINE_BOOL(parallel_scavenge, false,
+            "process roots and old-to-new pointers in parallel when scavenging")
+DEFINE_INT(parallel_scavenge_tasks, 0,
+           "number of parallel scavenge tasks (0 = based on number of cores)")
+DEFINE_BOOL(trace_parallel_scavenge, false,
+            "trace the duration of parallel scavenge tasks")
 DEFINE_BOOL(trace_incremental_marking, false,
             "trace progress of the incremental marking")
 DEFINE_BOOL(track_gc_object_stats, false,
@@ -786,6 +814,8 @@ DEFINE_BOOL(serialization_statistics, false,
 
 // Regexp
 DEFINE_BOOL(regexp_optimization, true, "generate optimized regexp code")
+DEFINE_BOOL(regexp_required_literal, true,
+            "skip subjects missing a literal required by the regexp")
 
 // Testing flags test/cctest/test-{flags,api,serialization}.cc
 DEFINE_BOOL(testing_bool_flag, true, "testing_bool_flag")
@@ -816,7 +846,11 @@ DEFINE_BOOL(predictable, false, "enable predictable mode")
 DEFINE_NEG_IMPLICATION(predictable, concurrent_recompilation)
 DEFINE_NEG_IMPLICATION(predictable, concurrent_osr)
 DEFINE_NEG_IMPLICATION(predictable, concurrent_sweeping)
+DEFINE_NEG_IMPLICATION(predictable, concurrent_array_buffer_freeing)
 DEFINE_NEG_IMPLICATION(predictable, parallel_compaction)
+DEFINE_NEG_IMPLICATION(predictable, parallel_global_handles)
+DEFINE_NEG_IMPLICATION(predictable, parallel_scavenge)
+DEFINE_NEG_IMPLICATION(predictable, concurrent_marking)
 
 // mark-compact.cc
 DEFINE_BOOL(force_marking_deque_overflows, false,
@@ -12,29 +12,31 @@
 #include "src/handles-inl.h"
 #include "src/isolate.h"
 #include "src/list-inl.h"
+#include "src/utils.h"
 
 namespace v8 {
 namespace internal {
 
-base::LazyMutex FutexEmulation::mutex_ = LAZY_MUTEX_INITIALIZER;
-base::LazyInstance<FutexWaitList>::type FutexEmulation::wait_list_ =
+base::LazyInstance<FutexWaitTable>::type FutexEmulation::wait_table_ =
     LAZY_INSTANCE_INITIALIZER;
 
 
 void FutexWaitListNode::NotifyWake() {
-  // Lock the FutexEmulation mutex before notifying. We know that the mutex
-  // will have been unlocked if we are currently waiting on the condition
-  // variable.
+  // Lock the mutex of the list this node is queued in before notifying. We
+  // know that the mutex will have been unlocked if we are currently waiting
+  // on the condition variable.
   //
   // The mutex may also not be locked if the other thread is currently handling
   // interrupts, or if FutexEmulation::Wait was just called and the mutex
   // hasn't been locked yet. In either of those cases, we set the interrupted
   // flag to true, which will be tested after the mutex is re-locked.
-  base::LockGuard<base::Mutex> lock_guard(FutexEmulation::mutex_.Pointer());
+  FutexWaitList* wait_list = FutexEmulation::LockWaitListOf(this);
+  if (wait_list == nullptr) return;
   if (waiting_) {
     cond_.NotifyOne();
     interrupted_ = true;
   }
+  wait_list->mutex_.Unlock();
 }
 
 
@@ -52,10 +54,12 @@ void FutexWaitList::AddNode(FutexWaitListNode* node) {
   node->prev_ = tail_;
   node->next_ = nullptr;
   tail_ = node;
+  node->wait_list_.SetValue(this);
 }
 
 
 void FutexWaitList::RemoveNode(FutexWaitListNode* node) {
+  DCHECK(node->wait_list_.Value() == this);
   if (node->prev_) {
     node->prev_->next_ = node->next_;
   } else {
@@ -69,6 +73,43 @@ void FutexWaitList::RemoveNode(FutexWaitListNode* node) {
   }
 
   node->prev_ = node->next_ = nullptr;
+  node->wait_list_.SetValue(nullptr);
+}
+
+
+FutexWaitList* FutexWaitTable::ListFor(void* backing_store, size_t addr) {
+  uintptr_t location = reinterpret_cast<uintptr_t>(backing_store) + addr;
+  // Waiting is only possible on int32 elements, so the low bits carry no
+  // information.
+  uint32_t hash = ComputeLongHash(static_cast<uint64_t>(location >> 2));
+  return &lists_[hash & (kNumLists - 1)];
+}
+
+
+FutexWaitList* FutexEmulation::LockWaitListOf(FutexWaitListNode* node) {
+  while (true) {
+    FutexWaitList* wait_list = node->wait_list_.Value();
+    if (wait_list == nullptr) return nullptr;
+    wait_list->mutex_.Lock();
+    if (node->wait_list_.Value() == wait_list) return wait_list;
+    // The node was requeued before we got the lock.
+    wait_list->mutex_.Unlock();
+  }
+}
+
+
+FutexWaitList* FutexEmulation::RelockIfRequeued(FutexWaitListNode* node,
+                                                FutexWaitList* locked_list) {
+  // The list of a node can only change while its current list is locked, so
+  // the value is stable once it matches the list we hold.
+  while (true) {
+    FutexWaitList* wait_list = node->wait_list_.Value();
+    DCHECK_NOT_NULL(wait_list);
+    if (wait_list == locked_list) return locked_list;
+    locked_list->mutex_.Unlock();
+    wait_list->mutex_.Lock();
+    locked_list = wait_list;
+  }
 }
 
 
@@ -81,9 +122,12 @@ Object* FutexEmulation::Wait(Isolate* isolate,
   int32_t* p =
       reinterpret_cast<int32_t*>(static_cast<int8_t*>(backing_store) + addr);
 
-  base::LockGuard<base::Mutex> lock_guard(mutex_.Pointer());
+  FutexWaitList* wait_list =
+      wait_table_.Pointer()->ListFor(backing_store, addr);
+  wait_list->mutex_.Lock();
 
   if (*p != value) {
+    wait_list->mutex_.Unlock();
     return Smi::FromInt(Result::kNotEqual);
   }
 
@@ -116,7 +160,7 @@ Object* FutexEmulation::Wait(Isolate* isolate,
   base::TimeTicks timeout_time = start_time + rel_timeout;
   base::TimeTicks current_time = start_time;
 
-  wait_list_.Pointer()->AddNode(node);
+  wait_list->AddNode(node);
 
   Object* result;
 
@@ -125,34 +169,37 @@ Object* FutexEmulation::Wait(Isolate* isolate,
     node->interrupted_ = false;
 
     // Unlock the mutex here to prevent deadlock from lock ordering between
-    // mutex_ and mutexes locked by HandleInterrupts.
-    mutex_.Pointer()->Unlock();
+    // the wait list mutex and mutexes locked by HandleInterrupts.
+    wait_list->mutex_.Unlock();
 
     // Because the mutex is unlocked, we have to be careful about not dropping
     // an interrupt. The notification can happen in three different places:
     // 1) Before Wait is called: the notification will be dropped, but
     //    interrupted_ will be set to 1. This will be checked below.
-    // 2) After interrupted has been checked here, but before mutex_ is
-    //    acquired: interrupted is checked again below, with mutex_ locked.
-    //    Because the wakeup signal also acquires mutex_, we know it will not
-    //    be able to notify until mutex_ is released below, when waiting on the
-    //    condition variable.
+    // 2) After interrupted has been checked here, but before the mutex is
+    //    acquired: interrupted is checked again below, with the mutex locked.
+    //    Because the wakeup signal also acquires the mutex, we know it will
+    //    not be able to notify until the mutex is released below, when
+    //    waiting on the condition variable.
     // 3) After the mutex is released in the call to WaitFor(): this
     // notification will wake up the condition variable. node->waiting() will
     // be false, so we'll loop and then check interrupts.
+    //
+    // While the mutex is unlocked the node may also be requeued to the list
+    // of another address, so the list is looked up again when locking.
     if (interrupted) {
       Object* interrupt_object = isolate->stack_guard()->HandleInterrupts();
       if (interrupt_object->IsException()) {
         result = interrupt_object;
-        mutex_.Pointer()->Lock();
+        wait_list = LockWaitListOf(node);
         break;
       }
     }
 
-    mutex_.Pointer()->Lock();
+    wait_list = LockWaitListOf(node);
 
     if (node->interrupted_) {
-      // An interrupt occured while the mutex_ was unlocked. Don't wait yet.
+      // An interrupt occured while the mutex was unlocked. Don't wait yet.
       continue;
     }
 
@@ -172,17 +219,19 @@ Object* FutexEmulation::Wait(Isolate* isolate,
       base::TimeDelta time_until_timeout = timeout_time - current_time;
       DCHECK(time_until_timeout.InMicroseconds() >= 0);
       bool wait_for_result =
-          node->cond_.WaitFor(mutex_.Pointer(), time_until_timeout);
+          node->cond_.WaitFor(&wait_list->mutex_, time_until_timeout);
       USE(wait_for_result);
     } else {
-      node->cond_.Wait(mutex_.Pointer());
+      node->cond_.Wait(&wait_list->mutex_);
     }
 
-    // Spurious wakeup, interrupt or timeout.
+    // Spurious wakeup, interrupt, timeout or requeue.
+    wait_list = RelockIfRequeued(node, wait_list);
   }
 
-  wait_list_.Pointer()->RemoveNode(node);
+  wait_list->RemoveNode(node);
   node->waiting_ = false;
+  wait_list->mutex_.Unlock();
 
   return result;
 }
@@ -196,10 +245,13 @@ Object* FutexEmulation::Wake(Isolate* isolate,
   int waiters_woken = 0;
   void* backing_store = array_buffer->backing_store();
 
-  base::LockGuard<base::Mutex> lock_guard(mutex_.Pointer());
-  FutexWaitListNode* node = wait_list_.Pointer()->head_;
+  FutexWaitList* wait_list =
+      wait_table_.Pointer()->ListFor(backing_store, addr);
+  base::LockGuard<base::Mutex> lock_guard(&wait_list->mutex_);
+  FutexWaitListNode* node = wait_list->head_;
   while (node && num_waiters_to_wake > 0) {
-    if (backing_store == node->backing_store_ && addr == node->wait_addr_) {
+    if (backing_store == node->backing_store_ && addr == node->wait_addr_ &&
+        node->waiting_) {
       node->waiting_ = false;
       node->cond_.NotifyOne();
       --num_waiters_to_wake;
@@ -224,30 +276,51 @@ Object* FutexEmulation::WakeOrRequeue(Isolate* isolate,
   int32_t* p =
       reinterpret_cast<int32_t*>(static_cast<int8_t*>(backing_store) + addr);
 
-  base::LockGuard<base::Mutex> lock_guard(mutex_.Pointer());
-  if (*p != value) {
-    return Smi::FromInt(Result::kNotEqual);
-  }
+  FutexWaitTable* wait_table = wait_table_.Pointer();
+  FutexWaitList* wait_list = wait_table->ListFor(backing_store, addr);
+  FutexWaitList* requeue_list = wait_table->ListFor(backing_store, addr2);
 
-  // Wake |num_waiters_to_wake|
-  int waiters_woken = 0;
-  FutexWaitListNode* node = wait_list_.Pointer()->head_;
-  while (node) {
-    if (backing_store == node->backing_store_ && addr == node->wait_addr_) {
-      if (num_waiters_to_wake > 0) {
-        node->waiting_ = false;
-        node->cond_.NotifyOne();
-        --num_waiters_to_wake;
-        waiters_woken++;
-      } else {
-        node->wait_addr_ = addr2;
+  // Lock both lists in a fixed order so that two concurrent requeues in
+  // opposite directions cannot deadlock.
+  FutexWaitList* first = Min(wait_list, requeue_list);
+  FutexWaitList* second = Max(wait_list, requeue_list);
+  first->mutex_.Lock();
+  if (second != first) second->mutex_.Lock();
+
+  Object* result;
+  if (*p != value) {
+    result = Smi::FromInt(Result::kNotEqual);
+  } else {
+    // Wake |num_waiters_to_wake|
+    int waiters_woken = 0;
+    FutexWaitListNode* node = wait_list->head_;
+    while (node) {
+      FutexWaitListNode* next = node->next_;
+      if (backing_store == node->backing_store_ && addr == node->wait_addr_ &&
+          node->waiting_) {
+        if (num_waiters_to_wake > 0) {
+          node->waiting_ = false;
+          node->cond_.NotifyOne();
+          --num_waiters_to_wake;
+          waiters_woken++;
+        } else {
+          node->wait_addr_ = addr2;
+          if (requeue_list != wait_list) {
+            // The waiter notices the move when it next locks its list.
+            wait_list->RemoveNode(node);
+            requeue_list->AddNode(node);
+          }
+        }
       }
-    }
 
-    node = node->next_;
+      node = next;
+    }
+    result = Smi::FromInt(waiters_woken);
   }
 
-  return Smi::FromInt(waiters_woken);
+  if (second != first) second->mutex_.Unlock();
+  first->mutex_.Unlock();
+  return result;
 }
 
 
@@ -257,12 +330,15 @@ Object* FutexEmulation::NumWaitersForTesting(Isolate* isolate,
   DCHECK(addr < NumberToSize(isolate, array_buffer->byte_length()));
   void* backing_store = array_buffer->backing_store();
 
-  base::LockGuard<base::Mutex> lock_guard(mutex_.Pointer());
+  FutexWaitList* wait_list =
+      wait_table_.Pointer()->ListFor(backing_store, addr);
+  base::LockGuard<base::Mutex> lock_guard(&wait_list->mutex_);
 
   int waiters = 0;
-  FutexWaitListNode* node = wait_list_.Pointer()->head_;
+  FutexWaitListNode* node = wait_list->head_;
   while (node) {
-    if (backing_store == node->backing_store_ && addr == node->wait_addr_) {
+    if (backing_store == node->backing_store_ && addr == node->wait_addr_ &&
+        node->waiting_) {
       waiters++;
     }
 
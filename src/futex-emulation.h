@@ -8,6 +8,7 @@
 #include <stdint.h>
 
 #include "src/allocation.h"
+#include "src/atomic-utils.h"
 #include "src/base/atomicops.h"
 #include "src/base/lazy-instance.h"
 #include "src/base/macros.h"
@@ -34,6 +35,9 @@ namespace internal {
 class Isolate;
 class JSArrayBuffer;
 
+class FutexWaitList;
+
+
 class FutexWaitListNode {
  public:
   FutexWaitListNode()
@@ -53,6 +57,10 @@ class FutexWaitListNode {
   base::ConditionVariable cond_;
   FutexWaitListNode* prev_;
   FutexWaitListNode* next_;
+  // The list this node is queued in, or nullptr if the node is not waiting.
+  // Only changed while holding the mutex of that list, and also the mutex of
+  // the new list when a waiter is requeued.
+  AtomicValue<FutexWaitList*> wait_list_;
   void* backing_store_;
   size_t wait_addr_;
   bool waiting_;
@@ -62,6 +70,8 @@ class FutexWaitListNode {
 };
 
 
+// The waiters of all addresses that hash to the same bucket of the
+// FutexEmulation wait table, together with the mutex guarding them.
 class FutexWaitList {
  public:
   FutexWaitList();
@@ -71,7 +81,9 @@ class FutexWaitList {
 
  private:
   friend class FutexEmulation;
+  friend class FutexWaitListNode;
 
+  base::Mutex mutex_;
   FutexWaitListNode* head_;
   FutexWaitListNode* tail_;
 
@@ -79,6 +91,24 @@ class FutexWaitList {
 };
 
 
+// Waiters are sharded by the address they wait on, so that waiting and waking
+// on different addresses neither contend for a lock nor have to look at each
+// other's waiters.
+class FutexWaitTable {
+ public:
+  static const int kNumLists = 128;
+
+  FutexWaitTable() {}
+
+  FutexWaitList* ListFor(void* backing_store, size_t addr);
+
+ private:
+  FutexWaitList lists_[kNumLists];
+
+  DISALLOW_COPY_AND_ASSIGN(FutexWaitTable);
+};
+
+
 class FutexEmulation : public AllStatic {
  public:
   // These must match the values in src/harmony-atomics.js
@@ -122,8 +152,17 @@ class FutexEmulation : public AllStatic {
  private:
   friend class FutexWaitListNode;
 
-  static base::LazyMutex mutex_;
-  static base::LazyInstance<FutexWaitList>::type wait_list_;
+  // Locks the list |node| is queued in and returns it, or returns nullptr if
+  // the node is not queued.
+  static FutexWaitList* LockWaitListOf(FutexWaitListNode* node);
+
+  // Called with |locked_list| locked after waking up from a condition
+  // variable. If |node| has been requeued to another list in the meantime,
+  // switches the lock over to that list. Returns the locked list.
+  static FutexWaitList* RelockIfRequeued(FutexWaitListNode* node,
+                                         FutexWaitList* locked_list);
+
+  static base::LazyInstance<FutexWaitTable>::type wait_table_;
 };
 }  // namespace internal
 }  // namespace v8
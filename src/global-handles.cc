@@ -5,6 +5,8 @@
 #include "src/global-handles.h"
 
 #include "src/api.h"
+#include "src/base/sys-info.h"
+#include "src/cancelable-task.h"
 #include "src/v8.h"
 #include "src/vm-state-inl.h"
 
@@ -494,32 +496,122 @@ class GlobalHandles::NodeIterator {
   DISALLOW_COPY_AND_ASSIGN(NodeIterator);
 };
 
+// Visits the used node blocks on the main thread and on background tasks.
+// Each block is a work item that is claimed by exactly one of them, so
+// ProcessBlock only has to be safe with respect to other blocks.
+class GlobalHandles::ParallelBlockIteration {
+ public:
+  explicit ParallelBlockIteration(GlobalHandles* global_handles)
+      : global_handles_(global_handles),
+        next_block_(0),
+        pending_tasks_semaphore_(0) {}
+  virtual ~ParallelBlockIteration() {}
+
+  void Run() {
+    for (NodeBlock* block = global_handles_->first_used_block_;
+         block != NULL; block = block->next_used()) {
+      blocks_.Add(block);
+    }
+    int num_tasks = NumberOfTasks(blocks_.length());
+    for (int i = 1; i < num_tasks; i++) {
+      V8::GetCurrentPlatform()->CallOnBackgroundThread(
+          new Task(this), v8::Platform::kShortRunningTask);
+    }
+    // Contribute in main thread.
+    ProcessBlocks();
+    for (int i = 1; i < num_tasks; i++) {
+      pending_tasks_semaphore_.Wait();
+    }
+  }
+
+ protected:
+  virtual void ProcessBlock(NodeBlock* block) = 0;
+
+ private:
+  class Task : public v8::Task {
+   public:
+    explicit Task(ParallelBlockIteration* iteration) : iteration_(iteration) {}
+    virtual ~Task() {}
+
+   private:
+    // v8::Task overrides.
+    void Run() override {
+      iteration_->ProcessBlocks();
+      iteration_->pending_tasks_semaphore_.Signal();
+    }
+
+    ParallelBlockIteration* iteration_;
+
+    DISALLOW_COPY_AND_ASSIGN(Task);
+  };
+
+  // The number of tasks, including the main thread. Small handle sets are
+  // not worth starting tasks for.
+  static int NumberOfTasks(int num_blocks) {
+    if (!FLAG_parallel_global_handles) return 1;
+    const int kBlocksPerTask = 16;
+    return Max(1, Min(num_blocks / kBlocksPerTask,
+                      base::SysInfo::NumberOfProcessors()));
+  }
+
+  void ProcessBlocks() {
+    while (true) {
+      int index = static_cast<int>(
+          base::NoBarrier_AtomicIncrement(&next_block_, 1) - 1);
+      if (index >= blocks_.length()) break;
+      ProcessBlock(blocks_[index]);
+    }
+  }
+
+  GlobalHandles* global_handles_;
+  List<NodeBlock*> blocks_;
+  base::AtomicWord next_block_;
+  base::Semaphore pending_tasks_semaphore_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelBlockIteration);
+};
+
+
 class GlobalHandles::PendingPhantomCallbacksSecondPassTask
     : public v8::internal::CancelableTask {
  public:
-  // Takes ownership of the contents of pending_phantom_callbacks, leaving it in
-  // the same state it would be after a call to Clear().
-  PendingPhantomCallbacksSecondPassTask(
-      List<PendingPhantomCallback>* pending_phantom_callbacks, Isolate* isolate)
-      : CancelableTask(isolate) {
-    pending_phantom_callbacks_.Swap(pending_phantom_callbacks);
-  }
+  PendingPhantomCallbacksSecondPassTask(GlobalHandles* global_handles,
+                                        Isolate* isolate)
+      : CancelableTask(isolate), global_handles_(global_handles) {}
 
   void RunInternal() override {
-    isolate_->heap()->CallGCPrologueCallbacks(
-        GCType::kGCTypeProcessWeakCallbacks, kNoGCCallbackFlags);
-    InvokeSecondPassPhantomCallbacks(&pending_phantom_callbacks_, isolate_);
-    isolate_->heap()->CallGCEpilogueCallbacks(
-        GCType::kGCTypeProcessWeakCallbacks, kNoGCCallbackFlags);
+    global_handles_->second_pass_task_pending_ = false;
+    global_handles_->RunSecondPassPhantomCallbacks(V8_INFINITY);
   }
 
  private:
-  List<PendingPhantomCallback> pending_phantom_callbacks_;
+  GlobalHandles* global_handles_;
 
   DISALLOW_COPY_AND_ASSIGN(PendingPhantomCallbacksSecondPassTask);
 };
 
 
+class GlobalHandles::PendingPhantomCallbacksSecondPassIdleTask
+    : public v8::internal::CancelableIdleTask {
+ public:
+  PendingPhantomCallbacksSecondPassIdleTask(GlobalHandles* global_handles,
+                                            Isolate* isolate)
+      : CancelableIdleTask(isolate), global_handles_(global_handles) {}
+
+  void RunInternal(double deadline_in_seconds) override {
+    global_handles_->second_pass_idle_task_pending_ = false;
+    global_handles_->RunSecondPassPhantomCallbacks(
+        deadline_in_seconds *
+        static_cast<double>(base::Time::kMillisecondsPerSecond));
+  }
+
+ private:
+  GlobalHandles* global_handles_;
+
+  DISALLOW_COPY_AND_ASSIGN(PendingPhantomCallbacksSecondPassIdleTask);
+};
+
+
 GlobalHandles::GlobalHandles(Isolate* isolate)
     : isolate_(isolate),
       number_of_global_handles_(0),
@@ -527,7 +619,10 @@ GlobalHandles::GlobalHandles(Isolate* isolate)
       first_used_block_(NULL),
       first_free_(NULL),
       post_gc_processing_count_(0),
-      object_group_connections_(kObjectGroupConnectionsCapacity) {}
+      object_group_connections_(kObjectGroupConnectionsCapacity),
+      second_pass_task_pending_(false),
+      second_pass_idle_task_pending_(false),
+      gcs_since_second_pass_idle_task_(0) {}
 
 
 GlobalHandles::~GlobalHandles() {
@@ -635,11 +730,25 @@ void GlobalHandles::IterateWeakRoots(ObjectVisitor* v) {
 
 
 void GlobalHandles::IdentifyWeakHandles(WeakSlotCallback f) {
-  for (NodeIterator it(this); !it.done(); it.Advance()) {
-    if (it.node()->IsWeak() && f(it.node()->location())) {
-      it.node()->MarkPending();
+  class IdentifyWeakHandlesIteration : public ParallelBlockIteration {
+   public:
+    IdentifyWeakHandlesIteration(GlobalHandles* global_handles,
+                                 WeakSlotCallback f)
+        : ParallelBlockIteration(global_handles), f_(f) {}
+
+   private:
+    void ProcessBlock(NodeBlock* block) override {
+      for (int i = 0; i < NodeBlock::kSize; i++) {
+        Node* node = block->node_at(i);
+        if (node->IsWeak() && f_(node->location())) node->MarkPending();
+      }
     }
-  }
+
+    WeakSlotCallback f_;
+  };
+
+  IdentifyWeakHandlesIteration iteration(this, f);
+  iteration.Run();
 }
 
 
@@ -842,18 +951,22 @@ int GlobalHandles::DispatchPendingPhantomCallbacks(
       freed_nodes++;
     }
   }
-  if (pending_phantom_callbacks_.length() > 0) {
+  // Only callbacks that asked for a second pass are kept around.
+  for (int i = 0; i < pending_phantom_callbacks_.length(); i++) {
+    if (pending_phantom_callbacks_[i].callback() != nullptr) {
+      second_pass_phantom_callbacks_.Add(pending_phantom_callbacks_[i]);
+    }
+  }
+  if (second_pass_phantom_callbacks_.length() > 0) {
     if (FLAG_optimize_for_size || FLAG_predictable || synchronous_second_pass) {
       isolate()->heap()->CallGCPrologueCallbacks(
           GCType::kGCTypeProcessWeakCallbacks, kNoGCCallbackFlags);
-      InvokeSecondPassPhantomCallbacks(&pending_phantom_callbacks_, isolate());
+      InvokeSecondPassPhantomCallbacks(&second_pass_phantom_callbacks_,
+                                       isolate());
       isolate()->heap()->CallGCEpilogueCallbacks(
           GCType::kGCTypeProcessWeakCallbacks, kNoGCCallbackFlags);
     } else {
-      auto task = new PendingPhantomCallbacksSecondPassTask(
-          &pending_phantom_callbacks_, isolate());
-      V8::GetCurrentPlatform()->CallOnForegroundThread(
-          reinterpret_cast<v8::Isolate*>(isolate()), task);
+      ScheduleSecondPassPhantomCallbacks();
     }
   }
   pending_phantom_callbacks_.Clear();
@@ -861,6 +974,55 @@ int GlobalHandles::DispatchPendingPhantomCallbacks(
 }
 
 
+void GlobalHandles::ScheduleSecondPassPhantomCallbacks() {
+  if (second_pass_task_pending_) return;
+  v8::Isolate* isolate = reinterpret_cast<v8::Isolate*>(isolate_);
+  v8::Platform* platform = V8::GetCurrentPlatform();
+  if (platform->IdleTasksEnabled(isolate)) {
+    if (!second_pass_idle_task_pending_) {
+      second_pass_idle_task_pending_ = true;
+      gcs_since_second_pass_idle_task_ = 0;
+      platform->CallIdleOnForegroundThread(
+          isolate,
+          new PendingPhantomCallbacksSecondPassIdleTask(this, isolate_));
+      return;
+    }
+    // A busy embedder may have no idle time for a long while. Do not let the
+    // queue grow without bound until it does.
+    if (++gcs_since_second_pass_idle_task_ < kMaxGCsBeforeSecondPassTask &&
+        second_pass_phantom_callbacks_.length() <
+            kMaxQueuedBeforeSecondPassTask) {
+      return;
+    }
+  }
+  second_pass_task_pending_ = true;
+  platform->CallOnForegroundThread(
+      isolate, new PendingPhantomCallbacksSecondPassTask(this, isolate_));
+}
+
+
+void GlobalHandles::RunSecondPassPhantomCallbacks(double deadline_in_ms) {
+  // The callbacks may have been run synchronously in the meantime.
+  if (second_pass_phantom_callbacks_.length() == 0) return;
+  Heap* heap = isolate()->heap();
+  heap->CallGCPrologueCallbacks(GCType::kGCTypeProcessWeakCallbacks,
+                                kNoGCCallbackFlags);
+  // Callbacks may trigger garbage collections that queue further callbacks,
+  // which are picked up by this loop as well.
+  do {
+    auto callback = second_pass_phantom_callbacks_.RemoveLast();
+    DCHECK(callback.node() == nullptr);
+    callback.Invoke(isolate());
+  } while (second_pass_phantom_callbacks_.length() > 0 &&
+           heap->MonotonicallyIncreasingTimeInMs() < deadline_in_ms);
+  heap->CallGCEpilogueCallbacks(GCType::kGCTypeProcessWeakCallbacks,
+                                kNoGCCallbackFlags);
+  if (second_pass_phantom_callbacks_.length() > 0) {
+    ScheduleSecondPassPhantomCallbacks();
+  }
+}
+
+
 void GlobalHandles::PendingPhantomCallback::Invoke(Isolate* isolate) {
   Data::Callback* callback_addr = nullptr;
   if (node_ != nullptr) {
@@ -934,6 +1096,28 @@ void GlobalHandles::IterateAllRoots(ObjectVisitor* v) {
 }
 
 
+void GlobalHandles::IterateAllRootsInParallel(ObjectVisitor* v) {
+  class AllRootsIteration : public ParallelBlockIteration {
+   public:
+    AllRootsIteration(GlobalHandles* global_handles, ObjectVisitor* v)
+        : ParallelBlockIteration(global_handles), v_(v) {}
+
+   private:
+    void ProcessBlock(NodeBlock* block) override {
+      for (int i = 0; i < NodeBlock::kSize; i++) {
+        Node* node = block->node_at(i);
+        if (node->IsRetainer()) v_->VisitPointer(node->location());
+      }
+    }
+
+    ObjectVisitor* v_;
+  };
+
+  AllRootsIteration iteration(this, v);
+  iteration.Run();
+}
+
+
 void GlobalHandles::IterateAllRootsWithClassIds(ObjectVisitor* v) {
   for (NodeIterator it(this); !it.done(); it.Advance()) {
     if (it.node()->IsRetainer() && it.node()->has_wrapper_class_id()) {
@@ -111,6 +111,13 @@ enum WeaknessType {
 
 class GlobalHandles {
  public:
+  // An idle task for the second pass phantom callbacks may not get to run for
+  // a long time. Once this many garbage collections have queued callbacks
+  // behind it, or this many callbacks are queued, a regular foreground task
+  // is posted as well.
+  static const int kMaxGCsBeforeSecondPassTask = 4;
+  static const int kMaxQueuedBeforeSecondPassTask = 1024;
+
   ~GlobalHandles();
 
   // Creates a new global handle that is alive until Destroy is called.
@@ -190,6 +197,10 @@ class GlobalHandles {
   // Iterates over all handles.
   void IterateAllRoots(ObjectVisitor* v);
 
+  // Iterates over all handles, splitting the work between the main thread and
+  // background tasks. The visitor must be safe to use concurrently.
+  void IterateAllRootsInParallel(ObjectVisitor* v);
+
   // Iterates over all handles that have embedder-assigned class ID.
   void IterateAllRootsWithClassIds(ObjectVisitor* v);
 
@@ -201,7 +212,8 @@ class GlobalHandles {
   void IterateWeakRoots(ObjectVisitor* v);
 
   // Find all weak handles satisfying the callback predicate, mark
-  // them as pending.
+  // them as pending. The predicate may be called concurrently from
+  // background tasks.
   void IdentifyWeakHandles(WeakSlotCallback f);
 
   // NOTE: Three ...NewSpace... functions below are used during
@@ -298,11 +310,22 @@ class GlobalHandles {
   int DispatchPendingPhantomCallbacks(bool synchronous_second_pass);
   void UpdateListOfNewSpaceNodes();
 
+  // Posts a task that invokes the queued second pass phantom callbacks,
+  // unless one is pending already. Idle tasks are preferred if the platform
+  // supports them, but see kMaxGCsBeforeSecondPassTask.
+  void ScheduleSecondPassPhantomCallbacks();
+
+  // Invokes queued second pass phantom callbacks until the queue is empty or
+  // |deadline_in_ms| is reached. At least one callback is invoked.
+  void RunSecondPassPhantomCallbacks(double deadline_in_ms);
+
   // Internal node structures.
   class Node;
   class NodeBlock;
   class NodeIterator;
+  class ParallelBlockIteration;
   class PendingPhantomCallbacksSecondPassTask;
+  class PendingPhantomCallbacksSecondPassIdleTask;
 
   Isolate* isolate_;
 
@@ -337,6 +360,16 @@ class GlobalHandles {
 
   List<PendingPhantomCallback> pending_phantom_callbacks_;
 
+  // Phantom callbacks whose first pass has run and which wait for their
+  // second pass. Callbacks of several garbage collections are batched here
+  // until a task gets to run them.
+  List<PendingPhantomCallback> second_pass_phantom_callbacks_;
+  bool second_pass_task_pending_;
+  bool second_pass_idle_task_pending_;
+  // Number of garbage collections that queued callbacks while the idle task
+  // was pending.
+  int gcs_since_second_pass_idle_task_;
+
   friend class Isolate;
 
   DISALLOW_COPY_AND_ASSIGN(GlobalHandles);
@@ -3,7 +3,7 @@
 // found in the LICENSE file.
 
 #include "src/heap/array-buffer-tracker.h"
-#include "src/heap/heap.h"
+#include "src/heap/heap-inl.h"
 #include "src/isolate.h"
 #include "src/objects.h"
 #include "src/objects-inl.h"
@@ -12,40 +12,161 @@
 namespace v8 {
 namespace internal {
 
-ArrayBufferTracker::~ArrayBufferTracker() {
-  Isolate* isolate = heap()->isolate();
+static size_t FreeBackingStores(
+    Isolate* isolate, const std::vector<ArrayBufferBackingStore>& stores) {
   size_t freed_memory = 0;
-  for (auto& buffer : live_array_buffers_) {
-    isolate->array_buffer_allocator()->Free(buffer.first, buffer.second);
-    freed_memory += buffer.second;
-  }
-  for (auto& buffer : live_array_buffers_for_scavenge_) {
-    isolate->array_buffer_allocator()->Free(buffer.first, buffer.second);
-    freed_memory += buffer.second;
+  for (auto& store : stores) {
+    isolate->array_buffer_allocator()->Free(store.first, store.second);
+    freed_memory += store.second;
   }
-  live_array_buffers_.clear();
-  live_array_buffers_for_scavenge_.clear();
-  not_yet_discovered_array_buffers_.clear();
-  not_yet_discovered_array_buffers_for_scavenge_.clear();
+  return freed_memory;
+}
 
+
+LocalArrayBufferTracker::~LocalArrayBufferTracker() {
+  // The page is going away, possibly on a background thread. All buffers
+  // that are still tracked die with it.
+  std::vector<ArrayBufferBackingStore> dead;
+  dead.reserve(array_buffers_.size());
+  for (auto& entry : array_buffers_) {
+    dead.push_back(std::make_pair(entry.first->backing_store(), entry.second));
+  }
+  array_buffers_.clear();
+  size_t freed_memory = FreeBackingStores(heap_->isolate(), dead);
   if (freed_memory > 0) {
-    heap()->update_amount_of_external_allocated_memory(
-        -static_cast<int64_t>(freed_memory));
+    heap_->IncrementExternalMemoryConcurrentlyFreed(
+        static_cast<intptr_t>(freed_memory));
   }
 }
 
 
+void LocalArrayBufferTracker::Add(JSArrayBuffer* buffer, size_t length) {
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  DCHECK(array_buffers_.count(buffer) == 0);
+  array_buffers_[buffer] = length;
+}
+
+
+size_t LocalArrayBufferTracker::Remove(JSArrayBuffer* buffer) {
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  TrackingMap::iterator it = array_buffers_.find(buffer);
+  DCHECK(it != array_buffers_.end());
+  size_t length = it->second;
+  array_buffers_.erase(it);
+  return length;
+}
+
+
+void LocalArrayBufferTracker::Process(
+    LivenessMode mode, std::vector<ArrayBufferBackingStore>* dead) {
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  for (TrackingMap::iterator it = array_buffers_.begin();
+       it != array_buffers_.end();) {
+    JSArrayBuffer* buffer = it->first;
+    MapWord map_word = buffer->map_word();
+    if (map_word.IsForwardingAddress()) {
+      // Evacuation writes the forwarding address into the map word of the
+      // old copy, both in the scavenger and in the mark-compactor. The target
+      // page has already been swept, so it is not processed concurrently.
+      JSArrayBuffer* target =
+          reinterpret_cast<JSArrayBuffer*>(map_word.ToForwardingAddress());
+      MemoryChunk* target_page = MemoryChunk::FromAddress(target->address());
+      ArrayBufferTracker::GetLocalTracker(target_page)->Add(target, it->second);
+      it = array_buffers_.erase(it);
+    } else if (mode == kForwardedOrMarked &&
+               Marking::IsBlack(Marking::MarkBitFrom(buffer))) {
+      ++it;
+    } else {
+      dead->push_back(std::make_pair(buffer->backing_store(), it->second));
+      it = array_buffers_.erase(it);
+    }
+  }
+}
+
+
+bool LocalArrayBufferTracker::IsEmpty() {
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  return array_buffers_.empty();
+}
+
+
+bool LocalArrayBufferTracker::IsTracked(JSArrayBuffer* buffer) {
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  return array_buffers_.count(buffer) > 0;
+}
+
+
+class ArrayBufferTracker::FreeBackingStoresTask : public v8::Task {
+ public:
+  FreeBackingStoresTask(ArrayBufferTracker* tracker,
+                        std::vector<ArrayBufferBackingStore>* stores)
+      : tracker_(tracker) {
+    stores_.swap(*stores);
+  }
+  virtual ~FreeBackingStoresTask() {}
+
+ private:
+  // v8::Task overrides.
+  void Run() override {
+    FreeBackingStores(tracker_->heap()->isolate(), stores_);
+    tracker_->pending_free_tasks_semaphore_.Signal();
+  }
+
+  ArrayBufferTracker* tracker_;
+  std::vector<ArrayBufferBackingStore> stores_;
+
+  DISALLOW_COPY_AND_ASSIGN(FreeBackingStoresTask);
+};
+
+
+ArrayBufferTracker::ArrayBufferTracker(Heap* heap)
+    : heap_(heap), pending_free_tasks_semaphore_(0), free_tasks_active_(0) {}
+
+
+ArrayBufferTracker::~ArrayBufferTracker() {
+  WaitUntilFreeingCompleted();
+  FreeBackingStores(heap()->isolate(), queued_backing_stores_);
+  queued_backing_stores_.clear();
+
+  // Pages of paged spaces release their trackers when they are freed, new
+  // space pages are not freed individually.
+  NewSpace* new_space = heap()->new_space();
+  ReleaseNewSpaceTrackers(new_space->ToSpaceStart(), new_space->ToSpaceEnd());
+  if (new_space->IsFromSpaceCommitted()) {
+    ReleaseNewSpaceTrackers(new_space->FromSpaceStart(),
+                            new_space->FromSpaceEnd());
+  }
+}
+
+
+void ArrayBufferTracker::ReleaseNewSpaceTrackers(Address start, Address end) {
+  NewSpacePageIterator it(start, end);
+  while (it.has_next()) {
+    NewSpacePage* page = it.next();
+    delete page->local_tracker();
+    page->set_local_tracker(nullptr);
+  }
+}
+
+
+LocalArrayBufferTracker* ArrayBufferTracker::GetLocalTracker(
+    MemoryChunk* page) {
+  // Trackers are only ever created on the main thread, for pages that are
+  // not being swept.
+  if (page->local_tracker() == nullptr) {
+    page->set_local_tracker(new LocalArrayBufferTracker(page->heap()));
+  }
+  return page->local_tracker();
+}
+
+
 void ArrayBufferTracker::RegisterNew(JSArrayBuffer* buffer) {
   void* data = buffer->backing_store();
   if (!data) return;
 
-  bool in_new_space = heap()->InNewSpace(buffer);
   size_t length = NumberToSize(heap()->isolate(), buffer->byte_length());
-  if (in_new_space) {
-    live_array_buffers_for_scavenge_[data] = length;
-  } else {
-    live_array_buffers_[data] = length;
-  }
+  MemoryChunk* page = MemoryChunk::FromAddress(buffer->address());
+  GetLocalTracker(page)->Add(buffer, length);
 
   // We may go over the limit of externally allocated memory here. We call the
   // api function to trigger a GC in this case.
@@ -58,80 +179,105 @@ void ArrayBufferTracker::Unregister(JSArrayBuffer* buffer) {
   void* data = buffer->backing_store();
   if (!data) return;
 
-  bool in_new_space = heap()->InNewSpace(buffer);
-  std::map<void*, size_t>* live_buffers =
-      in_new_space ? &live_array_buffers_for_scavenge_ : &live_array_buffers_;
-  std::map<void*, size_t>* not_yet_discovered_buffers =
-      in_new_space ? &not_yet_discovered_array_buffers_for_scavenge_
-                   : &not_yet_discovered_array_buffers_;
-
-  DCHECK(live_buffers->count(data) > 0);
-
-  size_t length = (*live_buffers)[data];
-  live_buffers->erase(data);
-  not_yet_discovered_buffers->erase(data);
+  MemoryChunk* page = MemoryChunk::FromAddress(buffer->address());
+  DCHECK(page->local_tracker() != nullptr);
+  size_t length = page->local_tracker()->Remove(buffer);
 
   heap()->update_amount_of_external_allocated_memory(
       -static_cast<int64_t>(length));
 }
 
 
-void ArrayBufferTracker::MarkLive(JSArrayBuffer* buffer) {
-  void* data = buffer->backing_store();
-
-  // ArrayBuffer might be in the middle of being constructed.
-  if (data == heap()->undefined_value()) return;
-  if (heap()->InNewSpace(buffer)) {
-    not_yet_discovered_array_buffers_for_scavenge_.erase(data);
-  } else {
-    not_yet_discovered_array_buffers_.erase(data);
+void ArrayBufferTracker::FreeDeadInNewSpace() {
+  NewSpace* new_space = heap()->new_space();
+  std::vector<ArrayBufferBackingStore> dead;
+  NewSpacePageIterator it(new_space->FromSpaceStart(),
+                          new_space->FromSpaceEnd());
+  while (it.has_next()) {
+    NewSpacePage* page = it.next();
+    LocalArrayBufferTracker* tracker = page->local_tracker();
+    if (tracker == nullptr) continue;
+    // All live objects have left from-space, so the tracker ends up empty.
+    tracker->Process(LocalArrayBufferTracker::kForwardedOnly, &dead);
+    DCHECK(tracker->IsEmpty());
+    delete tracker;
+    page->set_local_tracker(nullptr);
   }
+  QueueDead(dead);
 }
 
 
-void ArrayBufferTracker::FreeDead(bool from_scavenge) {
-  size_t freed_memory = 0;
-  Isolate* isolate = heap()->isolate();
-  for (auto& buffer : not_yet_discovered_array_buffers_for_scavenge_) {
-    isolate->array_buffer_allocator()->Free(buffer.first, buffer.second);
-    freed_memory += buffer.second;
-    live_array_buffers_for_scavenge_.erase(buffer.first);
-  }
+void ArrayBufferTracker::FreeDeadOnEvacuatedPage(MemoryChunk* page) {
+  LocalArrayBufferTracker* tracker = page->local_tracker();
+  if (tracker == nullptr) return;
+  std::vector<ArrayBufferBackingStore> dead;
+  tracker->Process(LocalArrayBufferTracker::kForwardedOnly, &dead);
+  DCHECK(tracker->IsEmpty());
+  delete tracker;
+  page->set_local_tracker(nullptr);
+  QueueDead(dead);
+}
 
-  if (!from_scavenge) {
-    for (auto& buffer : not_yet_discovered_array_buffers_) {
-      isolate->array_buffer_allocator()->Free(buffer.first, buffer.second);
-      freed_memory += buffer.second;
-      live_array_buffers_.erase(buffer.first);
-    }
-  }
 
-  not_yet_discovered_array_buffers_for_scavenge_ =
-      live_array_buffers_for_scavenge_;
-  if (!from_scavenge) not_yet_discovered_array_buffers_ = live_array_buffers_;
+void ArrayBufferTracker::FreeDeadOnSweptPage(MemoryChunk* page) {
+  LocalArrayBufferTracker* tracker = page->local_tracker();
+  if (tracker == nullptr) return;
+  std::vector<ArrayBufferBackingStore> dead;
+  tracker->Process(LocalArrayBufferTracker::kForwardedOrMarked, &dead);
+  if (dead.empty()) return;
+  // Sweeping usually runs on a background thread, so the freed memory is
+  // accounted for later on the main thread.
+  size_t freed_memory = FreeBackingStores(heap()->isolate(), dead);
+  heap()->IncrementExternalMemoryConcurrentlyFreed(
+      static_cast<intptr_t>(freed_memory));
+}
+
 
+void ArrayBufferTracker::QueueDead(
+    const std::vector<ArrayBufferBackingStore>& dead) {
+  size_t freed_memory = 0;
+  for (auto& store : dead) {
+    queued_backing_stores_.push_back(store);
+    freed_memory += store.second;
+  }
   // Do not call through the api as this code is triggered while doing a GC.
   heap()->update_amount_of_external_allocated_memory(
       -static_cast<int64_t>(freed_memory));
 }
 
 
-void ArrayBufferTracker::PrepareDiscoveryInNewSpace() {
-  not_yet_discovered_array_buffers_for_scavenge_ =
-      live_array_buffers_for_scavenge_;
+void ArrayBufferTracker::FreeQueuedBackingStores() {
+  if (queued_backing_stores_.empty()) return;
+  if (!FLAG_concurrent_array_buffer_freeing) {
+    FreeBackingStores(heap()->isolate(), queued_backing_stores_);
+    queued_backing_stores_.clear();
+    return;
+  }
+  // Reap tasks that have finished in the meantime to keep the count small.
+  while (free_tasks_active_ > 0 && pending_free_tasks_semaphore_.WaitFor(
+                                       base::TimeDelta::FromSeconds(0))) {
+    free_tasks_active_--;
+  }
+  V8::GetCurrentPlatform()->CallOnBackgroundThread(
+      new FreeBackingStoresTask(this, &queued_backing_stores_),
+      v8::Platform::kShortRunningTask);
+  free_tasks_active_++;
+  DCHECK(queued_backing_stores_.empty());
 }
 
 
-void ArrayBufferTracker::Promote(JSArrayBuffer* buffer) {
-  if (buffer->is_external()) return;
-  void* data = buffer->backing_store();
-  if (!data) return;
-  // ArrayBuffer might be in the middle of being constructed.
-  if (data == heap()->undefined_value()) return;
-  DCHECK(live_array_buffers_for_scavenge_.count(data) > 0);
-  live_array_buffers_[data] = live_array_buffers_for_scavenge_[data];
-  live_array_buffers_for_scavenge_.erase(data);
-  not_yet_discovered_array_buffers_for_scavenge_.erase(data);
+bool ArrayBufferTracker::IsTracked(JSArrayBuffer* buffer) {
+  MemoryChunk* page = MemoryChunk::FromAddress(buffer->address());
+  LocalArrayBufferTracker* tracker = page->local_tracker();
+  return tracker != nullptr && tracker->IsTracked(buffer);
+}
+
+
+void ArrayBufferTracker::WaitUntilFreeingCompleted() {
+  while (free_tasks_active_ > 0) {
+    pending_free_tasks_semaphore_.Wait();
+    free_tasks_active_--;
+  }
 }
 
 }  // namespace internal
@@ -5,8 +5,12 @@
 #ifndef V8_HEAP_ARRAY_BUFFER_TRACKER_H_
 #define V8_HEAP_ARRAY_BUFFER_TRACKER_H_
 
-#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "src/base/platform/mutex.h"
+#include "src/base/platform/semaphore.h"
 #include "src/globals.h"
 
 namespace v8 {
@@ -15,10 +19,63 @@ namespace internal {
 // Forward declarations.
 class Heap;
 class JSArrayBuffer;
+class MemoryChunk;
 
+// A backing store that is no longer referenced by any ArrayBuffer, given as
+// pointer and length as expected by v8::ArrayBuffer::Allocator::Free.
+typedef std::pair<void*, size_t> ArrayBufferBackingStore;
+
+
+// Tracks the backing stores of all non-external ArrayBuffers that live on a
+// single page. The tracker is owned by its page and deleted together with it,
+// freeing all backing stores that are still tracked at that point.
+//
+// The tracker of an old space page may be processed by a sweeper thread while
+// the main thread unregisters a buffer on the same page, so all operations
+// are guarded by a mutex.
+class LocalArrayBufferTracker {
+ public:
+  enum LivenessMode {
+    // Every buffer that was not evacuated is dead.
+    kForwardedOnly,
+    // Buffers that were not evacuated are live iff they are marked black.
+    kForwardedOrMarked
+  };
+
+  explicit LocalArrayBufferTracker(Heap* heap) : heap_(heap) {}
+  ~LocalArrayBufferTracker();
+
+  void Add(JSArrayBuffer* buffer, size_t length);
+
+  // Returns the length of the backing store of |buffer|.
+  size_t Remove(JSArrayBuffer* buffer);
+
+  // Visits all tracked buffers after their page has been evacuated or before
+  // it is swept. Buffers that were evacuated are handed over to the tracker
+  // of the page they were moved to, the backing stores of dead buffers are
+  // appended to |dead|.
+  void Process(LivenessMode mode, std::vector<ArrayBufferBackingStore>* dead);
+
+  bool IsEmpty();
+  bool IsTracked(JSArrayBuffer* buffer);
+
+ private:
+  typedef std::unordered_map<JSArrayBuffer*, size_t> TrackingMap;
+
+  Heap* heap_;
+  base::Mutex mutex_;
+  TrackingMap array_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(LocalArrayBufferTracker);
+};
+
+
+// Heap-wide entry point for ArrayBuffer tracking. Backing stores are tracked
+// by the page their ArrayBuffer lives on (see LocalArrayBufferTracker), so a
+// garbage collection only has to look at the pages it evacuates or sweeps.
 class ArrayBufferTracker {
  public:
-  explicit ArrayBufferTracker(Heap* heap) : heap_(heap) {}
+  explicit ArrayBufferTracker(Heap* heap);
   ~ArrayBufferTracker();
 
   inline Heap* heap() { return heap_; }
@@ -32,41 +89,46 @@ class ArrayBufferTracker {
   // The backing store |data| is no longer owned by V8.
   void Unregister(JSArrayBuffer* buffer);
 
-  // A live ArrayBuffer was discovered during marking/scavenge.
-  void MarkLive(JSArrayBuffer* buffer);
+  // Processes the trackers of the from-space pages after a scavenge or after
+  // new space has been evacuated by a full GC. Dead backing stores are queued
+  // for FreeQueuedBackingStores.
+  void FreeDeadInNewSpace();
 
-  // Frees all backing store pointers that weren't discovered in the previous
-  // marking or scavenge phase.
-  void FreeDead(bool from_scavenge);
+  // Processes the tracker of an old space page whose live objects have all
+  // been evacuated. Dead backing stores are queued for
+  // FreeQueuedBackingStores.
+  void FreeDeadOnEvacuatedPage(MemoryChunk* page);
 
-  // Prepare for a new scavenge phase. A new marking phase is implicitly
-  // prepared by finishing the previous one.
-  void PrepareDiscoveryInNewSpace();
+  // Frees the backing stores of dead buffers on |page| right away. Has to be
+  // called before the mark bits of the page are cleared. May be called
+  // concurrently from sweeper threads.
+  void FreeDeadOnSweptPage(MemoryChunk* page);
 
-  // An ArrayBuffer moved from new space to old space.
-  void Promote(JSArrayBuffer* buffer);
+  // Releases all queued backing stores to the ArrayBuffer::Allocator on a
+  // background task.
+  void FreeQueuedBackingStores();
+
+  // Returns whether the backing store of |buffer| is tracked by its page.
+  static bool IsTracked(JSArrayBuffer* buffer);
 
  private:
+  class FreeBackingStoresTask;
+
+  static LocalArrayBufferTracker* GetLocalTracker(MemoryChunk* page);
+  void ReleaseNewSpaceTrackers(Address start, Address end);
+  void QueueDead(const std::vector<ArrayBufferBackingStore>& dead);
+  void WaitUntilFreeingCompleted();
+
   Heap* heap_;
 
-  // |live_array_buffers_| maps externally allocated memory used as backing
-  // store for ArrayBuffers to the length of the respective memory blocks.
-  //
-  // At the beginning of mark/compact, |not_yet_discovered_array_buffers_| is
-  // a copy of |live_array_buffers_| and we remove pointers as we discover live
-  // ArrayBuffer objects during marking. At the end of mark/compact, the
-  // remaining memory blocks can be freed.
-  std::map<void*, size_t> live_array_buffers_;
-  std::map<void*, size_t> not_yet_discovered_array_buffers_;
-
-  // To be able to free memory held by ArrayBuffers during scavenge as well, we
-  // have a separate list of allocated memory held by ArrayBuffers in new space.
-  //
-  // Since mark/compact also evacuates the new space, all pointers in the
-  // |live_array_buffers_for_scavenge_| list are also in the
-  // |live_array_buffers_| list.
-  std::map<void*, size_t> live_array_buffers_for_scavenge_;
-  std::map<void*, size_t> not_yet_discovered_array_buffers_for_scavenge_;
+  // Backing stores of dead buffers found on the main thread, waiting to be
+  // handed to a FreeBackingStoresTask.
+  std::vector<ArrayBufferBackingStore> queued_backing_stores_;
+
+  base::Semaphore pending_free_tasks_semaphore_;
+  int free_tasks_active_;
+
+  friend class LocalArrayBufferTracker;
 };
 }  // namespace internal
 }  // namespace v8
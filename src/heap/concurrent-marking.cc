@@ -0,0 +1,318 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/heap/concurrent-marking.h"
+
+#include "src/base/platform/elapsed-timer.h"
+#include "src/heap/gc-tracer.h"
+#include "src/heap/heap-inl.h"
+#include "src/heap/incremental-marking.h"
+#include "src/heap/mark-compact-inl.h"
+#include "src/isolate.h"
+#include "src/list-inl.h"
+#include "src/objects-inl.h"
+#include "src/v8.h"
+
+namespace v8 {
+namespace internal {
+
+class ConcurrentMarking::Task : public v8::Task {
+ public:
+  explicit Task(ConcurrentMarking* concurrent_marking)
+      : concurrent_marking_(concurrent_marking) {}
+
+  virtual ~Task() {}
+
+ private:
+  // v8::Task overrides.
+  void Run() override { concurrent_marking_->Run(); }
+
+  ConcurrentMarking* concurrent_marking_;
+
+  DISALLOW_COPY_AND_ASSIGN(Task);
+};
+
+
+ConcurrentMarking::ConcurrentMarking(Heap* heap)
+    : heap_(heap),
+      task_pending_(false),
+      is_compacting_(false),
+      stop_requested_(false),
+      pending_task_semaphore_(0),
+      task_running_(false),
+      visited_bytes_(0),
+      duration_(0.0) {}
+
+
+ConcurrentMarking::~ConcurrentMarking() {
+  if (task_pending_) {
+    stop_requested_.SetValue(true);
+    pending_task_semaphore_.Wait();
+  }
+}
+
+
+void ConcurrentMarking::Results::MoveTo(Results* other) {
+  other->discovered.AddAll(discovered);
+  other->visited.AddAll(visited);
+  other->leaves.AddAll(leaves);
+  other->objects_to_mark.AddAll(objects_to_mark);
+  other->objects_to_visit.AddAll(objects_to_visit);
+  other->visited_bytes += visited_bytes;
+  Clear();
+}
+
+
+void ConcurrentMarking::Results::Clear() {
+  discovered.Clear();
+  visited.Clear();
+  leaves.Clear();
+  objects_to_mark.Clear();
+  objects_to_visit.Clear();
+  visited_bytes = 0;
+}
+
+
+bool ConcurrentMarking::Results::IsEmpty() {
+  return discovered.is_empty() && visited.is_empty() && leaves.is_empty() &&
+         objects_to_mark.is_empty() && objects_to_visit.is_empty();
+}
+
+
+static bool IsImmutableFixedArray(Heap* heap, Map* map) {
+  return map == heap->fixed_cow_array_map() || map == heap->scope_info_map();
+}
+
+
+static bool IsImmutableLeaf(Heap* heap, Map* map) {
+  return map == heap->heap_number_map() ||
+         map == heap->mutable_heap_number_map();
+}
+
+
+static bool InOldSpace(Heap* heap, HeapObject* object) {
+  return MemoryChunk::FromAddress(object->address())->owner() ==
+         heap->old_space();
+}
+
+
+bool ConcurrentMarking::CanVisit(Heap* heap, HeapObject* object, Map* map) {
+  return IsImmutableFixedArray(heap, map) && InOldSpace(heap, object);
+}
+
+
+void ConcurrentMarking::StartTaskIfNeeded() {
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  incoming_.AddAll(main_thread_work_);
+  main_thread_work_.Clear();
+  if (task_pending_ && !task_running_) {
+    // The task has already signaled the semaphore.
+    pending_task_semaphore_.Wait();
+    task_pending_ = false;
+  }
+  if (task_pending_ || incoming_.is_empty()) return;
+  is_compacting_ = heap_->incremental_marking()->IsCompacting();
+  task_pending_ = true;
+  task_running_ = true;
+  V8::GetCurrentPlatform()->CallOnBackgroundThread(
+      new Task(this), v8::Platform::kShortRunningTask);
+}
+
+
+void ConcurrentMarking::Run() {
+  base::ElapsedTimer timer;
+  timer.Start();
+  List<HeapObject*> work;
+  Results results;
+  int visited_since_flush = 0;
+  while (!stop_requested_.Value()) {
+    if (work.is_empty() || visited_since_flush >= kFlushInterval) {
+      base::LockGuard<base::Mutex> guard(&mutex_);
+      visited_bytes_ += results.visited_bytes;
+      results.MoveTo(&results_);
+      work.AddAll(incoming_);
+      incoming_.Clear();
+      visited_since_flush = 0;
+      if (work.is_empty()) break;
+    }
+    HeapObject* object = work.RemoveLast();
+    if (VisitObject(object, &work, &results)) {
+      results.visited.Add(object);
+    } else {
+      results.objects_to_visit.Add(object);
+    }
+    visited_since_flush++;
+  }
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  // Objects that were not visited because the main thread requested a stop
+  // are given back by Stop().
+  incoming_.AddAll(work);
+  visited_bytes_ += results.visited_bytes;
+  results.MoveTo(&results_);
+  duration_ += timer.Elapsed().InMillisecondsF();
+  task_running_ = false;
+  pending_task_semaphore_.Signal();
+}
+
+
+bool ConcurrentMarking::VisitObject(HeapObject* object,
+                                    List<HeapObject*>* work,
+                                    Results* results) {
+  Map* map = object->map();
+  DCHECK(IsImmutableFixedArray(heap_, map));
+  // These maps are strong roots and thus usually already marked.
+  if (!Marking::IsBlackOrGreyAtomic(Marking::MarkBitFrom(map))) {
+    results->objects_to_mark.Add(map);
+  }
+  int size = FixedArray::SizeFor(FixedArray::cast(object)->length());
+  Object** end = HeapObject::RawField(object, size);
+  for (Object** slot = HeapObject::RawField(object, FixedArray::kHeaderSize);
+       slot < end; slot++) {
+    if (!VisitPointer(slot, work, results)) return false;
+  }
+  results->visited_bytes += size;
+  return true;
+}
+
+
+bool ConcurrentMarking::VisitPointer(Object** slot, List<HeapObject*>* work,
+                                     Results* results) {
+  Object* value = *slot;
+  if (!value->IsHeapObject()) return true;
+  HeapObject* target = HeapObject::cast(value);
+  if (is_compacting_ &&
+      MarkCompactCollector::IsOnEvacuationCandidate(target)) {
+    return false;
+  }
+  // The mark bits may be stale, in which case the main thread skips the
+  // object when it applies the results.
+  if (Marking::IsBlackOrGreyAtomic(Marking::MarkBitFrom(target))) return true;
+  // The map of a new space object must not be read here since the main
+  // thread may be about to move the object.
+  if (heap_->InNewSpace(target)) {
+    results->objects_to_mark.Add(target);
+    return true;
+  }
+  Map* map = target->map();
+  if (IsImmutableLeaf(heap_, map)) {
+    results->leaves.Add(target);
+    results->visited_bytes += HeapNumber::kSize;
+  } else if (CanVisit(heap_, target, map)) {
+    if (discovered_.insert(target).second) {
+      results->discovered.Add(target);
+      work->Add(target);
+    }
+  } else {
+    results->objects_to_mark.Add(target);
+  }
+  return true;
+}
+
+
+void ConcurrentMarking::GiveBack(HeapObject* object) {
+  if (owned_.erase(object) == 0) return;
+  // The main thread may have visited the object after a marking deque
+  // overflow. Otherwise the object is grey, and if the deque is full, it is
+  // rediscovered when the marking deque is refilled.
+  if (!Marking::IsGrey(Marking::MarkBitFrom(object))) return;
+  heap_->mark_compact_collector()->marking_deque()->Push(object);
+}
+
+
+void ConcurrentMarking::ProcessBailout() {
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  // Discovered objects are applied first, since they may have been visited
+  // before the results were published.
+  for (int i = 0; i < results_.discovered.length(); i++) {
+    HeapObject* object = results_.discovered[i];
+    MarkBit mark_bit = Marking::MarkBitFrom(object);
+    if (Marking::IsWhite(mark_bit)) {
+      Marking::WhiteToGrey(mark_bit);
+      owned_.insert(object);
+    }
+  }
+  for (int i = 0; i < results_.leaves.length(); i++) {
+    HeapObject* object = results_.leaves[i];
+    MarkBit mark_bit = Marking::MarkBitFrom(object);
+    if (Marking::IsWhite(mark_bit)) {
+      Marking::WhiteToBlack(mark_bit);
+      MemoryChunk::IncrementLiveBytesFromGC(object, object->Size());
+    }
+  }
+  IncrementalMarking* incremental_marking = heap_->incremental_marking();
+  for (int i = 0; i < results_.objects_to_mark.length(); i++) {
+    HeapObject* object = results_.objects_to_mark[i];
+    MarkBit mark_bit = Marking::MarkBitFrom(object);
+    if (Marking::IsWhite(mark_bit)) {
+      incremental_marking->WhiteToGreyAndPush(object, mark_bit);
+    }
+  }
+  for (int i = 0; i < results_.visited.length(); i++) {
+    HeapObject* object = results_.visited[i];
+    // Objects not owned by the concurrent marker are on the marking deque
+    // and visited by the main thread as well.
+    if (owned_.erase(object) == 0) continue;
+    MarkBit mark_bit = Marking::MarkBitFrom(object);
+    // The main thread may have visited the object after a marking deque
+    // overflow.
+    if (!Marking::IsGrey(mark_bit)) continue;
+    Marking::GreyToBlack(mark_bit);
+    MemoryChunk::IncrementLiveBytesFromGC(object, object->Size());
+  }
+  for (int i = 0; i < results_.objects_to_visit.length(); i++) {
+    GiveBack(results_.objects_to_visit[i]);
+  }
+  if (duration_ > 0.0) {
+    heap_->tracer()->AddConcurrentMarkingTime(duration_);
+    if (FLAG_trace_concurrent_marking) {
+      PrintIsolate(heap_->isolate(),
+                   "Concurrent marking: visited %" V8_PTR_PREFIX
+                   "d bytes in %.2f ms\n",
+                   results_.visited_bytes, duration_);
+    }
+  }
+  results_.Clear();
+  duration_ = 0.0;
+}
+
+
+void ConcurrentMarking::Stop() {
+  if (task_pending_) {
+    stop_requested_.SetValue(true);
+    pending_task_semaphore_.Wait();
+    stop_requested_.SetValue(false);
+    task_pending_ = false;
+  }
+  if (heap_->mark_compact_collector()->marking_deque()->in_use()) {
+    ProcessBailout();
+    for (int i = 0; i < main_thread_work_.length(); i++) {
+      GiveBack(main_thread_work_[i]);
+    }
+    for (int i = 0; i < incoming_.length(); i++) {
+      GiveBack(incoming_[i]);
+    }
+    DCHECK(owned_.empty());
+  }
+  main_thread_work_.Clear();
+  incoming_.Clear();
+  owned_.clear();
+  discovered_.clear();
+  results_.Clear();
+}
+
+
+bool ConcurrentMarking::IsIdle() {
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  return !task_running_ && main_thread_work_.is_empty() &&
+         incoming_.is_empty() && results_.IsEmpty() && owned_.empty();
+}
+
+
+intptr_t ConcurrentMarking::visited_bytes() {
+  base::LockGuard<base::Mutex> guard(&mutex_);
+  return visited_bytes_;
+}
+
+}  // namespace internal
+}  // namespace v8
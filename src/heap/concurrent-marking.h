@@ -0,0 +1,183 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_HEAP_CONCURRENT_MARKING_H_
+#define V8_HEAP_CONCURRENT_MARKING_H_
+
+#include <set>
+
+#include "src/atomic-utils.h"
+#include "src/base/platform/mutex.h"
+#include "src/base/platform/semaphore.h"
+#include "src/list.h"
+
+namespace v8 {
+namespace internal {
+
+// Forward declarations.
+class Heap;
+class HeapObject;
+class Map;
+class MemoryChunk;
+class Object;
+
+// Helps incremental marking by tracing immutable parts of the old generation
+// on a background thread ahead of the main thread.
+//
+// The concurrent marker only visits objects whose layout and pointer fields
+// never change once they are reachable: copy-on-write fixed arrays and scope
+// infos in old space, as well as heap numbers without any pointer fields.
+// Since these objects are never written to, a snapshot of them taken by the
+// background thread stays valid and the write barrier is unchanged.
+//
+// The concurrent marker never writes mark bits. It only reads them to skip
+// objects that are already marked, and reports what it found to the main
+// thread. The main thread applies the results to the marking bitmap in
+// ProcessBailout(), marking the objects if they are still white. Mark bits
+// are therefore only ever written by the main thread, without atomics. All
+// other objects the concurrent marker discovers are handed back to the main
+// thread, which marks them in its regular incremental marking steps.
+class ConcurrentMarking {
+ public:
+  explicit ConcurrentMarking(Heap* heap);
+  ~ConcurrentMarking();
+
+  // Returns true if the grey |object| can be handed over to the concurrent
+  // marker.
+  static bool CanVisit(Heap* heap, HeapObject* object, Map* map);
+
+  // Hands a grey object over to the concurrent marker. The object stays grey
+  // until the concurrent marker reports it as visited. It is published by the
+  // next StartTaskIfNeeded().
+  void Push(HeapObject* object) {
+    main_thread_work_.Add(object);
+    owned_.insert(object);
+  }
+
+  // Publishes objects pushed since the last call and posts a background task
+  // if there is work and no task is running yet.
+  void StartTaskIfNeeded();
+
+  // Applies the results of the concurrent marker to the marking bitmap and
+  // the marking deque of the main thread, and accounts for the live bytes and
+  // the time of the concurrent marker.
+  void ProcessBailout();
+
+  // Waits for the background task to finish and hands all remaining work
+  // back to the main thread. Must be called before objects are moved.
+  void Stop();
+
+  // Returns true if the concurrent marker has no work left and does not hold
+  // any objects that still have to be processed on the main thread.
+  bool IsIdle();
+
+  // Returns the number of bytes visited by the concurrent marker so far.
+  intptr_t visited_bytes();
+
+ private:
+  class Task;
+
+  // What the background task found since it last published its results.
+  struct Results {
+    Results() : visited_bytes(0) {}
+
+    // Moves all entries to |other|.
+    void MoveTo(Results* other);
+
+    void Clear();
+
+    bool IsEmpty();
+
+    // White objects that the concurrent marker visits itself. The main thread
+    // greys them if they are still white.
+    List<HeapObject*> discovered;
+
+    // Objects that have been visited. The main thread blackens them if they
+    // have been handed over or discovered before.
+    List<HeapObject*> visited;
+
+    // White objects without pointer fields, to be marked black.
+    List<HeapObject*> leaves;
+
+    // Objects that the concurrent marker cannot visit. The main thread marks
+    // them if they are still white.
+    List<HeapObject*> objects_to_mark;
+
+    // Objects that have to be visited on the main thread instead.
+    List<HeapObject*> objects_to_visit;
+
+    intptr_t visited_bytes;
+  };
+
+  // The number of objects the background task visits before it publishes
+  // its results.
+  static const int kFlushInterval = 64;
+
+  // Runs on the background thread.
+  void Run();
+
+  // Visits an object on the background thread. Returns false if the object
+  // has to be visited on the main thread instead.
+  bool VisitObject(HeapObject* object, List<HeapObject*>* work,
+                   Results* results);
+
+  // Looks at the object |slot| points to. Returns false if the slot has to be
+  // recorded for compaction, which is only done on the main thread.
+  bool VisitPointer(Object** slot, List<HeapObject*>* work, Results* results);
+
+  // Pushes |object| on the marking deque if it is owned by the concurrent
+  // marker, i.e. grey but not on the marking deque.
+  void GiveBack(HeapObject* object);
+
+  Heap* heap_;
+
+  // Objects pushed by the main thread that are not published yet. Only
+  // accessed on the main thread.
+  List<HeapObject*> main_thread_work_;
+
+  // Grey objects that are not on the marking deque because the concurrent
+  // marker visits them. Only accessed on the main thread.
+  std::set<HeapObject*> owned_;
+
+  // Objects that the background task has discovered, so that it does not
+  // visit them twice. Only accessed by the background task, or by the main
+  // thread while no task is pending.
+  std::set<HeapObject*> discovered_;
+
+  // True if a task has been posted and not been joined yet. Only accessed on
+  // the main thread.
+  bool task_pending_;
+
+  // Whether incremental marking is compacting. Set before a task is posted.
+  bool is_compacting_;
+
+  // Set by the main thread to make the background task return early.
+  AtomicValue<bool> stop_requested_;
+
+  base::Semaphore pending_task_semaphore_;
+
+  // Guards the fields below.
+  base::Mutex mutex_;
+
+  // True while the background task processes objects.
+  bool task_running_;
+
+  // Objects handed over to the concurrent marker.
+  List<HeapObject*> incoming_;
+
+  // Results published by the background task.
+  Results results_;
+
+  // Bytes visited by the concurrent marker in total, and time spent since the
+  // last call to ProcessBailout().
+  intptr_t visited_bytes_;
+  double duration_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentMarking);
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_HEAP_CONCURRENT_MARKING_H_
@@ -6,6 +6,7 @@
 
 #include "src/flags.h"
 #include "src/heap/gc-tracer.h"
+#include "src/heap/spaces.h"
 #include "src/utils.h"
 
 namespace v8 {
@@ -16,6 +17,9 @@ const size_t GCIdleTimeHandler::kMaxMarkCompactTimeInMs = 1000;
 const size_t GCIdleTimeHandler::kMaxFinalIncrementalMarkCompactTimeInMs = 1000;
 const double GCIdleTimeHandler::kHighContextDisposalRate = 100;
 const size_t GCIdleTimeHandler::kMinTimeForOverApproximatingWeakClosureInMs = 1;
+const double GCIdleTimeHandler::kInstallOptimizedCodeTimeInMs = 0.5;
+const size_t GCIdleTimeHandler::kSweepingPageSize =
+    Page::kPageSize - Page::kObjectStartOffset;
 
 
 void GCIdleTimeAction::Print() {
@@ -35,6 +39,18 @@ void GCIdleTimeAction::Print() {
     case DO_FULL_GC:
       PrintF("full GC");
       break;
+    case DO_SWEEPING_STEP:
+      PrintF("sweeping step");
+      break;
+    case DO_INSTALL_OPTIMIZED_CODE:
+      PrintF("install optimized code");
+      break;
+    case DO_UNCOMMIT_FROM_SPACE:
+      PrintF("uncommit from-space");
+      break;
+    case DO_AGE_COMPILATION_CACHE:
+      PrintF("age compilation cache");
+      break;
   }
 }
 
@@ -45,11 +61,19 @@ void GCIdleTimeHeapState::Print() {
   PrintF("size_of_objects=%" V8_PTR_PREFIX "d ", size_of_objects);
   PrintF("incremental_marking_stopped=%d ", incremental_marking_stopped);
   PrintF("sweeping_in_progress=%d ", sweeping_in_progress);
+  PrintF("has_pending_sweeping_pages=%d ", has_pending_sweeping_pages);
+  PrintF("sweeping_completed=%d ", sweeping_completed);
   PrintF("has_low_allocation_rate=%d", has_low_allocation_rate);
   PrintF("mark_compact_speed=%" V8_PTR_PREFIX "d ",
          mark_compact_speed_in_bytes_per_ms);
   PrintF("incremental_marking_speed=%" V8_PTR_PREFIX "d ",
          incremental_marking_speed_in_bytes_per_ms);
+  PrintF("sweeping_speed=%" V8_PTR_PREFIX "d ",
+         sweeping_speed_in_bytes_per_ms);
+  PrintF("pending_optimized_code_installs=%d ",
+         pending_optimized_code_installs);
+  PrintF("from_space_committed=%d ", from_space_committed);
+  PrintF("compilation_cache_needs_aging=%d", compilation_cache_needs_aging);
 }
 
 
@@ -133,6 +157,31 @@ bool GCIdleTimeHandler::ShouldDoOverApproximateWeakClosure(
 }
 
 
+double GCIdleTimeHandler::EstimateSweepingTime(
+    size_t bytes, size_t sweeping_speed_in_bytes_per_ms) {
+  if (sweeping_speed_in_bytes_per_ms == 0) {
+    sweeping_speed_in_bytes_per_ms = kInitialConservativeSweepingSpeed;
+  }
+  return static_cast<double>(bytes) / sweeping_speed_in_bytes_per_ms;
+}
+
+
+bool GCIdleTimeHandler::ShouldDoSweepingStep(
+    size_t idle_time_in_ms, size_t sweeping_speed_in_bytes_per_ms) {
+  return idle_time_in_ms * kConservativeTimeRatio >=
+         EstimateSweepingTime(kSweepingPageSize,
+                              sweeping_speed_in_bytes_per_ms);
+}
+
+
+bool GCIdleTimeHandler::ShouldInstallOptimizedCode(size_t idle_time_in_ms,
+                                                   int pending_installs) {
+  return pending_installs > 0 &&
+         idle_time_in_ms * kConservativeTimeRatio >=
+             pending_installs * kInstallOptimizedCodeTimeInMs;
+}
+
+
 GCIdleTimeAction GCIdleTimeHandler::NothingOrDone(double idle_time_in_ms) {
   if (idle_time_in_ms >= kMinBackgroundIdleTime) {
     return GCIdleTimeAction::Nothing();
@@ -158,6 +207,10 @@ GCIdleTimeAction GCIdleTimeHandler::NothingOrDone(double idle_time_in_ms) {
 // request, we finalize sweeping here.
 // (5) If incremental marking is in progress, we perform a marking step. Note,
 // that this currently may trigger a full garbage collection.
+// (6) Otherwise we spend the idle time on deferred work that would otherwise
+// be done on the critical path: sweeping pages, installing concurrently
+// optimized code, aging the compilation cache and uncommitting the
+// from-space. Each is only done if its estimated cost fits into the idle time.
 GCIdleTimeAction GCIdleTimeHandler::Compute(double idle_time_in_ms,
                                             GCIdleTimeHeapState heap_state) {
   if (static_cast<int>(idle_time_in_ms) <= 0) {
@@ -179,12 +232,47 @@ GCIdleTimeAction GCIdleTimeHandler::Compute(double idle_time_in_ms,
   }
 
   if (!FLAG_incremental_marking || heap_state.incremental_marking_stopped) {
-    return GCIdleTimeAction::Done();
+    return DeferredWorkOrDone(static_cast<size_t>(idle_time_in_ms),
+                              heap_state);
   }
 
   return GCIdleTimeAction::IncrementalStep();
 }
 
 
+GCIdleTimeAction GCIdleTimeHandler::DeferredWorkOrDone(
+    size_t idle_time_in_ms, const GCIdleTimeHeapState& heap_state) {
+  // Sweeping can only make progress on the main thread if there are pages
+  // left that the sweeper threads have not picked up, or if they are done and
+  // sweeping just has to be finalized.
+  if (heap_state.sweeping_in_progress &&
+      (heap_state.has_pending_sweeping_pages ||
+       heap_state.sweeping_completed) &&
+      ShouldDoSweepingStep(idle_time_in_ms,
+                           heap_state.sweeping_speed_in_bytes_per_ms)) {
+    return GCIdleTimeAction::SweepingStep();
+  }
+
+  if (ShouldInstallOptimizedCode(idle_time_in_ms,
+                                 heap_state.pending_optimized_code_installs)) {
+    return GCIdleTimeAction::InstallOptimizedCode();
+  }
+
+  if (heap_state.compilation_cache_needs_aging &&
+      idle_time_in_ms >= kAgeCompilationCacheTimeInMs) {
+    return GCIdleTimeAction::AgeCompilationCache();
+  }
+
+  // A committed from-space is only worth keeping if the next scavenge is
+  // coming soon.
+  if (heap_state.from_space_committed && heap_state.has_low_allocation_rate &&
+      idle_time_in_ms >= kUncommitFromSpaceTimeInMs) {
+    return GCIdleTimeAction::UncommitFromSpace();
+  }
+
+  return GCIdleTimeAction::Done();
+}
+
+
 }  // namespace internal
 }  // namespace v8
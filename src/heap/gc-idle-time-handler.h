@@ -15,6 +15,10 @@ enum GCIdleTimeActionType {
   DO_NOTHING,
   DO_INCREMENTAL_STEP,
   DO_FULL_GC,
+  DO_SWEEPING_STEP,
+  DO_INSTALL_OPTIMIZED_CODE,
+  DO_UNCOMMIT_FROM_SPACE,
+  DO_AGE_COMPILATION_CACHE,
 };
 
 
@@ -48,6 +52,34 @@ class GCIdleTimeAction {
     return result;
   }
 
+  static GCIdleTimeAction SweepingStep() {
+    GCIdleTimeAction result;
+    result.type = DO_SWEEPING_STEP;
+    result.additional_work = false;
+    return result;
+  }
+
+  static GCIdleTimeAction InstallOptimizedCode() {
+    GCIdleTimeAction result;
+    result.type = DO_INSTALL_OPTIMIZED_CODE;
+    result.additional_work = false;
+    return result;
+  }
+
+  static GCIdleTimeAction UncommitFromSpace() {
+    GCIdleTimeAction result;
+    result.type = DO_UNCOMMIT_FROM_SPACE;
+    result.additional_work = false;
+    return result;
+  }
+
+  static GCIdleTimeAction AgeCompilationCache() {
+    GCIdleTimeAction result;
+    result.type = DO_AGE_COMPILATION_CACHE;
+    result.additional_work = false;
+    return result;
+  }
+
   void Print();
 
   GCIdleTimeActionType type;
@@ -64,11 +96,16 @@ class GCIdleTimeHeapState {
   size_t size_of_objects;
   bool incremental_marking_stopped;
   bool sweeping_in_progress;
+  bool has_pending_sweeping_pages;
   bool sweeping_completed;
   bool has_low_allocation_rate;
   size_t mark_compact_speed_in_bytes_per_ms;
   size_t incremental_marking_speed_in_bytes_per_ms;
   size_t final_incremental_mark_compact_speed_in_bytes_per_ms;
+  size_t sweeping_speed_in_bytes_per_ms;
+  int pending_optimized_code_installs;
+  bool from_space_committed;
+  bool compilation_cache_needs_aging;
 };
 
 
@@ -124,6 +161,24 @@ class GCIdleTimeHandler {
 
   static const size_t kMinTimeForOverApproximatingWeakClosureInMs;
 
+  // If we haven't recorded any idle sweeping steps yet, we conservatively
+  // assume this sweeping speed.
+  static const size_t kInitialConservativeSweepingSpeed = 512 * KB;
+
+  // Sweeping happens page by page, so a sweeping step is only started if at
+  // least one page can be swept in the given idle time. This is the size of
+  // the allocatable area of a page, which is what a sweeping step accounts.
+  static const size_t kSweepingPageSize;
+
+  // Estimated time it takes to install one concurrently optimized function.
+  static const double kInstallOptimizedCodeTimeInMs;
+
+  // Estimated time it takes to uncommit the from-space.
+  static const size_t kUncommitFromSpaceTimeInMs = 1;
+
+  // Estimated time it takes to age the compilation cache.
+  static const size_t kAgeCompilationCacheTimeInMs = 1;
+
   // Number of times we will return a Nothing action in the current mode
   // despite having idle time available before we returning a Done action to
   // ensure we don't keep scheduling idle tasks and making no progress.
@@ -158,9 +213,23 @@ class GCIdleTimeHandler {
 
   static bool ShouldDoOverApproximateWeakClosure(size_t idle_time_in_ms);
 
+  static double EstimateSweepingTime(size_t bytes,
+                                     size_t sweeping_speed_in_bytes_per_ms);
+
+  static bool ShouldDoSweepingStep(size_t idle_time_in_ms,
+                                   size_t sweeping_speed_in_bytes_per_ms);
+
+  static bool ShouldInstallOptimizedCode(size_t idle_time_in_ms,
+                                         int pending_installs);
+
  private:
   GCIdleTimeAction NothingOrDone(double idle_time_in_ms);
 
+  // Picks the deferred non-marking work that fits into the idle time, or
+  // returns Done if there is none.
+  GCIdleTimeAction DeferredWorkOrDone(size_t idle_time_in_ms,
+                                      const GCIdleTimeHeapState& heap_state);
+
   // Idle notifications with no progress.
   int idle_times_which_made_no_progress_;
 
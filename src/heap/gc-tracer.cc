@@ -59,7 +59,12 @@ GCTracer::Event::Event(Type type, const char* gc_reason,
       incremental_marking_duration(0.0),
       cumulative_pure_incremental_marking_duration(0.0),
       pure_incremental_marking_duration(0.0),
-      longest_incremental_marking_step(0.0) {
+      longest_incremental_marking_step(0.0),
+      cumulative_concurrent_marking_duration(0.0),
+      concurrent_marking_duration(0.0),
+      parallel_scavenge_tasks(0),
+      parallel_scavenge_task_duration_sum(0.0),
+      parallel_scavenge_task_duration_max(0.0) {
   for (int i = 0; i < Scope::NUMBER_OF_SCOPES; i++) {
     scopes[i] = 0;
   }
@@ -99,8 +104,11 @@ GCTracer::GCTracer(Heap* heap)
       cumulative_incremental_marking_duration_(0.0),
       cumulative_pure_incremental_marking_duration_(0.0),
       longest_incremental_marking_step_(0.0),
+      cumulative_concurrent_marking_duration_(0.0),
       cumulative_marking_duration_(0.0),
       cumulative_sweeping_duration_(0.0),
+      cumulative_idle_sweeping_bytes_(0),
+      cumulative_idle_sweeping_duration_(0.0),
       allocation_time_ms_(0.0),
       new_space_allocation_counter_bytes_(0),
       old_generation_allocation_counter_bytes_(0),
@@ -154,6 +162,8 @@ void GCTracer::Start(GarbageCollector collector, const char* gc_reason,
   current_.cumulative_pure_incremental_marking_duration =
       cumulative_pure_incremental_marking_duration_;
   current_.longest_incremental_marking_step = longest_incremental_marking_step_;
+  current_.cumulative_concurrent_marking_duration =
+      cumulative_concurrent_marking_duration_;
 
   for (int i = 0; i < Scope::NUMBER_OF_SCOPES; i++) {
     current_.scopes[i] = 0;
@@ -210,6 +220,9 @@ void GCTracer::Stop(GarbageCollector collector) {
     current_.pure_incremental_marking_duration =
         current_.cumulative_pure_incremental_marking_duration -
         previous_.cumulative_pure_incremental_marking_duration;
+    current_.concurrent_marking_duration =
+        current_.cumulative_concurrent_marking_duration -
+        previous_.cumulative_concurrent_marking_duration;
     scavenger_events_.push_front(current_);
   } else if (current_.type == Event::INCREMENTAL_MARK_COMPACTOR) {
     current_.incremental_marking_steps =
@@ -228,6 +241,10 @@ void GCTracer::Stop(GarbageCollector collector) {
         current_.cumulative_pure_incremental_marking_duration -
         previous_incremental_mark_compactor_event_
             .cumulative_pure_incremental_marking_duration;
+    current_.concurrent_marking_duration =
+        current_.cumulative_concurrent_marking_duration -
+        previous_incremental_mark_compactor_event_
+            .cumulative_concurrent_marking_duration;
     longest_incremental_marking_step_ = 0.0;
     incremental_mark_compactor_events_.push_front(current_);
     combined_mark_compact_speed_cache_ = 0.0;
@@ -325,6 +342,21 @@ void GCTracer::AddIncrementalMarkingStep(double duration, intptr_t bytes) {
 }
 
 
+void GCTracer::AddIdleSweepingStep(double duration, intptr_t bytes) {
+  cumulative_idle_sweeping_bytes_ += bytes;
+  cumulative_idle_sweeping_duration_ += duration;
+  cumulative_sweeping_duration_ += duration;
+}
+
+
+void GCTracer::AddParallelScavengeTask(double duration) {
+  current_.parallel_scavenge_tasks++;
+  current_.parallel_scavenge_task_duration_sum += duration;
+  current_.parallel_scavenge_task_duration_max =
+      Max(current_.parallel_scavenge_task_duration_max, duration);
+}
+
+
 void GCTracer::Output(const char* format, ...) const {
   if (FLAG_trace_gc) {
     va_list arguments;
@@ -376,6 +408,10 @@ void GCTracer::Print() const {
           current_.incremental_marking_steps,
           current_.longest_incremental_marking_step);
     }
+    if (current_.concurrent_marking_duration > 0) {
+      Output(" (+ %.1f ms concurrent marking)",
+             current_.concurrent_marking_duration);
+    }
   }
 
   if (current_.gc_reason != NULL) {
@@ -406,6 +442,12 @@ void GCTracer::PrintNVP() const {
       PrintF("scavenge=%.2f ", current_.scopes[Scope::SCAVENGER_SCAVENGE]);
       PrintF("old_new=%.2f ",
              current_.scopes[Scope::SCAVENGER_OLD_TO_NEW_POINTERS]);
+      PrintF("parallel=%.2f ", current_.scopes[Scope::SCAVENGER_PARALLEL]);
+      PrintF("parallel_tasks=%d ", current_.parallel_scavenge_tasks);
+      PrintF("parallel_task_sum=%.2f ",
+             current_.parallel_scavenge_task_duration_sum);
+      PrintF("parallel_task_max=%.2f ",
+             current_.parallel_scavenge_task_duration_max);
       PrintF("weak=%.2f ", current_.scopes[Scope::SCAVENGER_WEAK]);
       PrintF("roots=%.2f ", current_.scopes[Scope::SCAVENGER_ROOTS]);
       PrintF("code=%.2f ",
@@ -457,6 +499,7 @@ void GCTracer::PrintNVP() const {
       PrintF("steps_count=%d ", current_.incremental_marking_steps);
       PrintF("steps_took=%.1f ", current_.incremental_marking_duration);
       PrintF("longest_step=%.1f ", current_.longest_incremental_marking_step);
+      PrintF("concurrent_marking=%.1f ", current_.concurrent_marking_duration);
       PrintF("incremental_marking_throughput=%" V8_PTR_PREFIX "d ",
              IncrementalMarkingSpeedInBytesPerMillisecond());
       break;
@@ -585,6 +628,20 @@ intptr_t GCTracer::IncrementalMarkingSpeedInBytesPerMillisecond() const {
 }
 
 
+intptr_t GCTracer::IdleSweepingSpeedInBytesPerMillisecond() const {
+  if (cumulative_idle_sweeping_bytes_ == 0 ||
+      cumulative_idle_sweeping_duration_ == 0.0) {
+    return 0;
+  }
+  // Make sure the result is at least 1.
+  return Max<intptr_t>(
+      static_cast<intptr_t>(cumulative_idle_sweeping_bytes_ /
+                                cumulative_idle_sweeping_duration_ +
+                            0.5),
+      1);
+}
+
+
 intptr_t GCTracer::ScavengeSpeedInBytesPerMillisecond(
     ScavengeSpeedMode mode) const {
   intptr_t bytes = 0;
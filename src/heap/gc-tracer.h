@@ -123,6 +123,7 @@ class GCTracer {
       SCAVENGER_CODE_FLUSH_CANDIDATES,
       SCAVENGER_OBJECT_GROUPS,
       SCAVENGER_OLD_TO_NEW_POINTERS,
+      SCAVENGER_PARALLEL,
       SCAVENGER_ROOTS,
       SCAVENGER_SCAVENGE,
       SCAVENGER_SEMISPACE,
@@ -286,6 +287,23 @@ class GCTracer {
     // (value at start of event)
     double longest_incremental_marking_step;
 
+    // Cumulative duration of concurrent marking on the background thread
+    // since creation of tracer. (value at start of event)
+    double cumulative_concurrent_marking_duration;
+
+    // Duration of concurrent marking since
+    // - last event for SCAVENGER events
+    // - last INCREMENTAL_MARK_COMPACTOR event for INCREMENTAL_MARK_COMPACTOR
+    // events
+    double concurrent_marking_duration;
+
+    // Number of tasks that participated in a parallel scavenge.
+    int parallel_scavenge_tasks;
+
+    // Sum and maximum of the durations of the parallel scavenge tasks.
+    double parallel_scavenge_task_duration_sum;
+    double parallel_scavenge_task_duration_max;
+
     // Amounts of time spent in different scopes during GC.
     double scopes[Scope::NUMBER_OF_SCOPES];
   };
@@ -326,6 +344,14 @@ class GCTracer {
   // Log an incremental marking step.
   void AddIncrementalMarkingStep(double duration, intptr_t bytes);
 
+  // Log the duration of a task that participated in a parallel scavenge.
+  void AddParallelScavengeTask(double duration);
+
+  // Log time spent in concurrent marking on the background thread.
+  void AddConcurrentMarkingTime(double duration) {
+    cumulative_concurrent_marking_duration_ += duration;
+  }
+
   // Log time spent in marking.
   void AddMarkingTime(double duration) {
     cumulative_marking_duration_ += duration;
@@ -341,6 +367,9 @@ class GCTracer {
     cumulative_sweeping_duration_ += duration;
   }
 
+  // Log a sweeping step done on the main thread in idle time.
+  void AddIdleSweepingStep(double duration, intptr_t bytes);
+
   // Time spent in sweeping on main thread.
   double cumulative_sweeping_duration() const {
     return cumulative_sweeping_duration_;
@@ -386,6 +415,10 @@ class GCTracer {
   // Returns 0 if no events have been recorded.
   intptr_t IncrementalMarkingSpeedInBytesPerMillisecond() const;
 
+  // Compute the average speed of idle time sweeping steps in
+  // bytes/millisecond. Returns 0 if no steps have been recorded.
+  intptr_t IdleSweepingSpeedInBytesPerMillisecond() const;
+
   // Compute the average scavenge speed in bytes/millisecond.
   // Returns 0 if no events have been recorded.
   intptr_t ScavengeSpeedInBytesPerMillisecond(
@@ -472,6 +505,7 @@ class GCTracer {
     cumulative_incremental_marking_duration_ = 0;
     cumulative_pure_incremental_marking_duration_ = 0;
     longest_incremental_marking_step_ = 0;
+    cumulative_concurrent_marking_duration_ = 0;
     cumulative_marking_duration_ = 0;
     cumulative_sweeping_duration_ = 0;
   }
@@ -525,6 +559,10 @@ class GCTracer {
   // Longest incremental marking step since start of marking.
   double longest_incremental_marking_step_;
 
+  // Cumulative duration of concurrent marking on the background thread since
+  // creation of tracer.
+  double cumulative_concurrent_marking_duration_;
+
   // Total marking time.
   // This timer is precise when run with --print-cumulative-gc-stat
   double cumulative_marking_duration_;
@@ -538,6 +576,11 @@ class GCTracer {
   // all sweeping operations performed on the main thread.
   double cumulative_sweeping_duration_;
 
+  // Cumulative size and duration of idle time sweeping steps since creation
+  // of tracer.
+  intptr_t cumulative_idle_sweeping_bytes_;
+  double cumulative_idle_sweeping_duration_;
+
   // Timestamp and allocation counter at the last sampled allocation event.
   double allocation_time_ms_;
   size_t new_space_allocation_counter_bytes_;
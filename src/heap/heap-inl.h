@@ -177,15 +177,17 @@ AllocationResult Heap::AllocateTwoByteInternalizedString(Vector<const uc16> str,
   return answer;
 }
 
-AllocationResult Heap::CopyFixedArray(FixedArray* src) {
+AllocationResult Heap::CopyFixedArray(FixedArray* src,
+                                      PretenureFlag pretenure) {
   if (src->length() == 0) return src;
-  return CopyFixedArrayWithMap(src, src->map());
+  return CopyFixedArrayWithMap(src, src->map(), pretenure);
 }
 
 
-AllocationResult Heap::CopyFixedDoubleArray(FixedDoubleArray* src) {
+AllocationResult Heap::CopyFixedDoubleArray(FixedDoubleArray* src,
+                                            PretenureFlag pretenure) {
   if (src->length() == 0) return src;
-  return CopyFixedDoubleArrayWithMap(src, src->map());
+  return CopyFixedDoubleArrayWithMap(src, src->map(), pretenure);
 }
 
 
@@ -466,11 +468,17 @@ void Heap::MoveBlock(Address dst, Address src, int byte_size) {
 
 
 AllocationMemento* Heap::FindAllocationMemento(HeapObject* object) {
+  return FindAllocationMemento(object, object->Size());
+}
+
+
+AllocationMemento* Heap::FindAllocationMemento(HeapObject* object,
+                                               int object_size) {
   // Check if there is potentially a memento behind the object. If
   // the last word of the memento is on another page we return
   // immediately.
   Address object_address = object->address();
-  Address memento_address = object_address + object->Size();
+  Address memento_address = object_address + object_size;
   Address last_memento_word_address = memento_address + kPointerSize;
   if (!NewSpacePage::OnSamePage(object_address, last_memento_word_address)) {
     return NULL;
@@ -17,6 +17,7 @@
 #include "src/deoptimizer.h"
 #include "src/global-handles.h"
 #include "src/heap/array-buffer-tracker.h"
+#include "src/heap/concurrent-marking.h"
 #include "src/heap/gc-idle-time-handler.h"
 #include "src/heap/gc-tracer.h"
 #include "src/heap/incremental-marking.h"
@@ -100,6 +101,7 @@ Heap::Heap()
       old_gen_exhausted_(false),
       optimize_for_memory_usage_(false),
       inline_allocation_disabled_(false),
+      allocation_steps_paused_(false),
       store_buffer_rebuilder_(store_buffer()),
       total_regexp_code_generated_(0),
       tracer_(nullptr),
@@ -125,6 +127,7 @@ Heap::Heap()
       mark_compact_collector_(nullptr),
       store_buffer_(this),
       incremental_marking_(nullptr),
+      concurrent_marking_(nullptr),
       gc_idle_time_handler_(nullptr),
       memory_reducer_(nullptr),
       object_stats_(nullptr),
@@ -412,6 +415,8 @@ void Heap::GarbageCollectionPrologue() {
     AllowHeapAllocation for_the_first_part_of_prologue;
     gc_count_++;
 
+    AccountExternalMemoryConcurrentlyFreed();
+
     if (FLAG_flush_code) {
       mark_compact_collector()->EnableCodeFlushing(true);
     }
@@ -516,6 +521,16 @@ void Heap::RepairFreeListsAfterDeserialization() {
 }
 
 
+double Heap::PretenureRatioThreshold() {
+  if (!FLAG_adaptive_pretenuring) return AllocationSite::kPretenureRatio;
+  double survival_rate = Min(YoungGenerationSurvivalRate(), 100.0) / 100;
+  return AllocationSite::kMaxPretenureRatio -
+         (AllocationSite::kMaxPretenureRatio -
+          AllocationSite::kMinPretenureRatio) *
+             survival_rate;
+}
+
+
 bool Heap::ProcessPretenuringFeedback() {
   bool trigger_deoptimization = false;
   if (FLAG_allocation_site_pretenuring) {
@@ -532,13 +547,16 @@ bool Heap::ProcessPretenuringFeedback() {
     // allocation sites. We could hold the maybe tenured allocation sites
     // in a seperate data structure if this is a performance problem.
     bool deopt_maybe_tenured = DeoptMaybeTenuredAllocationSites();
+    bool check_tenured_sites =
+        gc_count_ % kTenuredAllocationSitesCheckInterval == 0;
     bool use_scratchpad =
         allocation_sites_scratchpad_length_ < kAllocationSiteScratchpadSize &&
-        !deopt_maybe_tenured;
+        !deopt_maybe_tenured && !check_tenured_sites;
 
     int i = 0;
     Object* list_element = allocation_sites_list();
     bool maximum_size_scavenge = MaximumSizeScavenge();
+    double ratio_threshold = PretenureRatioThreshold();
     while (use_scratchpad ? i < allocation_sites_scratchpad_length_
                           : list_element->IsAllocationSite()) {
       AllocationSite* site =
@@ -546,9 +564,17 @@ bool Heap::ProcessPretenuringFeedback() {
               ? AllocationSite::cast(allocation_sites_scratchpad()->get(i))
               : AllocationSite::cast(list_element);
       allocation_mementos_found += site->memento_found_count();
-      if (site->memento_found_count() > 0) {
+      // A tenured site whose objects died young has no mementos found, but
+      // enough created ones to be judged when the whole list is visited.
+      bool digest_feedback =
+          site->memento_found_count() > 0 ||
+          (!use_scratchpad && site->GetPretenureMode() == TENURED &&
+           site->memento_create_count() >=
+               AllocationSite::kPretenureMinimumCreated);
+      if (digest_feedback) {
         active_allocation_sites++;
-        if (site->DigestPretenuringFeedback(maximum_size_scavenge)) {
+        if (site->DigestPretenuringFeedback(maximum_size_scavenge,
+                                            ratio_threshold)) {
           trigger_deoptimization = true;
         }
         if (site->GetPretenureMode() == TENURED) {
@@ -582,11 +608,13 @@ bool Heap::ProcessPretenuringFeedback() {
          dont_tenure_decisions > 0)) {
       PrintF(
           "GC: (mode, #visited allocation sites, #active allocation sites, "
-          "#mementos, #tenure decisions, #donttenure decisions) "
-          "(%s, %d, %d, %d, %d, %d)\n",
+          "#mementos, #tenure decisions, #donttenure decisions, "
+          "survival rate, ratio threshold) "
+          "(%s, %d, %d, %d, %d, %d, %f, %f)\n",
           use_scratchpad ? "use scratchpad" : "use list", allocation_sites,
           active_allocation_sites, allocation_mementos_found, tenure_decisions,
-          dont_tenure_decisions);
+          dont_tenure_decisions, YoungGenerationSurvivalRate(),
+          ratio_threshold);
     }
   }
   return trigger_deoptimization;
@@ -959,6 +987,9 @@ bool Heap::CollectGarbage(GarbageCollector collector, const char* gc_reason,
   }
 
   {
+    // The concurrent marker must not run while objects are moved.
+    if (FLAG_concurrent_marking) concurrent_marking()->Stop();
+
     tracer()->Start(collector, gc_reason, collector_reason);
     DCHECK(AllowHeapAllocation::IsAllowed());
     DisallowHeapAllocation no_allocation_during_gc;
@@ -1270,8 +1301,9 @@ bool Heap::PerformGarbageCollection(
     Scavenge();
   }
 
-  ProcessPretenuringFeedback();
+  // The pretenuring thresholds depend on the survival rate of this GC.
   UpdateSurvivalStatistics(start_new_space_size);
+  ProcessPretenuringFeedback();
   ConfigureInitialOldGenerationSize();
 
   isolate_->counters()->objs_since_last_young()->Set(0);
@@ -1575,8 +1607,6 @@ void Heap::Scavenge() {
 
   scavenge_collector_->SelectScavengingVisitorsTable();
 
-  array_buffer_tracker()->PrepareDiscoveryInNewSpace();
-
   // Flip the semispaces.  After flipping, to space is empty, from space has
   // live objects.
   new_space_.Flip();
@@ -1603,19 +1633,41 @@ void Heap::Scavenge() {
   promotion_queue_.Initialize();
 
   ScavengeVisitor scavenge_visitor(this);
-  {
-    // Copy roots.
-    GCTracer::Scope gc_scope(tracer(), GCTracer::Scope::SCAVENGER_ROOTS);
-    IterateRoots(&scavenge_visitor, VISIT_ALL_IN_SCAVENGE);
-  }
-
-  {
-    // Copy objects reachable from the old generation.
-    GCTracer::Scope gc_scope(tracer(),
-                             GCTracer::Scope::SCAVENGER_OLD_TO_NEW_POINTERS);
+  const int num_parallel_tasks = ParallelScavenger::NumberOfTasks(this);
+  if (num_parallel_tasks > 1) {
+    // Copy roots and objects reachable from the old generation, including
+    // their transitive closure, in parallel.
+    GCTracer::Scope gc_scope(tracer(), GCTracer::Scope::SCAVENGER_PARALLEL);
     StoreBufferRebuildScope scope(this, store_buffer(),
                                   &ScavengeStoreBufferCallback);
-    store_buffer()->IteratePointersToNewSpace(&Scavenger::ScavengeObject);
+    bool some_pages_to_scan;
+    {
+      ParallelScavenger parallel_scavenger(this, num_parallel_tasks);
+      some_pages_to_scan = parallel_scavenger.ScavengeRootsAndStoreBuffer();
+    }
+    // All objects copied so far have been processed. The promotion queue is
+    // still empty and may have to move out of the way of the new top.
+    new_space_front = new_space_.top();
+    promotion_queue_.SetNewLimit(new_space_front);
+    if (some_pages_to_scan) {
+      store_buffer()->IteratePointersOnScanOnScavengePages(
+          &Scavenger::ScavengeObject);
+    }
+  } else {
+    {
+      // Copy roots.
+      GCTracer::Scope gc_scope(tracer(), GCTracer::Scope::SCAVENGER_ROOTS);
+      IterateRoots(&scavenge_visitor, VISIT_ALL_IN_SCAVENGE);
+    }
+
+    {
+      // Copy objects reachable from the old generation.
+      GCTracer::Scope gc_scope(tracer(),
+                               GCTracer::Scope::SCAVENGER_OLD_TO_NEW_POINTERS);
+      StoreBufferRebuildScope scope(this, store_buffer(),
+                                    &ScavengeStoreBufferCallback);
+      store_buffer()->IteratePointersToNewSpace(&Scavenger::ScavengeObject);
+    }
   }
 
   {
@@ -1677,7 +1729,10 @@ void Heap::Scavenge() {
   new_space_.LowerInlineAllocationLimit(
       new_space_.inline_allocation_limit_step());
 
-  array_buffer_tracker()->FreeDead(true);
+  // Hand surviving ArrayBuffers over to the trackers of their new pages and
+  // release the backing stores of the rest in the background.
+  array_buffer_tracker()->FreeDeadInNewSpace();
+  array_buffer_tracker()->FreeQueuedBackingStores();
 
   // Update how much has survived scavenge.
   IncrementYoungSurvivorsCounter(static_cast<int>(
@@ -2000,6 +2055,14 @@ void Heap::UnregisterArrayBuffer(JSArrayBuffer* buffer) {
 }
 
 
+void Heap::AccountExternalMemoryConcurrentlyFreed() {
+  intptr_t freed = external_memory_concurrently_freed_.Value();
+  if (freed == 0) return;
+  external_memory_concurrently_freed_.Increment(-freed);
+  amount_of_external_allocated_memory_ -= freed;
+}
+
+
 void Heap::ConfigureInitialOldGenerationSize() {
   if (!old_generation_size_configured_ && tracer()->SurvivalEventsRecorded()) {
     old_generation_allocation_limit_ =
@@ -3086,6 +3149,7 @@ AllocationResult Heap::AllocateBytecodeArray(int length,
   instance->set_length(length);
   instance->set_frame_size(frame_size);
   instance->set_parameter_count(parameter_count);
+  instance->set_interrupt_budget(interpreter::Interpreter::InterruptBudget());
   instance->set_constant_pool(constant_pool);
   CopyBytes(instance->GetFirstBytecodeAddress(), raw_bytecodes, length);
 
@@ -3451,6 +3515,9 @@ AllocationResult Heap::Allocate(Map* map, AllocationSpace space,
                                 AllocationSite* allocation_site) {
   DCHECK(gc_state_ == NOT_IN_GC);
   DCHECK(map->instance_type() != MAP_TYPE);
+  // Mementos are only ever found in new space, so pretenured objects do not
+  // get one.
+  if (space != NEW_SPACE) allocation_site = NULL;
   int size = map->instance_size();
   if (allocation_site != NULL) {
     size += AllocationMemento::kSize;
@@ -3558,15 +3625,34 @@ AllocationResult Heap::CopyJSObject(JSObject* source, AllocationSite* site) {
 
   DCHECK(site == NULL || AllocationSite::CanTrack(map->instance_type()));
 
+  // Clones for sites that were decided to be pretenured go to old space,
+  // without a memento. The store buffer cannot tell unboxed double fields
+  // apart from pointers, so objects with such fields stay in new space.
+  PretenureFlag pretenure = NOT_TENURED;
+  if (site != NULL && site->GetPretenureMode() == TENURED &&
+      (!FLAG_unbox_double_fields || map->HasFastPointerLayout())) {
+    pretenure = TENURED;
+    site = NULL;
+  }
+
   int adjusted_object_size =
       site != NULL ? object_size + AllocationMemento::kSize : object_size;
-  AllocationResult allocation = AllocateRaw(adjusted_object_size, NEW_SPACE);
+  AllocationResult allocation =
+      AllocateRaw(adjusted_object_size, SelectSpace(pretenure));
   if (!allocation.To(&clone)) return allocation;
 
-  SLOW_DCHECK(InNewSpace(clone));
-  // Since we know the clone is allocated in new space, we can copy
-  // the contents without worrying about updating the write barrier.
+  // If the clone is allocated in new space, we can copy the contents without
+  // worrying about updating the write barrier. A pretenured clone is still
+  // white, so incremental marking records its slots once it visits it, only
+  // its pointers into new space have to be remembered.
+  SLOW_DCHECK(pretenure == TENURED || InNewSpace(clone));
   CopyBlock(clone->address(), source->address(), object_size);
+  WriteBarrierMode mode = SKIP_WRITE_BARRIER;
+  if (pretenure == TENURED) {
+    RecordWrites(clone->address(), JSObject::kPropertiesOffset,
+                 (object_size - JSObject::kPropertiesOffset) / kPointerSize);
+    mode = UPDATE_WRITE_BARRIER;
+  }
 
   if (site != NULL) {
     AllocationMemento* alloc_memento = reinterpret_cast<AllocationMemento*>(
@@ -3586,22 +3672,23 @@ AllocationResult Heap::CopyJSObject(JSObject* source, AllocationSite* site) {
       if (elements->map() == fixed_cow_array_map()) {
         allocation = FixedArray::cast(elements);
       } else if (source->HasFastDoubleElements()) {
-        allocation = CopyFixedDoubleArray(FixedDoubleArray::cast(elements));
+        allocation = CopyFixedDoubleArray(FixedDoubleArray::cast(elements),
+                                          pretenure);
       } else {
-        allocation = CopyFixedArray(FixedArray::cast(elements));
+        allocation = CopyFixedArray(FixedArray::cast(elements), pretenure);
       }
       if (!allocation.To(&elem)) return allocation;
     }
-    JSObject::cast(clone)->set_elements(elem, SKIP_WRITE_BARRIER);
+    JSObject::cast(clone)->set_elements(elem, mode);
   }
   // Update properties if necessary.
   if (properties->length() > 0) {
     FixedArray* prop = nullptr;
     {
-      AllocationResult allocation = CopyFixedArray(properties);
+      AllocationResult allocation = CopyFixedArray(properties, pretenure);
       if (!allocation.To(&prop)) return allocation;
     }
-    JSObject::cast(clone)->set_properties(prop, SKIP_WRITE_BARRIER);
+    JSObject::cast(clone)->set_properties(prop, mode);
   }
   // Return the new clone.
   return clone;
@@ -3825,11 +3912,12 @@ AllocationResult Heap::CopyFixedArrayAndGrow(FixedArray* src, int grow_by,
 }
 
 
-AllocationResult Heap::CopyFixedArrayWithMap(FixedArray* src, Map* map) {
+AllocationResult Heap::CopyFixedArrayWithMap(FixedArray* src, Map* map,
+                                             PretenureFlag pretenure) {
   int len = src->length();
   HeapObject* obj = nullptr;
   {
-    AllocationResult allocation = AllocateRawFixedArray(len, NOT_TENURED);
+    AllocationResult allocation = AllocateRawFixedArray(len, pretenure);
     if (!allocation.To(&obj)) return allocation;
   }
   if (InNewSpace(obj)) {
@@ -3851,11 +3939,12 @@ AllocationResult Heap::CopyFixedArrayWithMap(FixedArray* src, Map* map) {
 
 
 AllocationResult Heap::CopyFixedDoubleArrayWithMap(FixedDoubleArray* src,
-                                                   Map* map) {
+                                                   Map* map,
+                                                   PretenureFlag pretenure) {
   int len = src->length();
   HeapObject* obj = nullptr;
   {
-    AllocationResult allocation = AllocateRawFixedDoubleArray(len, NOT_TENURED);
+    AllocationResult allocation = AllocateRawFixedDoubleArray(len, pretenure);
     if (!allocation.To(&obj)) return allocation;
   }
   obj->set_map_no_write_barrier(map);
@@ -4169,13 +4258,54 @@ GCIdleTimeHeapState Heap::ComputeHeapState() {
   heap_state.contexts_disposed = contexts_disposed_;
   heap_state.contexts_disposal_rate =
       tracer()->ContextDisposalRateInMilliseconds();
+  heap_state.size_of_objects = static_cast<size_t>(SizeOfObjects());
   heap_state.incremental_marking_stopped = incremental_marking()->IsStopped();
+  heap_state.has_low_allocation_rate = HasLowAllocationRate();
   heap_state.mark_compact_speed_in_bytes_per_ms =
       static_cast<size_t>(tracer()->MarkCompactSpeedInBytesPerMillisecond());
+
+  MarkCompactCollector* collector = mark_compact_collector();
+  heap_state.sweeping_in_progress = collector->sweeping_in_progress();
+  heap_state.has_pending_sweeping_pages =
+      heap_state.sweeping_in_progress && collector->HasPendingSweepingPages();
+  heap_state.sweeping_completed =
+      heap_state.sweeping_in_progress &&
+      (!concurrent_sweeping_enabled() || collector->IsSweepingCompleted());
+  heap_state.sweeping_speed_in_bytes_per_ms = static_cast<size_t>(
+      tracer()->IdleSweepingSpeedInBytesPerMillisecond());
+
+  heap_state.pending_optimized_code_installs =
+      isolate()->concurrent_recompilation_enabled()
+          ? isolate()->optimizing_compile_dispatcher()->OutputQueueLength()
+          : 0;
+  heap_state.from_space_committed = new_space_.IsFromSpaceCommitted();
+  heap_state.compilation_cache_needs_aging =
+      isolate()->compilation_cache()->NeedsAgingInIdleTime();
   return heap_state;
 }
 
 
+void Heap::IdleSweepingStep(double deadline_in_ms) {
+  MarkCompactCollector* collector = mark_compact_collector();
+  double start_ms = MonotonicallyIncreasingTimeInMs();
+  double page_sweeping_time_in_ms = GCIdleTimeHandler::EstimateSweepingTime(
+      GCIdleTimeHandler::kSweepingPageSize,
+      static_cast<size_t>(tracer()->IdleSweepingSpeedInBytesPerMillisecond()));
+  intptr_t swept_bytes =
+      collector->SweepInIdleTime(deadline_in_ms, page_sweeping_time_in_ms);
+  if (swept_bytes > 0) {
+    tracer()->AddIdleSweepingStep(MonotonicallyIncreasingTimeInMs() - start_ms,
+                                  swept_bytes);
+  }
+  // Finalizing only has to wait for the sweeper threads if they are still
+  // busy, which we must not do in idle time.
+  if (!collector->HasPendingSweepingPages() &&
+      (!concurrent_sweeping_enabled() || collector->IsSweepingCompleted())) {
+    collector->EnsureSweepingCompleted();
+  }
+}
+
+
 bool Heap::PerformIdleTimeAction(GCIdleTimeAction action,
                                  GCIdleTimeHeapState heap_state,
                                  double deadline_in_ms) {
@@ -4202,6 +4332,18 @@ bool Heap::PerformIdleTimeAction(GCIdleTimeAction action,
       CollectAllGarbage(kNoGCFlags, "idle notification: contexts disposed");
       break;
     }
+    case DO_SWEEPING_STEP:
+      IdleSweepingStep(deadline_in_ms);
+      break;
+    case DO_INSTALL_OPTIMIZED_CODE:
+      isolate()->optimizing_compile_dispatcher()->InstallOptimizedFunctions();
+      break;
+    case DO_UNCOMMIT_FROM_SPACE:
+      UncommitFromSpace();
+      break;
+    case DO_AGE_COMPILATION_CACHE:
+      isolate()->compilation_cache()->AgeInIdleTime();
+      break;
     case DO_NOTHING:
       break;
   }
@@ -4596,6 +4738,10 @@ void Heap::IterateStrongRoots(ObjectVisitor* v, VisitMode mode) {
       isolate_->global_handles()->IterateNewSpaceStrongAndDependentRoots(v);
       break;
     case VISIT_ALL_IN_SWEEP_NEWSPACE:
+      // Only used for updating pointers after evacuation. The visitor is
+      // thread-safe, so the potentially large set of handles is split up.
+      isolate_->global_handles()->IterateAllRootsInParallel(v);
+      break;
     case VISIT_ALL:
       isolate_->global_handles()->IterateAllRoots(v);
       break;
@@ -5044,6 +5190,7 @@ V8_DECLARE_ONCE(initialize_gc_once);
 static void InitializeGCOnce() {
   Scavenger::Initialize();
   StaticScavengeVisitor::Initialize();
+  ParallelScavenger::Initialize();
   MarkCompactCollector::Initialize();
 }
 
@@ -5076,6 +5223,8 @@ bool Heap::SetUp() {
   // Initialize incremental marking.
   incremental_marking_ = new IncrementalMarking(this);
 
+  concurrent_marking_ = new ConcurrentMarking(this);
+
   // Set up new space.
   if (!new_space_.SetUp(reserved_semispace_size_, max_semi_space_size_)) {
     return false;
@@ -5203,6 +5352,8 @@ void Heap::NotifyDeserializationComplete() {
 
 
 void Heap::TearDown() {
+  if (concurrent_marking_ != nullptr) concurrent_marking_->Stop();
+
 #ifdef VERIFY_HEAP
   if (FLAG_verify_heap) {
     Verify();
@@ -5255,6 +5406,9 @@ void Heap::TearDown() {
     mark_compact_collector_ = nullptr;
   }
 
+  delete concurrent_marking_;
+  concurrent_marking_ = nullptr;
+
   delete incremental_marking_;
   incremental_marking_ = nullptr;
 
@@ -423,6 +423,7 @@ namespace internal {
 
 // Forward declarations.
 class ArrayBufferTracker;
+class ConcurrentMarking;
 class GCIdleTimeAction;
 class GCIdleTimeHandler;
 class GCIdleTimeHeapState;
@@ -905,6 +906,12 @@ class Heap {
   // return NULL;
   inline AllocationMemento* FindAllocationMemento(HeapObject* object);
 
+  // Same as above for an object of known size. This does not read the map of
+  // |object| and can therefore be used while other threads may install a
+  // forwarding address in it.
+  inline AllocationMemento* FindAllocationMemento(HeapObject* object,
+                                                  int object_size);
+
   // Returns false if not able to reserve.
   bool ReserveSpace(Reservation* reservations);
 
@@ -987,12 +994,42 @@ class Heap {
     amount_of_external_allocated_memory_ += delta;
   }
 
+  // External memory released off the main thread, e.g. ArrayBuffer backing
+  // stores freed by sweeper threads, is only recorded here and subtracted
+  // from the amount of external memory by the main thread.
+  void IncrementExternalMemoryConcurrentlyFreed(intptr_t freed) {
+    external_memory_concurrently_freed_.Increment(freed);
+  }
+
+  void AccountExternalMemoryConcurrentlyFreed();
+
   void DeoptMarkedAllocationSites();
 
   bool DeoptMaybeTenuredAllocationSites() {
     return new_space_.IsAtMaximumCapacity() && maximum_size_scavenges_ == 0;
   }
 
+  // Survival rate of the young generation in the last garbage collection, in
+  // percent.
+  double YoungGenerationSurvivalRate() {
+    return promotion_ratio_ + semi_space_copied_rate_;
+  }
+
+  // Returns the ratio of found to created allocation mementos at which an
+  // allocation site is considered for pretenuring. The more of the young
+  // generation survives, the lower it gets.
+  double PretenureRatioThreshold();
+
+  // Tenured allocation sites whose objects all die young never make it into
+  // the scratchpad, because no memento is found for them. Every this many
+  // garbage collections, the whole allocation site list is processed so that
+  // they can be un-pretenured.
+  static const int kTenuredAllocationSitesCheckInterval = 8;
+
+  // TODO(hpayer): Allocation site pretenuring may make this method obsolete.
+  // Re-visit incremental marking heuristics.
+  bool IsHighSurvivalRate() { return high_survival_rate_period_length_ > 0; }
+
   void AddWeakObjectToCodeDependency(Handle<HeapObject> obj,
                                      Handle<DependentCode> dep);
 
@@ -1194,6 +1231,11 @@ class Heap {
   void EnableInlineAllocation();
   void DisableInlineAllocation();
 
+  // Indicates whether allocation steps, which drive incremental marking and
+  // the idle scavenge job, are skipped. They are while parallel scavenge tasks
+  // allocate, since the steps may only run on the main thread.
+  bool allocation_steps_paused() { return allocation_steps_paused_; }
+
   // ===========================================================================
   // Methods triggering GCs. ===================================================
   // ===========================================================================
@@ -1277,6 +1319,8 @@ class Heap {
 
   IncrementalMarking* incremental_marking() { return incremental_marking_; }
 
+  ConcurrentMarking* concurrent_marking() { return concurrent_marking_; }
+
   // ===========================================================================
   // External string table API. ================================================
   // ===========================================================================
@@ -1764,10 +1808,6 @@ class Heap {
   void AddAllocationSiteToScratchpad(AllocationSite* site,
                                      ScratchpadSlotMode mode);
 
-  // TODO(hpayer): Allocation site pretenuring may make this method obsolete.
-  // Re-visit incremental marking heuristics.
-  bool IsHighSurvivalRate() { return high_survival_rate_period_length_ > 0; }
-
   void ConfigureInitialOldGenerationSize();
 
   bool HasLowYoungGenerationAllocationRate();
@@ -1783,6 +1823,10 @@ class Heap {
 
   GCIdleTimeHeapState ComputeHeapState();
 
+  // Sweeps pages on the main thread until |deadline_in_ms| and finalizes
+  // sweeping if nothing is left to do.
+  void IdleSweepingStep(double deadline_in_ms);
+
   bool PerformIdleTimeAction(GCIdleTimeAction action,
                              GCIdleTimeHeapState heap_state,
                              double deadline_in_ms);
@@ -2024,7 +2068,8 @@ class Heap {
   MUST_USE_RESULT AllocationResult AllocateUninitializedFixedArray(int length);
 
   // Make a copy of src and return it.
-  MUST_USE_RESULT inline AllocationResult CopyFixedArray(FixedArray* src);
+  MUST_USE_RESULT inline AllocationResult CopyFixedArray(
+      FixedArray* src, PretenureFlag pretenure = NOT_TENURED);
 
   // Make a copy of src, also grow the copy, and return the copy.
   MUST_USE_RESULT AllocationResult
@@ -2032,11 +2077,12 @@ class Heap {
 
   // Make a copy of src, set the map, and return the copy.
   MUST_USE_RESULT AllocationResult
-      CopyFixedArrayWithMap(FixedArray* src, Map* map);
+      CopyFixedArrayWithMap(FixedArray* src, Map* map,
+                            PretenureFlag pretenure = NOT_TENURED);
 
   // Make a copy of src and return it.
   MUST_USE_RESULT inline AllocationResult CopyFixedDoubleArray(
-      FixedDoubleArray* src);
+      FixedDoubleArray* src, PretenureFlag pretenure = NOT_TENURED);
 
   // Computes a single character string where the character has code.
   // A cache is used for one-byte (Latin1) codes.
@@ -2060,8 +2106,8 @@ class Heap {
   MUST_USE_RESULT AllocationResult CopyAndTenureFixedCOWArray(FixedArray* src);
 
   // Make a copy of src, set the map, and return the copy.
-  MUST_USE_RESULT AllocationResult
-      CopyFixedDoubleArrayWithMap(FixedDoubleArray* src, Map* map);
+  MUST_USE_RESULT AllocationResult CopyFixedDoubleArrayWithMap(
+      FixedDoubleArray* src, Map* map, PretenureFlag pretenure = NOT_TENURED);
 
   // Allocates a fixed double array with uninitialized values. Returns
   MUST_USE_RESULT AllocationResult AllocateUninitializedFixedDoubleArray(
@@ -2194,6 +2240,9 @@ class Heap {
   // for all spaces. This is used to disable allocations in generated code.
   bool inline_allocation_disabled_;
 
+  // Set by the parallel scavenger while its tasks are running.
+  bool allocation_steps_paused_;
+
   // Weak list heads, threaded through the objects.
   // List heads are initialized lazily and contain the undefined_value at start.
   Object* native_contexts_list_;
@@ -2267,6 +2316,8 @@ class Heap {
 
   IncrementalMarking* incremental_marking_;
 
+  ConcurrentMarking* concurrent_marking_;
+
   GCIdleTimeHandler* gc_idle_time_handler_;
 
   MemoryReducer* memory_reducer_;
@@ -2340,6 +2391,8 @@ class Heap {
 
   ArrayBufferTracker* array_buffer_tracker_;
 
+  AtomicNumber<intptr_t> external_memory_concurrently_freed_;
+
   // Classes in "heap" can be friends.
   friend class AlwaysAllocateScope;
   friend class GCCallbacksScope;
@@ -2351,6 +2404,7 @@ class Heap {
   friend class NewSpace;
   friend class ObjectStatsVisitor;
   friend class Page;
+  friend class ParallelScavenger;
   friend class Scavenger;
   friend class StoreBuffer;
 
@@ -7,6 +7,7 @@
 #include "src/code-stubs.h"
 #include "src/compilation-cache.h"
 #include "src/conversions.h"
+#include "src/heap/concurrent-marking.h"
 #include "src/heap/gc-idle-time-handler.h"
 #include "src/heap/gc-tracer.h"
 #include "src/heap/mark-compact-inl.h"
@@ -741,6 +742,12 @@ intptr_t IncrementalMarking::ProcessMarkingDeque(intptr_t bytes_to_process) {
     Map* map = obj->map();
     if (map == filler_map) continue;
 
+    if (FLAG_concurrent_marking &&
+        ConcurrentMarking::CanVisit(heap_, obj, map)) {
+      heap_->concurrent_marking()->Push(obj);
+      continue;
+    }
+
     int size = obj->SizeFromMap(map);
     unscanned_bytes_of_large_object_ = 0;
     VisitObject(map, obj, size);
@@ -769,6 +776,7 @@ void IncrementalMarking::ProcessMarkingDeque() {
 
 void IncrementalMarking::Hurry() {
   if (state() == MARKING) {
+    if (FLAG_concurrent_marking) heap_->concurrent_marking()->Stop();
     double start = 0.0;
     if (FLAG_trace_incremental_marking || FLAG_print_cumulative_gc_stat) {
       start = base::OS::TimeCurrentMillis();
@@ -825,6 +833,7 @@ void IncrementalMarking::Stop() {
   IncrementalMarking::set_should_hurry(false);
   ResetStepCounters();
   if (IsMarking()) {
+    if (FLAG_concurrent_marking) heap_->concurrent_marking()->Stop();
     PatchIncrementalMarkingRecordWriteStubs(heap_,
                                             RecordWriteStub::STORE_BUFFER_ONLY);
     DeactivateIncrementalWriteBarrier();
@@ -1068,8 +1077,20 @@ intptr_t IncrementalMarking::Step(intptr_t allocated_bytes,
         StartMarking();
       }
     } else if (state_ == MARKING) {
+      ConcurrentMarking* concurrent_marking = heap_->concurrent_marking();
+      if (FLAG_concurrent_marking) concurrent_marking->ProcessBailout();
       bytes_processed = ProcessMarkingDeque(bytes_to_process);
-      if (heap_->mark_compact_collector()->marking_deque()->IsEmpty()) {
+      if (FLAG_concurrent_marking) {
+        if (completion == FORCE_COMPLETION &&
+            heap_->mark_compact_collector()->marking_deque()->IsEmpty()) {
+          // Do not wait for the concurrent marker but take over its work.
+          concurrent_marking->Stop();
+        } else {
+          concurrent_marking->StartTaskIfNeeded();
+        }
+      }
+      if (heap_->mark_compact_collector()->marking_deque()->IsEmpty() &&
+          (!FLAG_concurrent_marking || concurrent_marking->IsIdle())) {
         if (completion == FORCE_COMPLETION ||
             IsIdleMarkingDelayCounterLimitReached()) {
           if (FLAG_overapproximate_weak_closure &&
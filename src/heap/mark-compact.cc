@@ -66,7 +66,11 @@ MarkCompactCollector::MarkCompactCollector(Heap* heap)
       compaction_in_progress_(false),
       pending_sweeper_tasks_semaphore_(0),
       pending_compaction_tasks_semaphore_(0),
-      concurrent_compaction_tasks_active_(0) {
+      concurrent_compaction_tasks_active_(0),
+      pending_pointers_updating_tasks_semaphore_(0),
+      pointers_updating_buffers_(nullptr),
+      pointers_updating_pages_(nullptr),
+      next_pointers_updating_item_(0) {
 }
 
 #ifdef VERIFY_HEAP
@@ -497,6 +501,26 @@ class MarkCompactCollector::CompactionTask : public v8::Task {
 };
 
 
+class MarkCompactCollector::PointersUpdatingTask : public v8::Task {
+ public:
+  explicit PointersUpdatingTask(Heap* heap) : heap_(heap) {}
+
+  virtual ~PointersUpdatingTask() {}
+
+ private:
+  // v8::Task overrides.
+  void Run() override {
+    MarkCompactCollector* mark_compact = heap_->mark_compact_collector();
+    mark_compact->UpdatePointersFromWorkItems();
+    mark_compact->pending_pointers_updating_tasks_semaphore_.Signal();
+  }
+
+  Heap* heap_;
+
+  DISALLOW_COPY_AND_ASSIGN(PointersUpdatingTask);
+};
+
+
 class MarkCompactCollector::SweeperTask : public v8::Task {
  public:
   SweeperTask(Heap* heap, PagedSpace* space) : heap_(heap), space_(space) {}
@@ -547,6 +571,52 @@ void MarkCompactCollector::SweepOrWaitUntilSweepingCompleted(Page* page) {
 }
 
 
+intptr_t MarkCompactCollector::SweepInIdleTime(
+    double deadline_in_ms, double page_sweeping_time_in_ms) {
+  DCHECK(sweeping_in_progress_);
+  intptr_t swept_bytes = 0;
+  PagedSpaces spaces(heap());
+  for (PagedSpace* space = spaces.next(); space != NULL;
+       space = spaces.next()) {
+    PageIterator it(space);
+    while (it.has_next()) {
+      Page* p = it.next();
+      if (p->parallel_sweeping_state().Value() ==
+          MemoryChunk::kSweepingPending) {
+        if (heap()->MonotonicallyIncreasingTimeInMs() +
+                page_sweeping_time_in_ms >
+            deadline_in_ms) {
+          return swept_bytes;
+        }
+        bool swept = false;
+        SweepInParallel(p, space, &swept);
+        if (swept) swept_bytes += p->area_size();
+      }
+      if (p == space->end_of_unswept_pages()) break;
+    }
+  }
+  return swept_bytes;
+}
+
+
+bool MarkCompactCollector::HasPendingSweepingPages() {
+  PagedSpaces spaces(heap());
+  for (PagedSpace* space = spaces.next(); space != NULL;
+       space = spaces.next()) {
+    PageIterator it(space);
+    while (it.has_next()) {
+      Page* p = it.next();
+      if (p->parallel_sweeping_state().Value() ==
+          MemoryChunk::kSweepingPending) {
+        return true;
+      }
+      if (p == space->end_of_unswept_pages()) break;
+    }
+  }
+  return false;
+}
+
+
 void MarkCompactCollector::EnsureSweepingCompleted() {
   DCHECK(sweeping_in_progress_ == true);
 
@@ -566,6 +636,7 @@ void MarkCompactCollector::EnsureSweepingCompleted() {
 
   ParallelSweepSpacesComplete();
   sweeping_in_progress_ = false;
+  heap()->AccountExternalMemoryConcurrentlyFreed();
   RefillFreeList(heap()->paged_space(OLD_SPACE));
   RefillFreeList(heap()->paged_space(CODE_SPACE));
   RefillFreeList(heap()->paged_space(MAP_SPACE));
@@ -1733,9 +1804,6 @@ int MarkCompactCollector::DiscoverAndEvacuateBlackObjectsOnPage(
       Object* target = allocation.ToObjectChecked();
 
       MigrateObject(HeapObject::cast(target), object, size, NEW_SPACE, nullptr);
-      if (V8_UNLIKELY(target->IsJSArrayBuffer())) {
-        heap()->array_buffer_tracker()->MarkLive(JSArrayBuffer::cast(target));
-      }
       heap()->IncrementSemiSpaceCopiedObjectSize(size);
     }
     *cells = 0;
@@ -3092,10 +3160,6 @@ bool MarkCompactCollector::TryPromoteObject(HeapObject* object,
   if (allocation.To(&target)) {
     MigrateObject(target, object, object_size, old_space->identity(),
                   &migration_slots_buffer_);
-    // If we end up needing more special cases, we should factor this out.
-    if (V8_UNLIKELY(target->IsJSArrayBuffer())) {
-      heap()->array_buffer_tracker()->Promote(JSArrayBuffer::cast(target));
-    }
     heap()->IncrementPromotedObjectsSize(object_size);
     return true;
   }
@@ -3370,17 +3434,39 @@ bool MarkCompactCollector::EvacuateLiveObjectsFromPage(
 }
 
 
+static const int kMaxCompactionTasks = 8;
+
+
+static int MaxNumberOfCompactionTasks() {
+  if (FLAG_parallel_compaction_tasks > 0) {
+    return Min(kMaxCompactionTasks, FLAG_parallel_compaction_tasks);
+  }
+  return Min(kMaxCompactionTasks,
+             Max(1, base::SysInfo::NumberOfProcessors() - 1));
+}
+
+
 int MarkCompactCollector::NumberOfParallelCompactionTasks() {
   if (!FLAG_parallel_compaction) return 1;
   // We cap the number of parallel compaction tasks by
-  // - (#cores - 1)
+  // - (#cores - 1) or --parallel-compaction-tasks
   // - a value depending on the list of evacuation candidates
   // - a hard limit
   const int kPagesPerCompactionTask = 4;
-  const int kMaxCompactionTasks = 8;
-  return Min(kMaxCompactionTasks,
-             Min(1 + evacuation_candidates_.length() / kPagesPerCompactionTask,
-                 Max(1, base::SysInfo::NumberOfProcessors() - 1)));
+  return Min(1 + evacuation_candidates_.length() / kPagesPerCompactionTask,
+             MaxNumberOfCompactionTasks());
+}
+
+
+int MarkCompactCollector::NumberOfPointersUpdatingTasks(int num_items) {
+  if (!FLAG_parallel_compaction) return 1;
+  // Slots buffer chains and to-space pages are cheap to process compared to
+  // evacuating a page, but their sizes vary a lot. Spawn enough tasks to
+  // balance the load while not wasting time on starting tasks for a handful
+  // of items.
+  const int kItemsPerPointersUpdatingTask = 2;
+  return Max(1, Min(num_items / kItemsPerPointersUpdatingTask,
+                    MaxNumberOfCompactionTasks()));
 }
 
 
@@ -3576,6 +3662,9 @@ static int Sweep(PagedSpace* space, FreeList* free_list, Page* p,
   DCHECK(parallelism == MarkCompactCollector::SWEEP_ON_MAIN_THREAD ||
          sweeping_mode == SWEEP_ONLY);
 
+  // ArrayBuffers are checked against the mark bits cleared below.
+  space->heap()->array_buffer_tracker()->FreeDeadOnSweptPage(p);
+
   Address free_start = p->area_start();
   DCHECK(reinterpret_cast<intptr_t>(free_start) % (32 * kPointerSize) == 0);
   int offsets[16];
@@ -3690,6 +3779,64 @@ void MarkCompactCollector::RemoveObjectSlots(Address start_slot,
 }
 
 
+static void UpdatePointersInToSpacePage(NewSpacePage* page, Address top,
+                                        PointersUpdatingVisitor* visitor) {
+  Address current = page->area_start();
+  Address limit = NewSpacePage::FromLimit(top) == page ? top : page->area_end();
+  while (current < limit) {
+    HeapObject* object = HeapObject::FromAddress(current);
+    Map* map = object->map();
+    int size = object->SizeFromMap(map);
+    object->IterateBody(map->instance_type(), size, visitor);
+    current += size;
+  }
+}
+
+
+void MarkCompactCollector::UpdatePointersFromWorkItems() {
+  PointersUpdatingVisitor updating_visitor(heap());
+  Address top = heap()->new_space()->top();
+  const int num_buffers = pointers_updating_buffers_->length();
+  const int num_items = num_buffers + pointers_updating_pages_->length();
+  while (true) {
+    int item = static_cast<int>(
+        base::NoBarrier_AtomicIncrement(&next_pointers_updating_item_, 1) - 1);
+    if (item >= num_items) break;
+    if (item < num_buffers) {
+      UpdateSlotsRecordedIn(pointers_updating_buffers_->at(item));
+    } else {
+      UpdatePointersInToSpacePage(
+          pointers_updating_pages_->at(item - num_buffers), top,
+          &updating_visitor);
+    }
+  }
+}
+
+
+void MarkCompactCollector::UpdatePointersInParallel(
+    List<SlotsBuffer*>* buffers, List<NewSpacePage*>* pages) {
+  const int num_tasks =
+      NumberOfPointersUpdatingTasks(buffers->length() + pages->length());
+  pointers_updating_buffers_ = buffers;
+  pointers_updating_pages_ = pages;
+  next_pointers_updating_item_ = 0;
+
+  for (int i = 1; i < num_tasks; i++) {
+    V8::GetCurrentPlatform()->CallOnBackgroundThread(
+        new PointersUpdatingTask(heap()), v8::Platform::kShortRunningTask);
+  }
+
+  // Contribute in main thread.
+  UpdatePointersFromWorkItems();
+
+  for (int i = 1; i < num_tasks; i++) {
+    pending_pointers_updating_tasks_semaphore_.Wait();
+  }
+  pointers_updating_buffers_ = nullptr;
+  pointers_updating_pages_ = nullptr;
+}
+
+
 void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
   Heap::RelocationLock relocation_lock(heap());
 
@@ -3710,7 +3857,13 @@ void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
   {
     GCTracer::Scope gc_scope(heap()->tracer(),
                              GCTracer::Scope::MC_UPDATE_POINTERS_TO_EVACUATED);
-    UpdateSlotsRecordedIn(migration_slots_buffer_);
+    // The slots buffers are processed after evacuation of all pages finishes.
+    // Each buffer chain is a work item for the parallel tasks.
+    List<SlotsBuffer*> buffers(evacuation_slots_buffers_.length() + 1);
+    if (migration_slots_buffer_ != NULL) buffers.Add(migration_slots_buffer_);
+    buffers.AddAll(evacuation_slots_buffers_);
+    List<NewSpacePage*> no_pages;
+    UpdatePointersInParallel(&buffers, &no_pages);
     if (FLAG_trace_fragmentation_verbose) {
       PrintF("  migration slots buffer: %d\n",
              SlotsBuffer::SizeOfChain(migration_slots_buffer_));
@@ -3718,33 +3871,30 @@ void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
     slots_buffer_allocator_->DeallocateChain(&migration_slots_buffer_);
     DCHECK(migration_slots_buffer_ == NULL);
 
-    // TODO(hpayer): Process the slots buffers in parallel. This has to be done
-    // after evacuation of all pages finishes.
-    int buffers = evacuation_slots_buffers_.length();
-    for (int i = 0; i < buffers; i++) {
+    int num_buffers = evacuation_slots_buffers_.length();
+    for (int i = 0; i < num_buffers; i++) {
       SlotsBuffer* buffer = evacuation_slots_buffers_[i];
-      UpdateSlotsRecordedIn(buffer);
       slots_buffer_allocator_->DeallocateChain(&buffer);
     }
     evacuation_slots_buffers_.Rewind(0);
   }
 
-  // Second pass: find pointers to new space and update them.
-  PointersUpdatingVisitor updating_visitor(heap());
-
   {
     GCTracer::Scope gc_scope(heap()->tracer(),
                              GCTracer::Scope::MC_UPDATE_NEW_TO_NEW_POINTERS);
-    // Update pointers in to space.
-    SemiSpaceIterator to_it(heap()->new_space());
-    for (HeapObject* object = to_it.Next(); object != NULL;
-         object = to_it.Next()) {
-      Map* map = object->map();
-      object->IterateBody(map->instance_type(), object->SizeFromMap(map),
-                          &updating_visitor);
-    }
+    // Update pointers in to space. Each page is a work item for the parallel
+    // tasks.
+    List<NewSpacePage*> pages;
+    NewSpacePageIterator it(heap()->new_space()->bottom(),
+                            heap()->new_space()->top());
+    while (it.has_next()) pages.Add(it.next());
+    List<SlotsBuffer*> no_buffers;
+    UpdatePointersInParallel(&no_buffers, &pages);
   }
 
+  // Second pass: find pointers to new space and update them.
+  PointersUpdatingVisitor updating_visitor(heap());
+
   {
     GCTracer::Scope gc_scope(heap()->tracer(),
                              GCTracer::Scope::MC_UPDATE_ROOT_TO_NEW_POINTERS);
@@ -3765,13 +3915,24 @@ void MarkCompactCollector::EvacuateNewSpaceAndCandidates() {
     GCTracer::Scope gc_scope(
         heap()->tracer(),
         GCTracer::Scope::MC_UPDATE_POINTERS_BETWEEN_EVACUATED);
+    // Update the slots buffers of the evacuation candidates in parallel.
+    // Rescanning aborted and popular pages is left to the main thread.
+    List<SlotsBuffer*> buffers(npages);
+    for (int i = 0; i < npages; i++) {
+      Page* p = evacuation_candidates_[i];
+      if (p->IsEvacuationCandidate() && p->slots_buffer() != NULL) {
+        buffers.Add(p->slots_buffer());
+      }
+    }
+    List<NewSpacePage*> no_pages;
+    UpdatePointersInParallel(&buffers, &no_pages);
+
     for (int i = 0; i < npages; i++) {
       Page* p = evacuation_candidates_[i];
       DCHECK(p->IsEvacuationCandidate() ||
              p->IsFlagSet(Page::RESCAN_ON_EVACUATION));
 
       if (p->IsEvacuationCandidate()) {
-        UpdateSlotsRecordedIn(p->slots_buffer());
         if (FLAG_trace_fragmentation_verbose) {
           PrintF("  page %p slots buffer: %d\n", reinterpret_cast<void*>(p),
                  SlotsBuffer::SizeOfChain(p->slots_buffer()));
@@ -4286,8 +4447,10 @@ int MarkCompactCollector::SweepInParallel(PagedSpace* space,
 }
 
 
-int MarkCompactCollector::SweepInParallel(Page* page, PagedSpace* space) {
+int MarkCompactCollector::SweepInParallel(Page* page, PagedSpace* space,
+                                          bool* swept) {
   int max_freed = 0;
+  if (swept != NULL) *swept = false;
   if (page->TryLock()) {
     // If this page was already swept in the meantime, we can return here.
     if (page->parallel_sweeping_state().Value() !=
@@ -4316,6 +4479,7 @@ int MarkCompactCollector::SweepInParallel(Page* page, PagedSpace* space) {
     }
     free_list->Concatenate(&private_free_list);
     page->mutex()->Unlock();
+    if (swept != NULL) *swept = true;
   }
   return max_freed;
 }
@@ -4469,10 +4633,18 @@ void MarkCompactCollector::SweepSpaces() {
 
   EvacuateNewSpaceAndCandidates();
 
-  // EvacuateNewSpaceAndCandidates iterates over new space objects and for
-  // ArrayBuffers either re-registers them as live or promotes them. This is
-  // needed to properly free them.
-  heap()->array_buffer_tracker()->FreeDead(false);
+  // The old copies of evacuated ArrayBuffers now hold forwarding addresses.
+  // Hand the survivors over to the trackers of their new pages and free the
+  // backing stores of the rest. Aborted pages were swept during evacuation.
+  ArrayBufferTracker* array_buffer_tracker = heap()->array_buffer_tracker();
+  array_buffer_tracker->FreeDeadInNewSpace();
+  for (int i = 0; i < evacuation_candidates_.length(); i++) {
+    Page* p = evacuation_candidates_[i];
+    if (p->IsEvacuationCandidate()) {
+      array_buffer_tracker->FreeDeadOnEvacuatedPage(p);
+    }
+  }
+  array_buffer_tracker->FreeQueuedBackingStores();
 
   // Clear the marking state of live large objects.
   heap_->lo_space()->ClearMarkingStateOfLiveObjects();
@@ -68,6 +68,11 @@ class Marking : public AllStatic {
   // objects.
   INLINE(static bool IsBlackOrGrey(MarkBit mark_bit)) { return mark_bit.Get(); }
 
+  // Same as above but may be called by the concurrent marker.
+  INLINE(static bool IsBlackOrGreyAtomic(MarkBit mark_bit)) {
+    return mark_bit.AtomicGet();
+  }
+
   INLINE(static void MarkBlack(MarkBit mark_bit)) {
     mark_bit.Set();
     mark_bit.Next().Clear();
@@ -454,8 +459,20 @@ class MarkCompactCollector {
   int SweepInParallel(PagedSpace* space, int required_freed_bytes);
 
   // Sweeps a given page concurrently to the sweeper threads. It returns the
-  // size of the maximum continuous freed memory chunk.
-  int SweepInParallel(Page* page, PagedSpace* space);
+  // size of the maximum continuous freed memory chunk. If |swept| is given,
+  // it is set to whether this thread swept the page, as opposed to finding it
+  // taken or already swept by a sweeper thread.
+  int SweepInParallel(Page* page, PagedSpace* space, bool* swept = NULL);
+
+  // Sweeps pages that have not been picked up by the sweeper threads yet on
+  // the main thread, as long as sweeping another page, estimated to take
+  // |page_sweeping_time_in_ms|, does not exceed |deadline_in_ms|. Returns the
+  // number of bytes swept.
+  intptr_t SweepInIdleTime(double deadline_in_ms,
+                           double page_sweeping_time_in_ms);
+
+  // Returns whether any page is still waiting to be swept.
+  bool HasPendingSweepingPages();
 
   void EnsureSweepingCompleted();
 
@@ -514,6 +531,7 @@ class MarkCompactCollector {
 
  private:
   class CompactionTask;
+  class PointersUpdatingTask;
   class SweeperTask;
 
   explicit MarkCompactCollector(Heap* heap);
@@ -714,6 +732,20 @@ class MarkCompactCollector {
 
   void WaitUntilCompactionCompleted();
 
+  // Updates the slots recorded in |buffers| and the pointers in the objects
+  // on the to-space |pages|. Each slots buffer chain and each page is a work
+  // item that is claimed by one of the parallel tasks.
+  void UpdatePointersInParallel(List<SlotsBuffer*>* buffers,
+                                List<NewSpacePage*>* pages);
+
+  // Processes work items of the current UpdatePointersInParallel() call until
+  // none are left. Runs on the main thread and in PointersUpdatingTasks.
+  void UpdatePointersFromWorkItems();
+
+  // The number of parallel pointers updating tasks for |num_items| work items,
+  // including the main thread.
+  int NumberOfPointersUpdatingTasks(int num_items);
+
   void EvacuateNewSpaceAndCandidates();
 
   void ReleaseEvacuationCandidates();
@@ -790,6 +822,15 @@ class MarkCompactCollector {
   // Number of active compaction tasks (including main thread).
   intptr_t concurrent_compaction_tasks_active_;
 
+  // Semaphore used to synchronize pointers updating tasks.
+  base::Semaphore pending_pointers_updating_tasks_semaphore_;
+
+  // Work items of the UpdatePointersInParallel() call in progress and the
+  // index of the next unclaimed item.
+  List<SlotsBuffer*>* pointers_updating_buffers_;
+  List<NewSpacePage*>* pointers_updating_pages_;
+  base::AtomicWord next_pointers_updating_item_;
+
   friend class Heap;
 };
 
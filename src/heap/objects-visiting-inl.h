@@ -94,9 +94,6 @@ int StaticNewSpaceVisitor<StaticVisitor>::VisitJSArrayBuffer(
 
   JSArrayBuffer::JSArrayBufferIterateBody<
       StaticNewSpaceVisitor<StaticVisitor> >(heap, object);
-  if (!JSArrayBuffer::cast(object)->is_external()) {
-    heap->array_buffer_tracker()->MarkLive(JSArrayBuffer::cast(object));
-  }
   return JSArrayBuffer::kSizeWithInternalFields;
 }
 
@@ -539,10 +536,6 @@ void StaticMarkingVisitor<StaticVisitor>::VisitJSArrayBuffer(
   Heap* heap = map->GetHeap();
 
   JSArrayBuffer::JSArrayBufferIterateBody<StaticVisitor>(heap, object);
-  if (!JSArrayBuffer::cast(object)->is_external() &&
-      !heap->InNewSpace(object)) {
-    heap->array_buffer_tracker()->MarkLive(JSArrayBuffer::cast(object));
-  }
 }
 
 
@@ -4,13 +4,18 @@
 
 #include "src/heap/scavenger.h"
 
+#include "src/base/platform/elapsed-timer.h"
+#include "src/base/platform/platform.h"
+#include "src/base/sys-info.h"
 #include "src/contexts.h"
+#include "src/heap/gc-tracer.h"
 #include "src/heap/heap.h"
 #include "src/heap/objects-visiting-inl.h"
 #include "src/heap/scavenger-inl.h"
 #include "src/isolate.h"
 #include "src/log.h"
 #include "src/profiler/cpu-profiler.h"
+#include "src/v8.h"
 
 namespace v8 {
 namespace internal {
@@ -37,7 +42,8 @@ class ScavengingVisitor : public StaticVisitorBase {
     table_.Register(kVisitFixedDoubleArray, &EvacuateFixedDoubleArray);
     table_.Register(kVisitFixedTypedArray, &EvacuateFixedTypedArray);
     table_.Register(kVisitFixedFloat64Array, &EvacuateFixedFloat64Array);
-    table_.Register(kVisitJSArrayBuffer, &EvacuateJSArrayBuffer);
+    table_.Register(kVisitJSArrayBuffer,
+                    &ObjectEvacuationStrategy<POINTER_OBJECT>::Visit);
 
     table_.Register(
         kVisitNativeContext,
@@ -308,20 +314,6 @@ class ScavengingVisitor : public StaticVisitorBase {
   }
 
 
-  static inline void EvacuateJSArrayBuffer(Map* map, HeapObject** slot,
-                                           HeapObject* object) {
-    ObjectEvacuationStrategy<POINTER_OBJECT>::Visit(map, slot, object);
-
-    Heap* heap = map->GetHeap();
-    MapWord map_word = object->map_word();
-    DCHECK(map_word.IsForwardingAddress());
-    HeapObject* target = map_word.ToForwardingAddress();
-    if (!heap->InNewSpace(target)) {
-      heap->array_buffer_tracker()->Promote(JSArrayBuffer::cast(target));
-    }
-  }
-
-
   static inline void EvacuateByteArray(Map* map, HeapObject** slot,
                                        HeapObject* object) {
     int object_size = reinterpret_cast<ByteArray*>(object)->ByteArraySize();
@@ -431,12 +423,16 @@ void Scavenger::ScavengeObjectSlow(HeapObject** p, HeapObject* object) {
 }
 
 
+bool Scavenger::IsLoggingAndProfilingEnabled() {
+  return FLAG_verify_predictable || isolate()->logger()->is_logging() ||
+         isolate()->cpu_profiler()->is_profiling() ||
+         (isolate()->heap_profiler() != NULL &&
+          isolate()->heap_profiler()->is_tracking_object_moves());
+}
+
+
 void Scavenger::SelectScavengingVisitorsTable() {
-  bool logging_and_profiling =
-      FLAG_verify_predictable || isolate()->logger()->is_logging() ||
-      isolate()->cpu_profiler()->is_profiling() ||
-      (isolate()->heap_profiler() != NULL &&
-       isolate()->heap_profiler()->is_tracking_object_moves());
+  bool logging_and_profiling = IsLoggingAndProfilingEnabled();
 
   if (!heap()->incremental_marking()->IsMarking()) {
     if (!logging_and_profiling) {
@@ -492,5 +488,597 @@ void ScavengeVisitor::ScavengePointer(Object** p) {
                             reinterpret_cast<HeapObject*>(object));
 }
 
+
+// Thread-local key holding the ParallelScavenger::Local of the current task,
+// used by the static new space visitor below.
+static base::Thread::LocalStorageKey parallel_scavenger_local_key;
+
+
+// Per-task state of a parallel scavenge.
+class ParallelScavenger::Local {
+ public:
+  Local(ParallelScavenger* scavenger, int task_id)
+      : scavenger_(scavenger),
+        heap_(scavenger->heap()),
+        task_id_(task_id),
+        semi_space_copied_size_(0),
+        promoted_size_(0),
+        duration_(0.0) {}
+
+  static Local* Current() {
+    return reinterpret_cast<Local*>(
+        base::Thread::GetThreadLocal(parallel_scavenger_local_key));
+  }
+
+  void Enter() {
+    base::Thread::SetThreadLocal(parallel_scavenger_local_key, this);
+    timer_.Start();
+  }
+
+  void Leave() {
+    CloseNewSpaceBuffer();
+    CloseOldSpaceBuffer();
+    duration_ = timer_.Elapsed().InMillisecondsF();
+    base::Thread::SetThreadLocal(parallel_scavenger_local_key, NULL);
+  }
+
+  inline void ScavengePointer(Object** p);
+  inline void ProcessOldToNewSlot(Address slot_address);
+
+  // Processes copied objects until the local work list is empty.
+  void ProcessWork();
+
+  // Merges the results of the task into the heap. Must only be called on the
+  // main thread once all tasks are done.
+  void Finalize();
+
+  List<Entry>* work() { return &work_; }
+  int task_id() const { return task_id_; }
+  double duration() const { return duration_; }
+
+ private:
+  // Linear allocation buffer, used for bump-pointer allocation of copied
+  // objects without synchronization.
+  struct Buffer {
+    Buffer() : top(NULL), limit(NULL) {}
+
+    Address top;
+    Address limit;
+  };
+
+  static const int kBufferSize = 32 * KB;
+  static const int kMaxBufferedObjectSize = kBufferSize / 4;
+  static const int kMinWorkToShare = 64;
+
+  static inline AllocationAlignment AlignmentForVisitorId(int visitor_id);
+  static inline bool IsDataObject(int visitor_id);
+
+  inline HeapObject* AllocateLinearly(Buffer* buffer, int size,
+                                      AllocationAlignment alignment);
+  HeapObject* AllocateInNewSpace(int size, AllocationAlignment alignment);
+  HeapObject* AllocateInOldSpace(int size, AllocationAlignment alignment);
+
+  // Gives back memory for a copy that lost the race for an object.
+  void FreeCopy(HeapObject* target, int size);
+
+  void CloseNewSpaceBuffer();
+  void CloseOldSpaceBuffer();
+
+  void ScavengeObject(HeapObject** slot, HeapObject* object);
+  void IteratePromotedObject(HeapObject* target, int size);
+  void IterateAndRecordPointersToFromSpace(Address start, Address end);
+
+  ParallelScavenger* scavenger_;
+  Heap* heap_;
+  const int task_id_;
+
+  Buffer new_space_buffer_;
+  Buffer old_space_buffer_;
+
+  List<Entry> work_;
+  // Old-to-new slots in promoted objects and in the store buffer that have to
+  // be re-entered into the store buffer.
+  List<Address> surviving_slots_;
+  // Allocation sites of mementos found behind copied objects.
+  List<AllocationSite*> allocation_sites_;
+
+  intptr_t semi_space_copied_size_;
+  intptr_t promoted_size_;
+
+  base::ElapsedTimer timer_;
+  double duration_;
+
+  DISALLOW_COPY_AND_ASSIGN(Local);
+};
+
+
+class ParallelScavenger::Task : public v8::Task {
+ public:
+  Task(ParallelScavenger* scavenger, Local* local)
+      : scavenger_(scavenger), local_(local) {}
+
+  virtual ~Task() {}
+
+ private:
+  // v8::Task overrides.
+  void Run() override {
+    local_->Enter();
+    scavenger_->RunTask(local_);
+    local_->Leave();
+    scavenger_->pending_tasks_semaphore_.Signal();
+  }
+
+  ParallelScavenger* scavenger_;
+  Local* local_;
+
+  DISALLOW_COPY_AND_ASSIGN(Task);
+};
+
+
+// Static visitor for objects copied within new space. Forwards all pointers
+// to the Local of the current task.
+class ParallelScavenger::NewSpaceVisitor
+    : public StaticNewSpaceVisitor<ParallelScavenger::NewSpaceVisitor> {
+ public:
+  static inline void VisitPointer(Heap* heap, Object** p) {
+    Local::Current()->ScavengePointer(p);
+  }
+};
+
+
+class ParallelScavenger::RootVisitor : public ObjectVisitor {
+ public:
+  explicit RootVisitor(Local* local) : local_(local) {}
+
+  void VisitPointer(Object** p) override { local_->ScavengePointer(p); }
+
+  void VisitPointers(Object** start, Object** end) override {
+    for (Object** p = start; p < end; p++) local_->ScavengePointer(p);
+  }
+
+ private:
+  Local* local_;
+};
+
+
+// static
+AllocationAlignment ParallelScavenger::Local::AlignmentForVisitorId(
+    int visitor_id) {
+  switch (visitor_id) {
+    case StaticVisitorBase::kVisitFixedDoubleArray:
+    case StaticVisitorBase::kVisitFixedFloat64Array:
+      return kDoubleAligned;
+    default:
+      return kWordAligned;
+  }
+}
+
+
+// static
+bool ParallelScavenger::Local::IsDataObject(int visitor_id) {
+  switch (visitor_id) {
+    case StaticVisitorBase::kVisitSeqOneByteString:
+    case StaticVisitorBase::kVisitSeqTwoByteString:
+    case StaticVisitorBase::kVisitByteArray:
+    case StaticVisitorBase::kVisitFixedDoubleArray:
+    case StaticVisitorBase::kVisitFixedTypedArray:
+    case StaticVisitorBase::kVisitFixedFloat64Array:
+      return true;
+    default:
+      return visitor_id >= StaticVisitorBase::kVisitDataObject &&
+             visitor_id <= StaticVisitorBase::kVisitDataObjectGeneric;
+  }
+}
+
+
+HeapObject* ParallelScavenger::Local::AllocateLinearly(
+    Buffer* buffer, int size, AllocationAlignment alignment) {
+  if (buffer->top == NULL) return NULL;
+  int filler_size = Heap::GetFillToAlign(buffer->top, alignment);
+  if (buffer->limit - buffer->top < size + filler_size) return NULL;
+  HeapObject* object = HeapObject::FromAddress(buffer->top);
+  buffer->top += size + filler_size;
+  if (filler_size > 0) object = heap_->PrecedeWithFiller(object, filler_size);
+  return object;
+}
+
+
+HeapObject* ParallelScavenger::Local::AllocateInNewSpace(
+    int size, AllocationAlignment alignment) {
+  HeapObject* result = AllocateLinearly(&new_space_buffer_, size, alignment);
+  if (result != NULL) return result;
+  if (size <= kMaxBufferedObjectSize) {
+    CloseNewSpaceBuffer();
+    AllocationResult allocation =
+        scavenger_->AllocateInNewSpace(kBufferSize, kWordAligned);
+    HeapObject* buffer = NULL;
+    if (allocation.To(&buffer)) {
+      new_space_buffer_.top = buffer->address();
+      new_space_buffer_.limit = buffer->address() + kBufferSize;
+      result = AllocateLinearly(&new_space_buffer_, size, alignment);
+      DCHECK(result != NULL);
+      return result;
+    }
+  }
+  // Either the object is too large for a buffer or there is not enough room
+  // left for a whole buffer.
+  AllocationResult allocation = scavenger_->AllocateInNewSpace(size, alignment);
+  return allocation.To(&result) ? result : NULL;
+}
+
+
+HeapObject* ParallelScavenger::Local::AllocateInOldSpace(
+    int size, AllocationAlignment alignment) {
+  HeapObject* result = AllocateLinearly(&old_space_buffer_, size, alignment);
+  if (result != NULL) return result;
+  if (size <= kMaxBufferedObjectSize) {
+    CloseOldSpaceBuffer();
+    AllocationResult allocation =
+        scavenger_->AllocateInOldSpace(kBufferSize, kWordAligned);
+    HeapObject* buffer = NULL;
+    if (allocation.To(&buffer)) {
+      old_space_buffer_.top = buffer->address();
+      old_space_buffer_.limit = buffer->address() + kBufferSize;
+      result = AllocateLinearly(&old_space_buffer_, size, alignment);
+      DCHECK(result != NULL);
+      return result;
+    }
+  }
+  AllocationResult allocation = scavenger_->AllocateInOldSpace(size, alignment);
+  return allocation.To(&result) ? result : NULL;
+}
+
+
+void ParallelScavenger::Local::FreeCopy(HeapObject* target, int size) {
+  Address address = target->address();
+  if (address + size == new_space_buffer_.top) {
+    new_space_buffer_.top = address;
+  } else if (address + size == old_space_buffer_.top) {
+    old_space_buffer_.top = address;
+  } else {
+    heap_->CreateFillerObjectAt(address, size);
+  }
+}
+
+
+void ParallelScavenger::Local::CloseNewSpaceBuffer() {
+  Buffer* buffer = &new_space_buffer_;
+  if (buffer->top < buffer->limit) {
+    heap_->CreateFillerObjectAt(buffer->top,
+                                static_cast<int>(buffer->limit - buffer->top));
+  }
+  buffer->top = buffer->limit = NULL;
+}
+
+
+void ParallelScavenger::Local::CloseOldSpaceBuffer() {
+  Buffer* buffer = &old_space_buffer_;
+  if (buffer->top < buffer->limit) {
+    scavenger_->FreeInOldSpace(buffer->top,
+                               static_cast<int>(buffer->limit - buffer->top));
+  }
+  buffer->top = buffer->limit = NULL;
+}
+
+
+void ParallelScavenger::Local::ScavengePointer(Object** p) {
+  Object* object = *p;
+  if (!heap_->InFromSpace(object)) return;
+  ScavengeObject(reinterpret_cast<HeapObject**>(p),
+                 reinterpret_cast<HeapObject*>(object));
+}
+
+
+void ParallelScavenger::Local::ProcessOldToNewSlot(Address slot_address) {
+  Object** slot = reinterpret_cast<Object**>(slot_address);
+  Object* object = *slot;
+  // Store buffer entries may be duplicated, also across chunks processed by
+  // different tasks. A slot that is not pointing to from space anymore was
+  // already updated and recorded by the task that processed it first.
+  if (!heap_->InFromSpace(object)) return;
+  ScavengeObject(reinterpret_cast<HeapObject**>(slot),
+                 reinterpret_cast<HeapObject*>(object));
+  if (heap_->InToSpace(*slot)) surviving_slots_.Add(slot_address);
+}
+
+
+void ParallelScavenger::Local::ScavengeObject(HeapObject** slot,
+                                              HeapObject* object) {
+  DCHECK(heap_->InFromSpace(object));
+  MapWord first_word = object->synchronized_map_word();
+  if (first_word.IsForwardingAddress()) {
+    *slot = first_word.ToForwardingAddress();
+    return;
+  }
+
+  Map* map = first_word.ToMap();
+  DCHECK(map != heap_->allocation_memento_map());
+  int size = object->SizeFromMap(map);
+  int visitor_id = map->visitor_id();
+  AllocationAlignment alignment = AlignmentForVisitorId(visitor_id);
+  SLOW_DCHECK(size <= Page::kMaxRegularHeapObjectSize);
+
+  // Same policy as the sequential scavenger: copy within new space unless the
+  // object is old enough, and fall back to the other space on failure.
+  HeapObject* target = NULL;
+  bool promoted = false;
+  if (!heap_->ShouldBePromoted(object->address(), size)) {
+    target = AllocateInNewSpace(size, alignment);
+  }
+  if (target == NULL) {
+    target = AllocateInOldSpace(size, alignment);
+    promoted = target != NULL;
+  }
+  if (target == NULL) target = AllocateInNewSpace(size, alignment);
+  if (target == NULL) {
+    V8::FatalProcessOutOfMemory("ParallelScavenger::ScavengeObject");
+  }
+
+  heap_->CopyBlock(target->address(), object->address(), size);
+  if (!object->release_compare_and_swap_map_word(
+          first_word, MapWord::FromForwardingAddress(target))) {
+    // Another task copied the object first.
+    FreeCopy(target, size);
+    *slot = object->synchronized_map_word().ToForwardingAddress();
+    return;
+  }
+  *slot = target;
+
+  if (FLAG_allocation_site_pretenuring &&
+      AllocationSite::CanTrack(map->instance_type())) {
+    AllocationMemento* memento = heap_->FindAllocationMemento(object, size);
+    if (memento != NULL) allocation_sites_.Add(memento->GetAllocationSite());
+  }
+
+  if (visitor_id == StaticVisitorBase::kVisitFixedTypedArray ||
+      visitor_id == StaticVisitorBase::kVisitFixedFloat64Array) {
+    FixedTypedArrayBase* array = reinterpret_cast<FixedTypedArrayBase*>(target);
+    if (array->base_pointer() != Smi::FromInt(0)) {
+      array->set_base_pointer(array, SKIP_WRITE_BARRIER);
+    }
+  }
+
+  if (promoted) {
+    promoted_size_ += size;
+    if (!IsDataObject(visitor_id)) {
+      int scan_size = visitor_id == StaticVisitorBase::kVisitJSFunction
+                          ? JSFunction::kNonWeakFieldsEndOffset
+                          : size;
+      work_.Add(Entry(target, scan_size));
+    }
+  } else {
+    semi_space_copied_size_ += size;
+    work_.Add(Entry(target, 0));
+  }
+}
+
+
+void ParallelScavenger::Local::IteratePromotedObject(HeapObject* target,
+                                                     int size) {
+  DCHECK(!target->IsMap());
+  Address obj_address = target->address();
+#if V8_DOUBLE_FIELDS_UNBOXING
+  LayoutDescriptorHelper helper(target->map());
+  if (!helper.all_fields_tagged()) {
+    for (int offset = 0; offset < size;) {
+      int end_of_region_offset;
+      if (helper.IsTagged(offset, size, &end_of_region_offset)) {
+        IterateAndRecordPointersToFromSpace(obj_address + offset,
+                                            obj_address + end_of_region_offset);
+      }
+      offset = end_of_region_offset;
+    }
+    return;
+  }
+#endif
+  IterateAndRecordPointersToFromSpace(obj_address, obj_address + size);
+}
+
+
+void ParallelScavenger::Local::IterateAndRecordPointersToFromSpace(
+    Address start, Address end) {
+  for (Address slot_address = start; slot_address < end;
+       slot_address += kPointerSize) {
+    Object** slot = reinterpret_cast<Object**>(slot_address);
+    Object* target = *slot;
+    if (target->IsHeapObject() && heap_->InFromSpace(target)) {
+      ScavengeObject(reinterpret_cast<HeapObject**>(slot),
+                     HeapObject::cast(target));
+      if (heap_->InNewSpace(*slot)) surviving_slots_.Add(slot_address);
+    }
+  }
+}
+
+
+void ParallelScavenger::Local::ProcessWork() {
+  while (!work_.is_empty()) {
+    if (work_.length() >= kMinWorkToShare && scavenger_->IsWorkRequested()) {
+      scavenger_->ShareWork(&work_);
+    }
+    Entry entry = work_.RemoveLast();
+    if (entry.size == 0) {
+      NewSpaceVisitor::IterateBody(entry.object->map(), entry.object);
+    } else {
+      IteratePromotedObject(entry.object, entry.size);
+    }
+  }
+}
+
+
+void ParallelScavenger::Local::Finalize() {
+  DCHECK(work_.is_empty());
+  StoreBuffer* store_buffer = heap_->store_buffer();
+  for (int i = 0; i < surviving_slots_.length(); i++) {
+    store_buffer->EnterDirectlyIntoStoreBuffer(surviving_slots_[i]);
+  }
+  for (int i = 0; i < allocation_sites_.length(); i++) {
+    AllocationSite* site = allocation_sites_[i];
+    if (site->IncrementMementoFoundCount()) {
+      heap_->AddAllocationSiteToScratchpad(site, Heap::IGNORE_SCRATCHPAD_SLOT);
+    }
+  }
+  heap_->IncrementSemiSpaceCopiedObjectSize(
+      static_cast<int>(semi_space_copied_size_));
+  heap_->IncrementPromotedObjectsSize(static_cast<int>(promoted_size_));
+}
+
+
+ParallelScavenger::ParallelScavenger(Heap* heap, int num_tasks)
+    : heap_(heap),
+      num_tasks_(num_tasks),
+      locals_(new Local*[num_tasks]),
+      store_buffer_start_(NULL),
+      store_buffer_end_(NULL),
+      next_store_buffer_chunk_(0),
+      active_tasks_(0),
+      shared_work_requested_(0),
+      pending_tasks_semaphore_(0) {
+  DCHECK(num_tasks_ > 1 && num_tasks_ <= kMaxTasks);
+  for (int i = 0; i < num_tasks_; i++) locals_[i] = new Local(this, i);
+}
+
+
+ParallelScavenger::~ParallelScavenger() {
+  for (int i = 0; i < num_tasks_; i++) delete locals_[i];
+  delete[] locals_;
+}
+
+
+// static
+void ParallelScavenger::Initialize() {
+  parallel_scavenger_local_key = base::Thread::CreateThreadLocalKey();
+  NewSpaceVisitor::Initialize();
+}
+
+
+// static
+int ParallelScavenger::NumberOfTasks(Heap* heap) {
+  if (!FLAG_parallel_scavenge) return 1;
+  // Transferring marks and recording slots for incremental marking as well as
+  // reporting moved objects to the profilers is only implemented by the
+  // sequential scavenger.
+  if (heap->incremental_marking()->IsMarking()) return 1;
+  if (heap->scavenge_collector_->IsLoggingAndProfilingEnabled()) return 1;
+  if (FLAG_parallel_scavenge_tasks > 0) {
+    return Min(kMaxTasks, FLAG_parallel_scavenge_tasks);
+  }
+  // Like for parallel compaction, the main thread takes part as well, so we
+  // use at most (#cores - 1) tasks.
+  return Min(kMaxTasks, Max(1, base::SysInfo::NumberOfProcessors() - 1));
+}
+
+
+bool ParallelScavenger::ScavengeRootsAndStoreBuffer() {
+  bool some_pages_to_scan = heap_->store_buffer()->PrepareForParallelIteration(
+      &store_buffer_start_, &store_buffer_end_);
+
+  // All tasks count as active until they ran out of work for the first time.
+  active_tasks_ = num_tasks_;
+  heap_->allocation_steps_paused_ = true;
+  for (int i = 1; i < num_tasks_; i++) {
+    V8::GetCurrentPlatform()->CallOnBackgroundThread(
+        new Task(this, locals_[i]), v8::Platform::kShortRunningTask);
+  }
+
+  // The main thread processes the roots and then joins the other tasks.
+  Local* local = locals_[0];
+  local->Enter();
+  RootVisitor root_visitor(local);
+  heap_->IterateRoots(&root_visitor, VISIT_ALL_IN_SCAVENGE);
+  RunTask(local);
+  local->Leave();
+
+  for (int i = 1; i < num_tasks_; i++) pending_tasks_semaphore_.Wait();
+  heap_->allocation_steps_paused_ = false;
+
+  for (int i = 0; i < num_tasks_; i++) {
+    locals_[i]->Finalize();
+    heap_->tracer()->AddParallelScavengeTask(locals_[i]->duration());
+    if (FLAG_trace_parallel_scavenge) {
+      PrintIsolate(heap_->isolate(), "parallel scavenge task %d: %.1f ms\n",
+                   locals_[i]->task_id(), locals_[i]->duration());
+    }
+  }
+  DCHECK(shared_work_.is_empty());
+  return some_pages_to_scan;
+}
+
+
+bool ParallelScavenger::ClaimStoreBufferChunk(Address** start, Address** end) {
+  intptr_t size = store_buffer_end_ - store_buffer_start_;
+  intptr_t index =
+      base::NoBarrier_AtomicIncrement(&next_store_buffer_chunk_, 1) - 1;
+  intptr_t chunk_start = index * kStoreBufferChunkSize;
+  if (chunk_start >= size) return false;
+  *start = store_buffer_start_ + chunk_start;
+  *end = store_buffer_start_ + Min(size, chunk_start + kStoreBufferChunkSize);
+  return true;
+}
+
+
+AllocationResult ParallelScavenger::AllocateInNewSpace(
+    int size_in_bytes, AllocationAlignment alignment) {
+  base::LockGuard<base::Mutex> guard(&allocation_mutex_);
+  return heap_->new_space()->AllocateRaw(size_in_bytes, alignment);
+}
+
+
+AllocationResult ParallelScavenger::AllocateInOldSpace(
+    int size_in_bytes, AllocationAlignment alignment) {
+  base::LockGuard<base::Mutex> guard(&allocation_mutex_);
+  return heap_->old_space()->AllocateRaw(size_in_bytes, alignment);
+}
+
+
+void ParallelScavenger::FreeInOldSpace(Address start, int size_in_bytes) {
+  base::LockGuard<base::Mutex> guard(&allocation_mutex_);
+  heap_->old_space()->Free(start, size_in_bytes);
+}
+
+
+void ParallelScavenger::ShareWork(List<Entry>* work) {
+  base::LockGuard<base::Mutex> guard(&work_mutex_);
+  int count = work->length() / 2;
+  for (int i = 0; i < count; i++) shared_work_.Add(work->RemoveLast());
+  base::NoBarrier_Store(&shared_work_requested_, 0);
+  work_available_.NotifyAll();
+}
+
+
+bool ParallelScavenger::WaitForWork(List<Entry>* work) {
+  DCHECK(work->is_empty());
+  base::LockGuard<base::Mutex> guard(&work_mutex_);
+  active_tasks_--;
+  while (shared_work_.is_empty()) {
+    if (active_tasks_ == 0) {
+      // Nobody is left to produce more work.
+      work_available_.NotifyAll();
+      return false;
+    }
+    base::NoBarrier_Store(&shared_work_requested_, 1);
+    work_available_.Wait(&work_mutex_);
+  }
+  active_tasks_++;
+  int count = (shared_work_.length() + 1) / 2;
+  for (int i = 0; i < count; i++) work->Add(shared_work_.RemoveLast());
+  return true;
+}
+
+
+void ParallelScavenger::RunTask(Local* local) {
+  DCHECK_EQ(local, Local::Current());
+  do {
+    Address* start;
+    Address* end;
+    while (ClaimStoreBufferChunk(&start, &end)) {
+      for (Address* current = start; current < end; current++) {
+        local->ProcessOldToNewSlot(*current);
+      }
+      local->ProcessWork();
+    }
+    local->ProcessWork();
+  } while (WaitForWork(local->work()));
+}
+
 }  // namespace internal
 }  // namespace v8
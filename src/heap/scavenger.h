@@ -5,6 +5,9 @@
 #ifndef V8_HEAP_SCAVENGER_H_
 #define V8_HEAP_SCAVENGER_H_
 
+#include "src/base/platform/condition-variable.h"
+#include "src/base/platform/mutex.h"
+#include "src/base/platform/semaphore.h"
 #include "src/heap/objects-visiting.h"
 
 namespace v8 {
@@ -33,6 +36,10 @@ class Scavenger {
   // of the heap (i.e. incremental marking, logging and profiling).
   void SelectScavengingVisitorsTable();
 
+  // Returns true if copied objects have to be reported to the logger or the
+  // profilers.
+  bool IsLoggingAndProfilingEnabled();
+
   Isolate* isolate();
   Heap* heap() { return heap_; }
 
@@ -42,6 +49,98 @@ class Scavenger {
 };
 
 
+// Scavenges the objects reachable from the roots and from old-to-new slots
+// recorded in the store buffer using several tasks. Every task copies objects
+// into its own linear allocation buffers in to-space and old space and
+// installs forwarding addresses with a compare-and-swap. The task that loses
+// the race for an object discards its copy. Newly copied objects are
+// processed in task-local work lists that are balanced through a shared pool.
+class ParallelScavenger {
+ public:
+  ParallelScavenger(Heap* heap, int num_tasks);
+  ~ParallelScavenger();
+
+  // Initializes static visitor dispatch tables.
+  static void Initialize();
+
+  // Returns the number of tasks to use for the current scavenge, or 1 if the
+  // roots and the store buffer have to be processed sequentially.
+  static int NumberOfTasks(Heap* heap);
+
+  // Scavenges all objects transitively reachable from the roots and from the
+  // slots in the store buffer. Surviving old-to-new slots are re-entered into
+  // the store buffer, which has to be in rebuilding mode. Pages marked as
+  // scan-on-scavenge are not processed; returns true if there are such pages.
+  bool ScavengeRootsAndStoreBuffer();
+
+ private:
+  class Local;
+  class NewSpaceVisitor;
+  class RootVisitor;
+  class Task;
+
+  struct Entry {
+    Entry() : object(NULL), size(0) {}
+    Entry(HeapObject* object, int size) : object(object), size(size) {}
+
+    HeapObject* object;
+    // Size of the region to scan for promoted objects, 0 for objects that
+    // were copied within new space.
+    int size;
+  };
+
+  static const int kStoreBufferChunkSize = 1024;
+  static const int kMaxTasks = 8;
+
+  Heap* heap() { return heap_; }
+
+  // Claims the next chunk of store buffer slots. Returns false if all chunks
+  // have been claimed.
+  bool ClaimStoreBufferChunk(Address** start, Address** end);
+
+  // Allocates memory in the shared spaces on behalf of a task.
+  AllocationResult AllocateInNewSpace(int size_in_bytes,
+                                      AllocationAlignment alignment);
+  AllocationResult AllocateInOldSpace(int size_in_bytes,
+                                      AllocationAlignment alignment);
+  void FreeInOldSpace(Address start, int size_in_bytes);
+
+  // Returns true if an idle task is waiting for shared work.
+  bool IsWorkRequested() {
+    return base::NoBarrier_Load(&shared_work_requested_) != 0;
+  }
+
+  // Moves half of the work of a task to the shared pool.
+  void ShareWork(List<Entry>* work);
+
+  // Called by a task that ran out of work. Returns true and refills |work| if
+  // there is shared work left, returns false when all tasks are done.
+  bool WaitForWork(List<Entry>* work);
+
+  void RunTask(Local* local);
+
+  Heap* heap_;
+  const int num_tasks_;
+  Local** locals_;
+
+  Address* store_buffer_start_;
+  Address* store_buffer_end_;
+  base::AtomicWord next_store_buffer_chunk_;
+
+  base::Mutex allocation_mutex_;
+
+  base::Mutex work_mutex_;
+  base::ConditionVariable work_available_;
+  List<Entry> shared_work_;
+  int active_tasks_;
+  base::AtomicWord shared_work_requested_;
+
+  base::Semaphore pending_tasks_semaphore_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelScavenger);
+};
+
+
 // Helper class for turning the scavenger into an object visitor that is also
 // filtering out non-HeapObjects and objects which do not reside in new space.
 class ScavengeVisitor : public ObjectVisitor {
@@ -7,6 +7,7 @@
 #include "src/base/bits.h"
 #include "src/base/platform/platform.h"
 #include "src/full-codegen/full-codegen.h"
+#include "src/heap/array-buffer-tracker.h"
 #include "src/heap/slots-buffer.h"
 #include "src/macro-assembler.h"
 #include "src/msan.h"
@@ -483,6 +484,7 @@ MemoryChunk* MemoryChunk::Initialize(Heap* heap, Address base, size_t size,
   chunk->SetFlag(WAS_SWEPT);
   chunk->set_next_chunk(nullptr);
   chunk->set_prev_chunk(nullptr);
+  chunk->local_tracker_ = nullptr;
 
   DCHECK(OFFSET_OF(MemoryChunk, flags_) == kFlagsOffset);
   DCHECK(OFFSET_OF(MemoryChunk, live_byte_count_) == kLiveBytesOffset);
@@ -934,6 +936,7 @@ void MemoryChunk::ReleaseAllocatedMemory() {
   delete slots_buffer_;
   delete skip_list_;
   delete mutex_;
+  delete local_tracker_;
 }
 
 
@@ -1510,6 +1513,9 @@ bool NewSpace::EnsureAllocation(int size_in_bytes,
 
 
 void NewSpace::InlineAllocationStep(Address top, Address new_top) {
+  // While steps are paused, the bytes allocated are accounted for by the
+  // next step.
+  if (heap()->allocation_steps_paused()) return;
   if (top_on_previous_step_) {
     int bytes_allocated = static_cast<int>(top - top_on_previous_step_);
     heap()->ScheduleIdleScavengeIfNeeded(bytes_allocated);
@@ -2390,8 +2396,10 @@ HeapObject* FreeList::Allocate(int size_in_bytes) {
   owner_->Free(owner_->top(), old_linear_size);
   owner_->SetTopAndLimit(nullptr, nullptr);
 
-  owner_->heap()->incremental_marking()->OldSpaceStep(size_in_bytes -
-                                                      old_linear_size);
+  if (!owner_->heap()->allocation_steps_paused()) {
+    owner_->heap()->incremental_marking()->OldSpaceStep(size_in_bytes -
+                                                        old_linear_size);
+  }
 
   int new_node_size = 0;
   FreeSpace* new_node = FindNodeFor(size_in_bytes, &new_node_size);
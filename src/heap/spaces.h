@@ -129,6 +129,14 @@ class MarkBit {
   inline bool Get() { return (*cell_ & mask_) != 0; }
   inline void Clear() { *cell_ &= ~mask_; }
 
+  // Reads the bit while the main thread may update the cell. Only used by
+  // the concurrent marker, which never writes mark bits itself.
+  inline bool AtomicGet() {
+    base::Atomic32 value =
+        base::NoBarrier_Load(reinterpret_cast<base::Atomic32*>(cell_));
+    return (static_cast<CellType>(value) & mask_) != 0;
+  }
+
   CellType* cell_;
   CellType mask_;
 
@@ -259,6 +267,7 @@ class Bitmap {
 };
 
 
+class LocalArrayBufferTracker;
 class SkipList;
 class SlotsBuffer;
 
@@ -383,7 +392,8 @@ class MemoryChunk {
       + kPointerSize      // AtomicValue parallel_compaction_
       + 5 * kPointerSize  // AtomicNumber free-list statistics
       + kPointerSize      // AtomicValue next_chunk_
-      + kPointerSize;     // AtomicValue prev_chunk_
+      + kPointerSize      // AtomicValue prev_chunk_
+      + kPointerSize;     // LocalArrayBufferTracker* local_tracker_
 
   // We add some more space to the computed header size to amount for missing
   // alignment requirements in our computation.
@@ -672,6 +682,14 @@ class MemoryChunk {
 
   inline SlotsBuffer** slots_buffer_address() { return &slots_buffer_; }
 
+  // Backing stores of the ArrayBuffers on this chunk, created lazily by the
+  // ArrayBufferTracker.
+  inline LocalArrayBufferTracker* local_tracker() { return local_tracker_; }
+
+  inline void set_local_tracker(LocalArrayBufferTracker* local_tracker) {
+    local_tracker_ = local_tracker;
+  }
+
   void MarkEvacuationCandidate() {
     DCHECK(!IsFlagSet(NEVER_EVACUATE));
     DCHECK(slots_buffer_ == NULL);
@@ -744,6 +762,8 @@ class MemoryChunk {
   // prev_chunk_ holds a pointer of type MemoryChunk
   AtomicValue<MemoryChunk*> prev_chunk_;
 
+  LocalArrayBufferTracker* local_tracker_;
+
  private:
   void InitializeReservedMemory() { reservation_.Reset(); }
 
@@ -412,6 +412,18 @@ void StoreBuffer::VerifyValidStoreBufferEntries() {
 }
 
 
+bool StoreBuffer::PrepareForParallelIteration(Address** start,
+                                              Address** end) {
+  bool some_pages_to_scan = PrepareForIteration();
+  *start = old_start_;
+  *end = old_top_;
+  // The old buffer is rebuilt from the surviving slots once all parallel
+  // iterators are done reading from it.
+  old_top_ = old_start_;
+  return some_pages_to_scan;
+}
+
+
 void StoreBuffer::IteratePointersToNewSpace(ObjectSlotCallback slot_callback) {
   // We do not sort or remove duplicated entries from the store buffer because
   // we expect that callback will rebuild the store buffer thus removing
@@ -433,114 +445,120 @@ void StoreBuffer::IteratePointersToNewSpace(ObjectSlotCallback slot_callback) {
   // space left on the page we will keep the pointers in the store buffer and
   // remove the flag from the page.
   if (some_pages_to_scan) {
-    if (callback_ != NULL) {
-      (*callback_)(heap_, NULL, kStoreBufferStartScanningPagesEvent);
-    }
-    PointerChunkIterator it(heap_);
-    MemoryChunk* chunk;
-    while ((chunk = it.next()) != NULL) {
-      if (chunk->scan_on_scavenge()) {
-        chunk->set_scan_on_scavenge(false);
-        if (callback_ != NULL) {
-          (*callback_)(heap_, chunk, kStoreBufferScanningPageEvent);
-        }
-        if (chunk->owner() == heap_->lo_space()) {
-          LargePage* large_page = reinterpret_cast<LargePage*>(chunk);
-          HeapObject* array = large_page->GetObject();
-          DCHECK(array->IsFixedArray());
-          Address start = array->address();
-          Address end = start + array->Size();
-          FindPointersToNewSpaceInRegion(start, end, slot_callback);
+    IteratePointersOnScanOnScavengePages(slot_callback);
+  }
+}
+
+
+void StoreBuffer::IteratePointersOnScanOnScavengePages(
+    ObjectSlotCallback slot_callback) {
+  if (callback_ != NULL) {
+    (*callback_)(heap_, NULL, kStoreBufferStartScanningPagesEvent);
+  }
+  PointerChunkIterator it(heap_);
+  MemoryChunk* chunk;
+  while ((chunk = it.next()) != NULL) {
+    if (chunk->scan_on_scavenge()) {
+      chunk->set_scan_on_scavenge(false);
+      if (callback_ != NULL) {
+        (*callback_)(heap_, chunk, kStoreBufferScanningPageEvent);
+      }
+      if (chunk->owner() == heap_->lo_space()) {
+        LargePage* large_page = reinterpret_cast<LargePage*>(chunk);
+        HeapObject* array = large_page->GetObject();
+        DCHECK(array->IsFixedArray());
+        Address start = array->address();
+        Address end = start + array->Size();
+        FindPointersToNewSpaceInRegion(start, end, slot_callback);
+      } else {
+        Page* page = reinterpret_cast<Page*>(chunk);
+        PagedSpace* owner = reinterpret_cast<PagedSpace*>(page->owner());
+        if (owner == heap_->map_space()) {
+          DCHECK(page->WasSwept());
+          HeapObjectIterator iterator(page);
+          for (HeapObject* heap_object = iterator.Next(); heap_object != NULL;
+               heap_object = iterator.Next()) {
+            // We skip free space objects.
+            if (!heap_object->IsFiller()) {
+              DCHECK(heap_object->IsMap());
+              FindPointersToNewSpaceInRegion(
+                  heap_object->address() + Map::kPointerFieldsBeginOffset,
+                  heap_object->address() + Map::kPointerFieldsEndOffset,
+                  slot_callback);
+            }
+          }
         } else {
-          Page* page = reinterpret_cast<Page*>(chunk);
-          PagedSpace* owner = reinterpret_cast<PagedSpace*>(page->owner());
-          if (owner == heap_->map_space()) {
-            DCHECK(page->WasSwept());
-            HeapObjectIterator iterator(page);
-            for (HeapObject* heap_object = iterator.Next(); heap_object != NULL;
-                 heap_object = iterator.Next()) {
-              // We skip free space objects.
-              if (!heap_object->IsFiller()) {
-                DCHECK(heap_object->IsMap());
-                FindPointersToNewSpaceInRegion(
-                    heap_object->address() + Map::kPointerFieldsBeginOffset,
-                    heap_object->address() + Map::kPointerFieldsEndOffset,
-                    slot_callback);
+          heap_->mark_compact_collector()->SweepOrWaitUntilSweepingCompleted(
+              page);
+          HeapObjectIterator iterator(page);
+          for (HeapObject* heap_object = iterator.Next(); heap_object != NULL;
+               heap_object = iterator.Next()) {
+            // We iterate over objects that contain new space pointers only.
+            Address obj_address = heap_object->address();
+            const int start_offset = HeapObject::kHeaderSize;
+            const int end_offset = heap_object->Size();
+
+            switch (heap_object->ContentType()) {
+              case HeapObjectContents::kTaggedValues: {
+                Address start_address = obj_address + start_offset;
+                Address end_address = obj_address + end_offset;
+                // Object has only tagged fields.
+                FindPointersToNewSpaceInRegion(start_address, end_address,
+                                               slot_callback);
+                break;
               }
-            }
-          } else {
-            heap_->mark_compact_collector()->SweepOrWaitUntilSweepingCompleted(
-                page);
-            HeapObjectIterator iterator(page);
-            for (HeapObject* heap_object = iterator.Next(); heap_object != NULL;
-                 heap_object = iterator.Next()) {
-              // We iterate over objects that contain new space pointers only.
-              Address obj_address = heap_object->address();
-              const int start_offset = HeapObject::kHeaderSize;
-              const int end_offset = heap_object->Size();
-
-              switch (heap_object->ContentType()) {
-                case HeapObjectContents::kTaggedValues: {
-                  Address start_address = obj_address + start_offset;
-                  Address end_address = obj_address + end_offset;
-                  // Object has only tagged fields.
-                  FindPointersToNewSpaceInRegion(start_address, end_address,
-                                                 slot_callback);
-                  break;
-                }
 
-                case HeapObjectContents::kMixedValues: {
-                  if (heap_object->IsFixedTypedArrayBase()) {
-                    FindPointersToNewSpaceInRegion(
-                        obj_address + FixedTypedArrayBase::kBasePointerOffset,
-                        obj_address + FixedTypedArrayBase::kHeaderSize,
-                        slot_callback);
-                  } else if (heap_object->IsBytecodeArray()) {
-                    FindPointersToNewSpaceInRegion(
-                        obj_address + BytecodeArray::kConstantPoolOffset,
-                        obj_address + BytecodeArray::kHeaderSize,
-                        slot_callback);
-                  } else if (heap_object->IsJSArrayBuffer()) {
-                    FindPointersToNewSpaceInRegion(
-                        obj_address +
-                            JSArrayBuffer::BodyDescriptor::kStartOffset,
-                        obj_address + JSArrayBuffer::kByteLengthOffset +
-                            kPointerSize,
-                        slot_callback);
-                    FindPointersToNewSpaceInRegion(
-                        obj_address + JSArrayBuffer::kSize,
-                        obj_address + JSArrayBuffer::kSizeWithInternalFields,
-                        slot_callback);
-                  } else if (FLAG_unbox_double_fields) {
-                    LayoutDescriptorHelper helper(heap_object->map());
-                    DCHECK(!helper.all_fields_tagged());
-                    for (int offset = start_offset; offset < end_offset;) {
-                      int end_of_region_offset;
-                      if (helper.IsTagged(offset, end_offset,
-                                          &end_of_region_offset)) {
-                        FindPointersToNewSpaceInRegion(
-                            obj_address + offset,
-                            obj_address + end_of_region_offset, slot_callback);
-                      }
-                      offset = end_of_region_offset;
+              case HeapObjectContents::kMixedValues: {
+                if (heap_object->IsFixedTypedArrayBase()) {
+                  FindPointersToNewSpaceInRegion(
+                      obj_address + FixedTypedArrayBase::kBasePointerOffset,
+                      obj_address + FixedTypedArrayBase::kHeaderSize,
+                      slot_callback);
+                } else if (heap_object->IsBytecodeArray()) {
+                  FindPointersToNewSpaceInRegion(
+                      obj_address + BytecodeArray::kConstantPoolOffset,
+                      obj_address + BytecodeArray::kHeaderSize,
+                      slot_callback);
+                } else if (heap_object->IsJSArrayBuffer()) {
+                  FindPointersToNewSpaceInRegion(
+                      obj_address +
+                          JSArrayBuffer::BodyDescriptor::kStartOffset,
+                      obj_address + JSArrayBuffer::kByteLengthOffset +
+                          kPointerSize,
+                      slot_callback);
+                  FindPointersToNewSpaceInRegion(
+                      obj_address + JSArrayBuffer::kSize,
+                      obj_address + JSArrayBuffer::kSizeWithInternalFields,
+                      slot_callback);
+                } else if (FLAG_unbox_double_fields) {
+                  LayoutDescriptorHelper helper(heap_object->map());
+                  DCHECK(!helper.all_fields_tagged());
+                  for (int offset = start_offset; offset < end_offset;) {
+                    int end_of_region_offset;
+                    if (helper.IsTagged(offset, end_offset,
+                                        &end_of_region_offset)) {
+                      FindPointersToNewSpaceInRegion(
+                          obj_address + offset,
+                          obj_address + end_of_region_offset, slot_callback);
                     }
-                  } else {
-                    UNREACHABLE();
+                    offset = end_of_region_offset;
                   }
-                  break;
+                } else {
+                  UNREACHABLE();
                 }
-
-                case HeapObjectContents::kRawValues:
-                  break;
+                break;
               }
+
+              case HeapObjectContents::kRawValues:
+                break;
             }
           }
         }
       }
     }
-    if (callback_ != NULL) {
-      (*callback_)(heap_, NULL, kStoreBufferScanningPageEvent);
-    }
+  }
+  if (callback_ != NULL) {
+    (*callback_)(heap_, NULL, kStoreBufferScanningPageEvent);
   }
 }
 
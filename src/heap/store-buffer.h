@@ -61,6 +61,18 @@ class StoreBuffer {
   // surviving old-to-new pointers into the store buffer to rebuild it.
   void IteratePointersToNewSpace(ObjectSlotCallback callback);
 
+  // Prepares the store buffer for being iterated by multiple threads. Returns
+  // the range of slots in the old buffer in |start| and |end| and empties the
+  // old buffer, so that the slots surviving the iteration can be re-entered
+  // with EnterDirectlyIntoStoreBuffer once all threads are done. Returns true
+  // if there are pages marked as scan-on-scavenge, which have to be processed
+  // with IteratePointersOnScanOnScavengePages afterwards.
+  bool PrepareForParallelIteration(Address** start, Address** end);
+
+  // Iterates over the pointers to new space on pages marked as
+  // scan-on-scavenge and clears the flag on them.
+  void IteratePointersOnScanOnScavengePages(ObjectSlotCallback callback);
+
   static const int kStoreBufferOverflowBit = 1 << (14 + kPointerSizeLog2);
   static const int kStoreBufferSize = kStoreBufferOverflowBit;
   static const int kStoreBufferLength = kStoreBufferSize / sizeof(Address);
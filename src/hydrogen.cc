@@ -9775,7 +9775,7 @@ void HOptimizedGraphBuilder::VisitCall(Call* expr) {
 
   } else {
     VariableProxy* proxy = expr->expression()->AsVariableProxy();
-    if (proxy != NULL && proxy->var()->is_possibly_eval(isolate())) {
+    if (proxy != NULL && proxy->var()->is_possibly_eval()) {
       return Bailout(kPossibleDirectCallToEval);
     }
 
@@ -9822,7 +9822,7 @@ void HOptimizedGraphBuilder::VisitCall(Call* expr) {
           New<HCallFunction>(function, argument_count);
       call = call_function;
       if (expr->is_uninitialized() &&
-          expr->IsUsingCallFeedbackICSlot(isolate())) {
+          expr->IsUsingCallFeedbackICSlot()) {
         // We've never seen this call before, so let's have Crankshaft learn
         // through the type vector.
         Handle<TypeFeedbackVector> vector =
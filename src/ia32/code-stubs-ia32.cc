@@ -1229,6 +1229,19 @@ void RegExpExecStub::Generate(MacroAssembler* masm) {
   __ mov(ebx, FieldOperand(eax, HeapObject::kMapOffset));
   __ movzx_b(ebx, FieldOperand(ebx, Map::kInstanceTypeOffset));
 
+  // Leave long subjects to the runtime if the regexp has a required literal,
+  // so that the subject is searched for the literal first.
+  Label no_required_literal;
+  __ cmp(FieldOperand(ecx, JSRegExp::kIrregexpRequiredLiteralOffset),
+         factory->undefined_value());
+  __ j(equal, &no_required_literal, Label::kNear);
+  __ cmp(ebx, FIRST_NONSTRING_TYPE);
+  __ j(above_equal, &runtime);
+  __ cmp(FieldOperand(eax, String::kLengthOffset),
+         Immediate(Smi::FromInt(RegExpImpl::kRequiredLiteralMinSubjectLength)));
+  __ j(greater_equal, &runtime);
+  __ bind(&no_required_literal);
+
   // eax: subject string
   // edx: subject string
   // ebx: subject string instance type
@@ -14,9 +14,15 @@ BytecodeArrayBuilder::BytecodeArrayBuilder(Isolate* isolate, Zone* zone)
       bytecode_generated_(false),
       last_block_end_(0),
       last_bytecode_start_(~0),
+      previous_bytecode_start_(~0),
+      last_bound_label_offset_(0),
       return_seen_in_block_(false),
       constants_map_(isolate->heap(), zone),
+      smi_constants_map_(zone),
+      ast_constants_map_(zone),
       constants_(zone),
+      reserved_entry_count_(0),
+      reserved_entries_(zone),
       parameter_count_(-1),
       local_register_count_(-1),
       temporary_register_count_(0),
@@ -63,7 +69,14 @@ Handle<BytecodeArray> BytecodeArrayBuilder::ToBytecodeArray() {
   Handle<FixedArray> constant_pool =
       factory->NewFixedArray(constants_count, TENURED);
   for (int i = 0; i < constants_count; i++) {
-    constant_pool->set(i, *constants_[i]);
+    const Constant& constant = constants_[i];
+    if (constant.value != nullptr) {
+      constant_pool->set(i, *constant.value->value());
+    } else if (!constant.object.is_null()) {
+      constant_pool->set(i, *constant.object);
+    } else {
+      constant_pool->set(i, constant.smi);
+    }
   }
 
   Handle<BytecodeArray> output =
@@ -74,47 +87,76 @@ Handle<BytecodeArray> BytecodeArrayBuilder::ToBytecodeArray() {
 }
 
 
-template <size_t N>
-void BytecodeArrayBuilder::Output(uint8_t(&bytes)[N]) {
-  DCHECK_EQ(Bytecodes::NumberOfOperands(Bytecodes::FromByte(bytes[0])),
-            static_cast<int>(N) - 1);
+void BytecodeArrayBuilder::OutputScaled(Bytecode bytecode,
+                                        const uint32_t* operands,
+                                        int operand_count,
+                                        OperandScale operand_scale) {
+  DCHECK_EQ(Bytecodes::NumberOfOperands(bytecode), operand_count);
+  for (int i = 0; i < operand_count; i++) {
+    DCHECK(OperandIsValid(bytecode, i, operands[i]));
+    OperandType operand_type = Bytecodes::GetOperandType(bytecode, i);
+    OperandScale needed =
+        Bytecodes::IsSignedOperandType(operand_type)
+            ? Bytecodes::OperandScaleForSignedOperand(
+                  static_cast<int32_t>(operands[i]))
+            : Bytecodes::OperandScaleForUnsignedOperand(operands[i]);
+    if (needed > operand_scale) operand_scale = needed;
+  }
+
+  previous_bytecode_start_ = last_bytecode_start_;
   last_bytecode_start_ = bytecodes()->size();
-  for (int i = 1; i < static_cast<int>(N); i++) {
-    DCHECK(OperandIsValid(Bytecodes::FromByte(bytes[0]), i - 1, bytes[i]));
+  if (operand_scale != OperandScale::kSingle) {
+    bytecodes()->push_back(Bytecodes::ToByte(
+        Bytecodes::OperandScaleToPrefixBytecode(operand_scale)));
+  }
+  bytecodes()->push_back(Bytecodes::ToByte(bytecode));
+  for (int i = 0; i < operand_count; i++) {
+    // Operands are emitted in little-endian order.
+    uint32_t operand = operands[i];
+    for (int j = 0; j < static_cast<int>(operand_scale); j++) {
+      bytecodes()->push_back(static_cast<uint8_t>(operand));
+      operand >>= kBitsPerByte;
+    }
   }
-  bytecodes()->insert(bytecodes()->end(), bytes, bytes + N);
 }
 
 
-void BytecodeArrayBuilder::Output(Bytecode bytecode, uint8_t operand0,
-                                  uint8_t operand1, uint8_t operand2) {
-  uint8_t bytes[] = {Bytecodes::ToByte(bytecode), operand0, operand1, operand2};
-  Output(bytes);
+void BytecodeArrayBuilder::Output(Bytecode bytecode, uint32_t operand0,
+                                  uint32_t operand1, uint32_t operand2,
+                                  uint32_t operand3) {
+  uint32_t operands[] = {operand0, operand1, operand2, operand3};
+  OutputScaled(bytecode, operands, arraysize(operands), OperandScale::kSingle);
 }
 
 
-void BytecodeArrayBuilder::Output(Bytecode bytecode, uint8_t operand0,
-                                  uint8_t operand1) {
-  uint8_t bytes[] = {Bytecodes::ToByte(bytecode), operand0, operand1};
-  Output(bytes);
+void BytecodeArrayBuilder::Output(Bytecode bytecode, uint32_t operand0,
+                                  uint32_t operand1, uint32_t operand2) {
+  uint32_t operands[] = {operand0, operand1, operand2};
+  OutputScaled(bytecode, operands, arraysize(operands), OperandScale::kSingle);
 }
 
 
-void BytecodeArrayBuilder::Output(Bytecode bytecode, uint8_t operand0) {
-  uint8_t bytes[] = {Bytecodes::ToByte(bytecode), operand0};
-  Output(bytes);
+void BytecodeArrayBuilder::Output(Bytecode bytecode, uint32_t operand0,
+                                  uint32_t operand1) {
+  uint32_t operands[] = {operand0, operand1};
+  OutputScaled(bytecode, operands, arraysize(operands), OperandScale::kSingle);
+}
+
+
+void BytecodeArrayBuilder::Output(Bytecode bytecode, uint32_t operand0) {
+  uint32_t operands[] = {operand0};
+  OutputScaled(bytecode, operands, arraysize(operands), OperandScale::kSingle);
 }
 
 
 void BytecodeArrayBuilder::Output(Bytecode bytecode) {
-  uint8_t bytes[] = {Bytecodes::ToByte(bytecode)};
-  Output(bytes);
+  OutputScaled(bytecode, nullptr, 0, OperandScale::kSingle);
 }
 
 
 BytecodeArrayBuilder& BytecodeArrayBuilder::BinaryOperation(Token::Value op,
                                                             Register reg) {
-  Output(BytecodeForBinaryOperation(op), reg.ToOperand());
+  Output(BytecodeForBinaryOperation(op), RegisterOperand(reg));
   return *this;
 }
 
@@ -125,7 +167,7 @@ BytecodeArrayBuilder& BytecodeArrayBuilder::CompareOperation(
     UNIMPLEMENTED();
   }
 
-  Output(BytecodeForCompareOperation(op), reg.ToOperand());
+  Output(BytecodeForCompareOperation(op), RegisterOperand(reg));
   return *this;
 }
 
@@ -136,21 +178,28 @@ BytecodeArrayBuilder& BytecodeArrayBuilder::LoadLiteral(
   if (raw_smi == 0) {
     Output(Bytecode::kLdaZero);
   } else if (raw_smi >= -128 && raw_smi <= 127) {
-    Output(Bytecode::kLdaSmi8, static_cast<uint8_t>(raw_smi));
+    Output(Bytecode::kLdaSmi8, static_cast<uint32_t>(raw_smi));
   } else {
-    LoadLiteral(Handle<Object>(smi, isolate_));
+    LoadConstantPoolEntry(GetConstantPoolEntry(smi));
   }
   return *this;
 }
 
 
 BytecodeArrayBuilder& BytecodeArrayBuilder::LoadLiteral(Handle<Object> object) {
-  size_t entry = GetConstantPoolEntry(object);
-  if (FitsInIdxOperand(entry)) {
-    Output(Bytecode::kLdaConstant, static_cast<uint8_t>(entry));
-  } else {
-    UNIMPLEMENTED();
-  }
+  return LoadConstantPoolEntry(GetConstantPoolEntry(object));
+}
+
+
+BytecodeArrayBuilder& BytecodeArrayBuilder::LoadLiteral(
+    const AstValue* value) {
+  return LoadConstantPoolEntry(GetConstantPoolEntry(value));
+}
+
+
+BytecodeArrayBuilder& BytecodeArrayBuilder::LoadConstantPoolEntry(
+    size_t entry) {
+  Output(Bytecode::kLdaConstant, static_cast<uint32_t>(entry));
   return *this;
 }
 
@@ -187,25 +236,33 @@ BytecodeArrayBuilder& BytecodeArrayBuilder::LoadFalse() {
 
 BytecodeArrayBuilder& BytecodeArrayBuilder::LoadAccumulatorWithRegister(
     Register reg) {
-  Output(Bytecode::kLdar, reg.ToOperand());
+  Output(Bytecode::kLdar, RegisterOperand(reg));
   return *this;
 }
 
 
 BytecodeArrayBuilder& BytecodeArrayBuilder::StoreAccumulatorInRegister(
     Register reg) {
-  Output(Bytecode::kStar, reg.ToOperand());
+  if (FLAG_ignition_fuse_bytecodes &&
+      CanFuseBytecodeAt(previous_bytecode_start_, Bytecode::kLdar) &&
+      CanFuseBytecodeAt(last_bytecode_start_, Bytecode::kAdd)) {
+    // Ldar <src>, Add <lhs>, Star <dst> is the most frequent sequence of
+    // bytecodes generated for arithmetic on locals.
+    uint32_t src = RegisterOperandAt(previous_bytecode_start_, 0);
+    uint32_t lhs = RegisterOperandAt(last_bytecode_start_, 0);
+    RemoveLastBytecode();
+    RemoveLastBytecode();
+    Output(Bytecode::kLdarAddStar, src, lhs, RegisterOperand(reg));
+    return *this;
+  }
+  Output(Bytecode::kStar, RegisterOperand(reg));
   return *this;
 }
 
 
 BytecodeArrayBuilder& BytecodeArrayBuilder::LoadGlobal(int slot_index) {
   DCHECK(slot_index >= 0);
-  if (FitsInIdxOperand(slot_index)) {
-    Output(Bytecode::kLdaGlobal, static_cast<uint8_t>(slot_index));
-  } else {
-    UNIMPLEMENTED();
-  }
+  Output(Bytecode::kLdaGlobal, static_cast<uint32_t>(slot_index));
   return *this;
 }
 
@@ -215,12 +272,8 @@ BytecodeArrayBuilder& BytecodeArrayBuilder::LoadNamedProperty(
     UNIMPLEMENTED();
   }
 
-  if (FitsInIdxOperand(feedback_slot)) {
-    Output(Bytecode::kLoadIC, object.ToOperand(),
-           static_cast<uint8_t>(feedback_slot));
-  } else {
-    UNIMPLEMENTED();
-  }
+  Output(Bytecode::kLoadIC, RegisterOperand(object),
+         static_cast<uint32_t>(feedback_slot));
   return *this;
 }
 
@@ -231,12 +284,8 @@ BytecodeArrayBuilder& BytecodeArrayBuilder::LoadKeyedProperty(
     UNIMPLEMENTED();
   }
 
-  if (FitsInIdxOperand(feedback_slot)) {
-    Output(Bytecode::kKeyedLoadIC, object.ToOperand(),
-           static_cast<uint8_t>(feedback_slot));
-  } else {
-    UNIMPLEMENTED();
-  }
+  Output(Bytecode::kKeyedLoadIC, RegisterOperand(object),
+         static_cast<uint32_t>(feedback_slot));
   return *this;
 }
 
@@ -248,12 +297,8 @@ BytecodeArrayBuilder& BytecodeArrayBuilder::StoreNamedProperty(
     UNIMPLEMENTED();
   }
 
-  if (FitsInIdxOperand(feedback_slot)) {
-    Output(Bytecode::kStoreIC, object.ToOperand(), name.ToOperand(),
-           static_cast<uint8_t>(feedback_slot));
-  } else {
-    UNIMPLEMENTED();
-  }
+  Output(Bytecode::kStoreIC, RegisterOperand(object), RegisterOperand(name),
+         static_cast<uint32_t>(feedback_slot));
   return *this;
 }
 
@@ -265,12 +310,8 @@ BytecodeArrayBuilder& BytecodeArrayBuilder::StoreKeyedProperty(
     UNIMPLEMENTED();
   }
 
-  if (FitsInIdxOperand(feedback_slot)) {
-    Output(Bytecode::kKeyedStoreIC, object.ToOperand(), key.ToOperand(),
-           static_cast<uint8_t>(feedback_slot));
-  } else {
-    UNIMPLEMENTED();
-  }
+  Output(Bytecode::kKeyedStoreIC, RegisterOperand(object), RegisterOperand(key),
+         static_cast<uint32_t>(feedback_slot));
   return *this;
 }
 
@@ -310,15 +351,23 @@ BytecodeArrayBuilder& BytecodeArrayBuilder::Bind(BytecodeLabel* label) {
     // Now treat as if the label will only be back referred to.
   }
   label->bind_to(bytecodes()->size());
+  last_bound_label_offset_ = bytecodes()->size();
   return *this;
 }
 
 
+// static
+uint32_t BytecodeArrayBuilder::RegisterOperand(Register reg) {
+  return static_cast<uint32_t>(reg.ToRawOperand());
+}
+
+
 // static
 bool BytecodeArrayBuilder::IsJumpWithImm8Operand(Bytecode jump_bytecode) {
   return jump_bytecode == Bytecode::kJump ||
          jump_bytecode == Bytecode::kJumpIfTrue ||
-         jump_bytecode == Bytecode::kJumpIfFalse;
+         jump_bytecode == Bytecode::kJumpIfFalse ||
+         jump_bytecode == Bytecode::kTestLessThanJumpIfFalse;
 }
 
 
@@ -332,6 +381,8 @@ Bytecode BytecodeArrayBuilder::GetJumpWithConstantOperand(
       return Bytecode::kJumpIfTrueConstant;
     case Bytecode::kJumpIfFalse:
       return Bytecode::kJumpIfFalseConstant;
+    case Bytecode::kTestLessThanJumpIfFalse:
+      return Bytecode::kTestLessThanJumpIfFalseConstant;
     default:
       UNREACHABLE();
       return Bytecode::kJumpConstant;
@@ -343,63 +394,96 @@ void BytecodeArrayBuilder::PatchJump(
     const ZoneVector<uint8_t>::iterator& jump_target,
     ZoneVector<uint8_t>::iterator jump_location) {
   Bytecode jump_bytecode = Bytecodes::FromByte(*jump_location);
-  int delta = static_cast<int>(jump_target - jump_location);
+  if (Bytecodes::IsPrefixScalingBytecode(jump_bytecode)) {
+    // The jump could not reserve a constant pool entry and has a 32-bit
+    // offset relative to the prefixed bytecode, see OutputJump.
+    DCHECK_EQ(Bytecode::kExtraWide, jump_bytecode);
+    jump_location++;
+    jump_bytecode = Bytecodes::FromByte(*jump_location);
+    DCHECK(IsJumpWithImm8Operand(jump_bytecode));
+    int scale = static_cast<int>(OperandScale::kQuadruple);
+    int operand_offset =
+        Bytecodes::Size(jump_bytecode, OperandScale::kQuadruple) - scale;
+    uint32_t operand = static_cast<uint32_t>(jump_target - jump_location);
+    for (int i = 0; i < scale; i++) {
+      *(jump_location + operand_offset + i) = static_cast<uint8_t>(operand);
+      operand >>= kBitsPerByte;
+    }
+    return;
+  }
 
+  int delta = static_cast<int>(jump_target - jump_location);
   DCHECK(IsJumpWithImm8Operand(jump_bytecode));
-  DCHECK_EQ(Bytecodes::Size(jump_bytecode), 2);
   DCHECK_GE(delta, 0);
 
+  // The jump offset is the last operand of the jump bytecode.
+  int operand_offset = Bytecodes::Size(jump_bytecode) - 1;
   if (FitsInImm8Operand(delta)) {
     // Just update the operand
-    jump_location++;
-    *jump_location = static_cast<uint8_t>(delta);
+    *(jump_location + operand_offset) = static_cast<uint8_t>(delta);
+    DiscardReservedConstantPoolEntry();
   } else {
     // Update the jump type and operand
-    size_t entry = GetConstantPoolEntry(handle(Smi::FromInt(delta), isolate()));
-    if (FitsInIdxOperand(entry)) {
-      *jump_location++ =
-          Bytecodes::ToByte(GetJumpWithConstantOperand(jump_bytecode));
-      *jump_location = static_cast<uint8_t>(entry);
-    } else {
-      // TODO(oth): OutputJump should reserve a constant pool entry
-      // when jump is written. The reservation should be used here if
-      // needed, or cancelled if not. This is due to the patch needing
-      // to match the size of the code it's replacing. In future,
-      // there will probably be a jump with 32-bit operand for cases
-      // when constant pool is full, but that needs to be emitted in
-      // OutputJump too.
-      UNIMPLEMENTED();
-    }
+    size_t entry = CommitReservedConstantPoolEntry(Smi::FromInt(delta));
+    DCHECK(FitsInIdxOperand(entry));
+    *jump_location =
+        Bytecodes::ToByte(GetJumpWithConstantOperand(jump_bytecode));
+    *(jump_location + operand_offset) = static_cast<uint8_t>(entry);
   }
 }
 
 
 BytecodeArrayBuilder& BytecodeArrayBuilder::OutputJump(Bytecode jump_bytecode,
                                                        BytecodeLabel* label) {
-  int delta;
+  // TestLessThan <src>, JumpIfFalse is the most frequent compare and branch
+  // sequence, e.g. in loop conditions.
+  bool fuse_with_test =
+      FLAG_ignition_fuse_bytecodes && jump_bytecode == Bytecode::kJumpIfFalse &&
+      CanFuseBytecodeAt(last_bytecode_start_, Bytecode::kTestLessThan);
+  uint32_t test_register = 0;
+  if (fuse_with_test) {
+    test_register = RegisterOperandAt(last_bytecode_start_, 0);
+    RemoveLastBytecode();
+    jump_bytecode = Bytecode::kTestLessThanJumpIfFalse;
+  }
+
+  // Jumps are only prefixed if their offset does not fit an unprefixed
+  // operand or constant pool entry. Forward jumps reserve the constant pool
+  // entry up front so that they can be patched in place.
+  OperandScale operand_scale = OperandScale::kSingle;
+  uint32_t operand;
   if (label->is_bound()) {
     // Label has been bound already so this is a backwards jump.
     CHECK_GE(bytecodes()->size(), label->offset());
     CHECK_LE(bytecodes()->size(), static_cast<size_t>(kMaxInt));
     size_t abs_delta = bytecodes()->size() - label->offset();
-    delta = -static_cast<int>(abs_delta);
+    int delta = -static_cast<int>(abs_delta);
+    if (FitsInImm8Operand(delta)) {
+      operand = static_cast<uint32_t>(delta);
+    } else if (constants_.size() + reserved_entry_count_ <= kMaxUInt8) {
+      size_t entry = GetConstantPoolEntry(Smi::FromInt(delta));
+      DCHECK(FitsInIdxOperand(entry));
+      jump_bytecode = GetJumpWithConstantOperand(jump_bytecode);
+      operand = static_cast<uint32_t>(entry);
+    } else {
+      // A new constant pool entry would need a prefix as well, so prefix the
+      // offset instead. It is relative to the bytecode following the prefix.
+      operand = static_cast<uint32_t>(delta - 1);
+    }
   } else {
     // Label has not yet been bound so this is a forward reference
     // that will be patched when the label is bound.
     label->set_referrer(bytecodes()->size());
-    delta = 0;
+    if (!ReserveConstantPoolEntry()) {
+      operand_scale = OperandScale::kQuadruple;
+    }
+    operand = 0;
   }
-
-  if (FitsInImm8Operand(delta)) {
-    Output(jump_bytecode, static_cast<uint8_t>(delta));
+  if (fuse_with_test) {
+    uint32_t operands[] = {test_register, operand};
+    OutputScaled(jump_bytecode, operands, arraysize(operands), operand_scale);
   } else {
-    size_t entry = GetConstantPoolEntry(handle(Smi::FromInt(delta), isolate()));
-    if (FitsInIdxOperand(entry)) {
-      Output(GetJumpWithConstantOperand(jump_bytecode),
-             static_cast<uint8_t>(entry));
-    } else {
-      UNIMPLEMENTED();
-    }
+    OutputScaled(jump_bytecode, &operand, 1, operand_scale);
   }
   return *this;
 }
@@ -446,13 +530,13 @@ void BytecodeArrayBuilder::EnsureReturn() {
 
 BytecodeArrayBuilder& BytecodeArrayBuilder::Call(Register callable,
                                                  Register receiver,
-                                                 size_t arg_count) {
-  if (FitsInIdxOperand(arg_count)) {
-    Output(Bytecode::kCall, callable.ToOperand(), receiver.ToOperand(),
-           static_cast<uint8_t>(arg_count));
-  } else {
-    UNIMPLEMENTED();
-  }
+                                                 size_t arg_count,
+                                                 int feedback_slot) {
+  DCHECK_LE(arg_count, static_cast<size_t>(kMaxUInt32));
+  DCHECK_GE(feedback_slot, 0);
+  Output(Bytecode::kCall, RegisterOperand(callable), RegisterOperand(receiver),
+         static_cast<uint32_t>(arg_count),
+         static_cast<uint32_t>(feedback_slot));
   return *this;
 }
 
@@ -469,14 +553,98 @@ size_t BytecodeArrayBuilder::GetConstantPoolEntry(Handle<Object> object) {
   size_t* entry = constants_map_.Find(object);
   if (!entry) {
     entry = constants_map_.Get(object);
-    *entry = constants_.size();
-    constants_.push_back(object);
+    Constant constant = {object, nullptr, nullptr};
+    *entry = AddConstantPoolEntry(constant);
   }
-  DCHECK(constants_[*entry].is_identical_to(object));
+  DCHECK(constants_[*entry].object.is_identical_to(object));
   return *entry;
 }
 
 
+size_t BytecodeArrayBuilder::GetConstantPoolEntry(Smi* smi) {
+  auto it = smi_constants_map_.find(smi->value());
+  if (it != smi_constants_map_.end()) return it->second;
+  Constant constant = {Handle<Object>(), smi, nullptr};
+  size_t entry = AddConstantPoolEntry(constant);
+  smi_constants_map_.insert(std::make_pair(smi->value(), entry));
+  return entry;
+}
+
+
+size_t BytecodeArrayBuilder::GetConstantPoolEntry(const AstValue* value) {
+  // These constants shouldn't be added to the constant pool, the should use
+  // specialzed bytecodes instead.
+  DCHECK(!value->IsSmi() && !value->IsUndefined() && !value->IsNull() &&
+         !value->IsTheHole() && !value->IsTrue() && !value->IsFalse());
+
+  const void* key = value->IsString()
+                        ? static_cast<const void*>(value->AsString())
+                        : static_cast<const void*>(value);
+  auto it = ast_constants_map_.find(key);
+  if (it != ast_constants_map_.end()) return it->second;
+  Constant constant = {Handle<Object>(), nullptr, value};
+  size_t entry = AddConstantPoolEntry(constant);
+  ast_constants_map_.insert(std::make_pair(key, entry));
+  return entry;
+}
+
+
+size_t BytecodeArrayBuilder::AddConstantPoolEntry(const Constant& constant) {
+  // Keep enough unprefixed entries for the reservations of pending forward
+  // jumps by materializing them before the new entry takes the last one.
+  if (reserved_entry_count_ > 0 &&
+      constants_.size() + reserved_entry_count_ > kMaxUInt8) {
+    Constant placeholder = {Handle<Object>(), Smi::FromInt(0), nullptr};
+    for (; reserved_entry_count_ > 0; reserved_entry_count_--) {
+      reserved_entries_.push_back(constants_.size());
+      constants_.push_back(placeholder);
+    }
+  }
+  size_t entry = constants_.size();
+  constants_.push_back(constant);
+  return entry;
+}
+
+
+bool BytecodeArrayBuilder::ReserveConstantPoolEntry() {
+  if (constants_.size() + reserved_entry_count_ > kMaxUInt8) return false;
+  reserved_entry_count_++;
+  return true;
+}
+
+
+size_t BytecodeArrayBuilder::CommitReservedConstantPoolEntry(Smi* smi) {
+  auto it = smi_constants_map_.find(smi->value());
+  if (it != smi_constants_map_.end() && FitsInIdxOperand(it->second)) {
+    DiscardReservedConstantPoolEntry();
+    return it->second;
+  }
+  size_t entry;
+  if (reserved_entry_count_ > 0) {
+    reserved_entry_count_--;
+    entry = constants_.size();
+    Constant constant = {Handle<Object>(), smi, nullptr};
+    constants_.push_back(constant);
+  } else {
+    // The reservation has been materialized already.
+    DCHECK(!reserved_entries_.empty());
+    entry = reserved_entries_.back();
+    reserved_entries_.pop_back();
+    constants_[entry].smi = smi;
+  }
+  if (it == smi_constants_map_.end()) {
+    smi_constants_map_.insert(std::make_pair(smi->value(), entry));
+  }
+  return entry;
+}
+
+
+void BytecodeArrayBuilder::DiscardReservedConstantPoolEntry() {
+  // A materialized reservation stays in the constant pool unused.
+  if (reserved_entry_count_ > 0) reserved_entry_count_--;
+}
+
+
 int BytecodeArrayBuilder::BorrowTemporaryRegister() {
   DCHECK_GE(local_register_count_, 0);
   int temporary_reg_index = temporary_register_next_++;
@@ -495,7 +663,7 @@ void BytecodeArrayBuilder::ReturnTemporaryRegister(int reg_index) {
 
 
 bool BytecodeArrayBuilder::OperandIsValid(Bytecode bytecode, int operand_index,
-                                          uint8_t operand_value) const {
+                                          uint32_t operand_value) const {
   OperandType operand_type = Bytecodes::GetOperandType(bytecode, operand_index);
   switch (operand_type) {
     case OperandType::kNone:
@@ -505,7 +673,8 @@ bool BytecodeArrayBuilder::OperandIsValid(Bytecode bytecode, int operand_index,
     case OperandType::kIdx:
       return true;
     case OperandType::kReg: {
-      Register reg = Register::FromOperand(operand_value);
+      Register reg =
+          Register::FromRawOperand(static_cast<int32_t>(operand_value));
       if (reg.is_parameter()) {
         int parameter_index = reg.ToParameterIndex(parameter_count_);
         return parameter_index >= 0 && parameter_index < parameter_count_;
@@ -524,6 +693,36 @@ bool BytecodeArrayBuilder::LastBytecodeInSameBlock() const {
 }
 
 
+bool BytecodeArrayBuilder::CanFuseBytecodeAt(size_t offset,
+                                             Bytecode bytecode) const {
+  // A label bound at |offset| itself still refers to the fused bytecode.
+  return offset < bytecodes()->size() && offset >= last_block_end_ &&
+         offset >= last_bound_label_offset_ &&
+         bytecodes()->at(offset) == Bytecodes::ToByte(bytecode);
+}
+
+
+uint32_t BytecodeArrayBuilder::RegisterOperandAt(size_t offset,
+                                                 int operand_index) const {
+  Bytecode bytecode = Bytecodes::FromByte(bytecodes()->at(offset));
+  DCHECK_EQ(OperandType::kReg,
+            Bytecodes::GetOperandType(bytecode, operand_index));
+  int operand_offset = Bytecodes::GetOperandOffset(bytecode, operand_index,
+                                                   OperandScale::kSingle);
+  int8_t operand =
+      static_cast<int8_t>(bytecodes()->at(offset + operand_offset));
+  return static_cast<uint32_t>(static_cast<int32_t>(operand));
+}
+
+
+void BytecodeArrayBuilder::RemoveLastBytecode() {
+  DCHECK(LastBytecodeInSameBlock());
+  bytecodes()->resize(last_bytecode_start_);
+  last_bytecode_start_ = previous_bytecode_start_;
+  previous_bytecode_start_ = ~0;
+}
+
+
 // static
 Bytecode BytecodeArrayBuilder::BytecodeForBinaryOperation(Token::Value op) {
   switch (op) {
@@ -574,12 +773,6 @@ Bytecode BytecodeArrayBuilder::BytecodeForCompareOperation(Token::Value op) {
 }
 
 
-// static
-bool BytecodeArrayBuilder::FitsInIdxOperand(int value) {
-  return kMinUInt8 <= value && value <= kMaxUInt8;
-}
-
-
 // static
 bool BytecodeArrayBuilder::FitsInIdxOperand(size_t value) {
   return value <= static_cast<size_t>(kMaxUInt8);
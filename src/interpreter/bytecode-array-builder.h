@@ -23,6 +23,14 @@ namespace interpreter {
 class BytecodeLabel;
 class Register;
 
+// Builds a bytecode array. Unless constants are added as handles, building
+// the bytecode does not access the heap: constants for Smis and AST values
+// are only materialized by ToBytecodeArray(), which has to run on the main
+// thread after the AST has been internalized.
+//
+// Operands which do not fit into a single byte are emitted with a Wide or
+// ExtraWide prefix. With --ignition-fuse-bytecodes, frequent bytecode
+// sequences are fused into superinstructions as they are emitted.
 class BytecodeArrayBuilder {
  public:
   BytecodeArrayBuilder(Isolate* isolate, Zone* zone);
@@ -41,6 +49,7 @@ class BytecodeArrayBuilder {
   // Constant loads to accumulator.
   BytecodeArrayBuilder& LoadLiteral(v8::internal::Smi* value);
   BytecodeArrayBuilder& LoadLiteral(Handle<Object> object);
+  BytecodeArrayBuilder& LoadLiteral(const AstValue* value);
   BytecodeArrayBuilder& LoadUndefined();
   BytecodeArrayBuilder& LoadNull();
   BytecodeArrayBuilder& LoadTheHole();
@@ -71,9 +80,10 @@ class BytecodeArrayBuilder {
   // Call a JS function. The JSFunction or Callable to be called should be in
   // |callable|, the receiver should be in |receiver| and all subsequent
   // arguments should be in registers <receiver + 1> to
-  // <receiver + 1 + arg_count>.
+  // <receiver + 1 + arg_count>. The call target is recorded in the CallIC
+  // slot |feedback_slot|.
   BytecodeArrayBuilder& Call(Register callable, Register receiver,
-                             size_t arg_count);
+                             size_t arg_count, int feedback_slot);
 
   // Operators (register == lhs, accumulator = rhs).
   BytecodeArrayBuilder& BinaryOperation(Token::Value binop, Register reg);
@@ -102,19 +112,26 @@ class BytecodeArrayBuilder {
 
   static Bytecode BytecodeForBinaryOperation(Token::Value op);
   static Bytecode BytecodeForCompareOperation(Token::Value op);
-  static bool FitsInIdxOperand(int value);
   static bool FitsInIdxOperand(size_t value);
   static bool FitsInImm8Operand(int value);
+  static uint32_t RegisterOperand(Register reg);
   static bool IsJumpWithImm8Operand(Bytecode jump_bytecode);
   static Bytecode GetJumpWithConstantOperand(Bytecode jump_with_smi8_operand);
 
-  template <size_t N>
-  INLINE(void Output(uint8_t(&bytes)[N]));
-  void Output(Bytecode bytecode, uint8_t operand0, uint8_t operand1,
-              uint8_t operand2);
-  void Output(Bytecode bytecode, uint8_t operand0, uint8_t operand1);
-  void Output(Bytecode bytecode, uint8_t operand0);
+  // Operands are passed as raw 32-bit values. Signed operands are truncated
+  // and sign-extended when decoded, so e.g. register operands are passed as
+  // RegisterOperand(reg).
+  void Output(Bytecode bytecode, uint32_t operand0, uint32_t operand1,
+              uint32_t operand2, uint32_t operand3);
+  void Output(Bytecode bytecode, uint32_t operand0, uint32_t operand1,
+              uint32_t operand2);
+  void Output(Bytecode bytecode, uint32_t operand0, uint32_t operand1);
+  void Output(Bytecode bytecode, uint32_t operand0);
   void Output(Bytecode bytecode);
+  // Emits a Wide or ExtraWide prefix if the operands need it or if
+  // |operand_scale| asks for it.
+  void OutputScaled(Bytecode bytecode, const uint32_t* operands,
+                    int operand_count, OperandScale operand_scale);
   void PatchJump(const ZoneVector<uint8_t>::iterator& jump_target,
                  ZoneVector<uint8_t>::iterator jump_location);
   BytecodeArrayBuilder& OutputJump(Bytecode jump_bytecode,
@@ -123,10 +140,26 @@ class BytecodeArrayBuilder {
   void EnsureReturn();
 
   bool OperandIsValid(Bytecode bytecode, int operand_index,
-                      uint8_t operand_value) const;
+                      uint32_t operand_value) const;
   bool LastBytecodeInSameBlock() const;
 
+  // Helpers for fusing superinstructions. A bytecode can be fused if it is
+  // unprefixed and neither it nor any later bytecode is a jump target.
+  bool CanFuseBytecodeAt(size_t offset, Bytecode bytecode) const;
+  uint32_t RegisterOperandAt(size_t offset, int operand_index) const;
+  void RemoveLastBytecode();
+
   size_t GetConstantPoolEntry(Handle<Object> object);
+  size_t GetConstantPoolEntry(Smi* smi);
+  size_t GetConstantPoolEntry(const AstValue* value);
+  BytecodeArrayBuilder& LoadConstantPoolEntry(size_t entry);
+
+  // A forward jump reserves a constant pool entry that fits an unprefixed
+  // Idx operand in case its offset turns out not to fit an Imm8 operand.
+  // The reservation is committed or discarded when the jump is patched.
+  bool ReserveConstantPoolEntry();
+  size_t CommitReservedConstantPoolEntry(Smi* smi);
+  void DiscardReservedConstantPoolEntry();
 
   // Scope helpers used by TemporaryRegisterScope
   int BorrowTemporaryRegister();
@@ -137,10 +170,32 @@ class BytecodeArrayBuilder {
   bool bytecode_generated_;
   size_t last_block_end_;
   size_t last_bytecode_start_;
+  size_t previous_bytecode_start_;
+  size_t last_bound_label_offset_;
   bool return_seen_in_block_;
 
+  // A constant pool entry is either a handle, a Smi or an AST value.
+  struct Constant {
+    Handle<Object> object;
+    Smi* smi;
+    const AstValue* value;
+  };
+
+  size_t AddConstantPoolEntry(const Constant& constant);
+
+  // Constants are deduplicated by object identity, by Smi value and by AST
+  // string respectively. AST numbers get an entry each, like the heap numbers
+  // they internalize to.
   IdentityMap<size_t> constants_map_;
-  ZoneVector<Handle<Object>> constants_;
+  ZoneMap<int, size_t> smi_constants_map_;
+  ZoneMap<const void*, size_t> ast_constants_map_;
+  ZoneVector<Constant> constants_;
+
+  // Reservations of pending forward jumps, see ReserveConstantPoolEntry.
+  // They are counted until new constants would push them out of the
+  // unprefixed range, at which point placeholder entries are allocated.
+  size_t reserved_entry_count_;
+  ZoneVector<size_t> reserved_entries_;
 
   int parameter_count_;
   int local_register_count_;
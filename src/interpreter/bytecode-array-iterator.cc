@@ -16,7 +16,7 @@ BytecodeArrayIterator::BytecodeArrayIterator(
 
 
 void BytecodeArrayIterator::Advance() {
-  bytecode_offset_ += Bytecodes::Size(current_bytecode());
+  bytecode_offset_ += current_bytecode_size();
 }
 
 
@@ -27,37 +27,91 @@ bool BytecodeArrayIterator::done() const {
 
 Bytecode BytecodeArrayIterator::current_bytecode() const {
   DCHECK(!done());
-  uint8_t current_byte = bytecode_array()->get(bytecode_offset_);
+  uint8_t current_byte =
+      bytecode_array()->get(bytecode_offset_ + current_prefix_offset());
   return interpreter::Bytecodes::FromByte(current_byte);
 }
 
 
-uint8_t BytecodeArrayIterator::GetRawOperand(int operand_index,
-                                             OperandType operand_type) const {
+int BytecodeArrayIterator::current_bytecode_size() const {
+  return current_prefix_offset() +
+         Bytecodes::Size(current_bytecode(), current_operand_scale());
+}
+
+
+OperandScale BytecodeArrayIterator::current_operand_scale() const {
+  DCHECK(!done());
+  Bytecode bytecode =
+      Bytecodes::FromByte(bytecode_array()->get(bytecode_offset_));
+  if (Bytecodes::IsPrefixScalingBytecode(bytecode)) {
+    return Bytecodes::PrefixBytecodeToOperandScale(bytecode);
+  }
+  return OperandScale::kSingle;
+}
+
+
+int BytecodeArrayIterator::current_prefix_offset() const {
+  return current_operand_scale() == OperandScale::kSingle ? 0 : 1;
+}
+
+
+uint32_t BytecodeArrayIterator::GetRawOperand(int operand_index,
+                                              OperandType operand_type) const {
   DCHECK_GE(operand_index, 0);
   DCHECK_LT(operand_index, Bytecodes::NumberOfOperands(current_bytecode()));
   DCHECK_EQ(operand_type,
             Bytecodes::GetOperandType(current_bytecode(), operand_index));
-  int operands_start = bytecode_offset_ + 1;
-  return bytecode_array()->get(operands_start + operand_index);
+  OperandScale operand_scale = current_operand_scale();
+  int operand_start =
+      bytecode_offset_ + current_prefix_offset() +
+      Bytecodes::GetOperandOffset(current_bytecode(), operand_index,
+                                  operand_scale);
+  // Operands are encoded in little-endian order.
+  uint32_t value = 0;
+  for (int i = static_cast<int>(operand_scale) - 1; i >= 0; i--) {
+    value = (value << kBitsPerByte) | bytecode_array()->get(operand_start + i);
+  }
+  return value;
+}
+
+
+int32_t BytecodeArrayIterator::GetSignedOperand(
+    int operand_index, OperandType operand_type) const {
+  DCHECK(Bytecodes::IsSignedOperandType(operand_type));
+  uint32_t operand = GetRawOperand(operand_index, operand_type);
+  switch (current_operand_scale()) {
+    case OperandScale::kSingle:
+      return static_cast<int8_t>(operand);
+    case OperandScale::kDouble:
+      return static_cast<int16_t>(operand);
+    case OperandScale::kQuadruple:
+      return static_cast<int32_t>(operand);
+  }
+  UNREACHABLE();
+  return 0;
 }
 
 
-int8_t BytecodeArrayIterator::GetSmi8Operand(int operand_index) const {
-  uint8_t operand = GetRawOperand(operand_index, OperandType::kImm8);
-  return static_cast<int8_t>(operand);
+int32_t BytecodeArrayIterator::GetSmi8Operand(int operand_index) const {
+  return GetSignedOperand(operand_index, OperandType::kImm8);
 }
 
 
 int BytecodeArrayIterator::GetIndexOperand(int operand_index) const {
-  uint8_t operand = GetRawOperand(operand_index, OperandType::kIdx);
+  uint32_t operand = GetRawOperand(operand_index, OperandType::kIdx);
+  return static_cast<int>(operand);
+}
+
+
+int BytecodeArrayIterator::GetCountOperand(int operand_index) const {
+  uint32_t operand = GetRawOperand(operand_index, OperandType::kCount);
   return static_cast<int>(operand);
 }
 
 
 Register BytecodeArrayIterator::GetRegisterOperand(int operand_index) const {
-  uint8_t operand = GetRawOperand(operand_index, OperandType::kReg);
-  return Register::FromOperand(operand);
+  return Register::FromRawOperand(
+      GetSignedOperand(operand_index, OperandType::kReg));
 }
 
 
@@ -19,22 +19,35 @@ class BytecodeArrayIterator {
 
   void Advance();
   bool done() const;
+  // Returns the current bytecode, skipping over a Wide or ExtraWide prefix.
   Bytecode current_bytecode() const;
+  // Returns the size of the current bytecode including its prefix, if any.
+  int current_bytecode_size() const;
+  // Returns the offset of the current bytecode, or of its prefix if it has
+  // one.
   int current_offset() const { return bytecode_offset_; }
+  // Returns the scale of the operands of the current bytecode.
+  OperandScale current_operand_scale() const;
+  // Returns the size of the prefix of the current bytecode.
+  int current_prefix_offset() const;
   const Handle<BytecodeArray>& bytecode_array() const {
     return bytecode_array_;
   }
 
-  int8_t GetSmi8Operand(int operand_index) const;
+  int32_t GetSmi8Operand(int operand_index) const;
   int GetIndexOperand(int operand_index) const;
+  int GetCountOperand(int operand_index) const;
   Register GetRegisterOperand(int operand_index) const;
   Handle<Object> GetConstantForIndexOperand(int operand_index) const;
 
-  // Get the raw byte for the given operand. Note: you should prefer using the
-  // typed versions above which cast the return to an appropriate type.
-  uint8_t GetRawOperand(int operand_index, OperandType operand_type) const;
+  // Get the raw value for the given operand, zero-extended from its operand
+  // scale. Note: you should prefer using the typed versions above which cast
+  // the return to an appropriate type.
+  uint32_t GetRawOperand(int operand_index, OperandType operand_type) const;
 
  private:
+  int32_t GetSignedOperand(int operand_index, OperandType operand_type) const;
+
   Handle<BytecodeArray> bytecode_array_;
   int bytecode_offset_;
 
@@ -10,6 +10,7 @@
 #include "src/objects.h"
 #include "src/scopes.h"
 #include "src/token.h"
+#include "src/type-feedback-vector.h"
 
 namespace v8 {
 namespace internal {
@@ -25,6 +26,12 @@ BytecodeGenerator::~BytecodeGenerator() {}
 
 
 Handle<BytecodeArray> BytecodeGenerator::MakeBytecode(CompilationInfo* info) {
+  GenerateBytecode(info);
+  return FinalizeBytecode();
+}
+
+
+void BytecodeGenerator::GenerateBytecode(CompilationInfo* info) {
   set_info(info);
   set_scope(info->scope());
 
@@ -47,6 +54,10 @@ Handle<BytecodeArray> BytecodeGenerator::MakeBytecode(CompilationInfo* info) {
 
   set_scope(nullptr);
   set_info(nullptr);
+}
+
+
+Handle<BytecodeArray> BytecodeGenerator::FinalizeBytecode() {
   return builder_.ToBytecodeArray();
 }
 
@@ -226,9 +237,9 @@ void BytecodeGenerator::VisitConditional(Conditional* expr) { UNIMPLEMENTED(); }
 
 
 void BytecodeGenerator::VisitLiteral(Literal* expr) {
-  Handle<Object> value = expr->value();
+  const AstValue* value = expr->raw_value();
   if (value->IsSmi()) {
-    builder().LoadLiteral(Smi::cast(*value));
+    builder().LoadLiteral(Smi::FromInt(value->AsSmi()));
   } else if (value->IsUndefined()) {
     builder().LoadUndefined();
   } else if (value->IsTrue()) {
@@ -315,7 +326,7 @@ void BytecodeGenerator::VisitAssignment(Assignment* expr) {
       key = temporary_register_scope.NewRegister();
       Visit(property->obj());
       builder().StoreAccumulatorInRegister(object);
-      builder().LoadLiteral(property->key()->AsLiteral()->AsPropertyName());
+      builder().LoadLiteral(property->key()->AsLiteral()->raw_value());
       builder().StoreAccumulatorInRegister(key);
       break;
     case KEYED_PROPERTY:
@@ -377,7 +388,7 @@ void BytecodeGenerator::VisitPropertyLoad(Register obj, Property* expr) {
     case VARIABLE:
       UNREACHABLE();
     case NAMED_PROPERTY: {
-      builder().LoadLiteral(expr->key()->AsLiteral()->AsPropertyName());
+      builder().LoadLiteral(expr->key()->AsLiteral()->raw_value());
       builder().LoadNamedProperty(obj, feedback_index(slot), language_mode());
       break;
     }
@@ -404,7 +415,7 @@ void BytecodeGenerator::VisitProperty(Property* expr) {
 
 void BytecodeGenerator::VisitCall(Call* expr) {
   Expression* callee_expr = expr->expression();
-  Call::CallType call_type = expr->GetCallType(isolate());
+  Call::CallType call_type = expr->GetCallType();
 
   // Prepare the callee and the receiver to the function call. This depends on
   // the semantics of the underlying call type.
@@ -452,8 +463,8 @@ void BytecodeGenerator::VisitCall(Call* expr) {
   }
 
   // TODO(rmcilroy): Deal with possible direct eval here?
-  // TODO(rmcilroy): Use CallIC to allow call type feedback.
-  builder().Call(callee, receiver, args->length());
+  builder().Call(callee, receiver, args->length(),
+                 feedback_index(expr->CallFeedbackICSlot()));
 }
 
 
@@ -547,7 +558,8 @@ LanguageMode BytecodeGenerator::language_mode() const {
 
 
 int BytecodeGenerator::feedback_index(FeedbackVectorICSlot slot) const {
-  return info()->feedback_vector()->GetIndex(slot);
+  return TypeFeedbackVector::GetIndexFromSpec(
+      info()->literal()->feedback_vector_spec(), slot);
 }
 
 }  // namespace interpreter
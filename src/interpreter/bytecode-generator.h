@@ -18,8 +18,16 @@ class BytecodeGenerator : public AstVisitor {
   BytecodeGenerator(Isolate* isolate, Zone* zone);
   virtual ~BytecodeGenerator();
 
+  // Generates the bytecode for the function in |info| and allocates the
+  // bytecode array.
   Handle<BytecodeArray> MakeBytecode(CompilationInfo* info);
 
+  // The two phases of MakeBytecode(). GenerateBytecode() does not access the
+  // heap. FinalizeBytecode() allocates the bytecode array and its constant
+  // pool, which requires the AST to be internalized.
+  void GenerateBytecode(CompilationInfo* info);
+  Handle<BytecodeArray> FinalizeBytecode();
+
 #define DECLARE_VISIT(type) void Visit##type(type* node) override;
   AST_NODE_LIST(DECLARE_VISIT)
 #undef DECLARE_VISIT
@@ -11,7 +11,7 @@ namespace internal {
 namespace interpreter {
 
 // Maximum number of operands a bytecode may have.
-static const int kMaxOperands = 3;
+static const int kMaxOperands = 4;
 
 // kBytecodeTable relies on kNone being the same as zero to detect length.
 STATIC_ASSERT(static_cast<int>(OperandType::kNone) == 0);
@@ -90,7 +90,85 @@ OperandType Bytecodes::GetOperandType(Bytecode bytecode, int i) {
 
 // static
 int Bytecodes::Size(Bytecode bytecode) {
-  return 1 + NumberOfOperands(bytecode);
+  return Size(bytecode, OperandScale::kSingle);
+}
+
+
+// static
+int Bytecodes::Size(Bytecode bytecode, OperandScale operand_scale) {
+  return 1 + NumberOfOperands(bytecode) * static_cast<int>(operand_scale);
+}
+
+
+// static
+int Bytecodes::GetOperandOffset(Bytecode bytecode, int i,
+                                OperandScale operand_scale) {
+  DCHECK_LT(i, NumberOfOperands(bytecode));
+  return 1 + i * static_cast<int>(operand_scale);
+}
+
+
+// static
+bool Bytecodes::IsSignedOperandType(OperandType operand_type) {
+  return operand_type == OperandType::kImm8 ||
+         operand_type == OperandType::kReg;
+}
+
+
+// static
+OperandScale Bytecodes::OperandScaleForSignedOperand(int32_t value) {
+  if (kMinInt8 <= value && value <= kMaxInt8) {
+    return OperandScale::kSingle;
+  } else if (kMinInt16 <= value && value <= kMaxInt16) {
+    return OperandScale::kDouble;
+  }
+  return OperandScale::kQuadruple;
+}
+
+
+// static
+OperandScale Bytecodes::OperandScaleForUnsignedOperand(uint32_t value) {
+  if (value <= static_cast<uint32_t>(kMaxUInt8)) {
+    return OperandScale::kSingle;
+  } else if (value <= static_cast<uint32_t>(kMaxUInt16)) {
+    return OperandScale::kDouble;
+  }
+  return OperandScale::kQuadruple;
+}
+
+
+// static
+bool Bytecodes::IsPrefixScalingBytecode(Bytecode bytecode) {
+  return bytecode == Bytecode::kWide || bytecode == Bytecode::kExtraWide;
+}
+
+
+// static
+Bytecode Bytecodes::OperandScaleToPrefixBytecode(OperandScale operand_scale) {
+  switch (operand_scale) {
+    case OperandScale::kDouble:
+      return Bytecode::kWide;
+    case OperandScale::kQuadruple:
+      return Bytecode::kExtraWide;
+    case OperandScale::kSingle:
+      break;
+  }
+  UNREACHABLE();
+  return Bytecode::kWide;
+}
+
+
+// static
+OperandScale Bytecodes::PrefixBytecodeToOperandScale(Bytecode bytecode) {
+  switch (bytecode) {
+    case Bytecode::kWide:
+      return OperandScale::kDouble;
+    case Bytecode::kExtraWide:
+      return OperandScale::kQuadruple;
+    default:
+      UNREACHABLE();
+      return OperandScale::kSingle;
+  }
 }
 
 
@@ -99,7 +177,36 @@ int Bytecodes::MaximumNumberOfOperands() { return kMaxOperands; }
 
 
 // static
-int Bytecodes::MaximumSize() { return 1 + kMaxOperands; }
+int Bytecodes::MaximumSize() {
+  return 2 + kMaxOperands * static_cast<int>(OperandScale::kMaxValid);
+}
+
+
+// Reads an operand of |operand_scale| bytes in little-endian order.
+static uint32_t DecodeUnsignedOperand(const uint8_t* operand_start,
+                                      OperandScale operand_scale) {
+  uint32_t value = 0;
+  for (int i = static_cast<int>(operand_scale) - 1; i >= 0; i--) {
+    value = (value << kBitsPerByte) | operand_start[i];
+  }
+  return value;
+}
+
+
+static int32_t DecodeSignedOperand(const uint8_t* operand_start,
+                                   OperandScale operand_scale) {
+  uint32_t value = DecodeUnsignedOperand(operand_start, operand_scale);
+  switch (operand_scale) {
+    case OperandScale::kSingle:
+      return static_cast<int8_t>(value);
+    case OperandScale::kDouble:
+      return static_cast<int16_t>(value);
+    case OperandScale::kQuadruple:
+      return static_cast<int32_t>(value);
+  }
+  UNREACHABLE();
+  return 0;
+}
 
 
 // static
@@ -108,35 +215,51 @@ std::ostream& Bytecodes::Decode(std::ostream& os, const uint8_t* bytecode_start,
   Vector<char> buf = Vector<char>::New(50);
 
   Bytecode bytecode = Bytecodes::FromByte(bytecode_start[0]);
-  int bytecode_size = Bytecodes::Size(bytecode);
+  OperandScale operand_scale = OperandScale::kSingle;
+  int prefix_size = 0;
+  if (IsPrefixScalingBytecode(bytecode)) {
+    operand_scale = PrefixBytecodeToOperandScale(bytecode);
+    prefix_size = 1;
+    bytecode = Bytecodes::FromByte(bytecode_start[1]);
+  }
+  int bytecode_size = prefix_size + Bytecodes::Size(bytecode, operand_scale);
 
   for (int i = 0; i < bytecode_size; i++) {
     SNPrintF(buf, "%02x ", bytecode_start[i]);
     os << buf.start();
   }
-  for (int i = bytecode_size; i < Bytecodes::MaximumSize(); i++) {
+  // Pad to the size of the largest unprefixed bytecode, prefixed bytecodes
+  // are rare enough to not be worth aligning to.
+  for (int i = bytecode_size; i < 1 + kMaxOperands; i++) {
     os << "   ";
   }
 
-  os << bytecode << " ";
+  os << bytecode;
+  if (operand_scale != OperandScale::kSingle) {
+    os << "." << Bytecodes::OperandScaleToPrefixBytecode(operand_scale);
+  }
+  os << " ";
 
-  const uint8_t* operands_start = bytecode_start + 1;
-  int operands_size = bytecode_size - 1;
-  for (int i = 0; i < operands_size; i++) {
+  const uint8_t* operands_start = bytecode_start + prefix_size;
+  int number_of_operands = NumberOfOperands(bytecode);
+  for (int i = 0; i < number_of_operands; i++) {
     OperandType op_type = GetOperandType(bytecode, i);
-    uint8_t operand = operands_start[i];
+    const uint8_t* operand_start =
+        operands_start + GetOperandOffset(bytecode, i, operand_scale);
     switch (op_type) {
       case interpreter::OperandType::kCount:
-        os << "#" << static_cast<unsigned int>(operand);
+        os << "#" << DecodeUnsignedOperand(operand_start, operand_scale);
         break;
       case interpreter::OperandType::kIdx:
-        os << "[" << static_cast<unsigned int>(operand) << "]";
+        os << "[" << DecodeUnsignedOperand(operand_start, operand_scale)
+           << "]";
         break;
       case interpreter::OperandType::kImm8:
-        os << "#" << static_cast<int>(static_cast<int8_t>(operand));
+        os << "#" << DecodeSignedOperand(operand_start, operand_scale);
         break;
       case interpreter::OperandType::kReg: {
-        Register reg = Register::FromOperand(operand);
+        Register reg = Register::FromRawOperand(
+            DecodeSignedOperand(operand_start, operand_scale));
         if (reg.is_parameter()) {
           int parameter_index = reg.ToParameterIndex(parameter_count);
           if (parameter_index == 0) {
@@ -153,7 +276,7 @@ std::ostream& Bytecodes::Decode(std::ostream& os, const uint8_t* bytecode_start,
         UNREACHABLE();
         break;
     }
-    if (i != operands_size - 1) {
+    if (i != number_of_operands - 1) {
       os << ", ";
     }
   }
@@ -171,6 +294,11 @@ std::ostream& operator<<(std::ostream& os, const OperandType& operand_type) {
 }
 
 
+std::ostream& operator<<(std::ostream& os, const OperandScale& operand_scale) {
+  return os << "x" << static_cast<int>(operand_scale);
+}
+
+
 static const int kLastParamRegisterIndex =
     -InterpreterFrameConstants::kLastParamFromRegisterPointer / kPointerSize;
 
@@ -201,7 +329,11 @@ int Register::ToParameterIndex(int parameter_count) const {
 int Register::MaxParameterIndex() { return kMaxParameterIndex; }
 
 
-uint8_t Register::ToOperand() const { return static_cast<uint8_t>(-index_); }
+uint8_t Register::ToOperand() const {
+  DCHECK_LE(index_, kMaxRegisterIndex);
+  DCHECK_GE(index_, kMinRegisterIndex);
+  return static_cast<uint8_t>(-index_);
+}
 
 
 Register Register::FromOperand(uint8_t operand) {
@@ -26,6 +26,10 @@ namespace interpreter {
 // The list of bytecodes which are interpreted by the interpreter.
 #define BYTECODE_LIST(V)                                                   \
                                                                            \
+  /* Prefixes which scale the operands of the next bytecode */             \
+  V(Wide, OperandType::kNone)                                              \
+  V(ExtraWide, OperandType::kNone)                                         \
+                                                                           \
   /* Loading the accumulator */                                            \
   V(LdaZero, OperandType::kNone)                                           \
   V(LdaSmi8, OperandType::kImm8)                                           \
@@ -43,6 +47,9 @@ namespace interpreter {
   V(Ldar, OperandType::kReg)                                               \
   V(Star, OperandType::kReg)                                               \
                                                                            \
+  /* Fused Ldar, Add and Star */                                           \
+  V(LdarAddStar, OperandType::kReg, OperandType::kReg, OperandType::kReg)  \
+                                                                           \
   /* LoadIC operations */                                                  \
   V(LoadIC, OperandType::kReg, OperandType::kIdx)                          \
   V(KeyedLoadIC, OperandType::kReg, OperandType::kIdx)                     \
@@ -59,7 +66,8 @@ namespace interpreter {
   V(Mod, OperandType::kReg)                                                \
                                                                            \
   /* Call operations. */                                                   \
-  V(Call, OperandType::kReg, OperandType::kReg, OperandType::kCount)       \
+  V(Call, OperandType::kReg, OperandType::kReg, OperandType::kCount,       \
+    OperandType::kIdx)                                                     \
                                                                            \
   /* Test Operators */                                                     \
   V(TestEqual, OperandType::kReg)                                          \
@@ -83,6 +91,11 @@ namespace interpreter {
   V(JumpIfTrueConstant, OperandType::kIdx)                                 \
   V(JumpIfFalse, OperandType::kImm8)                                       \
   V(JumpIfFalseConstant, OperandType::kIdx)                                \
+                                                                           \
+  /* Fused TestLessThan and JumpIfFalse */                                 \
+  V(TestLessThanJumpIfFalse, OperandType::kReg, OperandType::kImm8)        \
+  V(TestLessThanJumpIfFalseConstant, OperandType::kReg, OperandType::kIdx) \
+                                                                           \
   V(Return, OperandType::kNone)
 
 
@@ -112,18 +125,31 @@ enum class Bytecode : uint8_t {
 };
 
 
+// The factor by which the operands of a bytecode are scaled. Operands are a
+// single byte wide unless the bytecode is preceded by a Wide or ExtraWide
+// prefix, which scale all of its operands to two or four bytes respectively.
+enum class OperandScale : uint8_t {
+  kSingle = 1,
+  kDouble = 2,
+  kQuadruple = 4,
+  kMaxValid = kQuadruple
+};
+
+
 // An interpreter register which is located in the function's register file
 // in its stack-frame. Register hold parameters, this, and expression values.
 class Register {
  public:
+  // Registers in this range can be encoded in single byte operands. Registers
+  // outside of it require a Wide or ExtraWide prefix.
   static const int kMaxRegisterIndex = 127;
   static const int kMinRegisterIndex = -128;
 
   Register() : index_(kIllegalIndex) {}
 
   explicit Register(int index) : index_(index) {
-    DCHECK_LE(index_, kMaxRegisterIndex);
-    DCHECK_GE(index_, kMinRegisterIndex);
+    DCHECK_LT(index_, kIllegalIndex);
+    DCHECK_LT(-kIllegalIndex, index_);
   }
 
   int index() const {
@@ -136,9 +162,15 @@ class Register {
   int ToParameterIndex(int parameter_count) const;
   static int MaxParameterIndex();
 
+  // Conversion from and to single byte operands.
   static Register FromOperand(uint8_t operand);
   uint8_t ToOperand() const;
 
+  // Conversion from and to operands of any scale, which hold the negated
+  // register index.
+  static Register FromRawOperand(int32_t operand) { return Register(-operand); }
+  int32_t ToRawOperand() const { return -index(); }
+
  private:
   static const int kIllegalIndex = kMaxInt;
 
@@ -172,13 +204,39 @@ class Bytecodes {
   // Returns the size of the bytecode including its operands.
   static int Size(Bytecode bytecode);
 
+  // Returns the size of the bytecode including its operands when they are
+  // scaled by |operand_scale|. Does not include the size of the prefix.
+  static int Size(Bytecode bytecode, OperandScale operand_scale);
+
+  // Returns the offset of the i-th operand of |bytecode| relative to the start
+  // of the bytecode.
+  static int GetOperandOffset(Bytecode bytecode, int i,
+                              OperandScale operand_scale);
+
+  // Returns true if operands of type |operand_type| are sign-extended.
+  static bool IsSignedOperandType(OperandType operand_type);
+
+  // Returns the smallest operand scale that can encode |value|.
+  static OperandScale OperandScaleForSignedOperand(int32_t value);
+  static OperandScale OperandScaleForUnsignedOperand(uint32_t value);
+
+  // Returns true if |bytecode| is a Wide or ExtraWide prefix.
+  static bool IsPrefixScalingBytecode(Bytecode bytecode);
+
+  // Returns the prefix bytecode for |operand_scale|, which must not be
+  // OperandScale::kSingle.
+  static Bytecode OperandScaleToPrefixBytecode(OperandScale operand_scale);
+
+  // Returns the operand scale applied by the prefix |bytecode|.
+  static OperandScale PrefixBytecodeToOperandScale(Bytecode bytecode);
+
   // The maximum number of operands across all bytecodes.
   static int MaximumNumberOfOperands();
 
-  // Maximum size of a bytecode and its operands.
+  // Maximum size of a bytecode and its operands, including prefixes.
   static int MaximumSize();
 
-  // Decode a single bytecode and operands to |os|.
+  // Decode a single, possibly prefixed, bytecode and operands to |os|.
   static std::ostream& Decode(std::ostream& os, const uint8_t* bytecode_start,
                               int number_of_parameters);
 
@@ -188,6 +246,7 @@ class Bytecodes {
 
 std::ostream& operator<<(std::ostream& os, const Bytecode& bytecode);
 std::ostream& operator<<(std::ostream& os, const OperandType& operand_type);
+std::ostream& operator<<(std::ostream& os, const OperandScale& operand_scale);
 
 }  // namespace interpreter
 }  // namespace internal
@@ -4,6 +4,9 @@
 
 #include "src/interpreter/interpreter.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "src/code-factory.h"
 #include "src/compiler.h"
 #include "src/compiler/interpreter-assembler.h"
@@ -20,15 +23,29 @@ using compiler::Node;
 #define __ assembler->
 
 
+static const OperandScale kOperandScales[] = {
+    OperandScale::kSingle, OperandScale::kDouble, OperandScale::kQuadruple};
+STATIC_ASSERT(arraysize(kOperandScales) ==
+              Interpreter::kNumberOfOperandScales);
+
+
 Interpreter::Interpreter(Isolate* isolate)
-    : isolate_(isolate) {}
+    : isolate_(isolate) {
+  if (FLAG_trace_ignition_dispatches) {
+    static const int kCounters =
+        kEntriesPerOperandScale * kEntriesPerOperandScale;
+    bytecode_dispatch_counters_table_.Reset(new uintptr_t[kCounters]);
+    memset(bytecode_dispatch_counters_table_.get(), 0,
+           sizeof(uintptr_t) * kCounters);
+  }
+}
 
 
 // static
 Handle<FixedArray> Interpreter::CreateUninitializedInterpreterTable(
     Isolate* isolate) {
   Handle<FixedArray> handler_table = isolate->factory()->NewFixedArray(
-      static_cast<int>(Bytecode::kLast) + 1, TENURED);
+      kNumberOfOperandScales * kEntriesPerOperandScale, TENURED);
   // We rely on the interpreter handler table being immovable, so check that
   // it was allocated on the first page (which is always immovable).
   DCHECK(isolate->heap()->old_space()->FirstPage()->Contains(
@@ -44,48 +61,142 @@ void Interpreter::Initialize() {
     Zone zone;
     HandleScope scope(isolate_);
 
-#define GENERATE_CODE(Name, ...)                                      \
-    {                                                                 \
-      compiler::InterpreterAssembler assembler(isolate_, &zone,       \
-                                               Bytecode::k##Name);    \
-      Do##Name(&assembler);                                           \
-      Handle<Code> code = assembler.GenerateCode();                   \
-      handler_table->set(static_cast<int>(Bytecode::k##Name), *code); \
-    }
-    BYTECODE_LIST(GENERATE_CODE)
+    for (OperandScale operand_scale : kOperandScales) {
+#define GENERATE_CODE(Name, ...)                                             \
+  {                                                                          \
+    int index = GetDispatchTableIndex(Bytecode::k##Name, operand_scale);     \
+    if (operand_scale == OperandScale::kSingle ||                            \
+        Bytecodes::NumberOfOperands(Bytecode::k##Name) > 0) {                \
+      compiler::InterpreterAssembler assembler(isolate_, &zone,              \
+                                               Bytecode::k##Name,            \
+                                               operand_scale);               \
+      Do##Name(&assembler);                                                  \
+      Handle<Code> code = assembler.GenerateCode();                          \
+      handler_table->set(index, *code);                                      \
+    } else {                                                                 \
+      /* Prefixes do not change bytecodes without operands. */              \
+      handler_table->set(index, handler_table->get(static_cast<int>(         \
+                                    Bytecode::k##Name)));                    \
+    }                                                                        \
+  }
+      BYTECODE_LIST(GENERATE_CODE)
 #undef GENERATE_CODE
+    }
   }
 }
 
 
-bool Interpreter::MakeBytecode(CompilationInfo* info) {
-  Handle<SharedFunctionInfo> shared_info = info->shared_info();
+// static
+int Interpreter::GetDispatchTableIndex(Bytecode bytecode,
+                                       OperandScale operand_scale) {
+  int index = static_cast<int>(bytecode);
+  switch (operand_scale) {
+    case OperandScale::kSingle:
+      return index;
+    case OperandScale::kDouble:
+      return index + kEntriesPerOperandScale;
+    case OperandScale::kQuadruple:
+      return index + 2 * kEntriesPerOperandScale;
+  }
+  UNREACHABLE();
+  return index;
+}
+
+
+void Interpreter::PrintDispatchCounters() {
+  uintptr_t* counters = bytecode_dispatch_counters_table();
+  if (counters == NULL) return;
+
+  struct Entry {
+    uintptr_t count;
+    int from;
+    int to;
+    bool operator<(const Entry& other) const { return count > other.count; }
+  };
+  std::vector<Entry> entries;
+  std::vector<uintptr_t> totals_from(kEntriesPerOperandScale, 0);
+  uintptr_t total = 0;
+  for (int from = 0; from < kEntriesPerOperandScale; from++) {
+    for (int to = 0; to < kEntriesPerOperandScale; to++) {
+      uintptr_t count = counters[from * kEntriesPerOperandScale + to];
+      if (count == 0) continue;
+      Entry entry = {count, from, to};
+      entries.push_back(entry);
+      totals_from[from] += count;
+      total += count;
+    }
+  }
+  std::sort(entries.begin(), entries.end());
+
+  // A pair is a candidate for a superinstruction if it is frequent overall
+  // and if the first bytecode is mostly followed by the second one. Run with
+  // --no-ignition-fuse-bytecodes to see the pairs that are currently fused.
+  PrintF("Bytecode dispatches (%" V8_PTR_PREFIX "u in total):\n", total);
+  PrintF("%12s %7s %7s  %s\n", "count", "total", "from", "from -> to");
+  for (const Entry& entry : entries) {
+    PrintF("%12" V8_PTR_PREFIX "u %6.2f%% %6.2f%%  %s -> %s\n", entry.count,
+           100.0 * entry.count / total,
+           100.0 * entry.count / totals_from[entry.from],
+           Bytecodes::ToString(Bytecodes::FromByte(entry.from)),
+           Bytecodes::ToString(Bytecodes::FromByte(entry.to)));
+  }
+}
 
+
+bool Interpreter::MakeBytecode(CompilationInfo* info) {
   BytecodeGenerator generator(info->isolate(), info->zone());
+  {
+    // Generating the bytecode must not touch the heap, so that it can be moved
+    // off the main thread.
+    DisallowHeapAllocation no_allocation;
+    DisallowHandleAllocation no_handles;
+    DisallowHandleDereference no_deref;
+    generator.GenerateBytecode(info);
+  }
   info->EnsureFeedbackVector();
-  Handle<BytecodeArray> bytecodes = generator.MakeBytecode(info);
+  Handle<BytecodeArray> bytecodes = generator.FinalizeBytecode();
   if (FLAG_print_bytecode) {
     bytecodes->Print();
   }
 
-  DCHECK(shared_info->function_data()->IsUndefined());
-  if (!shared_info->function_data()->IsUndefined()) {
-    return false;
-  }
-
-  shared_info->set_function_data(*bytecodes);
+  info->SetBytecodeArray(bytecodes);
   info->SetCode(info->isolate()->builtins()->InterpreterEntryTrampoline());
   return true;
 }
 
 
+// static
+int Interpreter::InterruptBudget() {
+  return FLAG_interrupt_budget * kCodeSizeMultiplier;
+}
+
+
 bool Interpreter::IsInterpreterTableInitialized(
     Handle<FixedArray> handler_table) {
-  DCHECK(handler_table->length() == static_cast<int>(Bytecode::kLast) + 1);
+  DCHECK(handler_table->length() ==
+         kNumberOfOperandScales * kEntriesPerOperandScale);
   return handler_table->get(0) != isolate_->heap()->undefined_value();
 }
 
 
+// Wide
+//
+// Prefix bytecode indicating that the operands of the next bytecode are
+// 16-bit wide.
+void Interpreter::DoWide(compiler::InterpreterAssembler* assembler) {
+  __ DispatchWide(OperandScale::kDouble);
+}
+
+
+// ExtraWide
+//
+// Prefix bytecode indicating that the operands of the next bytecode are
+// 32-bit wide.
+void Interpreter::DoExtraWide(compiler::InterpreterAssembler* assembler) {
+  __ DispatchWide(OperandScale::kQuadruple);
+}
+
+
 // LdaZero
 //
 // Load literal '0' into the accumulator.
@@ -191,6 +302,21 @@ void Interpreter::DoStar(compiler::InterpreterAssembler* assembler) {
 }
 
 
+// LdarAddStar <src> <lhs> <dst>
+//
+// Add register <lhs> to the value of register <src> and store the result in
+// the accumulator and in register <dst>. Fuses Ldar <src>, Add <lhs> and
+// Star <dst>.
+void Interpreter::DoLdarAddStar(compiler::InterpreterAssembler* assembler) {
+  Node* rhs = __ LoadRegister(__ BytecodeOperandReg(0));
+  Node* lhs = __ LoadRegister(__ BytecodeOperandReg(1));
+  Node* result = __ CallRuntime(Runtime::kAdd, lhs, rhs);
+  __ SetAccumulator(result);
+  __ StoreRegister(result, __ BytecodeOperandReg(2));
+  __ Dispatch();
+}
+
+
 // LdaGlobal <slot_index>
 //
 // Load the global at |slot_index| into the accumulator.
@@ -334,13 +460,15 @@ void Interpreter::DoMod(compiler::InterpreterAssembler* assembler) {
 }
 
 
-// Call <receiver> <arg_count>
+// Call <callable> <receiver> <arg_count> <feedback_slot>
 //
-// Call a JS function with receiver and |arg_count| arguments in subsequent
-// registers. The JSfunction or Callable to call is in the accumulator.
+// Call a JS function or Callable in <callable> with receiver and |arg_count|
+// arguments in subsequent registers. The call target is recorded in the
+// CallIC slot <feedback_slot>.
 void Interpreter::DoCall(compiler::InterpreterAssembler* assembler) {
   Node* function_reg = __ BytecodeOperandReg(0);
   Node* function = __ LoadRegister(function_reg);
+  __ RecordCallFeedback(function, __ BytecodeOperandIdx(3));
   Node* receiver_reg = __ BytecodeOperandReg(1);
   Node* first_arg = __ RegisterLocation(receiver_reg);
   Node* args_count = __ BytecodeOperandCount(2);
@@ -522,10 +650,51 @@ void Interpreter::DoJumpIfFalseConstant(
 }
 
 
+void Interpreter::DoCompareAndJumpIfFalse(
+    Runtime::FunctionId function_id, Node* relative_jump,
+    compiler::InterpreterAssembler* assembler) {
+  Node* reg_index = __ BytecodeOperandReg(0);
+  Node* lhs = __ LoadRegister(reg_index);
+  Node* rhs = __ GetAccumulator();
+  Node* result = __ CallRuntime(function_id, lhs, rhs);
+  __ SetAccumulator(result);
+  Node* false_value = __ BooleanConstant(false);
+  __ JumpIfWordEqual(result, false_value, relative_jump);
+}
+
+
+// TestLessThanJumpIfFalse <src> <imm8>
+//
+// Test if the value in the <src> register is less than the accumulator and
+// jump by the immediate operand if it is not. Fuses TestLessThan <src> and
+// JumpIfFalse <imm8>.
+void Interpreter::DoTestLessThanJumpIfFalse(
+    compiler::InterpreterAssembler* assembler) {
+  Node* relative_jump = __ BytecodeOperandImm8(1);
+  DoCompareAndJumpIfFalse(Runtime::kInterpreterLessThan, relative_jump,
+                          assembler);
+}
+
+
+// TestLessThanJumpIfFalseConstant <src> <idx>
+//
+// Test if the value in the <src> register is less than the accumulator and
+// jump by the Smi in the |idx| entry in the constant pool if it is not.
+void Interpreter::DoTestLessThanJumpIfFalseConstant(
+    compiler::InterpreterAssembler* assembler) {
+  Node* index = __ BytecodeOperandIdx(1);
+  Node* constant = __ LoadConstantPoolEntry(index);
+  Node* relative_jump = __ SmiUntag(constant);
+  DoCompareAndJumpIfFalse(Runtime::kInterpreterLessThan, relative_jump,
+                          assembler);
+}
+
+
 // Return
 //
 // Return the value in register 0.
 void Interpreter::DoReturn(compiler::InterpreterAssembler* assembler) {
+  __ UpdateInterruptBudgetOnReturn();
   __ Return();
 }
 
@@ -9,6 +9,7 @@
 // Do not include anything from src/interpreter other than
 // src/interpreter/bytecodes.h here!
 #include "src/base/macros.h"
+#include "src/base/smart-pointers.h"
 #include "src/builtins.h"
 #include "src/interpreter/bytecodes.h"
 #include "src/runtime/runtime.h"
@@ -23,6 +24,7 @@ class CompilationInfo;
 
 namespace compiler {
 class InterpreterAssembler;
+class Node;
 }
 
 namespace interpreter {
@@ -43,6 +45,30 @@ class Interpreter {
   // Generate bytecode for |info|.
   static bool MakeBytecode(CompilationInfo* info);
 
+  // Returns the interrupt budget of a BytecodeArray, in bytes of bytecode
+  // executed between two ticks of the runtime profiler.
+  static int InterruptBudget();
+
+  // The handler table holds one handler per bytecode for each operand scale.
+  // Wide and ExtraWide dispatch to the handler of the next bytecode for their
+  // operand scale.
+  static const int kEntriesPerOperandScale =
+      static_cast<int>(Bytecode::kLast) + 1;
+  static const int kNumberOfOperandScales = 3;
+  static int GetDispatchTableIndex(Bytecode bytecode,
+                                   OperandScale operand_scale);
+
+  // Returns the table of dispatch counters indexed by
+  // source bytecode * kEntriesPerOperandScale + target bytecode, or NULL
+  // unless --trace-ignition-dispatches is on.
+  uintptr_t* bytecode_dispatch_counters_table() {
+    return bytecode_dispatch_counters_table_.get();
+  }
+
+  // Prints the histogram of dispatches between pairs of bytecodes, which is
+  // used to select the sequences fused into superinstructions.
+  void PrintDispatchCounters();
+
  private:
 // Bytecode handler generator functions.
 #define DECLARE_BYTECODE_HANDLER_GENERATOR(Name, ...) \
@@ -66,9 +92,20 @@ class Interpreter {
   void DoPropertyStoreIC(Callable ic,
                          compiler::InterpreterAssembler* assembler);
 
+  // Generates code to perform the comparison via |function_id| and to jump by
+  // |relative_jump| if the result is false.
+  void DoCompareAndJumpIfFalse(Runtime::FunctionId function_id,
+                               compiler::Node* relative_jump,
+                               compiler::InterpreterAssembler* assembler);
+
   bool IsInterpreterTableInitialized(Handle<FixedArray> handler_table);
 
+  // Bytes of bytecode that correspond to one unit of --interrupt-budget, which
+  // is calibrated for full-codegen code.
+  static const int kCodeSizeMultiplier = 32;
+
   Isolate* isolate_;
+  base::SmartArrayPointer<uintptr_t> bytecode_dispatch_counters_table_;
 
   DISALLOW_COPY_AND_ASSIGN(Interpreter);
 };
@@ -1770,7 +1770,9 @@ Isolate::Isolate(bool enable_serializer)
       next_unique_sfi_id_(0),
 #endif
       use_counter_callback_(NULL),
-      basic_block_profiler_(NULL) {
+      basic_block_profiler_(NULL),
+      persistent_compilation_cache_(NULL),
+      deserialize_internal_fields_callback_(NULL) {
   {
     base::LockGuard<base::Mutex> lock_guard(thread_data_table_mutex_.Pointer());
     CHECK(thread_data_table_);
@@ -1879,6 +1881,7 @@ void Isolate::Deinit() {
   Sampler* sampler = logger_->sampler();
   if (sampler && sampler->IsActive()) sampler->Stop();
 
+  if (FLAG_trace_ignition_dispatches) interpreter_->PrintDispatchCounters();
   delete interpreter_;
   interpreter_ = NULL;
 
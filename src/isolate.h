@@ -387,6 +387,7 @@ typedef List<HeapObject*> DebugObjectCache;
   V(uint32_t, per_isolate_assert_data, 0xFFFFFFFFu)                            \
   V(PromiseRejectCallback, promise_reject_callback, NULL)                      \
   V(const v8::StartupData*, snapshot_blob, NULL)                               \
+  V(const intptr_t*, api_external_references, NULL)                            \
   ISOLATE_INIT_SIMULATOR_LIST(V)
 
 #define THREAD_LOCAL_TOP_ACCESSOR(type, name)                        \
@@ -1080,6 +1081,23 @@ class Isolate {
     return array_buffer_allocator_;
   }
 
+  void set_persistent_compilation_cache(
+      v8::PersistentCompilationCache* cache) {
+    persistent_compilation_cache_ = cache;
+  }
+  v8::PersistentCompilationCache* persistent_compilation_cache() const {
+    return persistent_compilation_cache_;
+  }
+
+  void set_deserialize_internal_fields_callback(
+      v8::DeserializeInternalFieldsCallback callback) {
+    deserialize_internal_fields_callback_ = callback;
+  }
+  v8::DeserializeInternalFieldsCallback deserialize_internal_fields_callback()
+      const {
+    return deserialize_internal_fields_callback_;
+  }
+
   FutexWaitListNode* futex_wait_list_node() { return &futex_wait_list_node_; }
 
   void RegisterCancelableTask(Cancelable* task);
@@ -1321,6 +1339,10 @@ class Isolate {
 
   v8::ArrayBuffer::Allocator* array_buffer_allocator_;
 
+  v8::PersistentCompilationCache* persistent_compilation_cache_;
+
+  v8::DeserializeInternalFieldsCallback deserialize_internal_fields_callback_;
+
   FutexWaitListNode futex_wait_list_node_;
 
   std::set<Cancelable*> cancelable_tasks_;
@@ -1337,6 +1359,7 @@ class Isolate {
   friend class TestCodeRangeScope;
   friend class v8::Isolate;
   friend class v8::Locker;
+  friend class v8::SnapshotCreator;
   friend class v8::Unlocker;
   friend v8::StartupData v8::V8::CreateSnapshotDataBlob(const char*);
 
@@ -41,7 +41,7 @@ class JsonParser BASE_EMBEDDED {
                             isolate_),
         position_(-1) {
     source_ = String::Flatten(source_);
-    pretenure_ = (source_length_ >= kPretenureTreshold) ? TENURED : NOT_TENURED;
+    pretenure_ = ShouldPretenure() ? TENURED : NOT_TENURED;
 
     // Optimized fast case where we only have Latin1 characters.
     if (seq_one_byte) {
@@ -184,11 +184,23 @@ class JsonParser BASE_EMBEDDED {
 
   static const int kInitialSpecialStringLength = 32;
   static const int kPretenureTreshold = 100 * 1024;
+  static const int kHighSurvivalPretenureTreshold = 8 * 1024;
 
 
  private:
   Zone* zone() { return &zone_; }
 
+  // Large inputs are always pretenured. While most of the young generation
+  // survives, e.g. when long-lived caches are built from JSON, smaller inputs
+  // are pretenured as well, so that their results are not copied through new
+  // space before they get promoted.
+  bool ShouldPretenure() {
+    if (source_length_ >= kPretenureTreshold) return true;
+    return FLAG_adaptive_pretenuring &&
+           source_length_ >= kHighSurvivalPretenureTreshold &&
+           isolate_->heap()->IsHighSurvivalRate();
+  }
+
   void CommitStateToJsonObject(Handle<JSObject> json_object, Handle<Map> map,
                                ZoneList<Handle<Object> >* properties);
 
@@ -0,0 +1,521 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/json-stream-parser.h"
+
+#include <limits>
+
+#include "src/char-predicates-inl.h"
+#include "src/conversions.h"
+#include "src/factory.h"
+#include "src/isolate-inl.h"
+#include "src/messages.h"
+#include "src/objects-inl.h"
+#include "src/transitions.h"
+#include "src/types.h"
+#include "src/unicode.h"
+
+namespace v8 {
+namespace internal {
+
+JsonStreamParser::JsonStreamParser(
+    Isolate* isolate, ScriptCompiler::ExternalSourceStream* source_stream,
+    ScriptCompiler::StreamedSource::Encoding encoding)
+    : source_stream_(source_stream),
+      encoding_(encoding),
+      chunk_(NULL),
+      chunk_position_(0),
+      chunk_length_(0),
+      bytes_received_(0),
+      source_exhausted_(false),
+      pretenure_(NOT_TENURED),
+      isolate_(isolate),
+      factory_(isolate->factory()),
+      object_constructor_(isolate->native_context()->object_function(),
+                          isolate),
+      c0_(kEndOfString) {
+  switch (encoding_) {
+    case ScriptCompiler::StreamedSource::ONE_BYTE:
+      one_byte_limit_ = unibrow::Latin1::kMaxChar + 1;
+      break;
+    case ScriptCompiler::StreamedSource::UTF8:
+      one_byte_limit_ = unibrow::Utf8::kMaxOneByteChar + 1;
+      break;
+    case ScriptCompiler::StreamedSource::TWO_BYTE:
+      one_byte_limit_ = 0;
+      break;
+  }
+}
+
+
+JsonStreamParser::~JsonStreamParser() { delete[] chunk_; }
+
+
+MaybeHandle<Object> JsonStreamParser::Parse(
+    Isolate* isolate, ScriptCompiler::ExternalSourceStream* source_stream,
+    ScriptCompiler::StreamedSource::Encoding encoding) {
+  return JsonStreamParser(isolate, source_stream, encoding).ParseJson();
+}
+
+
+bool JsonStreamParser::FetchChunk() {
+  DCHECK_EQ(chunk_position_, chunk_length_);
+  delete[] chunk_;
+  chunk_ = NULL;
+  chunk_position_ = 0;
+  chunk_length_ = 0;
+  if (source_exhausted_) return false;
+  const uint8_t* data = NULL;
+  size_t length = source_stream_->GetMoreData(&data);
+  if (length == 0) {
+    delete[] data;
+    source_exhausted_ = true;
+    return false;
+  }
+  chunk_ = data;
+  chunk_length_ = length;
+  bytes_received_ += length;
+  // The total size is not known up front; tenure the rest of the result
+  // once the source turns out to be large.
+  if (bytes_received_ >= kPretenureTreshold) pretenure_ = TENURED;
+  return true;
+}
+
+
+int JsonStreamParser::ReadByte() {
+  if (chunk_position_ == chunk_length_ && !FetchChunk()) return kEndOfString;
+  return chunk_[chunk_position_++];
+}
+
+
+int JsonStreamParser::PeekByte() {
+  if (chunk_position_ == chunk_length_ && !FetchChunk()) return kEndOfString;
+  return chunk_[chunk_position_];
+}
+
+
+uc32 JsonStreamParser::SlowAdvance() {
+  int first_byte = ReadByte();
+  if (first_byte == kEndOfString) return kEndOfString;
+  switch (encoding_) {
+    case ScriptCompiler::StreamedSource::ONE_BYTE:
+      return first_byte;
+    case ScriptCompiler::StreamedSource::UTF8:
+      return DecodeUtf8(first_byte);
+    case ScriptCompiler::StreamedSource::TWO_BYTE: {
+      // The two bytes of a code unit may be split between chunks.
+      int second_byte = ReadByte();
+      if (second_byte == kEndOfString) return unibrow::Utf8::kBadChar;
+      uint8_t bytes[] = {static_cast<uint8_t>(first_byte),
+                         static_cast<uint8_t>(second_byte)};
+      uint16_t code_unit;
+      MemCopy(&code_unit, bytes, sizeof(code_unit));
+      return code_unit;
+    }
+  }
+  UNREACHABLE();
+  return kEndOfString;
+}
+
+
+// Decodes a UTF-8 sequence that may be split across any number of chunks.
+// Malformed sequences decode to the replacement character, without consuming
+// the byte that made them malformed.
+uc32 JsonStreamParser::DecodeUtf8(int first_byte) {
+  if (first_byte < 0x80) return first_byte;
+  int continuation_bytes;
+  uc32 min_code_point;
+  uc32 code_point;
+  if (first_byte >= 0xC2 && first_byte <= 0xDF) {
+    continuation_bytes = 1;
+    min_code_point = 0x80;
+    code_point = first_byte & 0x1F;
+  } else if (first_byte >= 0xE0 && first_byte <= 0xEF) {
+    continuation_bytes = 2;
+    min_code_point = 0x800;
+    code_point = first_byte & 0x0F;
+  } else if (first_byte >= 0xF0 && first_byte <= 0xF4) {
+    continuation_bytes = 3;
+    min_code_point = 0x10000;
+    code_point = first_byte & 0x07;
+  } else {
+    return unibrow::Utf8::kBadChar;
+  }
+  for (int i = 0; i < continuation_bytes; i++) {
+    int byte = PeekByte();
+    if (byte == kEndOfString || (byte & 0xC0) != 0x80) {
+      return unibrow::Utf8::kBadChar;
+    }
+    chunk_position_++;
+    code_point = (code_point << 6) | (byte & 0x3F);
+  }
+  // Reject overlong encodings, encoded surrogates and values beyond U+10FFFF.
+  if (code_point < min_code_point || code_point > 0x10FFFF ||
+      (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+    return unibrow::Utf8::kBadChar;
+  }
+  return code_point;
+}
+
+
+MaybeHandle<Object> JsonStreamParser::ParseJson() {
+  // Advance to the first character (possibly EOS)
+  AdvanceSkipWhitespace();
+  Handle<Object> result = ParseJsonValue();
+  if (result.is_null() || c0_ != kEndOfString) {
+    // Some exception (for example stack overflow) is already pending.
+    if (isolate_->has_pending_exception()) return Handle<Object>::null();
+
+    // Parse failed. Current character is the unexpected token. There is no
+    // source string to point a message location into.
+    Factory* factory = this->factory();
+    MessageTemplate::Template message;
+    Handle<String> argument;
+
+    switch (c0_) {
+      case kEndOfString:
+        message = MessageTemplate::kUnexpectedEOS;
+        break;
+      case '-':
+      case '0':
+      case '1':
+      case '2':
+      case '3':
+      case '4':
+      case '5':
+      case '6':
+      case '7':
+      case '8':
+      case '9':
+        message = MessageTemplate::kUnexpectedTokenNumber;
+        break;
+      case '"':
+        message = MessageTemplate::kUnexpectedTokenString;
+        break;
+      default: {
+        uc32 c = c0_;
+        if (static_cast<uint32_t>(c) >
+            unibrow::Utf16::kMaxNonSurrogateCharCode) {
+          c = unibrow::Utf16::LeadSurrogate(c);
+        }
+        message = MessageTemplate::kUnexpectedToken;
+        argument = factory->LookupSingleCharacterStringFromCode(c);
+        break;
+      }
+    }
+
+    Handle<Object> error = factory->NewSyntaxError(message, argument);
+    return isolate()->Throw<Object>(error);
+  }
+  return result;
+}
+
+
+// Parse any JSON value.
+Handle<Object> JsonStreamParser::ParseJsonValue() {
+  StackLimitCheck stack_check(isolate_);
+  if (stack_check.HasOverflowed()) {
+    isolate_->StackOverflow();
+    return Handle<Object>::null();
+  }
+
+  if (stack_check.InterruptRequested()) {
+    ExecutionAccess access(isolate_);
+    // Avoid blocking GC in long running parser (v8:3974).
+    isolate_->stack_guard()->HandleGCInterrupt();
+  }
+
+  if (c0_ == '"') return ParseJsonString();
+  if ((c0_ >= '0' && c0_ <= '9') || c0_ == '-') return ParseJsonNumber();
+  if (c0_ == '{') return ParseJsonObject();
+  if (c0_ == '[') return ParseJsonArray();
+  if (c0_ == 'f') {
+    if (AdvanceGetChar() == 'a' && AdvanceGetChar() == 'l' &&
+        AdvanceGetChar() == 's' && AdvanceGetChar() == 'e') {
+      AdvanceSkipWhitespace();
+      return factory()->false_value();
+    }
+    return ReportUnexpectedCharacter();
+  }
+  if (c0_ == 't') {
+    if (AdvanceGetChar() == 'r' && AdvanceGetChar() == 'u' &&
+        AdvanceGetChar() == 'e') {
+      AdvanceSkipWhitespace();
+      return factory()->true_value();
+    }
+    return ReportUnexpectedCharacter();
+  }
+  if (c0_ == 'n') {
+    if (AdvanceGetChar() == 'u' && AdvanceGetChar() == 'l' &&
+        AdvanceGetChar() == 'l') {
+      AdvanceSkipWhitespace();
+      return factory()->null_value();
+    }
+    return ReportUnexpectedCharacter();
+  }
+  return ReportUnexpectedCharacter();
+}
+
+
+// Parse a JSON object. Position must be right at '{'.
+Handle<Object> JsonStreamParser::ParseJsonObject() {
+  HandleScope scope(isolate());
+  Handle<JSObject> json_object =
+      factory()->NewJSObject(object_constructor(), pretenure_);
+  Handle<Map> map(json_object->map());
+  int descriptor = 0;
+  ZoneList<Handle<Object> > properties(8, zone());
+  DCHECK_EQ(c0_, '{');
+
+  // Keys are only known once they have been scanned, so transitions are
+  // looked up by the internalized key rather than predicted from the source.
+  bool transitioning = true;
+
+  AdvanceSkipWhitespace();
+  if (c0_ != '}') {
+    do {
+      if (c0_ != '"') return ReportUnexpectedCharacter();
+      Handle<String> key = ParseJsonInternalizedString();
+      if (key.is_null() || c0_ != ':') return ReportUnexpectedCharacter();
+
+      AdvanceSkipWhitespace();
+      Handle<Object> value = ParseJsonValue();
+      if (value.is_null()) return ReportUnexpectedCharacter();
+
+      uint32_t index;
+      if (key->AsArrayIndex(&index)) {
+        JSObject::SetOwnElementIgnoreAttributes(json_object, index, value, NONE)
+            .Assert();
+        continue;
+      }
+
+      if (transitioning) {
+        Handle<Map> target = TransitionArray::FindTransitionToField(map, key);
+        if (!target.is_null()) {
+          PropertyDetails details =
+              target->instance_descriptors()->GetDetails(descriptor);
+          Representation expected_representation = details.representation();
+          if (value->FitsRepresentation(expected_representation)) {
+            if (expected_representation.IsHeapObject() &&
+                !target->instance_descriptors()
+                     ->GetFieldType(descriptor)
+                     ->NowContains(value)) {
+              Handle<HeapType> value_type(
+                  value->OptimalType(isolate(), expected_representation));
+              Map::GeneralizeFieldType(target, descriptor,
+                                       expected_representation, value_type);
+            }
+            DCHECK(target->instance_descriptors()
+                       ->GetFieldType(descriptor)
+                       ->NowContains(value));
+            properties.Add(value, zone());
+            map = target;
+            descriptor++;
+            continue;
+          }
+        }
+        // Commit the intermediate state to the object and stop transitioning.
+        transitioning = false;
+        CommitStateToJsonObject(json_object, map, &properties);
+      }
+
+      JSObject::DefinePropertyOrElementIgnoreAttributes(json_object, key, value)
+          .Check();
+    } while (MatchSkipWhiteSpace(','));
+
+    if (c0_ != '}') {
+      return ReportUnexpectedCharacter();
+    }
+  }
+
+  // If we transitioned until the very end, transition the map now.
+  if (transitioning) {
+    CommitStateToJsonObject(json_object, map, &properties);
+  }
+  AdvanceSkipWhitespace();
+  return scope.CloseAndEscape(json_object);
+}
+
+
+void JsonStreamParser::CommitStateToJsonObject(
+    Handle<JSObject> json_object, Handle<Map> map,
+    ZoneList<Handle<Object> >* properties) {
+  JSObject::AllocateStorageForMap(json_object, map);
+  DCHECK(!json_object->map()->is_dictionary_map());
+
+  DisallowHeapAllocation no_gc;
+
+  int length = properties->length();
+  for (int i = 0; i < length; i++) {
+    Handle<Object> value = (*properties)[i];
+    json_object->WriteToField(i, *value);
+  }
+}
+
+
+// Parse a JSON array. Position must be right at '['.
+Handle<Object> JsonStreamParser::ParseJsonArray() {
+  HandleScope scope(isolate());
+  ZoneList<Handle<Object> > elements(4, zone());
+  DCHECK_EQ(c0_, '[');
+
+  AdvanceSkipWhitespace();
+  if (c0_ != ']') {
+    do {
+      Handle<Object> element = ParseJsonValue();
+      if (element.is_null()) return ReportUnexpectedCharacter();
+      elements.Add(element, zone());
+    } while (MatchSkipWhiteSpace(','));
+    if (c0_ != ']') {
+      return ReportUnexpectedCharacter();
+    }
+  }
+  AdvanceSkipWhitespace();
+  // Allocate a fixed array with all the elements.
+  Handle<FixedArray> fast_elements =
+      factory()->NewFixedArray(elements.length(), pretenure_);
+  for (int i = 0, n = elements.length(); i < n; i++) {
+    fast_elements->set(i, *elements[i]);
+  }
+  Handle<Object> json_array = factory()->NewJSArrayWithElements(
+      fast_elements, FAST_ELEMENTS, Strength::WEAK, pretenure_);
+  return scope.CloseAndEscape(json_array);
+}
+
+
+// The characters of the number are buffered since the chunk they started in
+// may already be gone when the number ends.
+Handle<Object> JsonStreamParser::ParseJsonNumber() {
+  bool negative = false;
+  literal_.Reset();
+  if (c0_ == '-') {
+    BufferAndAdvance();
+    negative = true;
+  }
+  if (c0_ == '0') {
+    BufferAndAdvance();
+    // Prefix zero is only allowed if it's the only digit before
+    // a decimal point or exponent.
+    if (IsDecimalDigit(c0_)) return ReportUnexpectedCharacter();
+  } else {
+    int i = 0;
+    int digits = 0;
+    if (c0_ < '1' || c0_ > '9') return ReportUnexpectedCharacter();
+    do {
+      i = i * 10 + c0_ - '0';
+      digits++;
+      BufferAndAdvance();
+    } while (IsDecimalDigit(c0_));
+    if (c0_ != '.' && c0_ != 'e' && c0_ != 'E' && digits < 10) {
+      SkipWhitespace();
+      return Handle<Smi>(Smi::FromInt((negative ? -i : i)), isolate());
+    }
+  }
+  if (c0_ == '.') {
+    BufferAndAdvance();
+    if (!IsDecimalDigit(c0_)) return ReportUnexpectedCharacter();
+    do {
+      BufferAndAdvance();
+    } while (IsDecimalDigit(c0_));
+  }
+  if (AsciiAlphaToLower(c0_) == 'e') {
+    BufferAndAdvance();
+    if (c0_ == '-' || c0_ == '+') BufferAndAdvance();
+    if (!IsDecimalDigit(c0_)) return ReportUnexpectedCharacter();
+    do {
+      BufferAndAdvance();
+    } while (IsDecimalDigit(c0_));
+  }
+  double number = StringToDouble(isolate()->unicode_cache(),
+                                 literal_.one_byte_literal(),
+                                 NO_FLAGS,  // Hex, octal or trailing junk.
+                                 std::numeric_limits<double>::quiet_NaN());
+  SkipWhitespace();
+  return factory()->NewNumber(number, pretenure_);
+}
+
+
+bool JsonStreamParser::ScanJsonString() {
+  DCHECK_EQ('"', c0_);
+  literal_.Reset();
+  Advance();
+  while (c0_ != '"') {
+    // Check for control character (0x00-0x1f) or unterminated string (<0).
+    if (c0_ < 0x20) return false;
+    if (c0_ != '\\') {
+      BufferAndAdvance();
+      continue;
+    }
+    Advance();  // Advance past the \.
+    switch (c0_) {
+      case '"':
+      case '\\':
+      case '/':
+        literal_.AddChar(c0_);
+        break;
+      case 'b':
+        literal_.AddChar('\x08');
+        break;
+      case 'f':
+        literal_.AddChar('\x0c');
+        break;
+      case 'n':
+        literal_.AddChar('\x0a');
+        break;
+      case 'r':
+        literal_.AddChar('\x0d');
+        break;
+      case 't':
+        literal_.AddChar('\x09');
+        break;
+      case 'u': {
+        uc32 value = 0;
+        for (int i = 0; i < 4; i++) {
+          Advance();
+          int digit = HexValue(c0_);
+          if (digit < 0) return false;
+          value = value * 16 + digit;
+        }
+        literal_.AddChar(value);
+        break;
+      }
+      default:
+        return false;
+    }
+    Advance();
+  }
+
+  DCHECK_EQ('"', c0_);
+  // Advance past the last '"'.
+  AdvanceSkipWhitespace();
+  return true;
+}
+
+
+Handle<String> JsonStreamParser::ParseJsonString() {
+  if (!ScanJsonString()) return Handle<String>::null();
+  Handle<String> result;
+  if (literal_.is_one_byte()) {
+    if (!factory()
+             ->NewStringFromOneByte(literal_.one_byte_literal(), pretenure_)
+             .ToHandle(&result)) {
+      return Handle<String>::null();
+    }
+  } else if (!factory()
+                  ->NewStringFromTwoByte(literal_.two_byte_literal(),
+                                         pretenure_)
+                  .ToHandle(&result)) {
+    return Handle<String>::null();
+  }
+  return result;
+}
+
+
+Handle<String> JsonStreamParser::ParseJsonInternalizedString() {
+  if (!ScanJsonString()) return Handle<String>::null();
+  return literal_.Internalize(isolate());
+}
+
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,141 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_JSON_STREAM_PARSER_H_
+#define V8_JSON_STREAM_PARSER_H_
+
+#include "include/v8.h"
+#include "src/factory.h"
+#include "src/handles.h"
+#include "src/scanner.h"
+#include "src/zone.h"
+
+namespace v8 {
+namespace internal {
+
+// A JSON parser that pulls its source in chunks from an embedder provided
+// stream. Unlike JsonParser it never materializes the source as a String:
+// every chunk is released as soon as it has been consumed and objects are
+// allocated as their tokens arrive, so the peak memory usage is roughly the
+// size of the result.
+class JsonStreamParser BASE_EMBEDDED {
+ public:
+  MUST_USE_RESULT static MaybeHandle<Object> Parse(
+      Isolate* isolate, ScriptCompiler::ExternalSourceStream* source_stream,
+      ScriptCompiler::StreamedSource::Encoding encoding);
+
+  static const int kEndOfString = -1;
+
+ private:
+  JsonStreamParser(Isolate* isolate,
+                   ScriptCompiler::ExternalSourceStream* source_stream,
+                   ScriptCompiler::StreamedSource::Encoding encoding);
+  ~JsonStreamParser();
+
+  // Parse the whole stream as a single JSON value.
+  MaybeHandle<Object> ParseJson();
+
+  inline void Advance() {
+    // Fast case: the next code point is a single byte of the chunk.
+    if (chunk_position_ < chunk_length_ &&
+        chunk_[chunk_position_] < one_byte_limit_) {
+      c0_ = chunk_[chunk_position_++];
+    } else {
+      c0_ = SlowAdvance();
+    }
+  }
+
+  // The JSON lexical grammar is specified in the ECMAScript 5 standard,
+  // section 15.12.1.1. The only allowed whitespace characters between tokens
+  // are tab, carriage-return, newline and space.
+
+  inline void AdvanceSkipWhitespace() {
+    do {
+      Advance();
+    } while (c0_ == ' ' || c0_ == '\t' || c0_ == '\n' || c0_ == '\r');
+  }
+
+  inline void SkipWhitespace() {
+    while (c0_ == ' ' || c0_ == '\t' || c0_ == '\n' || c0_ == '\r') {
+      Advance();
+    }
+  }
+
+  inline uc32 AdvanceGetChar() {
+    Advance();
+    return c0_;
+  }
+
+  inline bool MatchSkipWhiteSpace(uc32 c) {
+    if (c0_ == c) {
+      AdvanceSkipWhitespace();
+      return true;
+    }
+    return false;
+  }
+
+  inline void BufferAndAdvance() {
+    literal_.AddChar(c0_);
+    Advance();
+  }
+
+  // Decodes the next code point when it is not a single byte in the current
+  // chunk, fetching new chunks from the stream as needed.
+  uc32 SlowAdvance();
+  uc32 DecodeUtf8(int first_byte);
+  int ReadByte();
+  int PeekByte();
+  bool FetchChunk();
+
+  // Scans a JSON string into literal_. Position must be right at '"'.
+  bool ScanJsonString();
+  Handle<String> ParseJsonString();
+  Handle<String> ParseJsonInternalizedString();
+
+  Handle<Object> ParseJsonNumber();
+  Handle<Object> ParseJsonValue();
+  Handle<Object> ParseJsonObject();
+  Handle<Object> ParseJsonArray();
+
+  inline Handle<Object> ReportUnexpectedCharacter() {
+    return Handle<Object>::null();
+  }
+
+  inline Isolate* isolate() { return isolate_; }
+  inline Factory* factory() { return factory_; }
+  inline Handle<JSFunction> object_constructor() { return object_constructor_; }
+  Zone* zone() { return &zone_; }
+
+  void CommitStateToJsonObject(Handle<JSObject> json_object, Handle<Map> map,
+                               ZoneList<Handle<Object> >* properties);
+
+  static const int kPretenureTreshold = 100 * 1024;
+
+  ScriptCompiler::ExternalSourceStream* source_stream_;
+  ScriptCompiler::StreamedSource::Encoding encoding_;
+  // Bytes below this value are complete code points in encoding_.
+  int one_byte_limit_;
+  const uint8_t* chunk_;
+  size_t chunk_position_;
+  size_t chunk_length_;
+  size_t bytes_received_;
+  bool source_exhausted_;
+
+  // Buffer for the string or number token being scanned.
+  LiteralBuffer literal_;
+
+  PretenureFlag pretenure_;
+  Isolate* isolate_;
+  Factory* factory_;
+  Zone zone_;
+  Handle<JSFunction> object_constructor_;
+  uc32 c0_;
+
+  DISALLOW_COPY_AND_ASSIGN(JsonStreamParser);
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_JSON_STREAM_PARSER_H_
@@ -34,16 +34,17 @@ const int DefaultPlatform::kMaxThreadPoolSize = 4;
 
 
 DefaultPlatform::DefaultPlatform()
-    : initialized_(false), thread_pool_size_(0) {}
+    : initialized_(false), thread_pool_size_(0), queue_(NULL) {}
 
 
 DefaultPlatform::~DefaultPlatform() {
   base::LockGuard<base::Mutex> guard(&lock_);
-  queue_.Terminate();
   if (initialized_) {
+    queue_->Terminate();
     for (auto i = thread_pool_.begin(); i != thread_pool_.end(); ++i) {
       delete *i;
     }
+    delete queue_;
   }
   for (auto i = main_thread_queue_.begin(); i != main_thread_queue_.end();
        ++i) {
@@ -78,8 +79,11 @@ void DefaultPlatform::EnsureInitialized() {
   if (initialized_) return;
   initialized_ = true;
 
+  // Tasks posted to a platform without worker threads are never run, but
+  // still need a deque to be queued in.
+  queue_ = new WorkStealingTaskQueue(std::max(thread_pool_size_, 1));
   for (int i = 0; i < thread_pool_size_; ++i)
-    thread_pool_.push_back(new WorkerThread(&queue_));
+    thread_pool_.push_back(new WorkerThread(queue_, i));
 }
 
 
@@ -136,7 +140,12 @@ bool DefaultPlatform::PumpMessageLoop(v8::Isolate* isolate) {
 void DefaultPlatform::CallOnBackgroundThread(Task *task,
                                              ExpectedRuntime expected_runtime) {
   EnsureInitialized();
-  queue_.Append(task);
+  // Short running tasks (e.g. sweeping or compaction) are typically on the
+  // critical path of the main thread and are preferred over long running
+  // ones (e.g. concurrent recompilation).
+  queue_->Append(task, expected_runtime == kShortRunningTask
+                           ? WorkStealingTaskQueue::kHighPriority
+                           : WorkStealingTaskQueue::kLowPriority);
 }
 
 
@@ -13,12 +13,11 @@
 #include "include/v8-platform.h"
 #include "src/base/macros.h"
 #include "src/base/platform/mutex.h"
-#include "src/libplatform/task-queue.h"
+#include "src/libplatform/work-stealing-task-queue.h"
 
 namespace v8 {
 namespace platform {
 
-class TaskQueue;
 class Thread;
 class WorkerThread;
 
@@ -55,7 +54,7 @@ class DefaultPlatform : public Platform {
   bool initialized_;
   int thread_pool_size_;
   std::vector<WorkerThread*> thread_pool_;
-  TaskQueue queue_;
+  WorkStealingTaskQueue* queue_;
   std::map<v8::Isolate*, std::queue<Task*> > main_thread_queue_;
 
   typedef std::pair<double, Task*> DelayedEntry;
@@ -0,0 +1,115 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/libplatform/work-stealing-task-queue.h"
+
+#include "src/base/logging.h"
+
+namespace v8 {
+namespace platform {
+
+WorkStealingTaskQueue::WorkStealingTaskQueue(int number_of_workers)
+    : number_of_workers_(number_of_workers),
+      next_worker_(0),
+      process_queue_semaphore_(0),
+      terminated_(0) {
+  DCHECK(number_of_workers > 0);
+  for (int i = 0; i < number_of_workers_; ++i) {
+    deques_.push_back(new WorkerDeques());
+  }
+}
+
+
+WorkStealingTaskQueue::~WorkStealingTaskQueue() {
+  DCHECK(base::Acquire_Load(&terminated_));
+  for (auto i = deques_.begin(); i != deques_.end(); ++i) {
+#ifdef DEBUG
+    for (int priority = 0; priority < kNumberOfPriorities; ++priority) {
+      DCHECK((*i)->tasks[priority].empty());
+    }
+#endif
+    delete *i;
+  }
+}
+
+
+void WorkStealingTaskQueue::Append(Task* task, Priority priority) {
+  DCHECK(!base::Acquire_Load(&terminated_));
+  // Round-robin distribution keeps the deques balanced without a shared lock;
+  // imbalances caused by uneven task lengths are fixed up by stealing.
+  int worker_id = static_cast<int>(
+      static_cast<uint32_t>(base::NoBarrier_AtomicIncrement(&next_worker_, 1)) %
+      number_of_workers_);
+  WorkerDeques* deques = deques_[worker_id];
+  {
+    base::LockGuard<base::Mutex> guard(&deques->lock);
+    deques->tasks[priority].push_back(task);
+  }
+  process_queue_semaphore_.Signal();
+}
+
+
+Task* WorkStealingTaskQueue::TryPopLocal(int worker_id, Priority priority) {
+  WorkerDeques* deques = deques_[worker_id];
+  base::LockGuard<base::Mutex> guard(&deques->lock);
+  std::deque<Task*>& tasks = deques->tasks[priority];
+  if (tasks.empty()) return NULL;
+  Task* result = tasks.front();
+  tasks.pop_front();
+  return result;
+}
+
+
+Task* WorkStealingTaskQueue::TrySteal(int thief_id, Priority priority) {
+  for (int i = 1; i < number_of_workers_; ++i) {
+    WorkerDeques* victim = deques_[(thief_id + i) % number_of_workers_];
+    base::LockGuard<base::Mutex> guard(&victim->lock);
+    std::deque<Task*>& tasks = victim->tasks[priority];
+    if (tasks.empty()) continue;
+    Task* result = tasks.back();
+    tasks.pop_back();
+    return result;
+  }
+  return NULL;
+}
+
+
+Task* WorkStealingTaskQueue::TryGetNext(int worker_id) {
+  for (int priority = 0; priority < kNumberOfPriorities; ++priority) {
+    Priority p = static_cast<Priority>(priority);
+    Task* task = TryPopLocal(worker_id, p);
+    if (task == NULL) task = TrySteal(worker_id, p);
+    if (task != NULL) return task;
+  }
+  return NULL;
+}
+
+
+Task* WorkStealingTaskQueue::GetNext(int worker_id) {
+  DCHECK(0 <= worker_id && worker_id < number_of_workers_);
+  for (;;) {
+    Task* result = TryGetNext(worker_id);
+    if (result != NULL) return result;
+    if (base::Acquire_Load(&terminated_)) {
+      // All tasks were appended before termination, so a final scan is
+      // guaranteed to observe any task that is still queued.
+      result = TryGetNext(worker_id);
+      if (result != NULL) return result;
+      // Wake up the next waiting worker so that it can terminate as well.
+      process_queue_semaphore_.Signal();
+      return NULL;
+    }
+    process_queue_semaphore_.Wait();
+  }
+}
+
+
+void WorkStealingTaskQueue::Terminate() {
+  DCHECK(!base::Acquire_Load(&terminated_));
+  base::Release_Store(&terminated_, 1);
+  process_queue_semaphore_.Signal();
+}
+
+}  // namespace platform
+}  // namespace v8
@@ -0,0 +1,75 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_LIBPLATFORM_WORK_STEALING_TASK_QUEUE_H_
+#define V8_LIBPLATFORM_WORK_STEALING_TASK_QUEUE_H_
+
+#include <deque>
+#include <vector>
+
+#include "src/base/atomicops.h"
+#include "src/base/macros.h"
+#include "src/base/platform/mutex.h"
+#include "src/base/platform/semaphore.h"
+
+namespace v8 {
+
+class Task;
+
+namespace platform {
+
+// A task queue for a fixed number of worker threads. Every worker owns one
+// deque per priority, each guarded by its own lock, so that workers only
+// contend when they run out of local work and start stealing from others.
+// Tasks of higher priority are always preferred over lower priority ones,
+// including when stealing.
+class WorkStealingTaskQueue {
+ public:
+  enum Priority { kHighPriority, kLowPriority, kNumberOfPriorities };
+
+  explicit WorkStealingTaskQueue(int number_of_workers);
+  ~WorkStealingTaskQueue();
+
+  // Appends a task to the queue of one of the workers, distributing tasks
+  // round-robin. The queue takes ownership of |task|.
+  void Append(Task* task, Priority priority);
+
+  // Returns the next task to process for the worker |worker_id|. Looks at the
+  // local deques first and steals from other workers otherwise. Blocks if no
+  // task is available. Returns NULL if the queue is terminated.
+  Task* GetNext(int worker_id);
+
+  // Terminate the queue.
+  void Terminate();
+
+  int number_of_workers() const { return number_of_workers_; }
+
+ private:
+  struct WorkerDeques {
+    base::Mutex lock;
+    std::deque<Task*> tasks[kNumberOfPriorities];
+  };
+
+  // Tries to pop a task from |worker_id|'s own deques, taking the oldest one.
+  Task* TryPopLocal(int worker_id, Priority priority);
+
+  // Tries to steal a task from any other worker, taking the newest one.
+  Task* TrySteal(int thief_id, Priority priority);
+
+  Task* TryGetNext(int worker_id);
+
+  const int number_of_workers_;
+  std::vector<WorkerDeques*> deques_;
+  base::Atomic32 next_worker_;
+  base::Semaphore process_queue_semaphore_;
+  base::Atomic32 terminated_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingTaskQueue);
+};
+
+}  // namespace platform
+}  // namespace v8
+
+
+#endif  // V8_LIBPLATFORM_WORK_STEALING_TASK_QUEUE_H_
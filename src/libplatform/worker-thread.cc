@@ -6,12 +6,25 @@
 
 #include "include/v8-platform.h"
 #include "src/libplatform/task-queue.h"
+#include "src/libplatform/work-stealing-task-queue.h"
 
 namespace v8 {
 namespace platform {
 
 WorkerThread::WorkerThread(TaskQueue* queue)
-    : Thread(Options("V8 WorkerThread")), queue_(queue) {
+    : Thread(Options("V8 WorkerThread")),
+      queue_(queue),
+      work_stealing_queue_(NULL),
+      worker_id_(0) {
+  Start();
+}
+
+
+WorkerThread::WorkerThread(WorkStealingTaskQueue* queue, int worker_id)
+    : Thread(Options("V8 WorkerThread")),
+      queue_(NULL),
+      work_stealing_queue_(queue),
+      worker_id_(worker_id) {
   Start();
 }
 
@@ -22,6 +35,13 @@ WorkerThread::~WorkerThread() {
 
 
 void WorkerThread::Run() {
+  if (work_stealing_queue_ != NULL) {
+    while (Task* task = work_stealing_queue_->GetNext(worker_id_)) {
+      task->Run();
+      delete task;
+    }
+    return;
+  }
   while (Task* task = queue_->GetNext()) {
     task->Run();
     delete task;
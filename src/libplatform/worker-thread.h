@@ -15,10 +15,12 @@ namespace v8 {
 namespace platform {
 
 class TaskQueue;
+class WorkStealingTaskQueue;
 
 class WorkerThread : public base::Thread {
  public:
   explicit WorkerThread(TaskQueue* queue);
+  WorkerThread(WorkStealingTaskQueue* queue, int worker_id);
   virtual ~WorkerThread();
 
   // Thread implementation.
@@ -28,6 +30,8 @@ class WorkerThread : public base::Thread {
   friend class QuitTask;
 
   TaskQueue* queue_;
+  WorkStealingTaskQueue* work_stealing_queue_;
+  int worker_id_;
 
   DISALLOW_COPY_AND_ASSIGN(WorkerThread);
 };
@@ -803,6 +803,8 @@ void JSRegExp::JSRegExpVerify() {
 
       CHECK(arr->get(JSRegExp::kIrregexpCaptureCountIndex)->IsSmi());
       CHECK(arr->get(JSRegExp::kIrregexpMaxRegisterCountIndex)->IsSmi());
+      Object* literal = arr->get(JSRegExp::kIrregexpRequiredLiteralIndex);
+      CHECK(literal->IsUndefined() || literal->IsString());
       break;
     }
     default:
@@ -1461,6 +1461,16 @@ void HeapObject::synchronized_set_map_word(MapWord map_word) {
 }
 
 
+bool HeapObject::release_compare_and_swap_map_word(MapWord old_map_word,
+                                                   MapWord new_map_word) {
+  base::AtomicWord result = base::Release_CompareAndSwap(
+      reinterpret_cast<base::AtomicWord*>(FIELD_ADDR(this, kMapOffset)),
+      static_cast<base::AtomicWord>(old_map_word.value_),
+      static_cast<base::AtomicWord>(new_map_word.value_));
+  return result == static_cast<base::AtomicWord>(old_map_word.value_);
+}
+
+
 int HeapObject::Size() {
   return SizeFromMap(map());
 }
@@ -1835,14 +1845,18 @@ inline void AllocationSite::IncrementMementoCreateCount() {
 inline bool AllocationSite::MakePretenureDecision(
     PretenureDecision current_decision,
     double ratio,
+    double ratio_threshold,
     bool maximum_size_scavenge) {
   // Here we just allow state transitions from undecided or maybe tenure
-  // to don't tenure, maybe tenure, or tenure.
+  // to don't tenure, maybe tenure, or tenure, and from tenure back to
+  // don't tenure.
   if ((current_decision == kUndecided || current_decision == kMaybeTenure)) {
-    if (ratio >= kPretenureRatio) {
+    if (ratio >= ratio_threshold) {
       // We just transition into tenure state when the semi-space was at
-      // maximum capacity.
-      if (maximum_size_scavenge) {
+      // maximum capacity, or when the objects of a maybe tenured site
+      // survived again. Otherwise they would be copied within new space
+      // once more before being promoted.
+      if (maximum_size_scavenge || current_decision == kMaybeTenure) {
         set_deopt_dependent_code(true);
         set_pretenure_decision(kTenure);
         // Currently we just need to deopt when we make a state transition to
@@ -1853,13 +1867,19 @@ inline bool AllocationSite::MakePretenureDecision(
     } else {
       set_pretenure_decision(kDontTenure);
     }
+  } else if (current_decision == kTenure && ratio < kUnpretenureRatio) {
+    // Objects of this site that are still allocated in new space, e.g. by
+    // unoptimized code, mostly die young. Stop pretenuring them.
+    set_deopt_dependent_code(true);
+    set_pretenure_decision(kDontTenure);
+    return true;
   }
   return false;
 }
 
 
 inline bool AllocationSite::DigestPretenuringFeedback(
-    bool maximum_size_scavenge) {
+    bool maximum_size_scavenge, double ratio_threshold) {
   bool deopt = false;
   int create_count = memento_create_count();
   int found_count = memento_found_count();
@@ -1870,16 +1890,17 @@ inline bool AllocationSite::DigestPretenuringFeedback(
   PretenureDecision current_decision = pretenure_decision();
 
   if (minimum_mementos_created) {
-    deopt = MakePretenureDecision(
-        current_decision, ratio, maximum_size_scavenge);
+    deopt = MakePretenureDecision(current_decision, ratio, ratio_threshold,
+                                  maximum_size_scavenge);
   }
 
   if (FLAG_trace_pretenuring_statistics) {
     PrintF(
-        "AllocationSite(%p): (created, found, ratio) (%d, %d, %f) %s => %s\n",
-         static_cast<void*>(this), create_count, found_count, ratio,
-         PretenureDecisionName(current_decision),
-         PretenureDecisionName(pretenure_decision()));
+        "AllocationSite(%p): (created, found, ratio, threshold) "
+        "(%d, %d, %f, %f) %s => %s\n",
+        static_cast<void*>(this), create_count, found_count, ratio,
+        ratio_threshold, PretenureDecisionName(current_decision),
+        PretenureDecisionName(pretenure_decision()));
   }
 
   // Clear feedback calculation fields until the next gc.
@@ -4152,6 +4173,16 @@ int BytecodeArray::parameter_count() const {
 }
 
 
+int BytecodeArray::interrupt_budget() const {
+  return READ_INT_FIELD(this, kInterruptBudgetOffset);
+}
+
+
+void BytecodeArray::set_interrupt_budget(int interrupt_budget) {
+  WRITE_INT_FIELD(this, kInterruptBudgetOffset, interrupt_budget);
+}
+
+
 ACCESSORS(BytecodeArray, constant_pool, FixedArray, kConstantPoolOffset)
 
 
@@ -10895,8 +10895,13 @@ void JSFunction::PrintName(FILE* out) {
 //   "name*"  only functions starting with "name"
 //   "~"      none; the tilde is not an identifier
 bool JSFunction::PassesFilter(const char* raw_filter) {
+  return SharedFunctionInfo::PassesFilter(shared()->DebugName(), raw_filter);
+}
+
+
+// static
+bool SharedFunctionInfo::PassesFilter(String* name, const char* raw_filter) {
   if (*raw_filter == '*') return true;
-  String* name = shared()->DebugName();
   Vector<const char> filter = CStrVector(raw_filter);
   if (filter.length() == 0) return name->length() == 0;
   if (filter[0] == '-') {
@@ -12511,7 +12516,15 @@ void BytecodeArray::Disassemble(std::ostream& os) {
     const uint8_t* bytecode_start = &first_bytecode_address[i];
     interpreter::Bytecode bytecode =
         interpreter::Bytecodes::FromByte(bytecode_start[0]);
-    bytecode_size = interpreter::Bytecodes::Size(bytecode);
+    if (interpreter::Bytecodes::IsPrefixScalingBytecode(bytecode)) {
+      interpreter::OperandScale operand_scale =
+          interpreter::Bytecodes::PrefixBytecodeToOperandScale(bytecode);
+      bytecode = interpreter::Bytecodes::FromByte(bytecode_start[1]);
+      bytecode_size =
+          1 + interpreter::Bytecodes::Size(bytecode, operand_scale);
+    } else {
+      bytecode_size = interpreter::Bytecodes::Size(bytecode);
+    }
 
     SNPrintF(buf, "%p", bytecode_start);
     os << buf.start() << " : ";
@@ -13253,6 +13266,9 @@ bool JSArray::SetLengthWouldNormalize(uint32_t new_length) {
 
 
 const double AllocationSite::kPretenureRatio = 0.85;
+const double AllocationSite::kMinPretenureRatio = 0.7;
+const double AllocationSite::kMaxPretenureRatio = 0.95;
+const double AllocationSite::kUnpretenureRatio = 0.3;
 
 
 void AllocationSite::ResetPretenureDecision() {
@@ -1500,6 +1500,11 @@ class HeapObject: public Object {
   inline void synchronized_set_map_no_write_barrier(Map* value);
   inline void synchronized_set_map_word(MapWord map_word);
 
+  // Installs |new_map_word| using a release compare-and-swap if the map word
+  // still contains |old_map_word|. Returns true on success.
+  inline bool release_compare_and_swap_map_word(MapWord old_map_word,
+                                                MapWord new_map_word);
+
   // During garbage collection, the map word of a heap object does not
   // necessarily contain a map pointer.
   inline MapWord map_word() const;
@@ -4287,6 +4292,12 @@ class BytecodeArray : public FixedArrayBase {
   inline int parameter_count() const;
   inline void set_parameter_count(int number_of_parameters);
 
+  // Accessors for the interrupt budget. The interpreter decrements the budget
+  // as it executes the bytecode and notifies the runtime profiler when it is
+  // exhausted.
+  inline int interrupt_budget() const;
+  inline void set_interrupt_budget(int interrupt_budget);
+
   // Accessors for the constant pool.
   DECL_ACCESSORS(constant_pool, FixedArray)
 
@@ -4304,7 +4315,9 @@ class BytecodeArray : public FixedArrayBase {
   // Layout description.
   static const int kFrameSizeOffset = FixedArrayBase::kHeaderSize;
   static const int kParameterSizeOffset = kFrameSizeOffset + kIntSize;
-  static const int kConstantPoolOffset = kParameterSizeOffset + kIntSize;
+  static const int kInterruptBudgetOffset = kParameterSizeOffset + kIntSize;
+  static const int kConstantPoolOffset =
+      POINTER_SIZE_ALIGN(kInterruptBudgetOffset + kIntSize);
   static const int kHeaderSize = kConstantPoolOffset + kPointerSize;
 
   static const int kAlignedSize = OBJECT_POINTER_ALIGN(kHeaderSize);
@@ -6499,6 +6512,10 @@ class SharedFunctionInfo: public HeapObject {
   // The function's name if it is non-empty, otherwise the inferred name.
   String* DebugName();
 
+  // Returns true if the debug name |name| passes the filter of flags such as
+  // --ignition-filter, see JSFunction::PassesFilter.
+  static bool PassesFilter(String* name, const char* raw_filter);
+
   // Position of the 'function' token in the script source.
   inline int function_token_position() const;
   inline void set_function_token_position(int function_token_position);
@@ -7561,6 +7578,7 @@ class JSMessageObject: public JSObject {
 // used for tracking the last usage (used for code flushing)..
 // - max number of registers used by irregexp implementations.
 // - number of capture registers (output values) of the regexp.
+// - a string that occurs in every match of the regexp, or undefined.
 class JSRegExp: public JSObject {
  public:
   // Meaning of Type:
@@ -7658,8 +7676,11 @@ class JSRegExp: public JSObject {
   static const int kIrregexpMaxRegisterCountIndex = kDataIndex + 4;
   // Number of captures in the compiled regexp.
   static const int kIrregexpCaptureCountIndex = kDataIndex + 5;
+  // A literal string that every match contains, used to reject subjects
+  // without running the regexp. Undefined if there is none.
+  static const int kIrregexpRequiredLiteralIndex = kDataIndex + 6;
 
-  static const int kIrregexpDataSize = kIrregexpCaptureCountIndex + 1;
+  static const int kIrregexpDataSize = kIrregexpRequiredLiteralIndex + 1;
 
   // Offsets directly into the data fixed array.
   static const int kDataTagOffset =
@@ -7670,6 +7691,8 @@ class JSRegExp: public JSObject {
       FixedArray::kHeaderSize + kIrregexpUC16CodeIndex * kPointerSize;
   static const int kIrregexpCaptureCountOffset =
       FixedArray::kHeaderSize + kIrregexpCaptureCountIndex * kPointerSize;
+  static const int kIrregexpRequiredLiteralOffset =
+      FixedArray::kHeaderSize + kIrregexpRequiredLiteralIndex * kPointerSize;
 
   // In-object fields.
   static const int kSourceFieldIndex = 0;
@@ -7962,6 +7985,15 @@ class AllocationSite: public Struct {
   static const double kPretenureRatio;
   static const int kPretenureMinimumCreated = 100;
 
+  // Bounds of the adaptive pretenuring threshold, see
+  // Heap::PretenureRatioThreshold.
+  static const double kMinPretenureRatio;
+  static const double kMaxPretenureRatio;
+
+  // Tenured sites whose objects still allocated in new space survive at a
+  // lower ratio than this are no longer pretenured.
+  static const double kUnpretenureRatio;
+
   // Values for pretenure decision field.
   enum PretenureDecision {
     kUndecided = 0,
@@ -8033,10 +8065,11 @@ class AllocationSite: public Struct {
   inline void MarkZombie();
 
   inline bool MakePretenureDecision(PretenureDecision current_decision,
-                                    double ratio,
+                                    double ratio, double ratio_threshold,
                                     bool maximum_size_scavenge);
 
-  inline bool DigestPretenuringFeedback(bool maximum_size_scavenge);
+  inline bool DigestPretenuringFeedback(bool maximum_size_scavenge,
+                                        double ratio_threshold);
 
   inline ElementsKind GetElementsKind();
   inline void SetElementsKind(ElementsKind kind);
@@ -8744,6 +8777,27 @@ class String: public Name {
   static inline int NonOneByteStart(const uc16* chars, int length) {
     const uc16* limit = chars + length;
     const uc16* start = chars;
+    const int kCharsPerWord = sizeof(uintptr_t) / kUC16Size;
+
+    if (length >= kCharsPerWord) {
+      // Check unaligned characters.
+      while (chars < limit &&
+             !IsAligned(reinterpret_cast<intptr_t>(chars), sizeof(uintptr_t))) {
+        if (*chars > kMaxOneByteCharCodeU) {
+          return static_cast<int>(chars - start);
+        }
+        ++chars;
+      }
+      // Check aligned words. The first word containing a non-one-byte
+      // character is rescanned below to find its exact position.
+      const uintptr_t non_one_byte_mask = kUintptrAllBitsSet / 0xFFFF * 0xFF00;
+      while (chars + kCharsPerWord <= limit &&
+             !(*reinterpret_cast<const uintptr_t*>(chars) &
+               non_one_byte_mask)) {
+        chars += kCharsPerWord;
+      }
+    }
+    // Check remaining characters.
     while (chars < limit) {
       if (*chars > kMaxOneByteCharCodeU) return static_cast<int>(chars - start);
       ++chars;
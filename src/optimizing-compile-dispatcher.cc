@@ -279,7 +279,7 @@ void OptimizingCompileDispatcher::QueueForOptimization(
     blocked_jobs_++;
   } else {
     V8::GetCurrentPlatform()->CallOnBackgroundThread(
-        new CompileTask(isolate_), v8::Platform::kShortRunningTask);
+        new CompileTask(isolate_), v8::Platform::kLongRunningTask);
   }
 }
 
@@ -287,7 +287,7 @@ void OptimizingCompileDispatcher::QueueForOptimization(
 void OptimizingCompileDispatcher::Unblock() {
   while (blocked_jobs_ > 0) {
     V8::GetCurrentPlatform()->CallOnBackgroundThread(
-        new CompileTask(isolate_), v8::Platform::kShortRunningTask);
+        new CompileTask(isolate_), v8::Platform::kLongRunningTask);
     blocked_jobs_--;
   }
 }
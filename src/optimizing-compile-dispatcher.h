@@ -58,6 +58,12 @@ class OptimizingCompileDispatcher {
 
   bool IsQueuedForOSR(JSFunction* function);
 
+  // Number of finished jobs waiting for InstallOptimizedFunctions.
+  inline int OutputQueueLength() {
+    base::LockGuard<base::Mutex> access_output_queue(&output_queue_mutex_);
+    return static_cast<int>(output_queue_.size());
+  }
+
   inline bool IsQueueAvailable() {
     base::LockGuard<base::Mutex> access_input_queue(&input_queue_mutex_);
     return input_queue_length_ < input_queue_capacity_;
@@ -2,8 +2,6 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-var $regexpLastMatchInfoOverride;
-
 (function(global, utils) {
 
 %CheckIsBootstrapping();
@@ -42,12 +40,6 @@ var RegExpLastMatchInfo = new InternalPackedArray(
  0                  // REGEXP_FIRST_CAPTURE + 1
 );
 
-// Override last match info with an array of actual substrings.
-// Used internally by replace regexp with function.
-// The array has the format of an "apply" argument for a replacement
-// function.
-$regexpLastMatchInfoOverride = null;
-
 // -------------------------------------------------------------------
 
 // A recursive descent parser for Patterns according to the grammar of
@@ -111,9 +103,7 @@ function RegExpCompileJS(pattern, flags) {
 
 
 function DoRegExpExec(regexp, string, index) {
-  var result = %_RegExpExec(regexp, string, index, RegExpLastMatchInfo);
-  if (result !== null) $regexpLastMatchInfoOverride = null;
-  return result;
+  return %_RegExpExec(regexp, string, index, RegExpLastMatchInfo);
 }
 
 
@@ -147,7 +137,6 @@ function RegExpExecNoTests(regexp, string, start) {
   // Must be called with RegExp, string and positive integer as arguments.
   var matchInfo = %_RegExpExec(regexp, string, start, RegExpLastMatchInfo);
   if (matchInfo !== null) {
-    $regexpLastMatchInfoOverride = null;
     RETURN_NEW_RESULT_FROM_MATCH_INFO(matchInfo, string);
   }
   regexp.lastIndex = 0;
@@ -187,7 +176,6 @@ function RegExpExecJS(string) {
   }
 
   // Successful match.
-  $regexpLastMatchInfoOverride = null;
   if (updateLastIndex) {
     this.lastIndex = RegExpLastMatchInfo[CAPTURE1];
   }
@@ -227,7 +215,6 @@ function RegExpTest(string) {
       this.lastIndex = 0;
       return false;
     }
-    $regexpLastMatchInfoOverride = null;
     this.lastIndex = RegExpLastMatchInfo[CAPTURE1];
     return true;
   } else {
@@ -248,7 +235,6 @@ function RegExpTest(string) {
       this.lastIndex = 0;
       return false;
     }
-    $regexpLastMatchInfoOverride = null;
     return true;
   }
 }
@@ -285,9 +271,6 @@ function RegExpToString() {
 // on the captures array of the last successful match and the subject string
 // of the last successful match.
 function RegExpGetLastMatch() {
-  if ($regexpLastMatchInfoOverride !== null) {
-    return OVERRIDE_MATCH($regexpLastMatchInfoOverride);
-  }
   var regExpSubject = LAST_SUBJECT(RegExpLastMatchInfo);
   return %_SubString(regExpSubject,
                      RegExpLastMatchInfo[CAPTURE0],
@@ -296,11 +279,6 @@ function RegExpGetLastMatch() {
 
 
 function RegExpGetLastParen() {
-  if ($regexpLastMatchInfoOverride) {
-    var override = $regexpLastMatchInfoOverride;
-    if (override.length <= 3) return '';
-    return override[override.length - 3];
-  }
   var length = NUMBER_OF_CAPTURES(RegExpLastMatchInfo);
   if (length <= 2) return '';  // There were no captures.
   // We match the SpiderMonkey behavior: return the substring defined by the
@@ -317,32 +295,15 @@ function RegExpGetLastParen() {
 
 
 function RegExpGetLeftContext() {
-  var start_index;
-  var subject;
-  if (!$regexpLastMatchInfoOverride) {
-    start_index = RegExpLastMatchInfo[CAPTURE0];
-    subject = LAST_SUBJECT(RegExpLastMatchInfo);
-  } else {
-    var override = $regexpLastMatchInfoOverride;
-    start_index = OVERRIDE_POS(override);
-    subject = OVERRIDE_SUBJECT(override);
-  }
+  var start_index = RegExpLastMatchInfo[CAPTURE0];
+  var subject = LAST_SUBJECT(RegExpLastMatchInfo);
   return %_SubString(subject, 0, start_index);
 }
 
 
 function RegExpGetRightContext() {
-  var start_index;
-  var subject;
-  if (!$regexpLastMatchInfoOverride) {
-    start_index = RegExpLastMatchInfo[CAPTURE1];
-    subject = LAST_SUBJECT(RegExpLastMatchInfo);
-  } else {
-    var override = $regexpLastMatchInfoOverride;
-    subject = OVERRIDE_SUBJECT(override);
-    var match = OVERRIDE_MATCH(override);
-    start_index = OVERRIDE_POS(override) + match.length;
-  }
+  var start_index = RegExpLastMatchInfo[CAPTURE1];
+  var subject = LAST_SUBJECT(RegExpLastMatchInfo);
   return %_SubString(subject, start_index, subject.length);
 }
 
@@ -352,12 +313,6 @@ function RegExpGetRightContext() {
 // called with indices from 1 to 9.
 function RegExpMakeCaptureGetter(n) {
   return function foo() {
-    if ($regexpLastMatchInfoOverride) {
-      if (n < $regexpLastMatchInfoOverride.length - 2) {
-        return OVERRIDE_CAPTURE($regexpLastMatchInfoOverride, n);
-      }
-      return '';
-    }
     var index = n * 2;
     if (index >= NUMBER_OF_CAPTURES(RegExpLastMatchInfo)) return '';
     var matchStart = RegExpLastMatchInfo[CAPTURE(index)];
@@ -188,7 +188,16 @@ MaybeHandle<Object> RegExpImpl::Compile(Handle<JSRegExp> re,
     }
   }
   if (!has_been_compiled) {
-    IrregexpInitialize(re, pattern, flags, parse_result.capture_count);
+    Handle<Object> required_literal = isolate->factory()->undefined_value();
+    Vector<const uc16> literal = RegExpEngine::FindRequiredLiteral(
+        &parse_result, flags.is_ignore_case(), &zone);
+    if (FLAG_regexp_required_literal && literal.length() > 0) {
+      ASSIGN_RETURN_ON_EXCEPTION(
+          isolate, required_literal,
+          isolate->factory()->NewStringFromTwoByte(literal), Object);
+    }
+    IrregexpInitialize(re, pattern, flags, parse_result.capture_count,
+                       required_literal);
   }
   DCHECK(re->data()->IsFixedArray());
   // Compilation succeeded so the data is set on the regexp
@@ -449,13 +458,15 @@ Code* RegExpImpl::IrregexpNativeCode(FixedArray* re, bool is_one_byte) {
 void RegExpImpl::IrregexpInitialize(Handle<JSRegExp> re,
                                     Handle<String> pattern,
                                     JSRegExp::Flags flags,
-                                    int capture_count) {
+                                    int capture_count,
+                                    Handle<Object> required_literal) {
   // Initialize compiled code entries to null.
   re->GetIsolate()->factory()->SetRegExpIrregexpData(re,
                                                      JSRegExp::IRREGEXP,
                                                      pattern,
                                                      flags,
-                                                     capture_count);
+                                                     capture_count,
+                                                     required_literal);
 }
 
 
@@ -482,6 +493,38 @@ int RegExpImpl::IrregexpPrepare(Handle<JSRegExp> regexp,
 }
 
 
+// Returns false if no match can start at or after |index| in |subject|,
+// because the subject does not contain the literal required by the regexp.
+static bool SubjectContainsRequiredLiteral(Isolate* isolate, FixedArray* data,
+                                           String* subject, int index) {
+  Object* literal = data->get(JSRegExp::kIrregexpRequiredLiteralIndex);
+  if (!literal->IsString() ||
+      subject->length() < RegExpImpl::kRequiredLiteralMinSubjectLength) {
+    return true;
+  }
+  DisallowHeapAllocation no_gc;
+  String* needle = String::cast(literal);
+  if (index + needle->length() > subject->length()) return false;
+  String::FlatContent needle_content = needle->GetFlatContent();
+  String::FlatContent subject_content = subject->GetFlatContent();
+  DCHECK(needle_content.IsFlat());
+  DCHECK(subject_content.IsFlat());
+  int position =
+      needle_content.IsOneByte()
+          ? (subject_content.IsOneByte()
+                 ? SearchString(isolate, subject_content.ToOneByteVector(),
+                                needle_content.ToOneByteVector(), index)
+                 : SearchString(isolate, subject_content.ToUC16Vector(),
+                                needle_content.ToOneByteVector(), index))
+          : (subject_content.IsOneByte()
+                 ? SearchString(isolate, subject_content.ToOneByteVector(),
+                                needle_content.ToUC16Vector(), index)
+                 : SearchString(isolate, subject_content.ToUC16Vector(),
+                                needle_content.ToUC16Vector(), index));
+  return position >= 0;
+}
+
+
 int RegExpImpl::IrregexpExecRaw(Handle<JSRegExp> regexp,
                                 Handle<String> subject,
                                 int index,
@@ -495,6 +538,11 @@ int RegExpImpl::IrregexpExecRaw(Handle<JSRegExp> regexp,
   DCHECK(index <= subject->length());
   DCHECK(subject->IsFlat());
 
+  if (!SubjectContainsRequiredLiteral(isolate, *irregexp, *subject, index)) {
+    isolate->counters()->regexp_required_literal_misses()->Increment();
+    return RE_FAILURE;
+  }
+
   bool is_one_byte = subject->IsOneByteRepresentationUnderneath();
 
 #ifndef V8_INTERPRETED_REGEXP
@@ -6407,5 +6455,81 @@ bool RegExpEngine::TooMuchRegExpCode(Handle<String> pattern) {
   }
   return too_much;
 }
+
+
+// Collects the literal strings that every match of a regexp tree consumes.
+// The characters matched by consecutive atoms form a run. Anything that may
+// match a varying string, like a character class, a disjunction or a
+// quantifier, ends the current run. Zero-width assertions keep the
+// characters around them adjacent, so they do not end a run.
+class RequiredLiteralFinder {
+ public:
+  explicit RequiredLiteralFinder(Zone* zone)
+      : zone_(zone), run_(8, zone), longest_(8, zone) {}
+
+  Vector<const uc16> Find(RegExpTree* tree) {
+    Visit(tree);
+    EndRun();
+    return longest_.ToConstVector();
+  }
+
+ private:
+  void Visit(RegExpTree* tree) {
+    if (tree->IsAtom()) {
+      AddToRun(tree->AsAtom()->data());
+    } else if (tree->IsText()) {
+      ZoneList<TextElement>* elements = tree->AsText()->elements();
+      for (int i = 0; i < elements->length(); i++) {
+        TextElement element = elements->at(i);
+        if (element.text_type() == TextElement::ATOM) {
+          AddToRun(element.atom()->data());
+        } else {
+          EndRun();
+        }
+      }
+    } else if (tree->IsAlternative()) {
+      ZoneList<RegExpTree*>* nodes = tree->AsAlternative()->nodes();
+      for (int i = 0; i < nodes->length(); i++) Visit(nodes->at(i));
+    } else if (tree->IsCapture()) {
+      Visit(tree->AsCapture()->body());
+    } else if (tree->IsAssertion() || tree->IsEmpty()) {
+      // Consumes no characters.
+    } else if (tree->IsQuantifier() && tree->AsQuantifier()->min() > 0) {
+      // The body is matched at least once, but not necessarily right next to
+      // the characters around the quantifier.
+      EndRun();
+      Visit(tree->AsQuantifier()->body());
+      EndRun();
+    } else {
+      EndRun();
+    }
+  }
+
+  void AddToRun(Vector<const uc16> chars) {
+    for (int i = 0; i < chars.length(); i++) run_.Add(chars[i], zone_);
+  }
+
+  void EndRun() {
+    if (run_.length() > longest_.length()) {
+      longest_.Rewind(0);
+      longest_.AddAll(run_, zone_);
+    }
+    run_.Rewind(0);
+  }
+
+  Zone* zone_;
+  ZoneList<uc16> run_;
+  ZoneList<uc16> longest_;
+};
+
+
+Vector<const uc16> RegExpEngine::FindRequiredLiteral(RegExpCompileData* data,
+                                                     bool ignore_case,
+                                                     Zone* zone) {
+  // With ignore case, the subject may contain the literal in any case.
+  if (ignore_case) return Vector<const uc16>();
+  RequiredLiteralFinder finder(zone);
+  return finder.Find(data->tree);
+}
 }  // namespace internal
 }  // namespace v8
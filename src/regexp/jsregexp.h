@@ -61,7 +61,8 @@ class RegExpImpl {
   static void IrregexpInitialize(Handle<JSRegExp> re,
                                  Handle<String> pattern,
                                  JSRegExp::Flags flags,
-                                 int capture_register_count);
+                                 int capture_register_count,
+                                 Handle<Object> required_literal);
 
 
   static void AtomCompile(Handle<JSRegExp> re,
@@ -214,6 +215,11 @@ class RegExpImpl {
   static const int kRegExpCompiledLimit = 1 * MB;
   static const int kRegExpTooLargeToOptimize = 20 * KB;
 
+  // Subjects are only searched for the required literal of a regexp before
+  // running it if they are at least this long. For shorter subjects the
+  // search does not pay for itself.
+  static const int kRequiredLiteralMinSubjectLength = 256;
+
  private:
   static bool CompileIrregexp(Handle<JSRegExp> re,
                               Handle<String> sample_subject, bool is_one_byte);
@@ -1655,6 +1661,12 @@ class RegExpEngine: public AllStatic {
 
   static bool TooMuchRegExpCode(Handle<String> pattern);
 
+  // Returns the longest string that occurs in every match of the parsed
+  // regexp, or an empty vector if there is none. Subjects that do not contain
+  // the string can be rejected without running the regexp.
+  static Vector<const uc16> FindRequiredLiteral(RegExpCompileData* data,
+                                                bool ignore_case, Zone* zone);
+
   static void DotPrint(const char* label, RegExpNode* node, bool ignore_case);
 };
 
@@ -62,12 +62,15 @@ static void GetICCounts(SharedFunctionInfo* shared,
   *ic_total_count = 0;
   *ic_generic_count = 0;
   *ic_with_type_info_count = 0;
-  Object* raw_info = shared_code->type_feedback_info();
-  if (raw_info->IsTypeFeedbackInfo()) {
-    TypeFeedbackInfo* info = TypeFeedbackInfo::cast(raw_info);
-    *ic_with_type_info_count = info->ic_with_type_info_count();
-    *ic_generic_count = info->ic_generic_count();
-    *ic_total_count = info->ic_total_count();
+  // Interpreted functions do not have full-codegen code.
+  if (shared_code->kind() == Code::FUNCTION) {
+    Object* raw_info = shared_code->type_feedback_info();
+    if (raw_info->IsTypeFeedbackInfo()) {
+      TypeFeedbackInfo* info = TypeFeedbackInfo::cast(raw_info);
+      *ic_with_type_info_count = info->ic_with_type_info_count();
+      *ic_generic_count = info->ic_generic_count();
+      *ic_total_count = info->ic_total_count();
+    }
   }
 
   // Harvest vector-ics as well
@@ -260,5 +263,28 @@ void RuntimeProfiler::OptimizeNow() {
 }
 
 
+void RuntimeProfiler::TickInterpretedFunction(JSFunction* function) {
+  if (!FLAG_ignition_tier_up || !isolate_->use_crankshaft()) return;
+
+  DisallowHeapAllocation no_gc;
+  SharedFunctionInfo* shared = function->shared();
+  if (function->IsOptimized() || function->IsMarkedForOptimization() ||
+      function->IsMarkedForConcurrentOptimization() ||
+      function->IsInOptimizationQueue()) {
+    return;
+  }
+  if (shared->optimization_disabled() || shared->is_toplevel()) return;
+
+  // The ticks are reset whenever the type feedback of the function changes,
+  // so a function is only optimized once its feedback is stable.
+  int ticks = shared->profiler_ticks();
+  if (ticks >= kProfilerTicksBeforeOptimization) {
+    Optimize(function, "hot interpreted function");
+  } else {
+    shared->set_profiler_ticks(ticks + 1);
+  }
+}
+
+
 }  // namespace internal
 }  // namespace v8
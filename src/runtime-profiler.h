@@ -25,6 +25,10 @@ class RuntimeProfiler {
 
   void OptimizeNow();
 
+  // Called when an interpreted function exhausted its interrupt budget.
+  // Marks the function for optimization from bytecode once it is hot.
+  void TickInterpretedFunction(JSFunction* function);
+
   void NotifyICChanged() { any_ic_changed_ = true; }
 
   void AttemptOnStackReplacement(JSFunction* function, int nesting_levels = 1);
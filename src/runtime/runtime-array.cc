@@ -287,8 +287,8 @@ static Object* ArrayConstructorCommon(Isolate* isolate,
       allocation_site = site;
     }
 
-    array = Handle<JSArray>::cast(
-        factory->NewJSObjectFromMap(initial_map, NOT_TENURED, allocation_site));
+    array = Handle<JSArray>::cast(factory->NewJSObjectFromMap(
+        initial_map, site->GetPretenureMode(), allocation_site));
   } else {
     array = Handle<JSArray>::cast(factory->NewJSObject(constructor));
 
@@ -67,15 +67,18 @@ RUNTIME_FUNCTION(Runtime_CompileOptimized) {
     }
     code = Handle<Code>(function->shared()->code(), isolate);
     if (code->kind() != Code::FUNCTION &&
-        code->kind() != Code::OPTIMIZED_FUNCTION) {
+        code->kind() != Code::OPTIMIZED_FUNCTION &&
+        !function->shared()->HasBytecodeArray()) {
       ASSIGN_RETURN_FAILURE_ON_EXCEPTION(
           isolate, code, Compiler::GetUnoptimizedCode(function));
     }
+    // Interpreted functions continue to run in the interpreter.
     function->ReplaceCode(*code);
   }
 
   DCHECK(function->code()->kind() == Code::FUNCTION ||
          function->code()->kind() == Code::OPTIMIZED_FUNCTION ||
+         function->shared()->HasBytecodeArray() ||
          function->IsInOptimizationQueue());
   return function->code();
 }
@@ -5,7 +5,10 @@
 #include "src/runtime/runtime-utils.h"
 
 #include "src/arguments.h"
+#include "src/interpreter/interpreter.h"
 #include "src/isolate-inl.h"
+#include "src/runtime-profiler.h"
+#include "src/type-feedback-vector.h"
 
 namespace v8 {
 namespace internal {
@@ -121,5 +124,47 @@ RUNTIME_FUNCTION(Runtime_InterpreterToBoolean) {
 }
 
 
+// Type feedback of an interpreted function changed, so postpone its
+// optimization until the feedback has stabilized.
+static void OnInterpreterFeedbackChanged(Isolate* isolate,
+                                         JSFunction* function) {
+  function->shared()->set_profiler_ticks(0);
+  isolate->runtime_profiler()->NotifyICChanged();
+}
+
+
+RUNTIME_FUNCTION(Runtime_InterpreterRecordCallFeedback) {
+  HandleScope scope(isolate);
+  DCHECK_EQ(3, args.length());
+  CONVERT_ARG_HANDLE_CHECKED(JSFunction, function, 0);
+  CONVERT_SMI_ARG_CHECKED(index, 1);
+  CONVERT_ARG_HANDLE_CHECKED(Object, target, 2);
+  Handle<TypeFeedbackVector> vector(function->shared()->feedback_vector(),
+                                    isolate);
+  CallICNexus nexus(vector, vector->ToICSlot(index));
+  InlineCacheState state = nexus.StateFromFeedback();
+  if (state == UNINITIALIZED && target->IsJSFunction()) {
+    nexus.ConfigureMonomorphic(Handle<JSFunction>::cast(target));
+  } else if (state != GENERIC) {
+    nexus.ConfigureMegamorphic();
+  } else {
+    return isolate->heap()->undefined_value();
+  }
+  OnInterpreterFeedbackChanged(isolate, *function);
+  return isolate->heap()->undefined_value();
+}
+
+
+RUNTIME_FUNCTION(Runtime_InterpreterProfilerTick) {
+  SealHandleScope scope(isolate);
+  DCHECK_EQ(1, args.length());
+  CONVERT_ARG_CHECKED(JSFunction, function, 0);
+  function->shared()->bytecode_array()->set_interrupt_budget(
+      interpreter::Interpreter::InterruptBudget());
+  isolate->runtime_profiler()->TickInterpretedFunction(function);
+  return isolate->heap()->undefined_value();
+}
+
+
 }  // namespace internal
 }  // namespace v8
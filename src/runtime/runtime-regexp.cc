@@ -1003,13 +1003,15 @@ RUNTIME_FUNCTION(Runtime_MaterializeRegExpLiteral) {
 
 // Only called from Runtime_RegExpExecMultiple so it doesn't need to maintain
 // separate last match info.  See comment on that function.
-template <bool has_capture>
+// Collects the capture registers of all matches into result_array, as
+// (capture_count + 1) * 2 smis per match with -1 for captures that did not
+// participate. No substrings are created; the caller slices the subject for
+// the matches and captures it actually needs.
 static Object* SearchRegExpMultiple(Isolate* isolate, Handle<String> subject,
                                     Handle<JSRegExp> regexp,
                                     Handle<JSArray> last_match_array,
                                     Handle<JSArray> result_array) {
   DCHECK(subject->IsFlat());
-  DCHECK_NE(has_capture, regexp->CaptureCount() == 0);
 
   int capture_count = regexp->CaptureCount();
   int subject_length = subject->length();
@@ -1050,101 +1052,45 @@ static Object* SearchRegExpMultiple(Isolate* isolate, Handle<String> subject,
   }
 
   FixedArrayBuilder builder(result_elements);
-
-  // Position to search from.
-  int match_start = -1;
-  int match_end = 0;
-  bool first = true;
-
-  // Two smis before and after the match, for very long strings.
-  static const int kMaxBuilderEntriesPerRegExpMatch = 5;
+  int registers_per_match = (capture_count + 1) * 2;
+  bool matched = false;
 
   while (true) {
     int32_t* current_match = global_cache.FetchNext();
     if (current_match == NULL) break;
-    match_start = current_match[0];
-    builder.EnsureCapacity(kMaxBuilderEntriesPerRegExpMatch);
-    if (match_end < match_start) {
-      ReplacementStringBuilder::AddSubjectSlice(&builder, match_end,
-                                                match_start);
-    }
-    match_end = current_match[1];
-    {
-      // Avoid accumulating new handles inside loop.
-      HandleScope temp_scope(isolate);
-      Handle<String> match;
-      if (!first) {
-        match = isolate->factory()->NewProperSubString(subject, match_start,
-                                                       match_end);
-      } else {
-        match =
-            isolate->factory()->NewSubString(subject, match_start, match_end);
-        first = false;
-      }
-
-      if (has_capture) {
-        // Arguments array to replace function is match, captures, index and
-        // subject, i.e., 3 + capture count in total.
-        Handle<FixedArray> elements =
-            isolate->factory()->NewFixedArray(3 + capture_count);
-
-        elements->set(0, *match);
-        for (int i = 1; i <= capture_count; i++) {
-          int start = current_match[i * 2];
-          if (start >= 0) {
-            int end = current_match[i * 2 + 1];
-            DCHECK(start <= end);
-            Handle<String> substring =
-                isolate->factory()->NewSubString(subject, start, end);
-            elements->set(i, *substring);
-          } else {
-            DCHECK(current_match[i * 2 + 1] < 0);
-            elements->set(i, isolate->heap()->undefined_value());
-          }
-        }
-        elements->set(capture_count + 1, Smi::FromInt(match_start));
-        elements->set(capture_count + 2, *subject);
-        builder.Add(*isolate->factory()->NewJSArrayWithElements(elements));
-      } else {
-        builder.Add(*match);
-      }
+    matched = true;
+    builder.EnsureCapacity(registers_per_match);
+    for (int i = 0; i < registers_per_match; i++) {
+      DCHECK(current_match[i] >= -1 && current_match[i] <= subject_length);
+      builder.Add(Smi::FromInt(current_match[i]));
     }
   }
 
   if (global_cache.HasException()) return isolate->heap()->exception();
 
-  if (match_start >= 0) {
-    // Finished matching, with at least one match.
-    if (match_end < subject_length) {
-      ReplacementStringBuilder::AddSubjectSlice(&builder, match_end,
-                                                subject_length);
-    }
+  if (!matched) return isolate->heap()->null_value();  // No matches at all.
 
-    RegExpImpl::SetLastMatchInfo(last_match_array, subject, capture_count,
-                                 NULL);
-
-    if (subject_length > kMinLengthToCache) {
-      // Store the length of the result array into the last element of the
-      // backing FixedArray.
-      builder.EnsureCapacity(1);
-      Handle<FixedArray> fixed_array = builder.array();
-      fixed_array->set(fixed_array->length() - 1,
-                       Smi::FromInt(builder.length()));
-      // Cache the result and turn the FixedArray into a COW array.
-      RegExpResultsCache::Enter(isolate, subject,
-                                handle(regexp->data(), isolate), fixed_array,
-                                RegExpResultsCache::REGEXP_MULTIPLE_INDICES);
-    }
-    return *builder.ToJSArray(result_array);
-  } else {
-    return isolate->heap()->null_value();  // No matches at all.
+  RegExpImpl::SetLastMatchInfo(last_match_array, subject, capture_count, NULL);
+
+  if (subject_length > kMinLengthToCache) {
+    // Store the length of the result array into the last element of the
+    // backing FixedArray.
+    builder.EnsureCapacity(1);
+    Handle<FixedArray> fixed_array = builder.array();
+    fixed_array->set(fixed_array->length() - 1,
+                     Smi::FromInt(builder.length()));
+    // Cache the result and turn the FixedArray into a COW array.
+    RegExpResultsCache::Enter(isolate, subject,
+                              handle(regexp->data(), isolate), fixed_array,
+                              RegExpResultsCache::REGEXP_MULTIPLE_INDICES);
   }
+  return *builder.ToJSArray(result_array);
 }
 
 
-// This is only called for StringReplaceGlobalRegExpWithFunction.  This sets
-// lastMatchInfoOverride to maintain the last match info, so we don't need to
-// set any other last match array info.
+// This is only called for StringReplaceGlobalRegExpWithFunction.  That copies
+// the registers of each match into the last match info before calling the
+// replace function, so we don't need to set any other last match array info.
 RUNTIME_FUNCTION(Runtime_RegExpExecMultiple) {
   HandleScope handles(isolate);
   DCHECK(args.length() == 4);
@@ -1159,13 +1105,8 @@ RUNTIME_FUNCTION(Runtime_RegExpExecMultiple) {
   subject = String::Flatten(subject);
   RUNTIME_ASSERT(regexp->GetFlags().is_global());
 
-  if (regexp->CaptureCount() == 0) {
-    return SearchRegExpMultiple<false>(isolate, subject, regexp,
-                                       last_match_info, result_array);
-  } else {
-    return SearchRegExpMultiple<true>(isolate, subject, regexp, last_match_info,
-                                      result_array);
-  }
+  return SearchRegExpMultiple(isolate, subject, regexp, last_match_info,
+                              result_array);
 }
 
 
@@ -4,7 +4,9 @@
 
 #include "src/snapshot/natives.h"
 
+#include "src/base/atomicops.h"
 #include "src/base/logging.h"
+#include "src/base/platform/mutex.h"
 #include "src/list.h"
 #include "src/list-inl.h"
 #include "src/snapshot/snapshot-source-sink.h"
@@ -125,6 +127,7 @@ template<NativeType type>
 class NativesHolder {
  public:
   static NativesStore* get() {
+    ReadNatives();
     DCHECK(holder_);
     return holder_;
   }
@@ -148,12 +151,20 @@ NativesStore* NativesHolder<type>::holder_ = NULL;
 
 // The natives blob. Memory is owned by caller.
 static StartupData* natives_blob_ = NULL;
+static base::LazyMutex natives_mutex_ = LAZY_MUTEX_INITIALIZER;
+static base::AtomicWord natives_read_ = 0;
 
 
 /**
  * Read the Natives blob, as previously set by SetNativesFromFile.
+ *
+ * This happens on first use of the natives. When V8 starts from a snapshot,
+ * the natives are already compiled into it, and only the sources of
+ * functions that are compiled lazily are ever looked at.
  */
 void ReadNatives() {
+  if (base::Acquire_Load(&natives_read_)) return;
+  base::LockGuard<base::Mutex> lock_guard(natives_mutex_.Pointer());
   if (natives_blob_ && NativesHolder<CORE>::empty()) {
     SnapshotByteSource bytes(natives_blob_->data, natives_blob_->raw_size);
     NativesHolder<CORE>::set(NativesStore::MakeFromScriptsSource(&bytes));
@@ -164,6 +175,7 @@ void ReadNatives() {
     NativesHolder<EXPERIMENTAL_EXTRAS>::set(
         NativesStore::MakeFromScriptsSource(&bytes));
     DCHECK(!bytes.HasMore());
+    base::Release_Store(&natives_read_, 1);
   }
 }
 
@@ -179,7 +191,6 @@ void SetNativesFromFile(StartupData* natives_blob) {
   DCHECK(natives_blob->raw_size > 0);
 
   natives_blob_ = natives_blob;
-  ReadNatives();
 }
 
 
@@ -187,6 +198,8 @@ void SetNativesFromFile(StartupData* natives_blob) {
  * Release memory allocated by SetNativesFromFile.
  */
 void DisposeNatives() {
+  base::LockGuard<base::Mutex> lock_guard(natives_mutex_.Pointer());
+  base::Release_Store(&natives_read_, 0);
   NativesHolder<CORE>::Dispose();
   NativesHolder<CODE_STUB>::Dispose();
   NativesHolder<EXPERIMENTAL>::Dispose();
@@ -33,6 +33,11 @@ namespace internal {
 // Coding of external references.
 
 
+base::OnceType ExternalReferenceTable::shared_references_once_ = V8_ONCE_INIT;
+const ExternalReferenceTable::ExternalReferenceList*
+    ExternalReferenceTable::shared_references_ = NULL;
+
+
 ExternalReferenceTable* ExternalReferenceTable::instance(Isolate* isolate) {
   ExternalReferenceTable* external_reference_table =
       isolate->external_reference_table();
@@ -44,7 +49,144 @@ ExternalReferenceTable* ExternalReferenceTable::instance(Isolate* isolate) {
 }
 
 
+void ExternalReferenceTable::AddIsolateIndependentReferences(
+    Isolate* isolate, ExternalReferenceList* refs) {
+  // Miscellaneous
+  Add(refs, ExternalReference::mod_two_doubles_operation(isolate).address(),
+      "mod_two_doubles");
+  Add(refs, ExternalReference::new_deoptimizer_function(isolate).address(),
+      "Deoptimizer::New()");
+  Add(refs,
+      ExternalReference::compute_output_frames_function(isolate).address(),
+      "Deoptimizer::ComputeOutputFrames()");
+  Add(refs, ExternalReference::address_of_min_int().address(),
+      "LDoubleConstant::min_int");
+  Add(refs, ExternalReference::address_of_one_half().address(),
+      "LDoubleConstant::one_half");
+  Add(refs, ExternalReference::address_of_negative_infinity().address(),
+      "LDoubleConstant::negative_infinity");
+  Add(refs,
+      ExternalReference::power_double_double_function(isolate).address(),
+      "power_double_double_function");
+  Add(refs, ExternalReference::power_double_int_function(isolate).address(),
+      "power_double_int_function");
+  Add(refs, ExternalReference::math_log_double_function(isolate).address(),
+      "std::log");
+  Add(refs, ExternalReference::address_of_the_hole_nan().address(),
+      "the_hole_nan");
+  Add(refs, ExternalReference::get_date_field_function(isolate).address(),
+      "JSDate::GetField");
+  Add(refs, ExternalReference::get_make_code_young_function(isolate).address(),
+      "Code::MakeCodeYoung");
+  Add(refs, ExternalReference::cpu_features().address(), "cpu_features");
+  Add(refs, ExternalReference::address_of_uint32_bias().address(),
+      "uint32_bias");
+  Add(refs,
+      ExternalReference::get_mark_code_as_executed_function(isolate).address(),
+      "Code::MarkCodeAsExecuted");
+  Add(refs, ExternalReference::invoke_function_callback(isolate).address(),
+      "InvokeFunctionCallback");
+  Add(refs,
+      ExternalReference::invoke_accessor_getter_callback(isolate).address(),
+      "InvokeAccessorGetterCallback");
+  Add(refs, ExternalReference::log_enter_external_function(isolate).address(),
+      "Logger::EnterExternal");
+  Add(refs, ExternalReference::log_leave_external_function(isolate).address(),
+      "Logger::LeaveExternal");
+  Add(refs, ExternalReference::address_of_minus_one_half().address(),
+      "double_constants.minus_one_half");
+
+#ifndef V8_INTERPRETED_REGEXP
+  Add(refs,
+      ExternalReference::re_case_insensitive_compare_uc16(isolate).address(),
+      "NativeRegExpMacroAssembler::CaseInsensitiveCompareUC16()");
+  Add(refs, ExternalReference::re_check_stack_guard_state(isolate).address(),
+      "RegExpMacroAssembler*::CheckStackGuardState()");
+  Add(refs, ExternalReference::re_grow_stack(isolate).address(),
+      "NativeRegExpMacroAssembler::GrowStack()");
+  Add(refs, ExternalReference::re_word_character_map().address(),
+      "NativeRegExpMacroAssembler::word_character_map");
+#endif  // V8_INTERPRETED_REGEXP
+
+  // The following populates all of the different type of external references
+  // into the ExternalReferenceTable.
+  //
+  // NOTE: This function was originally 100k of code.  It has since been
+  // rewritten to be mostly table driven, as the callback macro style tends to
+  // very easily cause code bloat.  Please be careful in the future when adding
+  // new references.
+
+  struct RefTableEntry {
+    uint16_t id;
+    const char* name;
+  };
+
+  static const RefTableEntry c_builtins[] = {
+#define DEF_ENTRY_C(name, ignored)           \
+  { Builtins::c_##name, "Builtins::" #name } \
+  ,
+      BUILTIN_LIST_C(DEF_ENTRY_C)
+#undef DEF_ENTRY_C
+  };
+
+  for (unsigned i = 0; i < arraysize(c_builtins); ++i) {
+    ExternalReference ref(static_cast<Builtins::CFunctionId>(c_builtins[i].id),
+                          isolate);
+    Add(refs, ref.address(), c_builtins[i].name);
+  }
+
+  static const RefTableEntry runtime_functions[] = {
+#define RUNTIME_ENTRY(name, i1, i2)       \
+  { Runtime::k##name, "Runtime::" #name } \
+  ,
+      FOR_EACH_INTRINSIC(RUNTIME_ENTRY)
+#undef RUNTIME_ENTRY
+  };
+
+  for (unsigned i = 0; i < arraysize(runtime_functions); ++i) {
+    ExternalReference ref(
+        static_cast<Runtime::FunctionId>(runtime_functions[i].id), isolate);
+    Add(refs, ref.address(), runtime_functions[i].name);
+  }
+
+  // Accessors
+  struct AccessorRefTable {
+    Address address;
+    const char* name;
+  };
+
+  static const AccessorRefTable accessors[] = {
+#define ACCESSOR_INFO_DECLARATION(name)                                     \
+  { FUNCTION_ADDR(&Accessors::name##Getter), "Accessors::" #name "Getter" } \
+  , {FUNCTION_ADDR(&Accessors::name##Setter), "Accessors::" #name "Setter"},
+      ACCESSOR_INFO_LIST(ACCESSOR_INFO_DECLARATION)
+#undef ACCESSOR_INFO_DECLARATION
+  };
+
+  for (unsigned i = 0; i < arraysize(accessors); ++i) {
+    Add(refs, accessors[i].address, accessors[i].name);
+  }
+}
+
+
+void ExternalReferenceTable::CreateSharedReferences(Isolate* isolate) {
+  ExternalReferenceList* refs = new ExternalReferenceList();
+  AddIsolateIndependentReferences(isolate, refs);
+  shared_references_ = refs;
+}
+
+
 ExternalReferenceTable::ExternalReferenceTable(Isolate* isolate) {
+#ifdef USE_SIMULATOR
+  shared_refs_ = NULL;
+  shared_size_ = 0;
+  AddIsolateIndependentReferences(isolate, &refs_);
+#else
+  base::CallOnce(&shared_references_once_, &CreateSharedReferences, isolate);
+  shared_refs_ = shared_references_;
+  shared_size_ = shared_references_->length();
+#endif  // USE_SIMULATOR
+
   // Miscellaneous
   Add(ExternalReference::roots_array_start(isolate).address(),
       "Heap::roots_array_start()");
@@ -62,8 +204,6 @@ ExternalReferenceTable::ExternalReferenceTable(Isolate* isolate) {
       "Heap::NewSpaceAllocationTopAddress()");
   Add(ExternalReference::debug_step_in_fp_address(isolate).address(),
       "Debug::step_in_fp_addr()");
-  Add(ExternalReference::mod_two_doubles_operation(isolate).address(),
-      "mod_two_doubles");
   // Keyed lookup cache.
   Add(ExternalReference::keyed_lookup_cache_keys(isolate).address(),
       "KeyedLookupCache::keys()");
@@ -75,58 +215,23 @@ ExternalReferenceTable::ExternalReferenceTable(Isolate* isolate) {
       "HandleScope::limit");
   Add(ExternalReference::handle_scope_level_address(isolate).address(),
       "HandleScope::level");
-  Add(ExternalReference::new_deoptimizer_function(isolate).address(),
-      "Deoptimizer::New()");
-  Add(ExternalReference::compute_output_frames_function(isolate).address(),
-      "Deoptimizer::ComputeOutputFrames()");
-  Add(ExternalReference::address_of_min_int().address(),
-      "LDoubleConstant::min_int");
-  Add(ExternalReference::address_of_one_half().address(),
-      "LDoubleConstant::one_half");
   Add(ExternalReference::isolate_address(isolate).address(), "isolate");
-  Add(ExternalReference::address_of_negative_infinity().address(),
-      "LDoubleConstant::negative_infinity");
-  Add(ExternalReference::power_double_double_function(isolate).address(),
-      "power_double_double_function");
-  Add(ExternalReference::power_double_int_function(isolate).address(),
-      "power_double_int_function");
-  Add(ExternalReference::math_log_double_function(isolate).address(),
-      "std::log");
   Add(ExternalReference::store_buffer_top(isolate).address(),
       "store_buffer_top");
-  Add(ExternalReference::address_of_the_hole_nan().address(), "the_hole_nan");
-  Add(ExternalReference::get_date_field_function(isolate).address(),
-      "JSDate::GetField");
   Add(ExternalReference::date_cache_stamp(isolate).address(),
       "date_cache_stamp");
   Add(ExternalReference::address_of_pending_message_obj(isolate).address(),
       "address_of_pending_message_obj");
-  Add(ExternalReference::get_make_code_young_function(isolate).address(),
-      "Code::MakeCodeYoung");
-  Add(ExternalReference::cpu_features().address(), "cpu_features");
   Add(ExternalReference::old_space_allocation_top_address(isolate).address(),
       "Heap::OldSpaceAllocationTopAddress");
   Add(ExternalReference::old_space_allocation_limit_address(isolate).address(),
       "Heap::OldSpaceAllocationLimitAddress");
   Add(ExternalReference::allocation_sites_list_address(isolate).address(),
       "Heap::allocation_sites_list_address()");
-  Add(ExternalReference::address_of_uint32_bias().address(), "uint32_bias");
-  Add(ExternalReference::get_mark_code_as_executed_function(isolate).address(),
-      "Code::MarkCodeAsExecuted");
   Add(ExternalReference::is_profiling_address(isolate).address(),
       "CpuProfiler::is_profiling");
   Add(ExternalReference::scheduled_exception_address(isolate).address(),
       "Isolate::scheduled_exception");
-  Add(ExternalReference::invoke_function_callback(isolate).address(),
-      "InvokeFunctionCallback");
-  Add(ExternalReference::invoke_accessor_getter_callback(isolate).address(),
-      "InvokeAccessorGetterCallback");
-  Add(ExternalReference::log_enter_external_function(isolate).address(),
-      "Logger::EnterExternal");
-  Add(ExternalReference::log_leave_external_function(isolate).address(),
-      "Logger::LeaveExternal");
-  Add(ExternalReference::address_of_minus_one_half().address(),
-      "double_constants.minus_one_half");
   Add(ExternalReference::stress_deopt_count(isolate).address(),
       "Isolate::stress_deopt_count_address()");
   Add(ExternalReference::vector_store_virtual_register(isolate).address(),
@@ -142,14 +247,6 @@ ExternalReferenceTable::ExternalReferenceTable(Isolate* isolate) {
       "Debug::is_active_address()");
 
 #ifndef V8_INTERPRETED_REGEXP
-  Add(ExternalReference::re_case_insensitive_compare_uc16(isolate).address(),
-      "NativeRegExpMacroAssembler::CaseInsensitiveCompareUC16()");
-  Add(ExternalReference::re_check_stack_guard_state(isolate).address(),
-      "RegExpMacroAssembler*::CheckStackGuardState()");
-  Add(ExternalReference::re_grow_stack(isolate).address(),
-      "NativeRegExpMacroAssembler::GrowStack()");
-  Add(ExternalReference::re_word_character_map().address(),
-      "NativeRegExpMacroAssembler::word_character_map");
   Add(ExternalReference::address_of_regexp_stack_limit(isolate).address(),
       "RegExpStack::limit_address()");
   Add(ExternalReference::address_of_regexp_stack_memory_address(isolate)
@@ -161,33 +258,11 @@ ExternalReferenceTable::ExternalReferenceTable(Isolate* isolate) {
       "OffsetsVector::static_offsets_vector");
 #endif  // V8_INTERPRETED_REGEXP
 
-  // The following populates all of the different type of external references
-  // into the ExternalReferenceTable.
-  //
-  // NOTE: This function was originally 100k of code.  It has since been
-  // rewritten to be mostly table driven, as the callback macro style tends to
-  // very easily cause code bloat.  Please be careful in the future when adding
-  // new references.
-
   struct RefTableEntry {
     uint16_t id;
     const char* name;
   };
 
-  static const RefTableEntry c_builtins[] = {
-#define DEF_ENTRY_C(name, ignored)           \
-  { Builtins::c_##name, "Builtins::" #name } \
-  ,
-      BUILTIN_LIST_C(DEF_ENTRY_C)
-#undef DEF_ENTRY_C
-  };
-
-  for (unsigned i = 0; i < arraysize(c_builtins); ++i) {
-    ExternalReference ref(static_cast<Builtins::CFunctionId>(c_builtins[i].id),
-                          isolate);
-    Add(ref.address(), c_builtins[i].name);
-  }
-
   static const RefTableEntry builtins[] = {
 #define DEF_ENTRY_C(name, ignored)          \
   { Builtins::k##name, "Builtins::" #name } \
@@ -206,20 +281,6 @@ ExternalReferenceTable::ExternalReferenceTable(Isolate* isolate) {
     Add(ref.address(), builtins[i].name);
   }
 
-  static const RefTableEntry runtime_functions[] = {
-#define RUNTIME_ENTRY(name, i1, i2)       \
-  { Runtime::k##name, "Runtime::" #name } \
-  ,
-      FOR_EACH_INTRINSIC(RUNTIME_ENTRY)
-#undef RUNTIME_ENTRY
-  };
-
-  for (unsigned i = 0; i < arraysize(runtime_functions); ++i) {
-    ExternalReference ref(
-        static_cast<Runtime::FunctionId>(runtime_functions[i].id), isolate);
-    Add(ref.address(), runtime_functions[i].name);
-  }
-
   // Stat counters
   struct StatsRefTableEntry {
     StatsCounter* (Counters::*counter)();
@@ -258,24 +319,6 @@ ExternalReferenceTable::ExternalReferenceTable(Isolate* isolate) {
         address_names[i]);
   }
 
-  // Accessors
-  struct AccessorRefTable {
-    Address address;
-    const char* name;
-  };
-
-  static const AccessorRefTable accessors[] = {
-#define ACCESSOR_INFO_DECLARATION(name)                                     \
-  { FUNCTION_ADDR(&Accessors::name##Getter), "Accessors::" #name "Getter" } \
-  , {FUNCTION_ADDR(&Accessors::name##Setter), "Accessors::" #name "Setter"},
-      ACCESSOR_INFO_LIST(ACCESSOR_INFO_DECLARATION)
-#undef ACCESSOR_INFO_DECLARATION
-  };
-
-  for (unsigned i = 0; i < arraysize(accessors); ++i) {
-    Add(accessors[i].address, accessors[i].name);
-  }
-
   StubCache* stub_cache = isolate->stub_cache();
 
   // Stub cache tables
@@ -312,6 +355,14 @@ ExternalReferenceTable::ExternalReferenceTable(Isolate* isolate) {
         Deoptimizer::CALCULATE_ENTRY_ADDRESS);
     Add(address, "lazy_deopt");
   }
+
+  // Embedder functions and data referenced from embedder-created snapshots.
+  const intptr_t* api_references = isolate->api_external_references();
+  if (api_references != NULL) {
+    for (; *api_references != 0; api_references++) {
+      Add(reinterpret_cast<Address>(*api_references), "<embedder>");
+    }
+  }
 }
 
 
@@ -335,7 +386,12 @@ uint32_t ExternalReferenceEncoder::Encode(Address address) const {
   DCHECK_NOT_NULL(address);
   HashMap::Entry* entry =
       const_cast<HashMap*>(map_)->Lookup(address, Hash(address));
-  DCHECK_NOT_NULL(entry);
+  if (entry == NULL) {
+    // Embedder functions have to be listed in the external references that
+    // the snapshot is created with.
+    V8_Fatal(__FILE__, __LINE__, "Unknown external reference %p",
+             reinterpret_cast<void*>(address));
+  }
   return static_cast<uint32_t>(reinterpret_cast<intptr_t>(entry->value));
 }
 
@@ -597,25 +653,60 @@ MaybeHandle<Object> Deserializer::DeserializePartial(
   attached_objects[kGlobalProxyReference] = global_proxy;
   SetAttachedObjects(attached_objects);
 
-  DisallowHeapAllocation no_gc;
-  // Keep track of the code space start and end pointers in case new
-  // code objects were unserialized
-  OldSpace* code_space = isolate_->heap()->code_space();
-  Address start_address = code_space->top();
-  Object* root;
-  Object* outdated_contexts;
-  VisitPointer(&root);
-  DeserializeDeferredObjects();
-  VisitPointer(&outdated_contexts);
-
-  // There's no code deserialized here. If this assert fires then that's
-  // changed and logging should be added to notify the profiler et al of the
-  // new code, which also has to be flushed from instruction cache.
-  CHECK_EQ(start_address, code_space->top());
-  CHECK(outdated_contexts->IsFixedArray());
-  *outdated_contexts_out =
-      Handle<FixedArray>(FixedArray::cast(outdated_contexts), isolate);
-  return Handle<Object>(root, isolate);
+  Handle<Object> result;
+  List<InternalField> internal_fields;
+  {
+    DisallowHeapAllocation no_gc;
+    // Keep track of the code space start and end pointers in case new
+    // code objects were unserialized
+    OldSpace* code_space = isolate_->heap()->code_space();
+    Address start_address = code_space->top();
+    Object* root;
+    Object* outdated_contexts;
+    VisitPointer(&root);
+    DeserializeDeferredObjects();
+    VisitPointer(&outdated_contexts);
+    ReadInternalFields(&internal_fields);
+
+    // There's no code deserialized here. If this assert fires then that's
+    // changed and logging should be added to notify the profiler et al of the
+    // new code, which also has to be flushed from instruction cache.
+    CHECK_EQ(start_address, code_space->top());
+    CHECK(outdated_contexts->IsFixedArray());
+    *outdated_contexts_out =
+        Handle<FixedArray>(FixedArray::cast(outdated_contexts), isolate);
+    result = Handle<Object>(root, isolate);
+  }
+
+  // The embedder restores its internal fields once the heap is consistent.
+  v8::DeserializeInternalFieldsCallback callback =
+      isolate->deserialize_internal_fields_callback();
+  if (callback != NULL) {
+    for (int i = 0; i < internal_fields.length(); i++) {
+      const InternalField& field = internal_fields[i];
+      callback(v8::Utils::ToLocal(field.holder), field.index, field.payload);
+    }
+  }
+  return result;
+}
+
+
+void Deserializer::ReadInternalFields(List<InternalField>* internal_fields) {
+  int count = source_.GetInt();
+  for (int i = 0; i < count; i++) {
+    Object* holder;
+    VisitPointer(&holder);
+    int index = source_.GetInt();
+    const byte* data;
+    int size;
+    CHECK(source_.GetBlob(&data, &size));
+    // The field was serialized as Smi zero, i.e. NULL, and stays so until
+    // the embedder restores it.
+    Handle<JSObject> object(JSObject::cast(holder), isolate_);
+    InternalField field = {
+        object, index, {reinterpret_cast<const char*>(data), size}};
+    internal_fields->Add(field);
+  }
 }
 
 
@@ -1504,10 +1595,43 @@ void PartialSerializer::Serialize(Object** o) {
   VisitPointer(o);
   SerializeDeferredObjects();
   SerializeOutdatedContextsAsFixedArray();
+  SerializeInternalFields();
   Pad();
 }
 
 
+void PartialSerializer::SerializeInternalFields() {
+  // Internal fields that hold aligned pointers are serialized by the embedder.
+  // The callback runs after the object graph has been written, so that each
+  // holder can be written as a back reference.
+  HandleScope scope(isolate_);
+  DisallowHeapAllocation no_gc;
+  List<InternalField> internal_fields;
+  for (int i = 0; i < internal_field_holders_.length(); i++) {
+    Handle<JSObject> holder(internal_field_holders_[i], isolate_);
+    for (int j = 0; j < holder->GetInternalFieldCount(); j++) {
+      Object* field = holder->GetInternalField(j);
+      if (!field->IsSmi() || field == Smi::FromInt(0)) continue;
+      v8::StartupData payload =
+          serialize_internal_fields_(v8::Utils::ToLocal(holder), j);
+      if (payload.raw_size <= 0) continue;
+      InternalField internal_field = {*holder, j, payload};
+      internal_fields.Add(internal_field);
+    }
+  }
+
+  sink_->PutInt(internal_fields.length(), "internal field count");
+  for (int i = 0; i < internal_fields.length(); i++) {
+    const InternalField& field = internal_fields[i];
+    SerializeObject(field.holder, kPlain, kStartOfObject, 0);
+    sink_->PutInt(field.index, "internal field index");
+    sink_->PutInt(field.payload.raw_size, "internal field size");
+    sink_->PutRaw(reinterpret_cast<const byte*>(field.payload.data),
+                  field.payload.raw_size, "internal field data");
+  }
+}
+
+
 void PartialSerializer::SerializeOutdatedContextsAsFixedArray() {
   int length = outdated_contexts_.length();
   if (length == 0) {
@@ -1878,6 +2002,11 @@ void PartialSerializer::SerializeObject(HeapObject* obj, HowToCode how_to_code,
     // become outdated after deserialization.
     outdated_contexts_.Add(Context::cast(obj));
   }
+
+  if (serialize_internal_fields_ != NULL && obj->IsJSObject() &&
+      JSObject::cast(obj)->GetInternalFieldCount() > 0) {
+    internal_field_holders_.Add(JSObject::cast(obj));
+  }
 }
 
 
@@ -2008,6 +2137,44 @@ class UnlinkWeakCellScope {
 };
 
 
+// Clear and later restore the internal fields of a JSObject that hold
+// aligned pointers. Such a pointer is only valid in the process that creates
+// the snapshot, so the snapshot gets Smi zero instead. The partial serializer
+// hands the fields to the embedder separately.
+class ClearAlignedPointersScope {
+ public:
+  explicit ClearAlignedPointersScope(HeapObject* object) : holder_(NULL) {
+    if (!object->IsJSObject()) return;
+    JSObject* holder = JSObject::cast(object);
+    for (int i = 0; i < holder->GetInternalFieldCount(); i++) {
+      Object* field = holder->GetInternalField(i);
+      if (!field->IsSmi() || field == Smi::FromInt(0)) continue;
+      ClearedField cleared = {i, Smi::cast(field)};
+      cleared_fields_.Add(cleared);
+      holder->SetInternalField(i, Smi::FromInt(0));
+    }
+    if (!cleared_fields_.is_empty()) holder_ = holder;
+  }
+
+  ~ClearAlignedPointersScope() {
+    for (int i = 0; i < cleared_fields_.length(); i++) {
+      const ClearedField& cleared = cleared_fields_[i];
+      holder_->SetInternalField(cleared.index, cleared.value);
+    }
+  }
+
+ private:
+  struct ClearedField {
+    int index;
+    Smi* value;
+  };
+
+  JSObject* holder_;
+  List<ClearedField> cleared_fields_;
+  DisallowHeapAllocation no_gc_;
+};
+
+
 void Serializer::ObjectSerializer::Serialize() {
   if (FLAG_trace_serializer) {
     PrintF(" Encoding heap object: ");
@@ -2061,6 +2228,7 @@ void Serializer::ObjectSerializer::Serialize() {
   }
 
   UnlinkWeakCellScope unlink_weak_cell(object_);
+  ClearAlignedPointersScope clear_aligned_pointers(object_);
 
   object_->IterateBody(map->instance_type(), size, this);
   OutputRawData(object_->address() + size);
@@ -2087,6 +2255,7 @@ void Serializer::ObjectSerializer::SerializeDeferred() {
   sink_->PutInt(size >> kPointerSizeLog2, "deferred object size");
 
   UnlinkWeakCellScope unlink_weak_cell(object_);
+  ClearAlignedPointersScope clear_aligned_pointers(object_);
 
   object_->IterateBody(map->instance_type(), size, this);
   OutputRawData(object_->address() + size);
@@ -5,6 +5,7 @@
 #ifndef V8_SNAPSHOT_SERIALIZE_H_
 #define V8_SNAPSHOT_SERIALIZE_H_
 
+#include "src/base/once.h"
 #include "src/hashmap.h"
 #include "src/heap/heap.h"
 #include "src/objects.h"
@@ -25,9 +26,9 @@ class ExternalReferenceTable {
  public:
   static ExternalReferenceTable* instance(Isolate* isolate);
 
-  int size() const { return refs_.length(); }
-  Address address(int i) { return refs_[i].address; }
-  const char* name(int i) { return refs_[i].name; }
+  int size() const { return shared_size_ + refs_.length(); }
+  Address address(int i) { return entry(i).address; }
+  const char* name(int i) { return entry(i).name; }
 
   inline static Address NotAvailable() { return NULL; }
 
@@ -36,15 +37,35 @@ class ExternalReferenceTable {
     Address address;
     const char* name;
   };
+  typedef List<ExternalReferenceEntry> ExternalReferenceList;
 
   explicit ExternalReferenceTable(Isolate* isolate);
 
-  void Add(Address address, const char* name) {
+  const ExternalReferenceEntry& entry(int i) const {
+    return i < shared_size_ ? shared_refs_->at(i) : refs_[i - shared_size_];
+  }
+
+  static void Add(ExternalReferenceList* refs, Address address,
+                  const char* name) {
     ExternalReferenceEntry entry = {address, name};
-    refs_.Add(entry);
+    refs->Add(entry);
   }
+  void Add(Address address, const char* name) { Add(&refs_, address, name); }
+
+  // References that are the same in every isolate come first in the table.
+  // They are created once per process and shared by the tables of all
+  // isolates, except in simulator builds, which redirect C functions per
+  // isolate.
+  static void AddIsolateIndependentReferences(Isolate* isolate,
+                                              ExternalReferenceList* refs);
+  static void CreateSharedReferences(Isolate* isolate);
+
+  static base::OnceType shared_references_once_;
+  static const ExternalReferenceList* shared_references_;
 
-  List<ExternalReferenceEntry> refs_;
+  const ExternalReferenceList* shared_refs_;
+  int shared_size_;
+  ExternalReferenceList refs_;
 
   DISALLOW_COPY_AND_ASSIGN(ExternalReferenceTable);
 };
@@ -574,6 +595,15 @@ class Deserializer: public SerializerDeserializer {
 
   void DeserializeDeferredObjects();
 
+  // An internal field that the embedder serialized, to be restored by the
+  // embedder once the context has been deserialized.
+  struct InternalField {
+    Handle<JSObject> holder;
+    int index;
+    v8::StartupData payload;
+  };
+  void ReadInternalFields(List<InternalField>* internal_fields);
+
   void FlushICacheForNewIsolate();
   void FlushICacheForNewCodeObjects();
 
@@ -775,12 +805,15 @@ class Serializer : public SerializerDeserializer {
 
 class PartialSerializer : public Serializer {
  public:
-  PartialSerializer(Isolate* isolate, Serializer* startup_snapshot_serializer,
-                    SnapshotByteSink* sink)
+  PartialSerializer(
+      Isolate* isolate, Serializer* startup_snapshot_serializer,
+      SnapshotByteSink* sink,
+      v8::SerializeInternalFieldsCallback serialize_internal_fields = NULL)
       : Serializer(isolate, sink),
         startup_serializer_(startup_snapshot_serializer),
         outdated_contexts_(0),
-        global_object_(NULL) {
+        global_object_(NULL),
+        serialize_internal_fields_(serialize_internal_fields) {
     InitializeCodeAddressMap();
   }
 
@@ -796,11 +829,20 @@ class PartialSerializer : public Serializer {
   bool ShouldBeInThePartialSnapshotCache(HeapObject* o);
 
   void SerializeOutdatedContextsAsFixedArray();
+  void SerializeInternalFields();
+
+  struct InternalField {
+    JSObject* holder;
+    int index;
+    v8::StartupData payload;
+  };
 
   Serializer* startup_serializer_;
   List<Context*> outdated_contexts_;
   Object* global_object_;
   PartialCacheIndexMap partial_cache_index_map_;
+  v8::SerializeInternalFieldsCallback serialize_internal_fields_;
+  List<JSObject*> internal_field_holders_;
   DISALLOW_COPY_AND_ASSIGN(PartialSerializer);
 };
 
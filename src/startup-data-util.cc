@@ -20,6 +20,8 @@ namespace {
 
 v8::StartupData g_natives;
 v8::StartupData g_snapshot;
+base::OS::MemoryMappedFile* g_natives_file = nullptr;
+base::OS::MemoryMappedFile* g_snapshot_file = nullptr;
 
 
 void ClearStartupData(v8::StartupData* data) {
@@ -28,43 +30,45 @@ void ClearStartupData(v8::StartupData* data) {
 }
 
 
-void DeleteStartupData(v8::StartupData* data) {
-  delete[] data->data;
+void DeleteStartupData(v8::StartupData* data,
+                       base::OS::MemoryMappedFile** file) {
+  delete *file;
+  *file = nullptr;
   ClearStartupData(data);
 }
 
 
 void FreeStartupData() {
-  DeleteStartupData(&g_natives);
-  DeleteStartupData(&g_snapshot);
+  DeleteStartupData(&g_natives, &g_natives_file);
+  DeleteStartupData(&g_snapshot, &g_snapshot_file);
 }
 
 
+// Maps the blob file read-only instead of reading it into the heap. Only
+// the pages that V8 actually touches are read in, and the pages can be
+// shared by all processes that use the same file.
 void Load(const char* blob_file, v8::StartupData* startup_data,
+          base::OS::MemoryMappedFile** mapped_file,
           void (*setter_fn)(v8::StartupData*)) {
   ClearStartupData(startup_data);
 
   if (!blob_file) return;
 
-  FILE* file = fopen(blob_file, "rb");
+  base::OS::MemoryMappedFile* file = base::OS::MemoryMappedFile::open(
+      blob_file, base::OS::MemoryMappedFile::kReadOnly);
   if (!file) return;
 
-  fseek(file, 0, SEEK_END);
-  startup_data->raw_size = static_cast<int>(ftell(file));
-  rewind(file);
-
-  startup_data->data = new char[startup_data->raw_size];
-  int read_size = static_cast<int>(fread(const_cast<char*>(startup_data->data),
-                                         1, startup_data->raw_size, file));
-  fclose(file);
-
-  if (startup_data->raw_size == read_size) (*setter_fn)(startup_data);
+  *mapped_file = file;
+  startup_data->data = reinterpret_cast<const char*>(file->memory());
+  startup_data->raw_size = static_cast<int>(file->size());
+  (*setter_fn)(startup_data);
 }
 
 
 void LoadFromFiles(const char* natives_blob, const char* snapshot_blob) {
-  Load(natives_blob, &g_natives, v8::V8::SetNativesDataBlob);
-  Load(snapshot_blob, &g_snapshot, v8::V8::SetSnapshotDataBlob);
+  Load(natives_blob, &g_natives, &g_natives_file, v8::V8::SetNativesDataBlob);
+  Load(snapshot_blob, &g_snapshot, &g_snapshot_file,
+       v8::V8::SetSnapshotDataBlob);
 
   atexit(&FreeStartupData);
 }
@@ -4,8 +4,10 @@
 
 #include "src/string-builder.h"
 
+#include "include/v8-profiler.h"
 #include "src/isolate-inl.h"
 #include "src/objects-inl.h"
+#include "src/unicode-inl.h"
 
 namespace v8 {
 namespace internal {
@@ -50,7 +52,8 @@ IncrementalStringBuilder::IncrementalStringBuilder(Isolate* isolate)
       encoding_(String::ONE_BYTE_ENCODING),
       overflowed_(false),
       part_length_(kInitialPartLength),
-      current_index_(0) {
+      current_index_(0),
+      writer_(NULL) {
   // Create an accumulator handle starting with the empty string.
   accumulator_ = Handle<String>(isolate->heap()->empty_string(), isolate);
   current_part_ =
@@ -59,6 +62,10 @@ IncrementalStringBuilder::IncrementalStringBuilder(Isolate* isolate)
 
 
 void IncrementalStringBuilder::Accumulate(Handle<String> new_part) {
+  if (writer_ != NULL) {
+    writer_->Write(new_part);
+    return;
+  }
   Handle<String> new_accumulator;
   if (accumulator()->length() + new_part->length() > String::kMaxLength) {
     // Set the flag and carry on. Delay throwing the exception till the end.
@@ -93,6 +100,7 @@ void IncrementalStringBuilder::Extend() {
 MaybeHandle<String> IncrementalStringBuilder::Finish() {
   ShrinkCurrentPart();
   Accumulate(current_part());
+  if (writer_ != NULL) writer_->Finalize();
   if (overflowed_) {
     THROW_NEW_ERROR(isolate_, NewInvalidStringLengthError(), String);
   }
@@ -106,5 +114,113 @@ void IncrementalStringBuilder::AppendString(Handle<String> string) {
   Extend();  // Attach current part and allocate new part.
   Accumulate(string);
 }
+
+
+Utf8OutputStreamWriter::Utf8OutputStreamWriter(v8::OutputStream* stream)
+    : stream_(stream),
+      chunk_size_(stream->GetChunkSize()),
+      chunk_position_(0),
+      pending_lead_surrogate_(unibrow::Utf16::kNoPreviousCharacter),
+      aborted_(false) {
+  DCHECK(chunk_size_ > 0);
+  // Leave room for the longest encoded character.
+  chunk_size_ =
+      Max(chunk_size_, static_cast<int>(unibrow::Utf8::kMaxEncodedSize));
+  chunk_ = NewArray<char>(chunk_size_);
+}
+
+
+Utf8OutputStreamWriter::~Utf8OutputStreamWriter() { DeleteArray(chunk_); }
+
+
+void Utf8OutputStreamWriter::Write(Handle<String> string) {
+  if (aborted_) return;
+  string = String::Flatten(string);
+  DisallowHeapAllocation no_gc;
+  String::FlatContent content = string->GetFlatContent();
+  DCHECK(content.IsFlat());
+  if (content.IsOneByte()) {
+    Vector<const uint8_t> chars = content.ToOneByteVector();
+    WriteChars(chars.start(), chars.length());
+  } else {
+    Vector<const uc16> chars = content.ToUC16Vector();
+    WriteChars(chars.start(), chars.length());
+  }
+}
+
+
+template <typename Char>
+void Utf8OutputStreamWriter::WriteChars(const Char* chars, int length) {
+  for (int i = 0; i < length && !aborted_; i++) {
+    if (pending_lead_surrogate_ == unibrow::Utf16::kNoPreviousCharacter) {
+      // Copy runs of ASCII characters straight into the chunk.
+      int run_end = i + Min(length - i, chunk_size_ - chunk_position_);
+      while (i < run_end && chars[i] <= unibrow::Utf8::kMaxOneByteChar) {
+        chunk_[chunk_position_++] = static_cast<char>(chars[i++]);
+      }
+      if (chunk_position_ == chunk_size_) Flush();
+      if (i == length) break;
+    }
+    WriteCodeUnit(chars[i]);
+  }
+}
+
+
+void Utf8OutputStreamWriter::WriteCodeUnit(uc16 c) {
+  if (chunk_size_ - chunk_position_ <
+      static_cast<int>(unibrow::Utf8::kMaxEncodedSize)) {
+    Flush();
+    if (aborted_) return;
+  }
+  char* out = chunk_ + chunk_position_;
+  int previous = pending_lead_surrogate_;
+  pending_lead_surrogate_ = unibrow::Utf16::kNoPreviousCharacter;
+  if (unibrow::Utf16::IsSurrogatePair(previous, c)) {
+    chunk_position_ += unibrow::Utf8::Encode(
+        out, unibrow::Utf16::CombineSurrogatePair(previous, c),
+        unibrow::Utf16::kNoPreviousCharacter, false);
+    return;
+  }
+  if (previous != unibrow::Utf16::kNoPreviousCharacter) {
+    // A lone lead surrogate is encoded as is, like String::WriteUtf8 does.
+    chunk_position_ += unibrow::Utf8::Encode(
+        out, previous, unibrow::Utf16::kNoPreviousCharacter, false);
+    WriteCodeUnit(c);
+    return;
+  }
+  if (unibrow::Utf16::IsLeadSurrogate(c)) {
+    // Hold back the lead surrogate until the next code unit is known.
+    pending_lead_surrogate_ = c;
+    return;
+  }
+  chunk_position_ += unibrow::Utf8::Encode(
+      out, c, unibrow::Utf16::kNoPreviousCharacter, false);
+}
+
+
+void Utf8OutputStreamWriter::Flush() {
+  if (aborted_ || chunk_position_ == 0) return;
+  if (stream_->WriteAsciiChunk(chunk_, chunk_position_) ==
+      v8::OutputStream::kAbort) {
+    aborted_ = true;
+  }
+  chunk_position_ = 0;
+}
+
+
+void Utf8OutputStreamWriter::Finalize() {
+  if (pending_lead_surrogate_ != unibrow::Utf16::kNoPreviousCharacter) {
+    if (chunk_size_ - chunk_position_ <
+        static_cast<int>(unibrow::Utf8::kMaxEncodedSize)) {
+      Flush();
+    }
+    chunk_position_ += unibrow::Utf8::Encode(
+        chunk_ + chunk_position_, pending_lead_surrogate_,
+        unibrow::Utf16::kNoPreviousCharacter, false);
+    pending_lead_surrogate_ = unibrow::Utf16::kNoPreviousCharacter;
+  }
+  Flush();
+  if (!aborted_) stream_->EndOfStream();
+}
 }  // namespace internal
 }  // namespace v8
@@ -267,10 +267,55 @@ class ReplacementStringBuilder {
 };
 
 
+// Encodes strings as UTF-8 and passes the result in chunks of the preferred
+// size to an embedder provided stream. Surrogate pairs split between two
+// writes are combined.
+class Utf8OutputStreamWriter {
+ public:
+  explicit Utf8OutputStreamWriter(v8::OutputStream* stream);
+  ~Utf8OutputStreamWriter();
+
+  void Write(Handle<String> string);
+
+  // Flush the buffered output and notify the stream about its end.
+  void Finalize();
+
+  bool aborted() const { return aborted_; }
+
+ private:
+  template <typename Char>
+  void WriteChars(const Char* chars, int length);
+
+  void WriteCodeUnit(uc16 c);
+  void Flush();
+
+  v8::OutputStream* stream_;
+  int chunk_size_;
+  char* chunk_;
+  int chunk_position_;
+  int pending_lead_surrogate_;
+  bool aborted_;
+
+  DISALLOW_COPY_AND_ASSIGN(Utf8OutputStreamWriter);
+};
+
+
 class IncrementalStringBuilder {
  public:
   explicit IncrementalStringBuilder(Isolate* isolate);
 
+  // Pass finished parts to |writer| instead of accumulating them into the
+  // result, which is then always the empty string. Must be set before
+  // anything is appended.
+  void set_output_stream_writer(Utf8OutputStreamWriter* writer) {
+    DCHECK(current_index_ == 0 && accumulator()->length() == 0);
+    writer_ = writer;
+  }
+
+  // Whether the output stream writer discards everything appended from now
+  // on because its stream aborted.
+  bool HasAborted() const { return writer_ != NULL && writer_->aborted(); }
+
   INLINE(String::Encoding CurrentEncoding()) { return encoding_; }
 
   template <typename SrcChar, typename DestChar>
@@ -412,6 +457,7 @@ class IncrementalStringBuilder {
   int current_index_;
   Handle<String> accumulator_;
   Handle<String> current_part_;
+  Utf8OutputStreamWriter* writer_;
 };
 
 
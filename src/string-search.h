@@ -5,9 +5,17 @@
 #ifndef V8_STRING_SEARCH_H_
 #define V8_STRING_SEARCH_H_
 
+#include "src/base/bits.h"
 #include "src/isolate.h"
 #include "src/vector.h"
 
+// SSE2 is part of the x64 baseline, so its kernels need no runtime CPU
+// dispatch. On ia32 they are only used when the compiler targets SSE2.
+#if V8_HOST_ARCH_X64 || (V8_HOST_ARCH_IA32 && defined(__SSE2__))
+#define V8_STRING_SEARCH_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace v8 {
 namespace internal {
 
@@ -206,12 +214,68 @@ inline uint8_t GetHighestValueByte(uc16 character) {
 inline uint8_t GetHighestValueByte(uint8_t character) { return character; }
 
 
+#ifdef V8_STRING_SEARCH_USE_SSE2
+
+// Number of bytes compared at once by the SSE2 kernels.
+static const int kSimdBlockSize = sizeof(__m128i);
+
+
+inline __m128i SimdSplat(uint8_t character) {
+  return _mm_set1_epi8(static_cast<char>(character));
+}
+
+
+inline __m128i SimdSplat(uc16 character) {
+  return _mm_set1_epi16(static_cast<int16_t>(character));
+}
+
+
+// Returns a mask with bit (i * sizeof(Char)) set iff chars[i] equals the
+// splatted character, for the kSimdBlockSize / sizeof(Char) characters
+// starting at |chars|.
+inline uint32_t SimdMatchMask(const uint8_t* chars, __m128i splat) {
+  __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(block, splat));
+}
+
+
+inline uint32_t SimdMatchMask(const uc16* chars, __m128i splat) {
+  __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars));
+  // Keep one bit per matching character.
+  return _mm_movemask_epi8(_mm_cmpeq_epi16(block, splat)) & 0x5555;
+}
+
+#endif  // V8_STRING_SEARCH_USE_SSE2
+
+
 template <typename PatternChar, typename SubjectChar>
 inline int FindFirstCharacter(Vector<const PatternChar> pattern,
                               Vector<const SubjectChar> subject, int index) {
   const PatternChar pattern_first_char = pattern[0];
   const int max_n = (subject.length() - pattern.length() + 1);
 
+#ifdef V8_STRING_SEARCH_USE_SSE2
+  // memchr is already vectorized for one-byte subjects, but it can only look
+  // for a single byte of a two-byte character.
+  if (sizeof(SubjectChar) == kUC16Size) {
+    const int kBlockLength = kSimdBlockSize / sizeof(SubjectChar);
+    const SubjectChar search_char =
+        static_cast<SubjectChar>(pattern_first_char);
+    const __m128i splat = SimdSplat(search_char);
+    int pos = index;
+    for (; pos + kBlockLength <= max_n; pos += kBlockLength) {
+      uint32_t mask = SimdMatchMask(subject.start() + pos, splat);
+      if (mask != 0) {
+        return pos + base::bits::CountTrailingZeros32(mask) / kUC16Size;
+      }
+    }
+    for (; pos < max_n; pos++) {
+      if (subject[pos] == search_char) return pos;
+    }
+    return -1;
+  }
+#endif
+
   const uint8_t search_byte = GetHighestValueByte(pattern_first_char);
   const SubjectChar search_char = static_cast<SubjectChar>(pattern_first_char);
   int pos = index;
@@ -270,6 +334,50 @@ inline bool CharCompare(const PatternChar* pattern,
 }
 
 
+#ifdef V8_STRING_SEARCH_USE_SSE2
+
+// Compares the first and the last pattern character against a block of
+// consecutive candidate positions at once, and only checks the rest of the
+// pattern where both match. Unlike a first character scan this rarely stops
+// on false positives in natural text.
+template <typename PatternChar, typename SubjectChar>
+inline int FirstLastCharacterSearch(Vector<const PatternChar> pattern,
+                                    Vector<const SubjectChar> subject,
+                                    int index) {
+  const int kBlockLength = kSimdBlockSize / sizeof(SubjectChar);
+  int pattern_length = pattern.length();
+  DCHECK(pattern_length > 1);
+  int n = subject.length() - pattern_length;
+  const __m128i first = SimdSplat(static_cast<SubjectChar>(pattern[0]));
+  const __m128i last =
+      SimdSplat(static_cast<SubjectChar>(pattern[pattern_length - 1]));
+  int i = index;
+  for (; i + kBlockLength - 1 <= n; i += kBlockLength) {
+    const SubjectChar* block = subject.start() + i;
+    uint32_t mask = SimdMatchMask(block, first) &
+                    SimdMatchMask(block + pattern_length - 1, last);
+    while (mask != 0) {
+      int offset = base::bits::CountTrailingZeros32(mask) / sizeof(SubjectChar);
+      if (CharCompare(pattern.start() + 1, block + offset + 1,
+                      pattern_length - 1)) {
+        return i + offset;
+      }
+      mask &= mask - 1;
+    }
+  }
+  for (; i <= n; i++) {
+    if (pattern[0] == subject[i] &&
+        CharCompare(pattern.start() + 1, subject.start() + i + 1,
+                    pattern_length - 1)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+#endif  // V8_STRING_SEARCH_USE_SSE2
+
+
 // Simple linear search for short patterns. Never bails out.
 template <typename PatternChar, typename SubjectChar>
 int StringSearch<PatternChar, SubjectChar>::LinearSearch(
@@ -278,6 +386,9 @@ int StringSearch<PatternChar, SubjectChar>::LinearSearch(
     int index) {
   Vector<const PatternChar> pattern = search->pattern_;
   DCHECK(pattern.length() > 1);
+#ifdef V8_STRING_SEARCH_USE_SSE2
+  return FirstLastCharacterSearch(pattern, subject, index);
+#else
   int pattern_length = pattern.length();
   int i = index;
   int n = subject.length() - pattern_length;
@@ -295,6 +406,7 @@ int StringSearch<PatternChar, SubjectChar>::LinearSearch(
     }
   }
   return -1;
+#endif  // V8_STRING_SEARCH_USE_SSE2
 }
 
 //---------------------------------------------------------------------
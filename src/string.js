@@ -158,7 +158,6 @@ function StringMatchJS(regexp) {
     var lastIndex = TO_INTEGER(regexp.lastIndex);
     if (!regexp.global) return RegExpExecNoTests(regexp, subject, 0);
     var result = %StringMatch(subject, regexp, RegExpLastMatchInfo);
-    if (result !== null) $regexpLastMatchInfoOverride = null;
     regexp.lastIndex = 0;
     return result;
   }
@@ -213,8 +212,6 @@ function StringReplace(search, replace) {
   // ........ empty string replace
   // ........ non-empty string replace (with $-expansion)
   // ...... global search
-  // ........ no need to circumvent last match info override
-  // ........ need to circument last match info override
   // .... function replace
   // ...... global search
   // ...... non-global search
@@ -249,24 +246,8 @@ function StringReplace(search, replace) {
 
       // Global regexp search, string replace.
       search.lastIndex = 0;
-      if ($regexpLastMatchInfoOverride == null) {
-        return %StringReplaceGlobalRegExpWithString(
-            subject, search, replace, RegExpLastMatchInfo);
-      } else {
-        // We use this hack to detect whether StringReplaceRegExpWithString
-        // found at least one hit. In that case we need to remove any
-        // override.
-        var saved_subject = RegExpLastMatchInfo[LAST_SUBJECT_INDEX];
-        RegExpLastMatchInfo[LAST_SUBJECT_INDEX] = 0;
-        var answer = %StringReplaceGlobalRegExpWithString(
-            subject, search, replace, RegExpLastMatchInfo);
-        if (%_IsSmi(RegExpLastMatchInfo[LAST_SUBJECT_INDEX])) {
-          RegExpLastMatchInfo[LAST_SUBJECT_INDEX] = saved_subject;
-        } else {
-          $regexpLastMatchInfoOverride = null;
-        }
-        return answer;
-      }
+      return %StringReplaceGlobalRegExpWithString(
+          subject, search, replace, RegExpLastMatchInfo);
     }
 
     if (search.global) {
@@ -408,11 +389,28 @@ function CaptureString(string, lastCaptureInfo, index) {
 
 // TODO(lrn): This array will survive indefinitely if replace is never
 // called again. However, it will be empty, since the contents are cleared
-// in the finally block.
+// before it is written back.
 var reusableReplaceArray = new InternalArray(4);
 
+// Adds the slice [from, to) of the subject to a part list for
+// %StringBuilderConcat, encoded like ReplacementStringBuilder does.
+function AddSubjectSlice(parts, from, to) {
+  var length = to - from;
+  if (length <= 0) return;
+  if (length < (1 << 11) && from < (1 << 19)) {
+    parts.push((from << 11) | length);
+  } else {
+    parts.push(-length, from);
+  }
+}
+
 // Helper function for replacing regular expressions with the result of a
 // function application in String.prototype.replace.
+//
+// %RegExpExecMultiple only records the capture registers of each match. The
+// match and its captures are sliced from the subject right before the call to
+// the replace function, and the registers are copied into the last match info
+// so that RegExp.$1, RegExp.leftContext etc. read them lazily.
 function StringReplaceGlobalRegExpWithFunction(subject, regexp, replace) {
   var resultArray = reusableReplaceArray;
   if (resultArray) {
@@ -435,52 +433,49 @@ function StringReplaceGlobalRegExpWithFunction(subject, regexp, replace) {
     return subject;
   }
   var len = res.length;
-  if (NUMBER_OF_CAPTURES(RegExpLastMatchInfo) == 2) {
-    // If the number of captures is two then there are no explicit captures in
-    // the regexp, just the implicit capture that captures the whole match.  In
-    // this case we can simplify quite a bit and end up with something faster.
-    // The builder will consist of some integers that indicate slices of the
-    // input string and some replacements that were returned from the replace
-    // function.
-    var match_start = 0;
-    var override = new InternalPackedArray(null, 0, subject);
-    for (var i = 0; i < len; i++) {
-      var elem = res[i];
-      if (%_IsSmi(elem)) {
-        // Integers represent slices of the original string.  Use these to
-        // get the offsets we need for the override array (so things like
-        // RegExp.leftContext work during the callback function.
-        if (elem > 0) {
-          match_start = (elem >> 11) + (elem & 0x7ff);
-        } else {
-          match_start = res[++i] - elem;
-        }
-      } else {
-        override[0] = elem;
-        override[1] = match_start;
-        $regexpLastMatchInfoOverride = override;
-        var func_result = replace(elem, match_start, subject);
-        // Overwrite the i'th element in the results with the string we got
-        // back from the callback function.
-        res[i] = TO_STRING(func_result);
-        match_start += elem.length;
-      }
+  // Twice the number of captures including the implicit whole match capture.
+  var registers = NUMBER_OF_CAPTURES(RegExpLastMatchInfo);
+  var parts = new InternalArray();
+  var parameters;
+  if (registers > 2) {
+    parameters = new InternalArray((registers >> 1) + 2);
+  }
+  var previous = 0;
+  for (var i = 0; i < len; i += registers) {
+    var match_start = res[i];
+    var match_end = res[i + 1];
+    AddSubjectSlice(parts, previous, match_start);
+    previous = match_end;
+    // The replace function may have run other regexps, so the last match
+    // info is rewritten for every match.
+    for (var j = 0; j < registers; j++) {
+      RegExpLastMatchInfo[CAPTURE(j)] = res[i + j];
     }
-  } else {
-    for (var i = 0; i < len; i++) {
-      var elem = res[i];
-      if (!%_IsSmi(elem)) {
-        // elem must be an Array.
-        // Use the apply argument as backing for global RegExp properties.
-        $regexpLastMatchInfoOverride = elem;
-        var func_result = %Apply(replace, UNDEFINED, elem, 0, elem.length);
-        // Overwrite the i'th element in the results with the string we got
-        // back from the callback function.
-        res[i] = TO_STRING(func_result);
+    RegExpLastMatchInfo[REGEXP_NUMBER_OF_CAPTURES] = registers;
+    RegExpLastMatchInfo[LAST_SUBJECT_INDEX] = subject;
+    var match = %_SubString(subject, match_start, match_end);
+    var func_result;
+    if (registers == 2) {
+      // Without explicit captures nothing but the match itself needs to be
+      // allocated.
+      func_result = replace(match, match_start, subject);
+    } else {
+      parameters[0] = match;
+      var k = 1;
+      for (var j = 2; j < registers; j += 2) {
+        var capture_start = res[i + j];
+        parameters[k++] = capture_start < 0
+            ? UNDEFINED
+            : %_SubString(subject, capture_start, res[i + j + 1]);
       }
+      parameters[k++] = match_start;
+      parameters[k++] = subject;
+      func_result = %Apply(replace, UNDEFINED, parameters, 0, k);
     }
+    parts.push(TO_STRING(func_result));
   }
-  var result = %StringBuilderConcat(res, res.length, subject);
+  AddSubjectSlice(parts, previous, subject.length);
+  var result = %StringBuilderConcat(parts, parts.length, subject);
   resultArray.length = 0;
   reusableReplaceArray = resultArray;
   return result;
@@ -5,26 +5,83 @@
 
 #include "src/unicode-inl.h"
 #include "src/unicode-decoder.h"
+#include "src/base/bits.h"
 #include <stdio.h>
 #include <stdlib.h>
 
+// SSE2 is part of the x64 baseline, so no runtime CPU dispatch is needed.
+#if V8_HOST_ARCH_X64 || (V8_HOST_ARCH_IA32 && defined(__SSE2__))
+#define V8_UTF8_DECODER_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace unibrow {
 
+size_t Utf8DecoderBase::AsciiPrefixLength(const uint8_t* stream,
+                                          size_t length) {
+  size_t i = 0;
+#ifdef V8_UTF8_DECODER_USE_SSE2
+  // The sign bits of a block are set exactly for its non-ASCII bytes.
+  const size_t kBlockSize = sizeof(__m128i);
+  for (; i + kBlockSize <= length; i += kBlockSize) {
+    __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(stream + i));
+    int mask = _mm_movemask_epi8(block);
+    if (mask != 0) {
+      return i + v8::base::bits::CountTrailingZeros32(mask);
+    }
+  }
+#else
+  const uintptr_t kNonAsciiMask =
+      v8::internal::kUintptrAllBitsSet / 0xFF * 0x80;
+  for (; i + sizeof(uintptr_t) <= length; i += sizeof(uintptr_t)) {
+    uintptr_t word;
+    v8::internal::MemCopy(&word, stream + i, sizeof(word));
+    if (word & kNonAsciiMask) break;
+  }
+#endif
+  while (i < length && stream[i] <= Utf8::kMaxOneByteChar) i++;
+  return i;
+}
+
+
 void Utf8DecoderBase::Reset(uint16_t* buffer, size_t buffer_length,
                             const uint8_t* stream, size_t stream_length) {
   // Assume everything will fit in the buffer and stream won't be needed.
   last_byte_of_buffer_unused_ = false;
   unbuffered_start_ = NULL;
   unbuffered_length_ = 0;
+  is_one_byte_ = true;
   bool writing_to_buffer = true;
   // Loop until stream is read, writing to buffer as long as buffer has space.
   size_t utf16_length = 0;
   while (stream_length != 0) {
+    if (*stream <= Utf8::kMaxOneByteChar) {
+      // Consume a whole run of ASCII characters at once.
+      size_t run_length = AsciiPrefixLength(stream, stream_length);
+      if (writing_to_buffer) {
+        DCHECK(utf16_length < buffer_length);
+        size_t space = buffer_length - utf16_length;
+        size_t copy_length = run_length < space ? run_length : space;
+        v8::internal::CopyChars(buffer, stream, copy_length);
+        buffer += copy_length;
+        if (copy_length == space) {
+          writing_to_buffer = false;
+          unbuffered_start_ = stream + copy_length;
+          unbuffered_length_ = stream_length - copy_length;
+        }
+      }
+      utf16_length += run_length;
+      stream += run_length;
+      stream_length -= run_length;
+      continue;
+    }
     size_t cursor = 0;
     uint32_t character = Utf8::ValueOf(stream, stream_length, &cursor);
     DCHECK(cursor > 0 && cursor <= stream_length);
     stream += cursor;
     stream_length -= cursor;
+    if (character > Latin1::kMaxChar) is_one_byte_ = false;
     bool is_two_characters = character > Utf16::kMaxNonSurrogateCharCode;
     utf16_length += is_two_characters ? 2 : 1;
     // Don't need to write to the buffer, but still need utf16_length.
@@ -62,6 +119,16 @@ void Utf8DecoderBase::WriteUtf16Slow(const uint8_t* stream,
                                      size_t stream_length, uint16_t* data,
                                      size_t data_length) {
   while (data_length != 0) {
+    if (*stream <= Utf8::kMaxOneByteChar) {
+      size_t run_length = AsciiPrefixLength(stream, stream_length);
+      if (run_length > data_length) run_length = data_length;
+      v8::internal::CopyChars(data, stream, run_length);
+      data += run_length;
+      data_length -= run_length;
+      stream += run_length;
+      stream_length -= run_length;
+      continue;
+    }
     size_t cursor = 0;
     uint32_t character = Utf8::ValueOf(stream, stream_length, &cursor);
     // There's a total lack of bounds checking for stream
@@ -81,4 +148,30 @@ void Utf8DecoderBase::WriteUtf16Slow(const uint8_t* stream,
   }
 }
 
+
+void Utf8DecoderBase::WriteOneByteSlow(const uint8_t* stream,
+                                       size_t stream_length, uint8_t* data,
+                                       size_t data_length) {
+  while (data_length != 0) {
+    if (*stream <= Utf8::kMaxOneByteChar) {
+      size_t run_length = AsciiPrefixLength(stream, stream_length);
+      if (run_length > data_length) run_length = data_length;
+      v8::internal::MemCopy(data, stream, run_length);
+      data += run_length;
+      data_length -= run_length;
+      stream += run_length;
+      stream_length -= run_length;
+      continue;
+    }
+    size_t cursor = 0;
+    uint32_t character = Utf8::ValueOf(stream, stream_length, &cursor);
+    DCHECK(character <= Latin1::kMaxChar);
+    stream += cursor;
+    DCHECK(stream_length >= cursor);
+    stream_length -= cursor;
+    *data++ = static_cast<uint8_t>(character);
+    data_length -= 1;
+  }
+}
+
 }  // namespace unibrow
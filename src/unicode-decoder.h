@@ -17,6 +17,11 @@ class Utf8DecoderBase {
   inline Utf8DecoderBase(uint16_t* buffer, size_t buffer_length,
                          const uint8_t* stream, size_t stream_length);
   inline size_t Utf16Length() const { return utf16_length_; }
+  // True if all decoded characters fit in one byte (Latin-1).
+  inline bool IsOneByte() const { return is_one_byte_; }
+
+  // Returns the length of the ASCII prefix of |stream|.
+  static size_t AsciiPrefixLength(const uint8_t* stream, size_t length);
 
  protected:
   // This reads all characters and sets the utf16_length_.
@@ -25,10 +30,13 @@ class Utf8DecoderBase {
              size_t stream_length);
   static void WriteUtf16Slow(const uint8_t* stream, size_t stream_length,
                              uint16_t* data, size_t length);
+  static void WriteOneByteSlow(const uint8_t* stream, size_t stream_length,
+                               uint8_t* data, size_t length);
   const uint8_t* unbuffered_start_;
   size_t unbuffered_length_;
   size_t utf16_length_;
   bool last_byte_of_buffer_unused_;
+  bool is_one_byte_;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(Utf8DecoderBase);
@@ -41,6 +49,8 @@ class Utf8Decoder : public Utf8DecoderBase {
   inline Utf8Decoder(const char* stream, size_t length);
   inline void Reset(const char* stream, size_t length);
   inline size_t WriteUtf16(uint16_t* data, size_t length) const;
+  // Like WriteUtf16, but for input that IsOneByte.
+  inline size_t WriteOneByte(uint8_t* data, size_t length) const;
 
  private:
   uint16_t buffer_[kBufferSize];
@@ -51,7 +61,8 @@ Utf8DecoderBase::Utf8DecoderBase()
     : unbuffered_start_(NULL),
       unbuffered_length_(0),
       utf16_length_(0),
-      last_byte_of_buffer_unused_(false) {}
+      last_byte_of_buffer_unused_(false),
+      is_one_byte_(true) {}
 
 
 Utf8DecoderBase::Utf8DecoderBase(uint16_t* buffer, size_t buffer_length,
@@ -91,6 +102,24 @@ size_t Utf8Decoder<kBufferSize>::WriteUtf16(uint16_t* data,
   return length;
 }
 
+
+template <size_t kBufferSize>
+size_t Utf8Decoder<kBufferSize>::WriteOneByte(uint8_t* data,
+                                              size_t length) const {
+  DCHECK(length > 0);
+  DCHECK(is_one_byte_);
+  if (length > utf16_length_) length = utf16_length_;
+  // One-byte characters never leave the last buffer slot unused.
+  DCHECK(!last_byte_of_buffer_unused_);
+  size_t copy_length = length <= kBufferSize ? length : kBufferSize;
+  v8::internal::CopyChars(data, buffer_, copy_length);
+  if (length <= kBufferSize) return length;
+  DCHECK(unbuffered_start_ != NULL);
+  WriteOneByteSlow(unbuffered_start_, unbuffered_length_, data + kBufferSize,
+                   length - kBufferSize);
+  return length;
+}
+
 class Latin1 {
  public:
   static const unsigned kMaxChar = 0xff;
@@ -0,0 +1,1040 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/value-serializer.h"
+
+#include <stdlib.h>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "src/base/logging.h"
+#include "src/conversions.h"
+#include "src/execution.h"
+#include "src/factory.h"
+#include "src/global-handles.h"
+#include "src/handles-inl.h"
+#include "src/isolate-inl.h"
+#include "src/lookup.h"
+#include "src/objects-inl.h"
+#include "src/objects.h"
+#include "src/utils.h"
+#include "src/v8.h"
+
+namespace v8 {
+namespace internal {
+
+const uint32_t ValueSerializer::kLatestVersion = 1;
+
+enum class SerializationTag : uint8_t {
+  // version:uint32_t (if at beginning of data, sets version > 0)
+  kVersion = 0xFF,
+  // Oddballs (no data).
+  kUndefined = '_',
+  kNull = '0',
+  kTrue = 'T',
+  kFalse = 'F',
+  // Number represented as 32-bit integer, ZigZag-encoded
+  // (like sint32 in protobuf)
+  kInt32 = 'I',
+  // Number represented as a 64-bit double.
+  // Host byte order is used (N.B. this makes the format non-portable).
+  kDouble = 'N',
+  // byteLength:uint32_t, then raw data
+  kOneByteString = '"',
+  kTwoByteString = 'c',
+  // Reference to a serialized object. objectID:uint32_t
+  kObjectReference = '^',
+  // Beginning of a JS object.
+  kBeginJSObject = 'o',
+  // End of a JS object. numProperties:uint32_t
+  kEndJSObject = '{',
+  // Beginning of a sparse JS array. length:uint32_t
+  // Elements and properties are written as key/value pairs, like objects.
+  kBeginSparseJSArray = 'a',
+  // End of a sparse JS array. numProperties:uint32_t length:uint32_t
+  kEndSparseJSArray = '@',
+  // Beginning of a dense JS array. length:uint32_t
+  // |length| elements, followed by properties as key/value pairs
+  kBeginDenseJSArray = 'A',
+  // End of a dense JS array. numProperties:uint32_t length:uint32_t
+  kEndDenseJSArray = '$',
+  // Date. millisSinceEpoch:double
+  kDate = 'D',
+  // Array buffer. byteLength:uint32_t, then raw data.
+  kArrayBuffer = 'B',
+  // Array buffer (transferred). transferID:uint32_t
+  kArrayBufferTransfer = 't',
+  // View into an array buffer.
+  // subtag:ArrayBufferViewTag, byteOffset:uint32_t, byteLength:uint32_t
+  // For typed arrays, byteOffset and byteLength must be divisible by the size
+  // of the element.
+  // Note: kArrayBufferView is special, and should have an ArrayBuffer (or an
+  // ObjectReference to one) serialized just before it.
+  kArrayBufferView = 'V',
+  // Shared array buffer (transferred). transferID:uint32_t
+  kSharedArrayBufferTransfer = 'u',
+  // The hole, which is written for missing elements of dense arrays.
+  kTheHole = '-',
+};
+
+
+namespace {
+
+enum class ArrayBufferViewTag : uint8_t {
+  kInt8Array = 'b',
+  kUint8Array = 'B',
+  kUint8ClampedArray = 'C',
+  kInt16Array = 'w',
+  kUint16Array = 'W',
+  kInt32Array = 'd',
+  kUint32Array = 'D',
+  kFloat32Array = 'f',
+  kFloat64Array = 'F',
+  kDataView = '?',
+};
+
+}  // namespace
+
+
+ValueSerializer::ValueSerializer(Isolate* isolate)
+    : isolate_(isolate),
+      buffer_(nullptr),
+      buffer_size_(0),
+      buffer_capacity_(0),
+      id_map_(isolate->heap(), &zone_),
+      next_id_(0),
+      array_buffer_transfer_map_(isolate->heap(), &zone_) {}
+
+
+ValueSerializer::~ValueSerializer() { free(buffer_); }
+
+
+void ValueSerializer::WriteHeader() {
+  WriteTag(SerializationTag::kVersion);
+  WriteVarint(kLatestVersion);
+}
+
+
+void ValueSerializer::WriteTag(SerializationTag tag) {
+  uint8_t raw_tag = static_cast<uint8_t>(tag);
+  WriteRawBytes(&raw_tag, sizeof(raw_tag));
+}
+
+
+template <typename T>
+void ValueSerializer::WriteVarint(T value) {
+  // Writes an unsigned integer as a base-128 varint.
+  // The number is written, 7 bits at a time, from the least significant to
+  // the most significant 7 bits. Each byte, except the last, has the MSB set.
+  // See also https://developers.google.com/protocol-buffers/docs/encoding
+  static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value,
+                "Only unsigned integer types can be written as varints.");
+  uint8_t stack_buffer[sizeof(T) * 8 / 7 + 1];
+  uint8_t* next_byte = &stack_buffer[0];
+  do {
+    *next_byte = (value & 0x7f) | 0x80;
+    next_byte++;
+    value >>= 7;
+  } while (value);
+  *(next_byte - 1) &= 0x7f;
+  WriteRawBytes(stack_buffer, next_byte - stack_buffer);
+}
+
+
+template <typename T>
+void ValueSerializer::WriteZigZag(T value) {
+  // Writes a signed integer as a varint using ZigZag encoding (i.e. 0 is
+  // encoded as 0, -1 as 1, 1 as 2, -2 as 3, and so on).
+  // See also https://developers.google.com/protocol-buffers/docs/encoding
+  // Note that this implementation relies on the right shift being arithmetic.
+  static_assert(std::is_integral<T>::value && std::is_signed<T>::value,
+                "Only signed integer types can be written as zigzag.");
+  typedef typename std::make_unsigned<T>::type UnsignedT;
+  WriteVarint((static_cast<UnsignedT>(value) << 1) ^
+              (value >> (8 * sizeof(T) - 1)));
+}
+
+
+void ValueSerializer::WriteDouble(double value) {
+  // Warning: this uses host endianness.
+  WriteRawBytes(&value, sizeof(value));
+}
+
+
+void ValueSerializer::WriteRawBytes(const void* source, size_t length) {
+  if (length == 0) return;
+  memcpy(ReserveRawBytes(length), source, length);
+}
+
+
+uint8_t* ValueSerializer::ReserveRawBytes(size_t bytes) {
+  size_t old_size = buffer_size_;
+  size_t new_size = old_size + bytes;
+  if (new_size > buffer_capacity_) {
+    size_t new_capacity = Max(buffer_capacity_ * 2, new_size + 64);
+    void* new_buffer = realloc(buffer_, new_capacity);
+    if (new_buffer == nullptr) {
+      V8::FatalProcessOutOfMemory("ValueSerializer::ReserveRawBytes");
+    }
+    buffer_ = static_cast<uint8_t*>(new_buffer);
+    buffer_capacity_ = new_capacity;
+  }
+  buffer_size_ = new_size;
+  return buffer_ + old_size;
+}
+
+
+uint8_t* ValueSerializer::ReleaseBuffer(size_t* size) {
+  uint8_t* result = buffer_;
+  *size = buffer_size_;
+  buffer_ = nullptr;
+  buffer_size_ = 0;
+  buffer_capacity_ = 0;
+  return result;
+}
+
+
+void ValueSerializer::TransferArrayBuffer(uint32_t transfer_id,
+                                          Handle<JSArrayBuffer> array_buffer) {
+  DCHECK(!array_buffer_transfer_map_.Find(array_buffer));
+  array_buffer_transfer_map_.Set(array_buffer, transfer_id);
+}
+
+
+Maybe<bool> ValueSerializer::WriteObject(Handle<Object> object) {
+  if (object->IsSmi()) {
+    WriteSmi(Smi::cast(*object));
+    return Just(true);
+  }
+
+  DCHECK(object->IsHeapObject());
+  switch (HeapObject::cast(*object)->map()->instance_type()) {
+    case ODDBALL_TYPE:
+      WriteOddball(Oddball::cast(*object));
+      return Just(true);
+    case HEAP_NUMBER_TYPE:
+    case MUTABLE_HEAP_NUMBER_TYPE:
+      WriteHeapNumber(HeapNumber::cast(*object));
+      return Just(true);
+    case JS_TYPED_ARRAY_TYPE:
+    case JS_DATA_VIEW_TYPE: {
+      // Despite being JSReceivers, these have their wrapped buffer serialized
+      // first, which needs to happen before the view is assigned an ID.
+      Handle<JSArrayBufferView> view = Handle<JSArrayBufferView>::cast(object);
+      if (!id_map_.Find(view)) {
+        Handle<JSArrayBuffer> buffer =
+            view->IsJSTypedArray()
+                ? Handle<JSTypedArray>::cast(view)->GetBuffer()
+                : handle(JSArrayBuffer::cast(view->buffer()), isolate_);
+        if (!WriteJSReceiver(buffer).FromMaybe(false)) return Nothing<bool>();
+      }
+      return WriteJSReceiver(view);
+    }
+    default:
+      if (object->IsString()) {
+        WriteString(Handle<String>::cast(object));
+        return Just(true);
+      } else if (object->IsJSReceiver()) {
+        return WriteJSReceiver(Handle<JSReceiver>::cast(object));
+      } else {
+        ThrowDataCloneError(MessageTemplate::kDataCloneError, object);
+        return Nothing<bool>();
+      }
+  }
+}
+
+
+void ValueSerializer::WriteOddball(Oddball* oddball) {
+  SerializationTag tag = SerializationTag::kUndefined;
+  switch (oddball->kind()) {
+    case Oddball::kUndefined:
+      tag = SerializationTag::kUndefined;
+      break;
+    case Oddball::kFalse:
+      tag = SerializationTag::kFalse;
+      break;
+    case Oddball::kTrue:
+      tag = SerializationTag::kTrue;
+      break;
+    case Oddball::kNull:
+      tag = SerializationTag::kNull;
+      break;
+    default:
+      UNREACHABLE();
+      break;
+  }
+  WriteTag(tag);
+}
+
+
+void ValueSerializer::WriteSmi(Smi* smi) {
+  static_assert(kSmiValueSize <= 32, "Expected SMI <= 32 bits.");
+  WriteTag(SerializationTag::kInt32);
+  WriteZigZag<int32_t>(smi->value());
+}
+
+
+void ValueSerializer::WriteHeapNumber(HeapNumber* number) {
+  WriteTag(SerializationTag::kDouble);
+  WriteDouble(number->value());
+}
+
+
+void ValueSerializer::WriteString(Handle<String> string) {
+  string = String::Flatten(string);
+  DisallowHeapAllocation no_gc;
+  String::FlatContent flat = string->GetFlatContent();
+  DCHECK(flat.IsFlat());
+  if (flat.IsOneByte()) {
+    Vector<const uint8_t> chars = flat.ToOneByteVector();
+    WriteTag(SerializationTag::kOneByteString);
+    WriteVarint<uint32_t>(chars.length());
+    WriteRawBytes(chars.begin(), chars.length() * sizeof(uint8_t));
+  } else {
+    Vector<const uc16> chars = flat.ToUC16Vector();
+    uint32_t byte_length = chars.length() * sizeof(uc16);
+    WriteTag(SerializationTag::kTwoByteString);
+    WriteVarint(byte_length);
+    WriteRawBytes(chars.begin(), byte_length);
+  }
+}
+
+
+Maybe<bool> ValueSerializer::WriteJSReceiver(Handle<JSReceiver> receiver) {
+  // If the object has already been serialized, just write its ID.
+  uint32_t* id_map_entry = id_map_.Get(receiver);
+  if (uint32_t id = *id_map_entry) {
+    WriteTag(SerializationTag::kObjectReference);
+    WriteVarint(id - 1);
+    return Just(true);
+  }
+
+  // Otherwise, allocate an ID for it.
+  uint32_t id = next_id_++;
+  *id_map_entry = id + 1;
+
+  // Callable and exotic objects, and objects carrying embedder state in
+  // internal fields, can't be cloned.
+  StackLimitCheck stack_check(isolate_);
+  if (stack_check.HasOverflowed()) {
+    isolate_->StackOverflow();
+    return Nothing<bool>();
+  }
+  switch (receiver->map()->instance_type()) {
+    case JS_ARRAY_TYPE:
+      return WriteJSArray(Handle<JSArray>::cast(receiver));
+    case JS_OBJECT_TYPE:
+      if (JSObject::cast(*receiver)->GetInternalFieldCount() == 0) {
+        return WriteJSObject(Handle<JSObject>::cast(receiver));
+      }
+      break;
+    case JS_DATE_TYPE:
+      WriteJSDate(JSDate::cast(*receiver));
+      return Just(true);
+    case JS_ARRAY_BUFFER_TYPE:
+      return WriteJSArrayBuffer(Handle<JSArrayBuffer>::cast(receiver));
+    case JS_TYPED_ARRAY_TYPE:
+    case JS_DATA_VIEW_TYPE:
+      return WriteJSArrayBufferView(JSArrayBufferView::cast(*receiver));
+    default:
+      break;
+  }
+  ThrowDataCloneError(MessageTemplate::kDataCloneError, receiver);
+  return Nothing<bool>();
+}
+
+
+Maybe<bool> ValueSerializer::WriteJSObject(Handle<JSObject> object) {
+  Handle<FixedArray> keys;
+  ASSIGN_RETURN_ON_EXCEPTION_VALUE(
+      isolate_, keys, JSReceiver::GetKeys(object, JSReceiver::OWN_ONLY),
+      Nothing<bool>());
+  WriteTag(SerializationTag::kBeginJSObject);
+  Maybe<uint32_t> properties_written =
+      WriteJSObjectProperties(object, keys, false);
+  if (properties_written.IsNothing()) return Nothing<bool>();
+  WriteTag(SerializationTag::kEndJSObject);
+  WriteVarint<uint32_t>(properties_written.FromJust());
+  return Just(true);
+}
+
+
+Maybe<bool> ValueSerializer::WriteJSArray(Handle<JSArray> array) {
+  uint32_t length = 0;
+  CHECK(array->length()->ToArrayLength(&length));
+  Handle<FixedArray> keys;
+  ASSIGN_RETURN_ON_EXCEPTION_VALUE(
+      isolate_, keys, JSReceiver::GetKeys(array, JSReceiver::OWN_ONLY),
+      Nothing<bool>());
+
+  // Arrays with fast elements are written densely, with holes marked as
+  // such. Arrays in dictionary mode may be very sparse, so only the
+  // elements that exist are written, as properties.
+  bool dense = array->HasFastElements();
+  Maybe<uint32_t> properties_written = Nothing<uint32_t>();
+  if (dense) {
+    WriteTag(SerializationTag::kBeginDenseJSArray);
+    WriteVarint<uint32_t>(length);
+    for (uint32_t i = 0; i < length; i++) {
+      // Only own elements are cloned; a getter may also have removed some.
+      Maybe<bool> has_element = JSReceiver::HasOwnElement(array, i);
+      if (has_element.IsNothing()) return Nothing<bool>();
+      if (!has_element.FromJust()) {
+        WriteTag(SerializationTag::kTheHole);
+        continue;
+      }
+      Handle<Object> element;
+      ASSIGN_RETURN_ON_EXCEPTION_VALUE(isolate_, element,
+                                       Object::GetElement(isolate_, array, i),
+                                       Nothing<bool>());
+      if (!WriteObject(element).FromMaybe(false)) return Nothing<bool>();
+    }
+    properties_written = WriteJSObjectProperties(array, keys, true);
+    if (properties_written.IsNothing()) return Nothing<bool>();
+    WriteTag(SerializationTag::kEndDenseJSArray);
+  } else {
+    WriteTag(SerializationTag::kBeginSparseJSArray);
+    WriteVarint<uint32_t>(length);
+    properties_written = WriteJSObjectProperties(array, keys, false);
+    if (properties_written.IsNothing()) return Nothing<bool>();
+    WriteTag(SerializationTag::kEndSparseJSArray);
+  }
+  WriteVarint<uint32_t>(properties_written.FromJust());
+  WriteVarint<uint32_t>(length);
+  return Just(true);
+}
+
+
+void ValueSerializer::WriteJSDate(JSDate* date) {
+  WriteTag(SerializationTag::kDate);
+  WriteDouble(date->value()->Number());
+}
+
+
+Maybe<bool> ValueSerializer::WriteJSArrayBuffer(
+    Handle<JSArrayBuffer> array_buffer) {
+  uint32_t* transfer_entry = array_buffer_transfer_map_.Find(array_buffer);
+  if (transfer_entry) {
+    WriteTag(array_buffer->is_shared()
+                 ? SerializationTag::kSharedArrayBufferTransfer
+                 : SerializationTag::kArrayBufferTransfer);
+    WriteVarint(*transfer_entry);
+    return Just(true);
+  }
+
+  if (array_buffer->is_shared()) {
+    ThrowDataCloneError(
+        MessageTemplate::kDataCloneErrorSharedArrayBufferNotTransferred);
+    return Nothing<bool>();
+  }
+  if (array_buffer->was_neutered()) {
+    ThrowDataCloneError(MessageTemplate::kDataCloneErrorNeuteredArrayBuffer);
+    return Nothing<bool>();
+  }
+  size_t byte_length = NumberToSize(isolate_, array_buffer->byte_length());
+  if (byte_length > std::numeric_limits<uint32_t>::max()) {
+    ThrowDataCloneError(MessageTemplate::kDataCloneError, array_buffer);
+    return Nothing<bool>();
+  }
+  WriteTag(SerializationTag::kArrayBuffer);
+  WriteVarint<uint32_t>(static_cast<uint32_t>(byte_length));
+  WriteRawBytes(array_buffer->backing_store(), byte_length);
+  return Just(true);
+}
+
+
+Maybe<bool> ValueSerializer::WriteJSArrayBufferView(JSArrayBufferView* view) {
+  if (view->WasNeutered()) {
+    ThrowDataCloneError(MessageTemplate::kDataCloneErrorNeuteredArrayBuffer);
+    return Nothing<bool>();
+  }
+  WriteTag(SerializationTag::kArrayBufferView);
+  ArrayBufferViewTag tag = ArrayBufferViewTag::kInt8Array;
+  if (view->IsJSTypedArray()) {
+    switch (JSTypedArray::cast(view)->type()) {
+#define TYPED_ARRAY_CASE(Type, type, TYPE, ctype, size) \
+  case kExternal##Type##Array:                          \
+    tag = ArrayBufferViewTag::k##Type##Array;           \
+    break;
+      TYPED_ARRAYS(TYPED_ARRAY_CASE)
+#undef TYPED_ARRAY_CASE
+    }
+  } else {
+    DCHECK(view->IsJSDataView());
+    tag = ArrayBufferViewTag::kDataView;
+  }
+  WriteVarint(static_cast<uint8_t>(tag));
+  WriteVarint(NumberToUint32(view->byte_offset()));
+  WriteVarint(NumberToUint32(view->byte_length()));
+  return Just(true);
+}
+
+
+Maybe<uint32_t> ValueSerializer::WriteJSObjectProperties(
+    Handle<JSObject> object, Handle<FixedArray> keys, bool skip_elements) {
+  uint32_t properties_written = 0;
+  int length = keys->length();
+  for (int i = 0; i < length; i++) {
+    Handle<Object> key(keys->get(i), isolate_);
+
+    // Element keys are numbers; the elements of dense arrays have already
+    // been written.
+    if (skip_elements && key->IsNumber()) continue;
+
+    bool success;
+    LookupIterator it = LookupIterator::PropertyOrElement(
+        isolate_, object, key, &success, LookupIterator::OWN);
+    DCHECK(success);
+    Handle<Object> value;
+    ASSIGN_RETURN_ON_EXCEPTION_VALUE(isolate_, value, Object::GetProperty(&it),
+                                     Nothing<uint32_t>());
+
+    // If the property is no longer found, do not serialize it.
+    // This could happen if a getter deleted the property.
+    if (!it.IsFound()) continue;
+
+    if (!WriteObject(key).FromMaybe(false) ||
+        !WriteObject(value).FromMaybe(false)) {
+      return Nothing<uint32_t>();
+    }
+
+    properties_written++;
+  }
+  return Just(properties_written);
+}
+
+
+void ValueSerializer::ThrowDataCloneError(
+    MessageTemplate::Template template_index, Handle<Object> arg0) {
+  isolate_->Throw(*isolate_->factory()->NewError(template_index, arg0));
+}
+
+
+ValueDeserializer::ValueDeserializer(Isolate* isolate,
+                                     Vector<const uint8_t> data)
+    : isolate_(isolate),
+      position_(data.start()),
+      end_(data.start() + data.length()),
+      version_(0),
+      next_id_(0),
+      id_map_(Handle<SeededNumberDictionary>::cast(
+          isolate->global_handles()->Create(
+              *SeededNumberDictionary::New(isolate, 0)))),
+      array_buffer_transfer_map_(Handle<SeededNumberDictionary>::cast(
+          isolate->global_handles()->Create(
+              *SeededNumberDictionary::New(isolate, 0)))) {}
+
+
+ValueDeserializer::~ValueDeserializer() {
+  GlobalHandles::Destroy(Handle<Object>::cast(id_map_).location());
+  GlobalHandles::Destroy(
+      Handle<Object>::cast(array_buffer_transfer_map_).location());
+}
+
+
+Maybe<bool> ValueDeserializer::ReadHeader() {
+  if (PeekTag().FromMaybe(SerializationTag::kUndefined) ==
+      SerializationTag::kVersion) {
+    ConsumeTag(SerializationTag::kVersion);
+    Maybe<uint32_t> version = ReadVarint<uint32_t>();
+    if (version.IsJust() && version.FromJust() > 0 &&
+        version.FromJust() <= ValueSerializer::kLatestVersion) {
+      version_ = version.FromJust();
+      return Just(true);
+    }
+  }
+  isolate_->Throw(*isolate_->factory()->NewError(
+      MessageTemplate::kDataCloneDeserializationVersionError));
+  return Nothing<bool>();
+}
+
+
+Maybe<SerializationTag> ValueDeserializer::PeekTag() const {
+  if (position_ >= end_) return Nothing<SerializationTag>();
+  return Just(static_cast<SerializationTag>(*position_));
+}
+
+
+void ValueDeserializer::ConsumeTag(SerializationTag peeked_tag) {
+  DCHECK(position_ < end_);
+  DCHECK_EQ(static_cast<uint8_t>(peeked_tag), *position_);
+  USE(peeked_tag);
+  position_++;
+}
+
+
+Maybe<SerializationTag> ValueDeserializer::ReadTag() {
+  if (position_ >= end_) return Nothing<SerializationTag>();
+  return Just(static_cast<SerializationTag>(*position_++));
+}
+
+
+template <typename T>
+Maybe<T> ValueDeserializer::ReadVarint() {
+  // Reads an unsigned integer as a base-128 varint.
+  // The number is written, 7 bits at a time, from the least significant to
+  // the most significant 7 bits. Each byte, except the last, has the MSB set.
+  // If the varint is larger than T, any more significant bits are discarded.
+  // See also https://developers.google.com/protocol-buffers/docs/encoding
+  static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value,
+                "Only unsigned integer types can be read as varints.");
+  T value = 0;
+  unsigned shift = 0;
+  bool has_another_byte;
+  do {
+    if (position_ >= end_) return Nothing<T>();
+    uint8_t byte = *position_;
+    if (V8_LIKELY(shift < sizeof(T) * 8)) {
+      value |= static_cast<T>(byte & 0x7f) << shift;
+      shift += 7;
+    }
+    has_another_byte = byte & 0x80;
+    position_++;
+  } while (has_another_byte);
+  return Just(value);
+}
+
+
+template <typename T>
+Maybe<T> ValueDeserializer::ReadZigZag() {
+  // Reads a signed integer as a varint using ZigZag encoding (i.e. 0 is
+  // encoded as 0, -1 as 1, 1 as 2, -2 as 3, and so on).
+  // See also https://developers.google.com/protocol-buffers/docs/encoding
+  static_assert(std::is_integral<T>::value && std::is_signed<T>::value,
+                "Only signed integer types can be read as zigzag.");
+  typedef typename std::make_unsigned<T>::type UnsignedT;
+  Maybe<UnsignedT> unsigned_value = ReadVarint<UnsignedT>();
+  if (unsigned_value.IsNothing()) return Nothing<T>();
+  UnsignedT value = unsigned_value.FromJust();
+  return Just(static_cast<T>((value >> 1) ^ -static_cast<T>(value & 1)));
+}
+
+
+Maybe<double> ValueDeserializer::ReadDouble() {
+  // Warning: this uses host endianness.
+  if (sizeof(double) > static_cast<size_t>(end_ - position_)) {
+    return Nothing<double>();
+  }
+  double value;
+  memcpy(&value, position_, sizeof(double));
+  position_ += sizeof(double);
+  if (std::isnan(value)) value = std::numeric_limits<double>::quiet_NaN();
+  return Just(value);
+}
+
+
+Maybe<Vector<const uint8_t>> ValueDeserializer::ReadRawBytes(int size) {
+  if (size < 0 || size > end_ - position_) {
+    return Nothing<Vector<const uint8_t>>();
+  }
+  const uint8_t* start = position_;
+  position_ += size;
+  return Just(Vector<const uint8_t>(start, size));
+}
+
+
+void ValueDeserializer::TransferArrayBuffer(
+    uint32_t transfer_id, Handle<JSArrayBuffer> array_buffer) {
+  DCHECK_EQ(SeededNumberDictionary::kNotFound,
+            array_buffer_transfer_map_->FindEntry(transfer_id));
+  UpdateDictionary(&array_buffer_transfer_map_,
+                   SeededNumberDictionary::AtNumberPut(
+                       array_buffer_transfer_map_, transfer_id, array_buffer,
+                       false));
+}
+
+
+MaybeHandle<Object> ValueDeserializer::ReadObject() {
+  StackLimitCheck stack_check(isolate_);
+  if (stack_check.HasOverflowed()) {
+    isolate_->StackOverflow();
+    return MaybeHandle<Object>();
+  }
+
+  MaybeHandle<Object> result = ReadObjectInternal();
+
+  // ArrayBufferView is special in that it consumes the value before it.
+  Handle<Object> object;
+  if (result.ToHandle(&object) && object->IsJSArrayBuffer() &&
+      PeekTag().FromMaybe(SerializationTag::kVersion) ==
+          SerializationTag::kArrayBufferView) {
+    ConsumeTag(SerializationTag::kArrayBufferView);
+    result = ReadJSArrayBufferView(Handle<JSArrayBuffer>::cast(object));
+  }
+  return result;
+}
+
+
+MaybeHandle<Object> ValueDeserializer::ReadObjectInternal() {
+  Maybe<SerializationTag> maybe_tag = ReadTag();
+  if (maybe_tag.IsNothing()) return MaybeHandle<Object>();
+  switch (maybe_tag.FromJust()) {
+    case SerializationTag::kUndefined:
+      return isolate_->factory()->undefined_value();
+    case SerializationTag::kNull:
+      return isolate_->factory()->null_value();
+    case SerializationTag::kTrue:
+      return isolate_->factory()->true_value();
+    case SerializationTag::kFalse:
+      return isolate_->factory()->false_value();
+    case SerializationTag::kInt32: {
+      Maybe<int32_t> number = ReadZigZag<int32_t>();
+      if (number.IsNothing()) return MaybeHandle<Object>();
+      return isolate_->factory()->NewNumberFromInt(number.FromJust());
+    }
+    case SerializationTag::kDouble: {
+      Maybe<double> number = ReadDouble();
+      if (number.IsNothing()) return MaybeHandle<Object>();
+      return isolate_->factory()->NewNumber(number.FromJust());
+    }
+    case SerializationTag::kOneByteString:
+      return ReadOneByteString();
+    case SerializationTag::kTwoByteString:
+      return ReadTwoByteString();
+    case SerializationTag::kObjectReference: {
+      Maybe<uint32_t> id = ReadVarint<uint32_t>();
+      if (id.IsNothing()) return MaybeHandle<Object>();
+      return GetObjectWithID(id.FromJust());
+    }
+    case SerializationTag::kBeginJSObject:
+      return ReadJSObject();
+    case SerializationTag::kBeginSparseJSArray:
+      return ReadSparseJSArray();
+    case SerializationTag::kBeginDenseJSArray:
+      return ReadDenseJSArray();
+    case SerializationTag::kDate:
+      return ReadJSDate();
+    case SerializationTag::kArrayBuffer:
+      return ReadJSArrayBuffer();
+    case SerializationTag::kArrayBufferTransfer:
+      return ReadTransferredJSArrayBuffer(false);
+    case SerializationTag::kSharedArrayBufferTransfer:
+      return ReadTransferredJSArrayBuffer(true);
+    default:
+      return MaybeHandle<Object>();
+  }
+}
+
+
+MaybeHandle<String> ValueDeserializer::ReadOneByteString() {
+  Maybe<uint32_t> byte_length = ReadVarint<uint32_t>();
+  if (byte_length.IsNothing() || byte_length.FromJust() > kMaxInt) {
+    return MaybeHandle<String>();
+  }
+  Maybe<Vector<const uint8_t>> bytes =
+      ReadRawBytes(static_cast<int>(byte_length.FromJust()));
+  if (bytes.IsNothing()) return MaybeHandle<String>();
+  return isolate_->factory()->NewStringFromOneByte(bytes.FromJust());
+}
+
+
+MaybeHandle<String> ValueDeserializer::ReadTwoByteString() {
+  Maybe<uint32_t> byte_length = ReadVarint<uint32_t>();
+  if (byte_length.IsNothing() || byte_length.FromJust() > kMaxInt ||
+      byte_length.FromJust() % sizeof(uc16) != 0) {
+    return MaybeHandle<String>();
+  }
+  Maybe<Vector<const uint8_t>> bytes =
+      ReadRawBytes(static_cast<int>(byte_length.FromJust()));
+  if (bytes.IsNothing()) return MaybeHandle<String>();
+
+  // Allocate an uninitialized string so that we can do a raw memcpy into the
+  // string on the heap (regardless of alignment).
+  Handle<SeqTwoByteString> string;
+  if (!isolate_->factory()
+           ->NewRawTwoByteString(bytes.FromJust().length() / sizeof(uc16))
+           .ToHandle(&string)) {
+    return MaybeHandle<String>();
+  }
+
+  // Copy the bytes directly into the new string.
+  // Warning: this uses host endianness.
+  memcpy(string->GetChars(), bytes.FromJust().begin(),
+         bytes.FromJust().length());
+  return string;
+}
+
+
+MaybeHandle<JSObject> ValueDeserializer::ReadJSObject() {
+  // If we are at the end of the stack, abort. This function may recurse.
+  StackLimitCheck stack_check(isolate_);
+  if (stack_check.HasOverflowed()) {
+    isolate_->StackOverflow();
+    return MaybeHandle<JSObject>();
+  }
+
+  uint32_t id = next_id_++;
+  HandleScope scope(isolate_);
+  Handle<JSObject> object =
+      isolate_->factory()->NewJSObject(isolate_->object_function());
+  AddObjectWithID(id, object);
+
+  Maybe<uint32_t> num_properties =
+      ReadJSObjectProperties(object, SerializationTag::kEndJSObject);
+  if (num_properties.IsNothing()) return MaybeHandle<JSObject>();
+  Maybe<uint32_t> expected_num_properties = ReadVarint<uint32_t>();
+  if (expected_num_properties.IsNothing() ||
+      num_properties.FromJust() != expected_num_properties.FromJust()) {
+    return MaybeHandle<JSObject>();
+  }
+
+  DCHECK(HasObjectWithID(id));
+  return scope.CloseAndEscape(object);
+}
+
+
+MaybeHandle<JSArray> ValueDeserializer::ReadSparseJSArray() {
+  // If we are at the end of the stack, abort. This function may recurse.
+  StackLimitCheck stack_check(isolate_);
+  if (stack_check.HasOverflowed()) {
+    isolate_->StackOverflow();
+    return MaybeHandle<JSArray>();
+  }
+
+  Maybe<uint32_t> length = ReadVarint<uint32_t>();
+  if (length.IsNothing()) return MaybeHandle<JSArray>();
+
+  uint32_t id = next_id_++;
+  HandleScope scope(isolate_);
+  Handle<JSArray> array = isolate_->factory()->NewJSArray(FAST_HOLEY_ELEMENTS);
+  JSArray::SetLength(array, length.FromJust());
+  AddObjectWithID(id, array);
+
+  Maybe<uint32_t> num_properties =
+      ReadJSObjectProperties(array, SerializationTag::kEndSparseJSArray);
+  if (num_properties.IsNothing()) return MaybeHandle<JSArray>();
+  Maybe<uint32_t> expected_num_properties = ReadVarint<uint32_t>();
+  Maybe<uint32_t> expected_length = ReadVarint<uint32_t>();
+  if (expected_num_properties.IsNothing() || expected_length.IsNothing() ||
+      num_properties.FromJust() != expected_num_properties.FromJust() ||
+      length.FromJust() != expected_length.FromJust()) {
+    return MaybeHandle<JSArray>();
+  }
+
+  DCHECK(HasObjectWithID(id));
+  return scope.CloseAndEscape(array);
+}
+
+
+MaybeHandle<JSArray> ValueDeserializer::ReadDenseJSArray() {
+  // If we are at the end of the stack, abort. This function may recurse.
+  StackLimitCheck stack_check(isolate_);
+  if (stack_check.HasOverflowed()) {
+    isolate_->StackOverflow();
+    return MaybeHandle<JSArray>();
+  }
+
+  // We shouldn't permit an array larger than the biggest we can request from
+  // V8. As an additional sanity check, since each entry will take at least
+  // one byte to encode, if there are fewer bytes than that we can also fail
+  // fast.
+  Maybe<uint32_t> length = ReadVarint<uint32_t>();
+  if (length.IsNothing() ||
+      length.FromJust() > static_cast<uint32_t>(FixedArray::kMaxLength) ||
+      length.FromJust() > static_cast<size_t>(end_ - position_)) {
+    return MaybeHandle<JSArray>();
+  }
+
+  uint32_t id = next_id_++;
+  HandleScope scope(isolate_);
+  int array_length = static_cast<int>(length.FromJust());
+  Handle<JSArray> array = isolate_->factory()->NewJSArray(
+      FAST_HOLEY_ELEMENTS, array_length, array_length, Strength::WEAK,
+      INITIALIZE_ARRAY_ELEMENTS_WITH_HOLE);
+  AddObjectWithID(id, array);
+
+  // No JavaScript that could touch the array runs while it is being read, so
+  // its backing store stays in place.
+  Handle<FixedArray> elements(FixedArray::cast(array->elements()), isolate_);
+  for (int i = 0; i < array_length; i++) {
+    if (PeekTag().FromMaybe(SerializationTag::kVersion) ==
+        SerializationTag::kTheHole) {
+      ConsumeTag(SerializationTag::kTheHole);
+      continue;
+    }
+    Handle<Object> element;
+    if (!ReadObject().ToHandle(&element)) return MaybeHandle<JSArray>();
+    DCHECK(*elements == array->elements());
+    elements->set(i, *element);
+  }
+
+  Maybe<uint32_t> num_properties =
+      ReadJSObjectProperties(array, SerializationTag::kEndDenseJSArray);
+  if (num_properties.IsNothing()) return MaybeHandle<JSArray>();
+  Maybe<uint32_t> expected_num_properties = ReadVarint<uint32_t>();
+  Maybe<uint32_t> expected_length = ReadVarint<uint32_t>();
+  if (expected_num_properties.IsNothing() || expected_length.IsNothing() ||
+      num_properties.FromJust() != expected_num_properties.FromJust() ||
+      length.FromJust() != expected_length.FromJust()) {
+    return MaybeHandle<JSArray>();
+  }
+
+  DCHECK(HasObjectWithID(id));
+  return scope.CloseAndEscape(array);
+}
+
+
+MaybeHandle<JSObject> ValueDeserializer::ReadJSDate() {
+  Maybe<double> value = ReadDouble();
+  if (value.IsNothing()) return MaybeHandle<JSObject>();
+  uint32_t id = next_id_++;
+  Handle<Object> date;
+  if (!Execution::NewDate(isolate_, value.FromJust()).ToHandle(&date)) {
+    return MaybeHandle<JSObject>();
+  }
+  DCHECK(date->IsJSDate());
+  AddObjectWithID(id, Handle<JSDate>::cast(date));
+  return Handle<JSDate>::cast(date);
+}
+
+
+MaybeHandle<JSArrayBuffer> ValueDeserializer::ReadJSArrayBuffer() {
+  Maybe<uint32_t> byte_length = ReadVarint<uint32_t>();
+  if (byte_length.IsNothing() ||
+      byte_length.FromJust() > static_cast<size_t>(end_ - position_)) {
+    return MaybeHandle<JSArrayBuffer>();
+  }
+  uint32_t id = next_id_++;
+  Handle<JSArrayBuffer> array_buffer =
+      isolate_->factory()->NewJSArrayBuffer();
+  const bool should_initialize = false;
+  if (!JSArrayBuffer::SetupAllocatingData(array_buffer, isolate_,
+                                          byte_length.FromJust(),
+                                          should_initialize)) {
+    return MaybeHandle<JSArrayBuffer>();
+  }
+  if (byte_length.FromJust() > 0) {
+    memcpy(array_buffer->backing_store(), position_, byte_length.FromJust());
+  }
+  position_ += byte_length.FromJust();
+  AddObjectWithID(id, array_buffer);
+  return array_buffer;
+}
+
+
+MaybeHandle<JSArrayBuffer> ValueDeserializer::ReadTransferredJSArrayBuffer(
+    bool is_shared) {
+  uint32_t id = next_id_++;
+  Maybe<uint32_t> transfer_id = ReadVarint<uint32_t>();
+  if (transfer_id.IsNothing()) return MaybeHandle<JSArrayBuffer>();
+  int index = array_buffer_transfer_map_->FindEntry(transfer_id.FromJust());
+  if (index == SeededNumberDictionary::kNotFound) {
+    return MaybeHandle<JSArrayBuffer>();
+  }
+  Handle<JSArrayBuffer> array_buffer(
+      JSArrayBuffer::cast(array_buffer_transfer_map_->ValueAt(index)),
+      isolate_);
+  if (array_buffer->is_shared() != is_shared) {
+    return MaybeHandle<JSArrayBuffer>();
+  }
+  AddObjectWithID(id, array_buffer);
+  return array_buffer;
+}
+
+
+MaybeHandle<JSArrayBufferView> ValueDeserializer::ReadJSArrayBufferView(
+    Handle<JSArrayBuffer> buffer) {
+  uint32_t buffer_byte_length = NumberToUint32(buffer->byte_length());
+  Maybe<uint8_t> tag = ReadVarint<uint8_t>();
+  Maybe<uint32_t> byte_offset = ReadVarint<uint32_t>();
+  Maybe<uint32_t> byte_length = ReadVarint<uint32_t>();
+  if (tag.IsNothing() || byte_offset.IsNothing() || byte_length.IsNothing() ||
+      byte_offset.FromJust() > buffer_byte_length ||
+      byte_length.FromJust() > buffer_byte_length - byte_offset.FromJust()) {
+    return MaybeHandle<JSArrayBufferView>();
+  }
+  uint32_t offset = byte_offset.FromJust();
+  uint32_t length = byte_length.FromJust();
+  uint32_t id = next_id_++;
+  Handle<JSArrayBufferView> view;
+  switch (static_cast<ArrayBufferViewTag>(tag.FromJust())) {
+    case ArrayBufferViewTag::kDataView:
+      view = isolate_->factory()->NewJSDataView(buffer, offset, length);
+      break;
+#define TYPED_ARRAY_CASE(Type, type, TYPE, ctype, size)                 \
+  case ArrayBufferViewTag::k##Type##Array:                              \
+    if (offset % size != 0 || length % size != 0) {                     \
+      return MaybeHandle<JSArrayBufferView>();                          \
+    }                                                                   \
+    view = isolate_->factory()->NewJSTypedArray(kExternal##Type##Array, \
+                                                buffer, offset,         \
+                                                length / size);         \
+    break;
+      TYPED_ARRAYS(TYPED_ARRAY_CASE)
+#undef TYPED_ARRAY_CASE
+    default:
+      return MaybeHandle<JSArrayBufferView>();
+  }
+  AddObjectWithID(id, view);
+  return view;
+}
+
+
+Maybe<uint32_t> ValueDeserializer::ReadJSObjectProperties(
+    Handle<JSObject> object, SerializationTag end_tag) {
+  for (uint32_t num_properties = 0;; num_properties++) {
+    Maybe<SerializationTag> tag = PeekTag();
+    if (tag.IsNothing()) return Nothing<uint32_t>();
+    if (tag.FromJust() == end_tag) {
+      ConsumeTag(end_tag);
+      return Just(num_properties);
+    }
+
+    HandleScope scope(isolate_);
+    Handle<Object> key;
+    if (!ReadObject().ToHandle(&key)) return Nothing<uint32_t>();
+    // Keys are strings or, for elements, numbers.
+    if (!key->IsString() && !key->IsNumber()) return Nothing<uint32_t>();
+    Handle<Object> value;
+    if (!ReadObject().ToHandle(&value)) return Nothing<uint32_t>();
+
+    bool success;
+    LookupIterator it = LookupIterator::PropertyOrElement(
+        isolate_, object, key, &success, LookupIterator::OWN);
+    if (!success ||
+        JSObject::DefineOwnPropertyIgnoreAttributes(&it, value, NONE)
+            .is_null()) {
+      return Nothing<uint32_t>();
+    }
+  }
+}
+
+
+bool ValueDeserializer::HasObjectWithID(uint32_t id) {
+  return id_map_->FindEntry(id) != SeededNumberDictionary::kNotFound;
+}
+
+
+MaybeHandle<JSReceiver> ValueDeserializer::GetObjectWithID(uint32_t id) {
+  int index = id_map_->FindEntry(id);
+  if (index == SeededNumberDictionary::kNotFound) {
+    return MaybeHandle<JSReceiver>();
+  }
+  Object* value = id_map_->ValueAt(index);
+  DCHECK(value->IsJSReceiver());
+  return Handle<JSReceiver>(JSReceiver::cast(value), isolate_);
+}
+
+
+void ValueDeserializer::AddObjectWithID(uint32_t id,
+                                        Handle<JSReceiver> object) {
+  DCHECK(!HasObjectWithID(id));
+  UpdateDictionary(&id_map_, SeededNumberDictionary::AtNumberPut(
+                                 id_map_, id, object, false));
+}
+
+
+void ValueDeserializer::UpdateDictionary(
+    Handle<SeededNumberDictionary>* slot,
+    Handle<SeededNumberDictionary> dictionary) {
+  // If the dictionary was reallocated, update the global handle.
+  if (dictionary.is_identical_to(*slot)) return;
+  GlobalHandles::Destroy(Handle<Object>::cast(*slot).location());
+  *slot = Handle<SeededNumberDictionary>::cast(
+      isolate_->global_handles()->Create(*dictionary));
+}
+
+}  // namespace internal
+}  // namespace v8
@@ -0,0 +1,196 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef V8_VALUE_SERIALIZER_H_
+#define V8_VALUE_SERIALIZER_H_
+
+#include "include/v8.h"
+#include "src/base/macros.h"
+#include "src/handles.h"
+#include "src/identity-map.h"
+#include "src/messages.h"
+#include "src/vector.h"
+#include "src/zone.h"
+
+namespace v8 {
+namespace internal {
+
+class HeapNumber;
+class Isolate;
+class JSArrayBuffer;
+class JSArrayBufferView;
+class JSDate;
+class Object;
+class Oddball;
+class SeededNumberDictionary;
+class Smi;
+
+enum class SerializationTag : uint8_t;
+
+// Writes V8 objects in a binary format that allows the objects to be cloned
+// according to the HTML structured clone algorithm.
+//
+// Objects that are reachable more than once, including through cycles, are
+// written once and referred to by id afterwards. Array buffer contents can be
+// passed out of band instead of being copied into the buffer.
+class ValueSerializer {
+ public:
+  static const uint32_t kLatestVersion;
+
+  explicit ValueSerializer(Isolate* isolate);
+  ~ValueSerializer();
+
+  // Writes out a header, which includes the format version.
+  void WriteHeader();
+
+  // Serializes a V8 object into the buffer. Returns Nothing if an exception
+  // has been thrown.
+  MUST_USE_RESULT Maybe<bool> WriteObject(Handle<Object> object);
+
+  // Returns the stored data and its size. The caller takes ownership of the
+  // buffer, which must be released with free(). The serializer is left
+  // empty.
+  uint8_t* ReleaseBuffer(size_t* size);
+
+  // Marks an ArrayBuffer or SharedArrayBuffer as having its contents passed
+  // out of band. Only the transfer id is written for it.
+  void TransferArrayBuffer(uint32_t transfer_id,
+                           Handle<JSArrayBuffer> array_buffer);
+
+ private:
+  // Writing the wire format.
+  void WriteTag(SerializationTag tag);
+  template <typename T>
+  void WriteVarint(T value);
+  template <typename T>
+  void WriteZigZag(T value);
+  void WriteDouble(double value);
+  void WriteRawBytes(const void* source, size_t length);
+  uint8_t* ReserveRawBytes(size_t bytes);
+
+  // Writing V8 objects of various kinds.
+  void WriteOddball(Oddball* oddball);
+  void WriteSmi(Smi* smi);
+  void WriteHeapNumber(HeapNumber* number);
+  void WriteString(Handle<String> string);
+  Maybe<bool> WriteJSReceiver(Handle<JSReceiver> receiver);
+  Maybe<bool> WriteJSObject(Handle<JSObject> object);
+  Maybe<bool> WriteJSArray(Handle<JSArray> array);
+  void WriteJSDate(JSDate* date);
+  Maybe<bool> WriteJSArrayBuffer(Handle<JSArrayBuffer> array_buffer);
+  Maybe<bool> WriteJSArrayBufferView(JSArrayBufferView* array_buffer_view);
+
+  // Writes the own enumerable properties of |object| named by |keys|,
+  // leaving out elements if |skip_elements| is set. Returns the number of
+  // properties written.
+  Maybe<uint32_t> WriteJSObjectProperties(Handle<JSObject> object,
+                                          Handle<FixedArray> keys,
+                                          bool skip_elements);
+
+  void ThrowDataCloneError(MessageTemplate::Template template_index,
+                           Handle<Object> arg0 = Handle<Object>());
+
+  Isolate* const isolate_;
+  uint8_t* buffer_;
+  size_t buffer_size_;
+  size_t buffer_capacity_;
+  Zone zone_;
+
+  // To avoid extra lookups in the identity map, ID+1 is actually stored in
+  // the map (checking if the used identity is zero is the fast way of
+  // checking if the entry is new).
+  IdentityMap<uint32_t> id_map_;
+  uint32_t next_id_;
+
+  // A similar map, for transferred array buffers.
+  IdentityMap<uint32_t> array_buffer_transfer_map_;
+
+  DISALLOW_COPY_AND_ASSIGN(ValueSerializer);
+};
+
+
+// Deserializes values from data written with ValueSerializer, or a
+// compatible implementation.
+class ValueDeserializer {
+ public:
+  ValueDeserializer(Isolate* isolate, Vector<const uint8_t> data);
+  ~ValueDeserializer();
+
+  // Runs version detection logic, which may fail if the format is invalid.
+  MUST_USE_RESULT Maybe<bool> ReadHeader();
+
+  // Reads the underlying wire format version. Likely mostly to be useful to
+  // legacy code reading old wire format versions. Must be called after
+  // ReadHeader.
+  uint32_t GetWireFormatVersion() const { return version_; }
+
+  // Deserializes a V8 object from the buffer.
+  MUST_USE_RESULT MaybeHandle<Object> ReadObject();
+
+  // Accepts the array buffer corresponding to the one passed out of band to
+  // ValueSerializer::TransferArrayBuffer with the same id.
+  void TransferArrayBuffer(uint32_t transfer_id,
+                           Handle<JSArrayBuffer> array_buffer);
+
+ private:
+  // Reading the wire format.
+  Maybe<SerializationTag> PeekTag() const;
+  void ConsumeTag(SerializationTag peeked_tag);
+  Maybe<SerializationTag> ReadTag();
+  template <typename T>
+  Maybe<T> ReadVarint();
+  template <typename T>
+  Maybe<T> ReadZigZag();
+  Maybe<double> ReadDouble();
+  Maybe<Vector<const uint8_t>> ReadRawBytes(int size);
+
+  // Like ReadObject, but doesn't handle array buffer views that follow
+  // their array buffer.
+  MaybeHandle<Object> ReadObjectInternal();
+
+  // Reading V8 objects of specific kinds. The tag is assumed to have already
+  // been read.
+  MaybeHandle<String> ReadOneByteString();
+  MaybeHandle<String> ReadTwoByteString();
+  MaybeHandle<JSObject> ReadJSObject();
+  MaybeHandle<JSArray> ReadDenseJSArray();
+  MaybeHandle<JSArray> ReadSparseJSArray();
+  MaybeHandle<JSObject> ReadJSDate();
+  MaybeHandle<JSArrayBuffer> ReadJSArrayBuffer();
+  MaybeHandle<JSArrayBuffer> ReadTransferredJSArrayBuffer(bool is_shared);
+  MaybeHandle<JSArrayBufferView> ReadJSArrayBufferView(
+      Handle<JSArrayBuffer> buffer);
+
+  // Reads key-value pairs into the object until the end tag is encountered.
+  // Returns the number of properties read.
+  Maybe<uint32_t> ReadJSObjectProperties(Handle<JSObject> object,
+                                         SerializationTag end_tag);
+
+  // Manipulating the map from IDs to reified objects.
+  bool HasObjectWithID(uint32_t id);
+  MaybeHandle<JSReceiver> GetObjectWithID(uint32_t id);
+  void AddObjectWithID(uint32_t id, Handle<JSReceiver> object);
+
+  // Replaces the global handle in |*slot| by one to |dictionary|.
+  void UpdateDictionary(Handle<SeededNumberDictionary>* slot,
+                        Handle<SeededNumberDictionary> dictionary);
+
+  Isolate* const isolate_;
+  const uint8_t* position_;
+  const uint8_t* const end_;
+  uint32_t version_;
+  uint32_t next_id_;
+
+  // Both are global handles, as the deserializer may outlive the handle
+  // scope it was created in.
+  Handle<SeededNumberDictionary> id_map_;
+  Handle<SeededNumberDictionary> array_buffer_transfer_map_;
+
+  DISALLOW_COPY_AND_ASSIGN(ValueDeserializer);
+};
+
+}  // namespace internal
+}  // namespace v8
+
+#endif  // V8_VALUE_SERIALIZER_H_
@@ -100,8 +100,10 @@ class Variable: public ZoneObject {
   }
 
   // True if the variable is named eval and not known to be shadowed.
-  bool is_possibly_eval(Isolate* isolate) const {
-    return IsVariable(isolate->factory()->eval_string());
+  // Does not access the heap, so that it can be used before the AST is
+  // internalized.
+  bool is_possibly_eval() const {
+    return !is_this() && raw_name()->IsOneByteEqualTo("eval");
   }
 
   Variable* local_if_not_shadowed() const {
@@ -1164,6 +1164,19 @@ void RegExpExecStub::Generate(MacroAssembler* masm) {
   // smi (code flushing support)
   __ JumpIfSmi(r11, &runtime);
 
+  // rax: RegExp data (FixedArray)
+  // r15: original subject string
+  // Leave long subjects to the runtime if the regexp has a required literal,
+  // so that the subject is searched for the literal first.
+  Label no_required_literal;
+  __ CompareRoot(FieldOperand(rax, JSRegExp::kIrregexpRequiredLiteralOffset),
+                 Heap::kUndefinedValueRootIndex);
+  __ j(equal, &no_required_literal, Label::kNear);
+  __ SmiCompare(FieldOperand(r15, String::kLengthOffset),
+                Smi::FromInt(RegExpImpl::kRequiredLiteralMinSubjectLength));
+  __ j(greater_equal, &runtime);
+  __ bind(&no_required_literal);
+
   // rdi: sequential subject string (or look-alike, external string)
   // r15: original subject string
   // rcx: encoding of subject string (1 if one_byte, 0 if two_byte);
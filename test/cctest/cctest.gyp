@@ -128,6 +128,7 @@
         'test-fixed-dtoa.cc',
         'test-flags.cc',
         'test-func-name-inference.cc',
+        'test-futex-emulation.cc',
         'test-gc-tracer.cc',
         'test-global-handles.cc',
         'test-global-object.cc',
@@ -173,6 +174,7 @@
         'test-unique.cc',
         'test-unscopables-hidden-prototype.cc',
         'test-utils.cc',
+        'test-value-serializer.cc',
         'test-version.cc',
         'test-weakmaps.cc',
         'test-weaksets.cc',
@@ -586,66 +586,66 @@ TEST(PropertyCall) {
   InitializedHandleScope handle_scope;
   BytecodeGeneratorHelper helper;  //
 
-  FeedbackVectorSlotKind ic_kinds[] = {i::FeedbackVectorSlotKind::LOAD_IC,
+  FeedbackVectorSlotKind ic_kinds[] = {i::FeedbackVectorSlotKind::CALL_IC,
                                        i::FeedbackVectorSlotKind::LOAD_IC};
   StaticFeedbackVectorSpec feedback_spec(0, 2, ic_kinds);
   Handle<i::TypeFeedbackVector> vector =
       helper.factory()->NewTypeFeedbackVector(&feedback_spec);
+  int call_slot = vector->first_ic_slot_index();
+  int load_slot = vector->first_ic_slot_index() + 2;
 
   ExpectedSnippet<const char*> snippets[] = {
       {"function f(a) { return a.func(); }\nf(" FUNC_ARG ")",
        2 * kPointerSize,
        2,
-       16,
+       17,
        {
-           B(Ldar), R(helper.kLastParamIndex),                      //
-           B(Star), R(1),                                           //
-           B(LdaConstant), U8(0),                                   //
-           B(LoadIC), R(1), U8(vector->first_ic_slot_index() + 2),  //
-           B(Star), R(0),                                           //
-           B(Call), R(0), R(1), U8(0),                              //
-           B(Return)                                                //
+           B(Ldar), R(helper.kLastParamIndex),                     //
+           B(Star), R(1),                                          //
+           B(LdaConstant), U8(0),                                  //
+           B(LoadIC), R(1), U8(load_slot),                         //
+           B(Star), R(0),                                          //
+           B(Call), R(0), R(1), U8(0), U8(call_slot),              //
+           B(Return)                                               //
        },
        1,
        {"func"}},
       {"function f(a, b, c) { return a.func(b, c); }\nf(" FUNC_ARG ", 1, 2)",
        4 * kPointerSize,
        4,
-       24,
+       25,
        {
-           B(Ldar), R(helper.kLastParamIndex - 2),                  //
-           B(Star), R(1),                                           //
-           B(LdaConstant), U8(0),                                   //
-           B(LoadIC), R(1), U8(vector->first_ic_slot_index() + 2),  //
-           B(Star), R(0),                                           //
-           B(Ldar), R(helper.kLastParamIndex - 1),                  //
-           B(Star), R(2),                                           //
-           B(Ldar), R(helper.kLastParamIndex),                      //
-           B(Star), R(3),                                           //
-           B(Call), R(0), R(1), U8(2),                              //
-           B(Return)                                                //
+           B(Ldar), R(helper.kLastParamIndex - 2),                 //
+           B(Star), R(1),                                          //
+           B(LdaConstant), U8(0),                                  //
+           B(LoadIC), R(1), U8(load_slot),                         //
+           B(Star), R(0),                                          //
+           B(Ldar), R(helper.kLastParamIndex - 1),                 //
+           B(Star), R(2),                                          //
+           B(Ldar), R(helper.kLastParamIndex),                     //
+           B(Star), R(3),                                          //
+           B(Call), R(0), R(1), U8(2), U8(call_slot),              //
+           B(Return)                                               //
        },
        1,
        {"func"}},
       {"function f(a, b) { return a.func(b + b, b); }\nf(" FUNC_ARG ", 1)",
        4 * kPointerSize,
        3,
-       30,
+       29,
        {
-           B(Ldar), R(helper.kLastParamIndex - 1),                  //
-           B(Star), R(1),                                           //
-           B(LdaConstant), U8(0),                                   //
-           B(LoadIC), R(1), U8(vector->first_ic_slot_index() + 2),  //
-           B(Star), R(0),                                           //
-           B(Ldar), R(helper.kLastParamIndex),                      //
-           B(Star), R(2),                                           //
-           B(Ldar), R(helper.kLastParamIndex),                      //
-           B(Add), R(2),                                            //
-           B(Star), R(2),                                           //
-           B(Ldar), R(helper.kLastParamIndex),                      //
-           B(Star), R(3),                                           //
-           B(Call), R(0), R(1), U8(2),                              //
-           B(Return)                                                //
+           B(Ldar), R(helper.kLastParamIndex - 1),                 //
+           B(Star), R(1),                                          //
+           B(LdaConstant), U8(0),                                  //
+           B(LoadIC), R(1), U8(load_slot),                         //
+           B(Star), R(0),                                          //
+           B(Ldar), R(helper.kLastParamIndex),                     //
+           B(Star), R(2),                                          //
+           B(LdarAddStar), R(helper.kLastParamIndex), R(2), R(2),  //
+           B(Ldar), R(helper.kLastParamIndex),                     //
+           B(Star), R(3),                                          //
+           B(Call), R(0), R(1), U8(2), U8(call_slot),              //
+           B(Return)                                               //
        },
        1,
        {"func"}}};
@@ -690,20 +690,27 @@ TEST(CallGlobal) {
   InitializedHandleScope handle_scope;
   BytecodeGeneratorHelper helper;
 
+  FeedbackVectorSlotKind ic_kinds[] = {i::FeedbackVectorSlotKind::CALL_IC,
+                                       i::FeedbackVectorSlotKind::LOAD_IC};
+  StaticFeedbackVectorSpec feedback_spec(0, 2, ic_kinds);
+  Handle<i::TypeFeedbackVector> vector =
+      helper.factory()->NewTypeFeedbackVector(&feedback_spec);
+  int call_slot = vector->first_ic_slot_index();
+
   ExpectedSnippet<const char*> snippets[] = {
       {"function t() { }\nfunction f() { return t(); }\nf()",
-       2 * kPointerSize, 1, 12,
+       2 * kPointerSize, 1, 13,
        {
           B(LdaUndefined),
           B(Star), R(1),
           B(LdaGlobal), _,
           B(Star), R(0),
-          B(Call), R(0), R(1), U8(0),
+          B(Call), R(0), R(1), U8(0), U8(call_slot),
           B(Return)
        },
       },
       {"function t(a, b, c) { }\nfunction f() { return t(1, 2, 3); }\nf()",
-       5 * kPointerSize, 1, 24,
+       5 * kPointerSize, 1, 25,
        {
           B(LdaUndefined),
           B(Star), R(1),
@@ -715,7 +722,7 @@ TEST(CallGlobal) {
           B(Star), R(3),
           B(LdaSmi8), U8(3),
           B(Star), R(4),
-          B(Call), R(0), R(1), U8(3),
+          B(Call), R(0), R(1), U8(3), U8(call_slot),
           B(Return)
        },
       },
@@ -869,7 +876,7 @@ TEST(IfConditions) {
        "} f(1, 1);",
        kPointerSize,
        3,
-       122,
+       121,
        {
 #define IF_CONDITION_RETURN(condition) \
   B(Ldar), R(-6),                      \
@@ -882,7 +889,13 @@ TEST(IfConditions) {
   B(Jump), U8(2),
            IF_CONDITION_RETURN(TestEqual)               //
            IF_CONDITION_RETURN(TestEqualStrict)         //
-           IF_CONDITION_RETURN(TestLessThan)            //
+           B(Ldar), R(-6),                              //
+           B(Star), R(0),                               //
+           B(Ldar), R(-5),                              //
+           B(TestLessThanJumpIfFalse), R(0), U8(8),     //
+           B(LdaSmi8), U8(1),                           //
+           B(Return),                                   //
+           B(Jump), U8(2),                              //
            IF_CONDITION_RETURN(TestGreaterThan)         //
            IF_CONDITION_RETURN(TestLessThanOrEqual)     //
            IF_CONDITION_RETURN(TestGreaterThanOrEqual)  //
@@ -349,6 +349,84 @@ TEST(InterpreterLoadStoreRegisters) {
 }
 
 
+TEST(InterpreterLoadStoreWideRegisters) {
+  HandleAndZoneScope handles;
+  Handle<Object> true_value = handles.main_isolate()->factory()->true_value();
+  int indices[] = {Register::kMaxRegisterIndex + 1, 255, 256, 1000, 4000};
+  for (size_t i = 0; i < arraysize(indices); i++) {
+    BytecodeArrayBuilder builder(handles.main_isolate(), handles.main_zone());
+    builder.set_locals_count(indices[i] + 1);
+    builder.set_parameter_count(1);
+    Register reg(indices[i]);
+    builder.LoadTrue()
+        .StoreAccumulatorInRegister(reg)
+        .LoadFalse()
+        .LoadAccumulatorWithRegister(reg)
+        .Return();
+    Handle<BytecodeArray> bytecode_array = builder.ToBytecodeArray();
+
+    InterpreterTester tester(handles.main_isolate(), bytecode_array);
+    auto callable = tester.GetCallable<>();
+    Handle<Object> return_val = callable().ToHandleChecked();
+    CHECK(return_val.is_identical_to(true_value));
+  }
+}
+
+
+TEST(InterpreterWideConstantPoolIndex) {
+  HandleAndZoneScope handles;
+  i::Factory* factory = handles.main_isolate()->factory();
+  BytecodeArrayBuilder builder(handles.main_isolate(), handles.main_zone());
+  builder.set_locals_count(0);
+  builder.set_parameter_count(1);
+  for (int i = 0; i < 300; i++) {
+    builder.LoadLiteral(factory->NewHeapNumber(i + 0.5));
+  }
+  builder.Return();
+  Handle<BytecodeArray> bytecode_array = builder.ToBytecodeArray();
+  CHECK_EQ(bytecode_array->constant_pool()->length(), 300);
+
+  InterpreterTester tester(handles.main_isolate(), bytecode_array);
+  auto callable = tester.GetCallable<>();
+  Handle<Object> return_val = callable().ToHandleChecked();
+  CHECK_EQ(i::HeapNumber::cast(*return_val)->value(), 299.5);
+}
+
+
+TEST(InterpreterFusedBytecodes) {
+  HandleAndZoneScope handles;
+  for (int lhs = -1; lhs <= 3; lhs++) {
+    BytecodeArrayBuilder builder(handles.main_isolate(), handles.main_zone());
+    builder.set_locals_count(3);
+    builder.set_parameter_count(1);
+    Register reg0(0), reg1(1), reg2(2);
+    BytecodeLabel not_less_than;
+    // r2 = r0 + r1, then return r2 if r1 < r2 or -1 otherwise.
+    builder.LoadLiteral(Smi::FromInt(lhs))
+        .StoreAccumulatorInRegister(reg0)
+        .LoadLiteral(Smi::FromInt(2 - lhs))
+        .StoreAccumulatorInRegister(reg1)
+        .LoadAccumulatorWithRegister(reg0)
+        .BinaryOperation(Token::Value::ADD, reg1)
+        .StoreAccumulatorInRegister(reg2)
+        .CompareOperation(Token::Value::LT, reg1, LanguageMode::SLOPPY)
+        .JumpIfFalse(&not_less_than)
+        .LoadAccumulatorWithRegister(reg2)
+        .Return()
+        .Bind(&not_less_than)
+        .LoadLiteral(Smi::FromInt(-1))
+        .Return();
+    Handle<BytecodeArray> bytecode_array = builder.ToBytecodeArray();
+
+    InterpreterTester tester(handles.main_isolate(), bytecode_array);
+    auto callable = tester.GetCallable<>();
+    Handle<Object> return_val = callable().ToHandleChecked();
+    // r2 is always 2, so r1 < r2 holds iff r1 = 2 - lhs < 2.
+    CHECK_EQ(Smi::cast(*return_val), Smi::FromInt(lhs > 0 ? 2 : -1));
+  }
+}
+
+
 static const Token::Value kArithmeticOperators[] = {
     Token::Value::ADD, Token::Value::SUB, Token::Value::MUL, Token::Value::DIV,
     Token::Value::MOD};
@@ -797,10 +875,13 @@ TEST(InterpreterCall) {
   i::Isolate* isolate = handles.main_isolate();
   i::Factory* factory = isolate->factory();
 
-  i::FeedbackVectorSlotKind ic_kinds[] = {i::FeedbackVectorSlotKind::LOAD_IC};
-  i::StaticFeedbackVectorSpec feedback_spec(0, 1, ic_kinds);
+  i::FeedbackVectorSlotKind ic_kinds[] = {i::FeedbackVectorSlotKind::LOAD_IC,
+                                          i::FeedbackVectorSlotKind::CALL_IC};
+  i::StaticFeedbackVectorSpec feedback_spec(0, 2, ic_kinds);
   Handle<i::TypeFeedbackVector> vector =
       factory->NewTypeFeedbackVector(&feedback_spec);
+  i::FeedbackVectorICSlot call_slot(1);
+  int call_slot_index = vector->GetIndex(call_slot);
 
   Handle<i::String> name = factory->NewStringFromAsciiChecked("func");
   name = factory->string_table()->LookupString(isolate, name);
@@ -814,7 +895,7 @@ TEST(InterpreterCall) {
         .LoadNamedProperty(builder.Parameter(0), vector->first_ic_slot_index(),
                            i::SLOPPY)
         .StoreAccumulatorInRegister(Register(0))
-        .Call(Register(0), builder.Parameter(0), 0)
+        .Call(Register(0), builder.Parameter(0), 0, call_slot_index)
         .Return();
     Handle<BytecodeArray> bytecode_array = builder.ToBytecodeArray();
 
@@ -825,6 +906,10 @@ TEST(InterpreterCall) {
         "new (function Obj() { this.func = function() { return 0x265; }})()");
     Handle<Object> return_val = callable(object).ToHandleChecked();
     CHECK_EQ(Smi::cast(*return_val), Smi::FromInt(0x265));
+
+    // The call target was recorded.
+    i::CallICNexus nexus(vector, call_slot);
+    CHECK_EQ(i::MONOMORPHIC, nexus.StateFromFeedback());
   }
 
   // Check that receiver is passed properly.
@@ -836,7 +921,7 @@ TEST(InterpreterCall) {
         .LoadNamedProperty(builder.Parameter(0), vector->first_ic_slot_index(),
                            i::SLOPPY)
         .StoreAccumulatorInRegister(Register(0))
-        .Call(Register(0), builder.Parameter(0), 0)
+        .Call(Register(0), builder.Parameter(0), 0, call_slot_index)
         .Return();
     Handle<BytecodeArray> bytecode_array = builder.ToBytecodeArray();
 
@@ -850,6 +935,10 @@ TEST(InterpreterCall) {
         "})()");
     Handle<Object> return_val = callable(object).ToHandleChecked();
     CHECK_EQ(Smi::cast(*return_val), Smi::FromInt(1234));
+
+    // The call site has seen a second target.
+    i::CallICNexus nexus(vector, call_slot);
+    CHECK_EQ(i::GENERIC, nexus.StateFromFeedback());
   }
 
   // Check with two parameters (+ receiver).
@@ -867,7 +956,7 @@ TEST(InterpreterCall) {
         .StoreAccumulatorInRegister(Register(2))
         .LoadLiteral(Smi::FromInt(11))
         .StoreAccumulatorInRegister(Register(3))
-        .Call(Register(0), Register(1), 2)
+        .Call(Register(0), Register(1), 2, call_slot_index)
         .Return();
     Handle<BytecodeArray> bytecode_array = builder.ToBytecodeArray();
 
@@ -913,7 +1002,7 @@ TEST(InterpreterCall) {
         .StoreAccumulatorInRegister(Register(10))
         .LoadLiteral(factory->NewStringFromAsciiChecked("j"))
         .StoreAccumulatorInRegister(Register(11))
-        .Call(Register(0), Register(1), 10)
+        .Call(Register(0), Register(1), 10, call_slot_index)
         .Return();
     Handle<BytecodeArray> bytecode_array = builder.ToBytecodeArray();
 
@@ -1018,6 +1107,38 @@ TEST(InterpreterConditionalJumps) {
 }
 
 
+TEST(InterpreterConditionalJumpsChargeInterruptBudget) {
+  HandleAndZoneScope handles;
+  BytecodeArrayBuilder builder(handles.main_isolate(), handles.main_zone());
+  builder.set_locals_count(2);
+  builder.set_parameter_count(0);
+  Register reg(0), scratch(1);
+  BytecodeLabel loop;
+
+  // Count register r0 up to 3 with a backward JumpIfTrue.
+  builder.LoadLiteral(Smi::FromInt(0))
+      .StoreAccumulatorInRegister(reg)
+      .Bind(&loop);
+  IncrementRegister(builder, reg, 1, scratch)
+      .LoadLiteral(Smi::FromInt(3))
+      .CompareOperation(Token::Value::LT, reg, LanguageMode::SLOPPY)
+      .JumpIfTrue(&loop)
+      .LoadAccumulatorWithRegister(reg)
+      .Return();
+
+  Handle<BytecodeArray> bytecode_array = builder.ToBytecodeArray();
+  InterpreterTester tester(handles.main_isolate(), bytecode_array);
+  auto callable = tester.GetCallable<>();
+  int budget = bytecode_array->interrupt_budget();
+  Handle<Object> return_value = callable().ToHandleChecked();
+  CHECK_EQ(Smi::cast(*return_value)->value(), 3);
+  // The return alone is charged with less than the length of the bytecode,
+  // the two backward jumps that were taken make up the rest.
+  CHECK_LT(bytecode_array->length(),
+           budget - bytecode_array->interrupt_budget());
+}
+
+
 static const Token::Value kComparisonTypes[] = {
     Token::Value::EQ,        Token::Value::NE,  Token::Value::EQ_STRICT,
     Token::Value::NE_STRICT, Token::Value::LTE, Token::Value::LTE,
@@ -1284,3 +1405,30 @@ TEST(InterpreterTestIn) {
     CHECK_EQ(return_value->BooleanValue(), expected_value);
   }
 }
+
+
+TEST(InterpreterTierUpToTurboFan) {
+  HandleAndZoneScope handles;
+  i::Isolate* isolate = handles.main_isolate();
+  i::FLAG_ignition_tier_up = true;
+  i::FLAG_concurrent_recompilation = false;
+  // Tick the runtime profiler every 512 bytes of bytecode executed.
+  i::FLAG_interrupt_budget = 16;
+  InterpreterTester tester(isolate, "function f(a, b) { return a + b; }");
+  auto callable = tester.GetCallable<Handle<Object>, Handle<Object>>();
+  Handle<i::JSFunction> function = v8::Utils::OpenHandle(
+      *v8::Local<v8::Function>::Cast(CcTest::global()->Get(v8_str("f"))));
+
+  Handle<Object> lhs(Smi::FromInt(3), isolate);
+  Handle<Object> rhs(Smi::FromInt(4), isolate);
+  for (int i = 0; i < 10000 && !function->IsOptimized(); i++) {
+    Handle<Object> return_val = callable(lhs, rhs).ToHandleChecked();
+    CHECK_EQ(Smi::FromInt(7), *return_val);
+  }
+  // The function was interpreted and is now optimized from its bytecode.
+  CHECK(function->shared()->HasBytecodeArray());
+  CHECK(function->IsOptimized());
+  CHECK_EQ(i::Code::OPTIMIZED_FUNCTION, function->code()->kind());
+  Handle<Object> return_val = callable(lhs, rhs).ToHandleChecked();
+  CHECK_EQ(Smi::FromInt(7), *return_val);
+}
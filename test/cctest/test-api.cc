@@ -36,6 +36,7 @@
 #include <unistd.h>  // NOLINT
 #endif
 
+#include "include/v8-profiler.h"
 #include "include/v8-util.h"
 #include "src/api.h"
 #include "src/arguments.h"
@@ -3284,6 +3285,27 @@ TEST(TwoPassPhantomCallbacksNestedGc) {
 }
 
 
+TEST(TwoPassPhantomCallbacksOfSeveralGcsAreBatched) {
+  auto isolate = CcTest::isolate();
+  const size_t kLength = 20;
+  int instance_counter = 0;
+  for (int gc = 0; gc < 3; gc++) {
+    for (size_t i = 0; i < kLength; ++i) {
+      auto data = new TwoPassCallbackData(isolate, &instance_counter);
+      data->SetWeak();
+    }
+    // Without a forced GC the second pass is left to a task, which does not
+    // get to run before the next GC.
+    CcTest::heap()->CollectGarbage(i::OLD_SPACE);
+  }
+  if (!i::FLAG_optimize_for_size && !i::FLAG_predictable) {
+    CHECK_EQ(static_cast<int>(3 * kLength), instance_counter);
+  }
+  EmptyMessageQueues(isolate);
+  CHECK_EQ(0, instance_counter);
+}
+
+
 namespace {
 
 void* IntKeyToVoidPointer(int key) { return reinterpret_cast<void*>(key << 1); }
@@ -21266,6 +21288,196 @@ TEST(StreamingScriptWithSourceMappingURLInTheMiddle) {
 }
 
 
+// Parses the chunks with JSON::Parse and checks that the result matches
+// JSON.parse of the concatenated source.
+static void RunJSONStreamingTest(
+    const char** chunks,
+    v8::ScriptCompiler::StreamedSource::Encoding encoding) {
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  v8::HandleScope scope(isolate);
+  v8::TryCatch try_catch(isolate);
+
+  TestSourceStream stream(chunks);
+  v8::Local<Value> result;
+  CHECK(v8::JSON::Parse(isolate, &stream, encoding).ToLocal(&result));
+  CHECK(!try_catch.HasCaught());
+
+  char* full_source = TestSourceStream::FullSourceString(chunks);
+  v8::Local<v8::String> source =
+      encoding == v8::ScriptCompiler::StreamedSource::ONE_BYTE
+          ? v8::String::NewFromOneByte(
+                isolate, reinterpret_cast<const uint8_t*>(full_source),
+                v8::NewStringType::kNormal).ToLocalChecked()
+          : v8_str(full_source);
+  delete[] full_source;
+  CHECK(env->Global()->Set(env.local(), v8_str("result"), result).FromJust());
+  CHECK(env->Global()->Set(env.local(), v8_str("source"), source).FromJust());
+  ExpectTrue("JSON.stringify(result) === JSON.stringify(JSON.parse(source))");
+}
+
+
+TEST(JSONStreamingParse) {
+  const char* chunks[] = {"{\"a\": 1, \"b\": [tr", "ue, 2.5e", "1, -0, null],",
+                          " \"c\": {\"d\": \"e\\u00", "e9\\n\"}, \"1\": 2}",
+                          NULL};
+  RunJSONStreamingTest(chunks, v8::ScriptCompiler::StreamedSource::ONE_BYTE);
+  RunJSONStreamingTest(chunks, v8::ScriptCompiler::StreamedSource::UTF8);
+}
+
+
+TEST(JSONStreamingParseOneByte) {
+  const char* chunks[] = {"[\"caf\xe9\", ", "\"\xff\"]", NULL};
+  RunJSONStreamingTest(chunks, v8::ScriptCompiler::StreamedSource::ONE_BYTE);
+}
+
+
+TEST(JSONStreamingParseSplitUtf8) {
+  // Multi-byte characters split across two and across three chunks.
+  const char* chunks[] = {"[\"\xc3", "\xa9\", \"\xf0\x9f", "\x98", "\x80\"]",
+                          NULL};
+  RunJSONStreamingTest(chunks, v8::ScriptCompiler::StreamedSource::UTF8);
+}
+
+
+TEST(JSONStreamingParseError) {
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  v8::HandleScope scope(isolate);
+
+  const char* truncated[] = {"{\"a\": [1, ", "2", NULL};
+  const char* invalid[] = {"{\"a\": ", "tru}", NULL};
+  const char** sources[] = {truncated, invalid};
+  for (size_t i = 0; i < arraysize(sources); i++) {
+    v8::TryCatch try_catch(isolate);
+    TestSourceStream stream(sources[i]);
+    CHECK(v8::JSON::Parse(isolate, &stream,
+                          v8::ScriptCompiler::StreamedSource::UTF8).IsEmpty());
+    CHECK(try_catch.HasCaught());
+    CHECK(try_catch.Exception()->IsNativeError());
+  }
+}
+
+
+class TestJSONOutputStream : public v8::OutputStream {
+ public:
+  explicit TestJSONOutputStream(int chunk_size, int abort_after = -1)
+      : chunk_size_(chunk_size),
+        abort_after_(abort_after),
+        chunk_count_(0),
+        eos_signaled_(false) {}
+
+  virtual void EndOfStream() { eos_signaled_ = true; }
+  virtual int GetChunkSize() { return chunk_size_; }
+  virtual WriteResult WriteAsciiChunk(char* data, int size) {
+    CHECK(!eos_signaled_);
+    CHECK(size > 0 && size <= chunk_size_);
+    output_.append(data, size);
+    return ++chunk_count_ == abort_after_ ? kAbort : kContinue;
+  }
+
+  const std::string& output() const { return output_; }
+  int chunk_count() const { return chunk_count_; }
+  bool eos_signaled() const { return eos_signaled_; }
+
+ private:
+  int chunk_size_;
+  int abort_after_;
+  int chunk_count_;
+  bool eos_signaled_;
+  std::string output_;
+};
+
+
+TEST(JSONStringifyToStream) {
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  v8::HandleScope scope(isolate);
+
+  const char* sources[] = {
+      "42",
+      "'plain ascii'",
+      "({a: [1, 2.5, null, true], 'b\\n': {c: 'caf\\u00e9'}})",
+      // Two-byte strings, including a surrogate pair and a lone surrogate.
+      "['\\u65e5\\u672c\\u8a9e', 'x\\ud83d\\ude00y', '\\ud800!']",
+      "({toJSON: function() { return new Array(9).join('\\u20ac'); }})",
+      // Symbols take the generic path, which appends a whole string.
+      "[Symbol('s'), {s: Symbol()}, 1]",
+      "(function() { var a = []; for (var i = 0; i < 3000; i++) {"
+      "  a.push({key: 'value' + i, n: i / 7}); } return a; })()"};
+  const int chunk_sizes[] = {1, 5, 1024};
+  for (size_t i = 0; i < arraysize(sources); i++) {
+    v8::Local<v8::Value> value = CompileRun(sources[i]);
+    v8::Local<v8::Object> json = env->Global()
+                                     ->Get(env.local(), v8_str("JSON"))
+                                     .ToLocalChecked()
+                                     .As<v8::Object>();
+    v8::Local<v8::Function> stringify = json->Get(env.local(),
+                                                  v8_str("stringify"))
+                                            .ToLocalChecked()
+                                            .As<v8::Function>();
+    v8::Local<v8::Value> expected_string =
+        stringify->Call(env.local(), json, 1, &value).ToLocalChecked();
+    v8::String::Utf8Value expected(expected_string);
+    for (size_t j = 0; j < arraysize(chunk_sizes); j++) {
+      TestJSONOutputStream stream(chunk_sizes[j]);
+      CHECK(v8::JSON::StringifyToStream(env.local(), value, &stream)
+                .FromJust());
+      CHECK(stream.eos_signaled());
+      CHECK_EQ(std::string(*expected, expected.length()), stream.output());
+    }
+  }
+}
+
+
+TEST(JSONStringifyToStreamAbortAndException) {
+  LocalContext env;
+  v8::Isolate* isolate = env->GetIsolate();
+  v8::HandleScope scope(isolate);
+
+  {
+    // Values without a JSON representation write nothing.
+    TestJSONOutputStream stream(16);
+    CHECK(!v8::JSON::StringifyToStream(env.local(), v8::Undefined(isolate),
+                                       &stream).FromJust());
+    CHECK_EQ(0, stream.chunk_count());
+    CHECK(!stream.eos_signaled());
+  }
+  {
+    TestJSONOutputStream stream(16, 2);
+    v8::Local<v8::Value> value =
+        CompileRun("new Array(1000).join('abc').split('')");
+    CHECK(!v8::JSON::StringifyToStream(env.local(), value, &stream)
+               .FromJust());
+    CHECK_EQ(2, stream.chunk_count());
+    CHECK(!stream.eos_signaled());
+  }
+  {
+    // No toJSON functions are called once the stream aborted.
+    TestJSONOutputStream stream(16, 1);
+    v8::Local<v8::Value> value = CompileRun(
+        "var calls = 0; var a = [];"
+        "for (var i = 0; i < 1000; i++) {"
+        "  a.push({toJSON: function() { calls++; return 'abcdefgh'; }});"
+        "}"
+        "a");
+    CHECK(!v8::JSON::StringifyToStream(env.local(), value, &stream)
+               .FromJust());
+    CHECK_EQ(1, stream.chunk_count());
+    CHECK_LT(CompileRun("calls")->Int32Value(), 100);
+  }
+  {
+    v8::TryCatch try_catch(isolate);
+    TestJSONOutputStream stream(16);
+    v8::Local<v8::Value> value = CompileRun("var o = {}; o.o = o; o");
+    CHECK(v8::JSON::StringifyToStream(env.local(), value, &stream)
+              .IsNothing());
+    CHECK(try_catch.HasCaught());
+    CHECK(!stream.eos_signaled());
+  }
+}
+
+
 TEST(NewStringRangeError) {
   v8::Isolate* isolate = CcTest::isolate();
   v8::HandleScope handle_scope(isolate);
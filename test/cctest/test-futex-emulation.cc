@@ -0,0 +1,203 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "src/v8.h"
+
+#include "src/api.h"
+#include "src/base/atomicops.h"
+#include "src/base/platform/platform.h"
+#include "src/base/platform/semaphore.h"
+#include "src/futex-emulation.h"
+#include "test/cctest/cctest.h"
+
+using namespace v8::internal;
+
+namespace {
+
+// Waiters are spread out so that no two of them share a cache line.
+const int kSlotStride = 16;
+const int kMaxThreads = 16;
+const size_t kSlotsSize = kMaxThreads * kSlotStride * sizeof(int32_t);
+
+
+size_t SlotOffset(int index) { return index * kSlotStride * sizeof(int32_t); }
+
+
+// Runs on its own isolate, viewing |slots| through an ArrayBuffer of that
+// isolate.
+class FutexThread : public v8::base::Thread {
+ public:
+  FutexThread(const char* name, int32_t* slots, v8::base::Semaphore* ready,
+              v8::base::Semaphore* go)
+      : Thread(Options(name)), slots_(slots), ready_(ready), go_(go) {}
+
+  void Run() override {
+    v8::Isolate::CreateParams create_params;
+    create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+    v8::Isolate* isolate = v8::Isolate::New(create_params);
+    {
+      v8::Isolate::Scope isolate_scope(isolate);
+      v8::HandleScope handle_scope(isolate);
+      v8::Local<v8::Context> context = v8::Context::New(isolate);
+      v8::Context::Scope context_scope(context);
+      v8::Local<v8::ArrayBuffer> array_buffer =
+          v8::ArrayBuffer::New(isolate, slots_, kSlotsSize);
+      Handle<JSArrayBuffer> buffer = v8::Utils::OpenHandle(*array_buffer);
+      ready_->Signal();
+      go_->Wait();
+      RunWithBuffer(reinterpret_cast<Isolate*>(isolate), buffer);
+    }
+    isolate->Dispose();
+  }
+
+ protected:
+  virtual void RunWithBuffer(Isolate* isolate,
+                             Handle<JSArrayBuffer> buffer) = 0;
+
+  volatile v8::base::Atomic32* slot(int index) {
+    return reinterpret_cast<volatile v8::base::Atomic32*>(
+        reinterpret_cast<int8_t*>(slots_) + SlotOffset(index));
+  }
+
+  // Blocks until slot |index| becomes non-zero and resets it.
+  void WaitForSignal(Isolate* isolate, Handle<JSArrayBuffer> buffer,
+                     int index) {
+    while (v8::base::Acquire_Load(slot(index)) == 0) {
+      FutexEmulation::Wait(isolate, buffer, SlotOffset(index), 0,
+                           V8_INFINITY);
+    }
+    v8::base::Release_Store(slot(index), 0);
+  }
+
+  void Signal(Isolate* isolate, Handle<JSArrayBuffer> buffer, int index) {
+    v8::base::Release_Store(slot(index), 1);
+    FutexEmulation::Wake(isolate, buffer, SlotOffset(index), 1);
+  }
+
+  int32_t* slots_;
+
+ private:
+  v8::base::Semaphore* ready_;
+  v8::base::Semaphore* go_;
+};
+
+
+// Threads 2k and 2k+1 play ping-pong, each waiting on its own slot and
+// waking its partner's.
+class PingPongThread : public FutexThread {
+ public:
+  PingPongThread(int32_t* slots, int index, int rounds,
+                 v8::base::Semaphore* ready, v8::base::Semaphore* go)
+      : FutexThread("futex ping-pong", slots, ready, go),
+        index_(index),
+        rounds_(rounds) {}
+
+ protected:
+  void RunWithBuffer(Isolate* isolate, Handle<JSArrayBuffer> buffer) override {
+    int partner = index_ ^ 1;
+    for (int i = 0; i < rounds_; i++) {
+      if (index_ % 2 == 0) {
+        Signal(isolate, buffer, partner);
+        WaitForSignal(isolate, buffer, index_);
+      } else {
+        WaitForSignal(isolate, buffer, index_);
+        Signal(isolate, buffer, partner);
+      }
+    }
+  }
+
+ private:
+  int index_;
+  int rounds_;
+};
+
+
+class WaitOnceThread : public FutexThread {
+ public:
+  WaitOnceThread(int32_t* slots, int index, v8::base::Semaphore* ready,
+                 v8::base::Semaphore* go)
+      : FutexThread("futex waiter", slots, ready, go),
+        index_(index),
+        result_(nullptr) {}
+
+  Object* result() { return result_; }
+
+ protected:
+  void RunWithBuffer(Isolate* isolate, Handle<JSArrayBuffer> buffer) override {
+    result_ = FutexEmulation::Wait(isolate, buffer, SlotOffset(index_), 0,
+                                   V8_INFINITY);
+  }
+
+ private:
+  int index_;
+  Object* result_;
+};
+
+
+int NumWaiters(Handle<JSArrayBuffer> buffer, int index) {
+  return Smi::cast(FutexEmulation::NumWaitersForTesting(
+                       CcTest::i_isolate(), buffer, SlotOffset(index)))
+      ->value();
+}
+
+}  // namespace
+
+
+TEST(FutexRequeueToOtherAddress) {
+  CcTest::InitializeVM();
+  v8::HandleScope scope(CcTest::isolate());
+  int32_t slots[kMaxThreads * kSlotStride] = {0};
+  Handle<JSArrayBuffer> buffer = v8::Utils::OpenHandle(
+      *v8::ArrayBuffer::New(CcTest::isolate(), slots, kSlotsSize));
+
+  v8::base::Semaphore ready(0);
+  v8::base::Semaphore go(0);
+  WaitOnceThread thread(slots, 0, &ready, &go);
+  thread.Start();
+  ready.Wait();
+  go.Signal();
+  while (NumWaiters(buffer, 0) == 0) {
+    v8::base::OS::Sleep(v8::base::TimeDelta::FromMilliseconds(1));
+  }
+
+  // Requeue the waiter to slot 1 without waking it. The slots may well hash
+  // to different wait lists.
+  Isolate* isolate = CcTest::i_isolate();
+  CHECK_EQ(Smi::FromInt(0),
+           FutexEmulation::WakeOrRequeue(isolate, buffer, SlotOffset(0), 0, 0,
+                                         SlotOffset(1)));
+  CHECK_EQ(0, NumWaiters(buffer, 0));
+  CHECK_EQ(1, NumWaiters(buffer, 1));
+  CHECK_EQ(Smi::FromInt(0),
+           FutexEmulation::Wake(isolate, buffer, SlotOffset(0), 1));
+  CHECK_EQ(Smi::FromInt(1),
+           FutexEmulation::Wake(isolate, buffer, SlotOffset(1), 1));
+  thread.Join();
+  CHECK_EQ(Smi::FromInt(FutexEmulation::kOk), thread.result());
+  CHECK_EQ(0, NumWaiters(buffer, 1));
+}
+
+
+TEST(FutexWakeOnDistinctAddresses) {
+  // Pairs of threads ping-pong through Wait and Wake on their own slots.
+  // Every wake must reach the waiter on its address and no other.
+  CcTest::InitializeVM();
+  static const int kThreads = 4;
+  static const int kRounds = 50;
+  int32_t slots[kMaxThreads * kSlotStride] = {0};
+  v8::base::Semaphore ready(0);
+  v8::base::Semaphore go(0);
+  PingPongThread* ping_pong[kThreads];
+  for (int i = 0; i < kThreads; i++) {
+    ping_pong[i] = new PingPongThread(slots, i, kRounds, &ready, &go);
+    ping_pong[i]->Start();
+  }
+  for (int i = 0; i < kThreads; i++) ready.Wait();
+  for (int i = 0; i < kThreads; i++) go.Signal();
+  for (int i = 0; i < kThreads; i++) {
+    ping_pong[i]->Join();
+    delete ping_pong[i];
+  }
+  for (int i = 0; i < kThreads; i++) CHECK_EQ(0, slots[i * kSlotStride]);
+}
@@ -25,6 +25,8 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <vector>
+
 #include "src/global-handles.h"
 
 #include "test/cctest/cctest.h"
@@ -397,3 +399,161 @@ TEST(PersistentBaseGetLocal) {
   CHECK(o == g.Get(isolate));
   CHECK(v8::Local<v8::Object>::New(isolate, g) == g.Get(isolate));
 }
+
+
+namespace {
+
+void DestroyOnFirstPass(const v8::WeakCallbackInfo<void>& data) {
+  Object** location = reinterpret_cast<Object**>(data.GetParameter());
+  GlobalHandles::Destroy(location);
+}
+
+
+int second_pass_callback_count = 0;
+
+
+void CountSecondPass(const v8::WeakCallbackInfo<void>& data) {
+  second_pass_callback_count++;
+}
+
+
+void DestroyAndRequestSecondPass(const v8::WeakCallbackInfo<void>& data) {
+  DestroyOnFirstPass(data);
+  data.SetSecondPassCallback(&CountSecondPass);
+}
+
+
+// Supports idle tasks but runs no task until asked to.
+class SecondPassPlatform : public v8::Platform {
+ public:
+  explicit SecondPassPlatform(v8::Platform* platform) : platform_(platform) {}
+  virtual ~SecondPassPlatform() {
+    for (auto task : tasks_) delete task;
+    for (auto task : idle_tasks_) delete task;
+  }
+
+  void CallOnBackgroundThread(v8::Task* task,
+                              ExpectedRuntime expected_runtime) override {
+    platform_->CallOnBackgroundThread(task, expected_runtime);
+  }
+
+  void CallOnForegroundThread(v8::Isolate* isolate, v8::Task* task) override {
+    tasks_.push_back(task);
+  }
+
+  void CallDelayedOnForegroundThread(v8::Isolate* isolate, v8::Task* task,
+                                     double delay_in_seconds) override {
+    platform_->CallDelayedOnForegroundThread(isolate, task, delay_in_seconds);
+  }
+
+  void CallIdleOnForegroundThread(v8::Isolate* isolate,
+                                  v8::IdleTask* task) override {
+    idle_tasks_.push_back(task);
+  }
+
+  bool IdleTasksEnabled(v8::Isolate* isolate) override { return true; }
+
+  double MonotonicallyIncreasingTime() override {
+    return platform_->MonotonicallyIncreasingTime();
+  }
+
+  void RunForegroundTasks() {
+    std::vector<v8::Task*> tasks;
+    tasks.swap(tasks_);
+    for (auto task : tasks) {
+      task->Run();
+      delete task;
+    }
+  }
+
+ private:
+  v8::Platform* platform_;
+  std::vector<v8::Task*> tasks_;
+  std::vector<v8::IdleTask*> idle_tasks_;
+};
+
+}  // namespace
+
+
+TEST(WeakHandlesAcrossManyBlocks) {
+  // Enough handles to split a mark-compact's walk over the global handles
+  // between several tasks.
+  CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
+  GlobalHandles* global_handles = isolate->global_handles();
+  const int kNumObjects = 8 * 1024;
+  int initial_handle_count = global_handles->global_handles_count();
+
+  ScopedVector<Handle<Object> > strong(kNumObjects);
+  ScopedVector<Handle<Object> > weak_to_live(kNumObjects);
+  {
+    HandleScope scope(isolate);
+    for (int i = 0; i < kNumObjects; i++) {
+      Handle<FixedArray> live = isolate->factory()->NewFixedArray(1);
+      live->set(0, Smi::FromInt(i));
+      strong[i] = global_handles->Create(*live);
+      weak_to_live[i] = global_handles->Create(*live);
+      GlobalHandles::MakeWeak(weak_to_live[i].location(),
+                              weak_to_live[i].location(), &DestroyOnFirstPass,
+                              v8::WeakCallbackType::kParameter);
+
+      Handle<FixedArray> dead = isolate->factory()->NewFixedArray(1);
+      Handle<Object> weak_to_dead = global_handles->Create(*dead);
+      GlobalHandles::MakeWeak(weak_to_dead.location(), weak_to_dead.location(),
+                              &DestroyOnFirstPass,
+                              v8::WeakCallbackType::kParameter);
+    }
+  }
+  CHECK_EQ(initial_handle_count + 3 * kNumObjects,
+           global_handles->global_handles_count());
+
+  isolate->heap()->CollectAllAvailableGarbage();
+
+  // Exactly the handles to dead objects are gone, and the remaining ones
+  // still agree on where the live objects are.
+  CHECK_EQ(initial_handle_count + 2 * kNumObjects,
+           global_handles->global_handles_count());
+  for (int i = 0; i < kNumObjects; i++) {
+    CHECK(!GlobalHandles::IsNearDeath(weak_to_live[i].location()));
+    CHECK_EQ(*strong[i], *weak_to_live[i]);
+    CHECK_EQ(Smi::FromInt(i), FixedArray::cast(*strong[i])->get(0));
+    GlobalHandles::Destroy(weak_to_live[i].location());
+    GlobalHandles::Destroy(strong[i].location());
+  }
+}
+
+
+TEST(SecondPassCallbacksDoNotWaitForeverForIdleTime) {
+  if (FLAG_optimize_for_size || FLAG_predictable) return;
+  CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
+  GlobalHandles* global_handles = isolate->global_handles();
+  v8::Platform* old_platform = V8::GetCurrentPlatform();
+  SecondPassPlatform* platform = new SecondPassPlatform(old_platform);
+  V8::SetPlatformForTesting(platform);
+  second_pass_callback_count = 0;
+
+  // Each garbage collection queues one second pass callback. The idle task
+  // posted for them never runs.
+  for (int gc = 0; gc <= GlobalHandles::kMaxGCsBeforeSecondPassTask; gc++) {
+    {
+      HandleScope scope(isolate);
+      Handle<Object> weak =
+          global_handles->Create(*isolate->factory()->NewFixedArray(1));
+      GlobalHandles::MakeWeak(weak.location(), weak.location(),
+                              &DestroyAndRequestSecondPass,
+                              v8::WeakCallbackType::kParameter);
+    }
+    isolate->heap()->CollectGarbage(OLD_SPACE);
+    platform->RunForegroundTasks();
+    if (gc < GlobalHandles::kMaxGCsBeforeSecondPassTask) {
+      CHECK_EQ(0, second_pass_callback_count);
+    }
+  }
+  // Too many garbage collections went by, so a regular task ran them.
+  CHECK_EQ(GlobalHandles::kMaxGCsBeforeSecondPassTask + 1,
+           second_pass_callback_count);
+
+  V8::SetPlatformForTesting(old_platform);
+  delete platform;
+}
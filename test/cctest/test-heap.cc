@@ -28,12 +28,15 @@
 #include <stdlib.h>
 #include <utility>
 
+#include "src/base/platform/elapsed-timer.h"
 #include "src/compilation-cache.h"
 #include "src/context-measure.h"
 #include "src/deoptimizer.h"
 #include "src/execution.h"
 #include "src/factory.h"
 #include "src/global-handles.h"
+#include "src/heap/array-buffer-tracker.h"
+#include "src/heap/concurrent-marking.h"
 #include "src/heap/gc-tracer.h"
 #include "src/ic/ic.h"
 #include "src/macro-assembler.h"
@@ -3234,6 +3237,86 @@ TEST(OptimizedPretenuringNestedDoubleLiterals) {
 }
 
 
+TEST(PretenuringOfRuntimeLiteralCopies) {
+  i::FLAG_expose_gc = true;
+  CcTest::InitializeVM();
+  if (!i::FLAG_allocation_site_pretenuring) return;
+  if (i::FLAG_gc_global || i::FLAG_stress_compaction) return;
+  v8::HandleScope scope(CcTest::isolate());
+
+  // Nested literals are copied by the runtime. Their site is pretenured once
+  // its objects survived two garbage collections, even if new space never
+  // grew to its maximum capacity.
+  i::ScopedVector<char> source(1024);
+  i::SNPrintF(
+      source,
+      "var number_elements = %d;"
+      "var elements = new Array(number_elements);"
+      "function f() {"
+      "  for (var i = 0; i < number_elements; i++) {"
+      "    elements[i] = [{}, {}, {}];"
+      "  }"
+      "  return elements[number_elements - 1];"
+      "};"
+      "f(); gc();"
+      "f(); gc();"
+      "f();",
+      AllocationSite::kPretenureMinimumCreated);
+
+  v8::Local<v8::Value> res = CompileRun(source.start());
+
+  Handle<JSObject> o =
+      v8::Utils::OpenHandle(*v8::Handle<v8::Object>::Cast(res));
+  CHECK(CcTest::heap()->InOldSpace(*o));
+  CHECK(CcTest::heap()->InOldSpace(o->elements()));
+}
+
+
+TEST(AllocationSiteUnpretenuring) {
+  // Unoptimized code keeps allocating the literal in new space with a
+  // memento, which is what feeds the site.
+  i::FLAG_opt = false;
+  CcTest::InitializeVM();
+  if (!i::FLAG_allocation_site_pretenuring || i::FLAG_always_opt) return;
+  if (i::FLAG_gc_global || i::FLAG_stress_compaction) return;
+  v8::HandleScope scope(CcTest::isolate());
+  Heap* heap = CcTest::heap();
+
+  i::ScopedVector<char> source(1024);
+  i::SNPrintF(source,
+              "var keep = [];"
+              "function f(retain) {"
+              "  for (var i = 0; i < %d; i++) {"
+              "    var a = [1, 2, 3];"
+              "    if (retain) keep[i] = a;"
+              "  }"
+              "};"
+              "f(true);",
+              2 * AllocationSite::kPretenureMinimumCreated);
+  CompileRun(source.start());
+  // The site of the literal in f is the most recently created one.
+  Handle<AllocationSite> site(
+      AllocationSite::cast(heap->allocation_sites_list()));
+
+  // Sites whose objects survive two scavenges are pretenured.
+  heap->CollectGarbage(NEW_SPACE);
+  CHECK_EQ(AllocationSite::kMaybeTenure, site->pretenure_decision());
+  CompileRun("f(true);");
+  heap->CollectGarbage(NEW_SPACE);
+  CHECK_EQ(TENURED, site->GetPretenureMode());
+  CompileRun("keep = [];");
+
+  // Pretenuring stops when the objects that are still allocated in new space
+  // die young, although no memento of the site is found anymore.
+  CompileRun("f(false);");
+  for (int i = 0; i < Heap::kTenuredAllocationSitesCheckInterval; i++) {
+    heap->CollectGarbage(NEW_SPACE);
+  }
+  CHECK_EQ(AllocationSite::kDontTenure, site->pretenure_decision());
+  CHECK_EQ(NOT_TENURED, site->GetPretenureMode());
+}
+
+
 // Test regular array literals allocation.
 TEST(OptimizedAllocationArrayLiterals) {
   i::FLAG_allow_natives_syntax = true;
@@ -6417,5 +6500,212 @@ TEST(Regress519319) {
 }
 
 
+TEST(ParallelScavenge) {
+  i::FLAG_expose_gc = true;
+  i::FLAG_parallel_scavenge = true;
+  i::FLAG_parallel_scavenge_tasks = 4;
+  CcTest::InitializeVM();
+  v8::HandleScope scope(CcTest::isolate());
+  Heap* heap = CcTest::heap();
+
+  // Objects reachable from the roots, some of which get promoted by the
+  // second scavenge.
+  CompileRun(
+      "var list = null;"
+      "for (var i = 0; i < 20000; i++) {"
+      "  list = {value: i, next: list, name: 'n' + i, doubles: [i + 0.5]};"
+      "}");
+  heap->CollectGarbage(NEW_SPACE);
+  heap->CollectGarbage(NEW_SPACE);
+
+  // Old-to-new pointers recorded in the store buffer.
+  CompileRun(
+      "var old = [];"
+      "for (var i = 0; i < 1000; i++) old.push({});"
+      "gc();"
+      "for (var i = 0; i < old.length; i++) old[i].child = {value: i};");
+  heap->CollectGarbage(NEW_SPACE);
+  heap->CollectGarbage(NEW_SPACE);
+
+  v8::Local<v8::Value> result = CompileRun(
+      "var sum = 0;"
+      "for (var o = list; o !== null; o = o.next) {"
+      "  if (o.name !== 'n' + o.value || o.doubles[0] !== o.value + 0.5) {"
+      "    throw 'corrupted';"
+      "  }"
+      "  sum += o.value;"
+      "}"
+      "for (var i = 0; i < old.length; i++) sum += old[i].child.value;"
+      "sum;");
+  CHECK_EQ(20000 * 19999 / 2 + 1000 * 999 / 2, result->Int32Value());
+}
+
+
+TEST(ConcurrentMarking) {
+  if (!i::FLAG_incremental_marking) return;
+  i::FLAG_concurrent_marking = true;
+  CcTest::InitializeVM();
+  v8::HandleScope scope(CcTest::isolate());
+  Heap* heap = CcTest::heap();
+
+  // Copy-on-write literal arrays in old space, which contain heap numbers,
+  // are handed over to the concurrent marker.
+  CompileRun(
+      "var literals = [];"
+      "for (var i = 0; i < 1000; i++) {"
+      "  literals.push(new Function('return [' + i + ', 0.5, \"a\", ' + i +"
+      "                             '];'));"
+      "  literals[i]();"
+      "}");
+  heap->CollectAllGarbage();
+  heap->CollectAllGarbage();
+
+  IncrementalMarking* marking = heap->incremental_marking();
+  ConcurrentMarking* concurrent_marking = heap->concurrent_marking();
+  SimulateIncrementalMarking(heap, false);
+  // Marking cannot complete without forcing it while the concurrent marker
+  // still has work, so the background task eventually visits the arrays.
+  while (!marking->IsComplete() && concurrent_marking->visited_bytes() == 0) {
+    marking->Step(MB, IncrementalMarking::NO_GC_VIA_STACK_GUARD,
+                  IncrementalMarking::FORCE_MARKING,
+                  IncrementalMarking::DO_NOT_FORCE_COMPLETION);
+    v8::base::OS::Sleep(v8::base::TimeDelta::FromMilliseconds(1));
+  }
+  CHECK_LT(0, concurrent_marking->visited_bytes());
+  SimulateIncrementalMarking(heap);
+  heap->CollectAllGarbage();
+
+  v8::Local<v8::Value> result = CompileRun(
+      "var sum = 0;"
+      "for (var i = 0; i < literals.length; i++) {"
+      "  var array = literals[i]();"
+      "  if (array[1] !== 0.5 || array[2] !== 'a') throw 'corrupted';"
+      "  sum += array[0] + array[3];"
+      "}"
+      "sum;");
+  CHECK_EQ(1000 * 999, result->Int32Value());
+}
+
+
+TEST(ParallelCompactionPauseTime) {
+  // Reports the average pause of full GCs that evacuate every other page of a
+  // fragmented old space with 1, 2, 4 and 8 parallel compaction tasks. The
+  // reduction in pause time depends on the number of cores of the machine.
+  i::FLAG_expose_gc = true;
+  i::FLAG_parallel_compaction = true;
+  i::FLAG_manual_evacuation_candidates_selection = true;
+  CcTest::InitializeVM();
+  v8::HandleScope scope(CcTest::isolate());
+  Heap* heap = CcTest::heap();
+
+  static const int kTaskCounts[] = {1, 2, 4, 8};
+  static const int kRuns = 3;
+  for (size_t i = 0; i < arraysize(kTaskCounts); i++) {
+    i::FLAG_parallel_compaction_tasks = kTaskCounts[i];
+    double total_ms = 0.0;
+    for (int run = 0; run < kRuns; run++) {
+      // Tenure the objects, drop every other one and keep some of the
+      // survivors reachable from new space as well.
+      CompileRun(
+          "var retained = [];"
+          "for (var i = 0; i < 20000; i++) {"
+          "  retained.push({value: i, payload: [i, i + 1], name: 'n' + i});"
+          "}"
+          "gc();"
+          "gc();"
+          "for (var i = 0; i < retained.length; i += 2) retained[i] = null;"
+          "var young = [];"
+          "for (var i = 1; i < retained.length; i += 10) {"
+          "  young.push({old: retained[i]});"
+          "}");
+      int page_index = 0;
+      PageIterator it(heap->old_space());
+      while (it.has_next()) {
+        Page* p = it.next();
+        if (page_index++ % 2 == 0) {
+          p->SetFlag(MemoryChunk::FORCE_EVACUATION_CANDIDATE_FOR_TESTING);
+        }
+      }
+      base::ElapsedTimer timer;
+      timer.Start();
+      heap->CollectGarbage(OLD_SPACE);
+      total_ms += timer.Elapsed().InMillisecondsF();
+
+      v8::Local<v8::Value> result = CompileRun(
+          "var sum = 0;"
+          "for (var i = 1; i < retained.length; i += 2) {"
+          "  var o = retained[i];"
+          "  if (o.payload[1] !== i + 1 || o.name !== 'n' + i) {"
+          "    throw 'corrupted';"
+          "  }"
+          "  sum += o.value;"
+          "}"
+          "for (var i = 0; i < young.length; i++) {"
+          "  if (young[i].old !== retained[1 + i * 10]) throw 'corrupted';"
+          "}"
+          "sum;");
+      CHECK_EQ(10000 * 10000, result->Int32Value());
+    }
+    PrintF("Full GC with %d compaction tasks: %.2f ms\n", kTaskCounts[i],
+           total_ms / kRuns);
+  }
+}
+
+
+TEST(ArrayBufferTrackingFollowsEvacuation) {
+  i::FLAG_manual_evacuation_candidates_selection = true;
+  CcTest::InitializeVM();
+  Isolate* isolate = CcTest::i_isolate();
+  Heap* heap = isolate->heap();
+  v8::HandleScope scope(CcTest::isolate());
+  const size_t kLength = 100;
+
+  Handle<JSArrayBuffer> buffer = isolate->factory()->NewJSArrayBuffer();
+  CHECK(JSArrayBuffer::SetupAllocatingData(buffer, isolate, kLength));
+  CHECK(heap->InNewSpace(*buffer));
+  CHECK(ArrayBufferTracker::IsTracked(*buffer));
+  void* backing_store = buffer->backing_store();
+
+  // A dead buffer in new space is released by the next scavenge.
+  int64_t external_memory = heap->amount_of_external_allocated_memory();
+  {
+    HandleScope inner_scope(isolate);
+    Handle<JSArrayBuffer> dead = isolate->factory()->NewJSArrayBuffer();
+    CHECK(JSArrayBuffer::SetupAllocatingData(dead, isolate, kLength));
+    CHECK_EQ(external_memory + static_cast<int64_t>(kLength),
+             heap->amount_of_external_allocated_memory());
+  }
+  heap->CollectGarbage(NEW_SPACE);
+  CHECK_EQ(external_memory, heap->amount_of_external_allocated_memory());
+
+  // Copying within new space and promotion hand the buffer over to the
+  // tracker of its new page.
+  heap->CollectGarbage(NEW_SPACE);
+  heap->CollectGarbage(NEW_SPACE);
+  CHECK(!heap->InNewSpace(*buffer));
+  CHECK(ArrayBufferTracker::IsTracked(*buffer));
+  CHECK_EQ(backing_store, buffer->backing_store());
+
+  // So does compaction of old space.
+  Address old_address = buffer->address();
+  Page::FromAddress(old_address)
+      ->SetFlag(MemoryChunk::FORCE_EVACUATION_CANDIDATE_FOR_TESTING);
+  heap->CollectAllGarbage();
+  CHECK(old_address != buffer->address());
+  CHECK(ArrayBufferTracker::IsTracked(*buffer));
+  CHECK_EQ(backing_store, buffer->backing_store());
+  CHECK_EQ(external_memory, heap->amount_of_external_allocated_memory());
+
+  // Externalizing a buffer stops tracking it.
+  v8::Local<v8::ArrayBuffer> api_buffer = v8::Utils::ToLocal(buffer);
+  v8::ArrayBuffer::Contents contents = api_buffer->Externalize();
+  CHECK(!ArrayBufferTracker::IsTracked(*buffer));
+  CHECK_EQ(external_memory - static_cast<int64_t>(kLength),
+           heap->amount_of_external_allocated_memory());
+  isolate->array_buffer_allocator()->Free(contents.Data(),
+                                          contents.ByteLength());
+}
+
+
 }  // namespace internal
 }  // namespace v8
@@ -1816,3 +1816,40 @@ TEST(CharacterRangeMerge) {
 TEST(Graph) {
   Execute("\\b\\w+\\b", false, true, true);
 }
+
+
+static void CheckRequiredLiteral(const char* input, const char* expected,
+                                 bool ignore_case = false) {
+  v8::HandleScope scope(CcTest::isolate());
+  Zone zone;
+  FlatStringReader reader(CcTest::i_isolate(), CStrVector(input));
+  RegExpCompileData result;
+  CHECK(v8::internal::RegExpParser::ParseRegExp(
+      CcTest::i_isolate(), &zone, &reader, false, false, &result));
+  Vector<const uc16> literal =
+      RegExpEngine::FindRequiredLiteral(&result, ignore_case, &zone);
+  int length = StrLength(expected);
+  CHECK_EQ(length, literal.length());
+  for (int i = 0; i < length; i++) CHECK_EQ(expected[i], literal[i]);
+}
+
+
+TEST(RequiredLiteral) {
+  CheckRequiredLiteral("abc", "abc");
+  CheckRequiredLiteral("abc", "", true);
+  CheckRequiredLiteral("foo\\d+barbaz", "barbaz");
+  CheckRequiredLiteral("foo\\d+bar", "foo");
+  CheckRequiredLiteral("a(bc)d", "abcd");
+  CheckRequiredLiteral("(?:ab|cd)ef", "ef");
+  CheckRequiredLiteral("^abc$", "abc");
+  CheckRequiredLiteral("x\\bfoo", "xfoo");
+  CheckRequiredLiteral("(?=abc)d", "d");
+  CheckRequiredLiteral("q(xyz)+", "xyz");
+  CheckRequiredLiteral("q(xyz)*", "q");
+  CheckRequiredLiteral("q(xyz){0,2}r", "q");
+  CheckRequiredLiteral("a[bc]de", "de");
+  CheckRequiredLiteral("(a)b\\1", "ab");
+  CheckRequiredLiteral("ab|cd", "");
+  CheckRequiredLiteral("\\d+", "");
+  CheckRequiredLiteral("", "");
+}
@@ -35,6 +35,7 @@
 #include "src/compilation-cache.h"
 #include "src/debug/debug.h"
 #include "src/heap/spaces.h"
+#include "src/interpreter/interpreter.h"
 #include "src/objects.h"
 #include "src/parser.h"
 #include "src/runtime/runtime.h"
@@ -706,6 +707,34 @@ TEST(PerIsolateSnapshotBlobs) {
 }
 
 
+TEST(ExternalReferenceTablesAgreeAcrossIsolates) {
+  Isolate* isolate1 = CcTest::i_isolate();
+  ExternalReferenceTable* table1 = ExternalReferenceTable::instance(isolate1);
+
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  v8::Isolate* v8_isolate2 = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope i_scope(v8_isolate2);
+    Isolate* isolate2 = reinterpret_cast<Isolate*>(v8_isolate2);
+    ExternalReferenceTable* table2 = ExternalReferenceTable::instance(isolate2);
+    // Snapshots encode external references by index, so both tables have to
+    // list the same references in the same order.
+    CHECK_EQ(table1->size(), table2->size());
+    for (int i = 0; i < table1->size(); i++) {
+      CHECK_EQ(0, strcmp(table1->name(i), table2->name(i)));
+#ifndef USE_SIMULATOR
+      // Runtime functions are shared by all isolates.
+      if (strncmp(table1->name(i), "Runtime::", 9) == 0) {
+        CHECK_EQ(table1->address(i), table2->address(i));
+      }
+#endif  // USE_SIMULATOR
+    }
+  }
+  v8_isolate2->Dispose();
+}
+
+
 static void SerializationFunctionTemplate(
     const v8::FunctionCallbackInfo<v8::Value>& args) {
   args.GetReturnValue().Set(args[0]);
@@ -757,6 +786,169 @@ TEST(PerIsolateSnapshotBlobsOutdatedContextWithOverflow) {
 }
 
 
+struct SerializedEmbedderData {
+  int value;
+};
+
+
+static int serialized_internal_fields = 0;
+
+
+static v8::StartupData SerializeInternalFields(v8::Local<v8::Object> holder,
+                                               int index) {
+  SerializedEmbedderData* data = static_cast<SerializedEmbedderData*>(
+      holder->GetAlignedPointerFromInternalField(index));
+  serialized_internal_fields++;
+  v8::StartupData payload = {reinterpret_cast<const char*>(data),
+                             static_cast<int>(sizeof(*data))};
+  return payload;
+}
+
+
+static void DeserializeInternalFields(v8::Local<v8::Object> holder, int index,
+                                      v8::StartupData payload) {
+  CHECK_EQ(static_cast<int>(sizeof(SerializedEmbedderData)),
+           payload.raw_size);
+  CHECK_NULL(holder->GetAlignedPointerFromInternalField(index));
+  SerializedEmbedderData* data = new SerializedEmbedderData;
+  memcpy(data, payload.data, sizeof(*data));
+  holder->SetAlignedPointerInInternalField(index, data);
+}
+
+
+TEST(SnapshotCreatorTemplatesAndInternalFields) {
+  DisableTurbofan();
+  intptr_t external_references[] = {
+      reinterpret_cast<intptr_t>(SerializationFunctionTemplate), 0};
+  SerializedEmbedderData original = {42};
+  serialized_internal_fields = 0;
+
+  v8::StartupData blob;
+  {
+    v8::SnapshotCreator creator(external_references);
+    v8::Isolate* isolate = creator.GetIsolate();
+    {
+      v8::HandleScope handle_scope(isolate);
+      v8::Local<v8::ObjectTemplate> global = v8::ObjectTemplate::New(isolate);
+      global->Set(isolate, "echo", v8::FunctionTemplate::New(
+                                       isolate, SerializationFunctionTemplate));
+      v8::Local<v8::Context> context = v8::Context::New(isolate, NULL, global);
+      v8::Context::Scope context_scope(context);
+      CompileRun("var bootstrapped = echo(13);");
+
+      v8::Local<v8::ObjectTemplate> holder_template =
+          v8::ObjectTemplate::New(isolate);
+      holder_template->SetInternalFieldCount(2);
+      v8::Local<v8::Object> holder =
+          holder_template->NewInstance(context).ToLocalChecked();
+      holder->SetAlignedPointerInInternalField(0, &original);
+      holder->SetInternalField(1, v8_str("kept"));
+      CHECK(context->Global()
+                ->Set(context, v8_str("holder"), holder)
+                .FromJust());
+      creator.SetDefaultContext(context);
+    }
+    blob = creator.CreateBlob(SerializeInternalFields);
+  }
+  CHECK(blob.data != NULL);
+  CHECK_EQ(1, serialized_internal_fields);
+
+  v8::Isolate::CreateParams params;
+  params.snapshot_blob = &blob;
+  params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  params.external_references = external_references;
+  params.deserialize_internal_fields_callback = DeserializeInternalFields;
+  v8::Isolate* isolate = v8::Isolate::New(params);
+  {
+    v8::Isolate::Scope i_scope(isolate);
+    v8::HandleScope h_scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope c_scope(context);
+    CHECK_EQ(13, CompileRun("bootstrapped")->Int32Value(context).FromJust());
+    CHECK_EQ(7, CompileRun("echo(7)")->Int32Value(context).FromJust());
+
+    v8::Local<v8::Object> holder = CompileRun("holder").As<v8::Object>();
+    SerializedEmbedderData* data = static_cast<SerializedEmbedderData*>(
+        holder->GetAlignedPointerFromInternalField(0));
+    CHECK_NE(&original, data);
+    CHECK_EQ(42, data->value);
+    CHECK(v8_str("kept")->Equals(holder->GetInternalField(1)));
+    delete data;
+  }
+  isolate->Dispose();
+  delete[] blob.data;
+}
+
+
+static v8::StartupData SerializeFirstInternalField(
+    v8::Local<v8::Object> holder, int index) {
+  if (index != 0) {
+    v8::StartupData skipped = {NULL, 0};
+    return skipped;
+  }
+  return SerializeInternalFields(holder, index);
+}
+
+
+TEST(SnapshotCreatorSkippedInternalFieldsAreNull) {
+  DisableTurbofan();
+  SerializedEmbedderData original = {42};
+  SerializedEmbedderData skipped = {43};
+  v8::SerializeInternalFieldsCallback callbacks[] = {
+      SerializeFirstInternalField, NULL};
+
+  for (size_t i = 0; i < arraysize(callbacks); i++) {
+    v8::StartupData blob;
+    {
+      v8::SnapshotCreator creator;
+      v8::Isolate* isolate = creator.GetIsolate();
+      {
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::Context> context = v8::Context::New(isolate);
+        v8::Context::Scope context_scope(context);
+        v8::Local<v8::ObjectTemplate> holder_template =
+            v8::ObjectTemplate::New(isolate);
+        holder_template->SetInternalFieldCount(2);
+        v8::Local<v8::Object> holder =
+            holder_template->NewInstance(context).ToLocalChecked();
+        holder->SetAlignedPointerInInternalField(0, &original);
+        holder->SetAlignedPointerInInternalField(1, &skipped);
+        CHECK(context->Global()
+                  ->Set(context, v8_str("holder"), holder)
+                  .FromJust());
+        creator.SetDefaultContext(context);
+      }
+      blob = creator.CreateBlob(callbacks[i]);
+    }
+    CHECK(blob.data != NULL);
+
+    v8::Isolate::CreateParams params;
+    params.snapshot_blob = &blob;
+    params.array_buffer_allocator = CcTest::array_buffer_allocator();
+    params.deserialize_internal_fields_callback = DeserializeInternalFields;
+    v8::Isolate* isolate = v8::Isolate::New(params);
+    {
+      v8::Isolate::Scope i_scope(isolate);
+      v8::HandleScope h_scope(isolate);
+      v8::Local<v8::Context> context = v8::Context::New(isolate);
+      v8::Context::Scope c_scope(context);
+      v8::Local<v8::Object> holder = CompileRun("holder").As<v8::Object>();
+      SerializedEmbedderData* data = static_cast<SerializedEmbedderData*>(
+          holder->GetAlignedPointerFromInternalField(0));
+      if (callbacks[i] != NULL) {
+        CHECK_EQ(42, data->value);
+        delete data;
+      } else {
+        CHECK_NULL(data);
+      }
+      CHECK_NULL(holder->GetAlignedPointerFromInternalField(1));
+    }
+    isolate->Dispose();
+    delete[] blob.data;
+  }
+}
+
+
 TEST(PerIsolateSnapshotBlobsWithLocker) {
   DisableTurbofan();
   v8::Isolate::CreateParams create_params;
@@ -920,6 +1112,68 @@ TEST(SerializeToplevelOnePlusOne) {
 }
 
 
+TEST(SerializeToplevelBytecode) {
+  FLAG_serialize_toplevel = true;
+  FLAG_vector_stores = true;
+  FLAG_ignition = true;
+  FLAG_ignition_filter = StrDup("f");
+  FLAG_always_opt = false;
+  LocalContext context;
+  Isolate* isolate = CcTest::i_isolate();
+  isolate->compilation_cache()->Disable();  // Disable same-isolate code cache.
+  isolate->interpreter()->Initialize();
+
+  v8::HandleScope scope(CcTest::isolate());
+
+  // The eagerly compiled inner function is compiled to bytecode.
+  const char* source =
+      "var f = (function f(a) { return a + 1000; });"
+      "f(41);";
+
+  Handle<String> orig_source = isolate->factory()
+                                   ->NewStringFromUtf8(CStrVector(source))
+                                   .ToHandleChecked();
+  Handle<String> copy_source = isolate->factory()
+                                   ->NewStringFromUtf8(CStrVector(source))
+                                   .ToHandleChecked();
+
+  ScriptData* cache = NULL;
+
+  CompileScript(isolate, orig_source, Handle<String>(), &cache,
+                v8::ScriptCompiler::kProduceCodeCache);
+
+  Handle<SharedFunctionInfo> copy;
+  {
+    DisallowCompilation no_compile_expected(isolate);
+    copy = CompileScript(isolate, copy_source, Handle<String>(), &cache,
+                         v8::ScriptCompiler::kConsumeCodeCache);
+  }
+  CHECK(!cache->rejected());
+
+  Handle<JSFunction> copy_fun =
+      isolate->factory()->NewFunctionFromSharedFunctionInfo(
+          copy, isolate->native_context());
+  Handle<JSObject> global(isolate->context()->global_object());
+  Handle<Object> copy_result;
+  {
+    DisallowCompilation no_compile_expected(isolate);
+    copy_result =
+        Execution::Call(isolate, copy_fun, global, 0, NULL).ToHandleChecked();
+  }
+  CHECK_EQ(1041, Handle<Smi>::cast(copy_result)->value());
+
+  // The bytecode and its constant pool came from the cache.
+  Handle<JSFunction> f = Handle<JSFunction>::cast(
+      v8::Utils::OpenHandle(*CompileRun("f")));
+  CHECK(f->shared()->HasBytecodeArray());
+  FixedArray* constant_pool = f->shared()->bytecode_array()->constant_pool();
+  CHECK_EQ(1, constant_pool->length());
+  CHECK_EQ(1000, Smi::cast(constant_pool->get(0))->value());
+
+  delete cache;
+}
+
+
 TEST(CodeCachePromotedToCompilationCache) {
   FLAG_serialize_toplevel = true;
   LocalContext context;
@@ -1528,6 +1782,99 @@ TEST(SerializeToplevelBitFlip) {
 }
 
 
+class SingleEntryPersistentCache : public v8::PersistentCompilationCache {
+ public:
+  SingleEntryPersistentCache() : lookups_(0), stores_(0) {}
+
+  v8::ScriptCompiler::CachedData* Lookup(const uint8_t* key,
+                                         int key_length) override {
+    lookups_++;
+    if (std::string(reinterpret_cast<const char*>(key), key_length) != key_) {
+      return NULL;
+    }
+    return new v8::ScriptCompiler::CachedData(&data_[0],
+                                              static_cast<int>(data_.size()));
+  }
+
+  void Store(const uint8_t* key, int key_length, const uint8_t* data,
+             int length) override {
+    stores_++;
+    key_.assign(reinterpret_cast<const char*>(key), key_length);
+    data_.assign(data, data + length);
+  }
+
+  int lookups() const { return lookups_; }
+  int stores() const { return stores_; }
+
+ private:
+  std::string key_;
+  std::vector<uint8_t> data_;
+  int lookups_;
+  int stores_;
+};
+
+
+static void CompileAndRunWithPersistentCache(
+    v8::PersistentCompilationCache* cache, const char* source,
+    const char* name, const char* expected, bool expect_compilation) {
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = CcTest::array_buffer_allocator();
+  create_params.persistent_compilation_cache = cache;
+  v8::Isolate* isolate = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope iscope(isolate);
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> context = v8::Context::New(isolate);
+    v8::Context::Scope context_scope(context);
+
+    v8::ScriptOrigin origin(v8_str(name));
+    v8::ScriptCompiler::Source script_source(v8_str(source), origin);
+    v8::Local<v8::UnboundScript> script;
+    if (expect_compilation) {
+      script = v8::ScriptCompiler::CompileUnbound(isolate, &script_source);
+    } else {
+      DisallowCompilation no_compile(reinterpret_cast<Isolate*>(isolate));
+      script = v8::ScriptCompiler::CompileUnbound(isolate, &script_source);
+    }
+    v8::Local<v8::Value> result = script->BindToCurrentContext()->Run();
+    CHECK(result->ToString(isolate)->Equals(v8_str(expected)));
+  }
+  isolate->Dispose();
+}
+
+
+TEST(PersistentCompilationCache) {
+  FLAG_serialize_toplevel = true;
+
+  const char* source = "function f() { return 'abc'; }; f() + 'def'";
+  SingleEntryPersistentCache cache;
+
+  // The first isolate compiles the script and stores its code.
+  CompileAndRunWithPersistentCache(&cache, source, "test", "abcdef", true);
+  CHECK_EQ(1, cache.lookups());
+  CHECK_EQ(1, cache.stores());
+
+  // The second isolate deserializes the code instead of compiling.
+  CompileAndRunWithPersistentCache(&cache, source, "test", "abcdef", false);
+  CHECK_EQ(2, cache.lookups());
+  CHECK_EQ(1, cache.stores());
+
+  // A different origin is a different key.
+  CompileAndRunWithPersistentCache(&cache, source, "other", "abcdef", true);
+  CHECK_EQ(3, cache.lookups());
+  CHECK_EQ(2, cache.stores());
+
+  // Changing a flag invalidates the entry.
+  CompileAndRunWithPersistentCache(&cache, source, "other", "abcdef", false);
+  CHECK_EQ(4, cache.lookups());
+  FLAG_allow_natives_syntax = true;
+  FlagList::EnforceFlagImplications();
+  CompileAndRunWithPersistentCache(&cache, source, "other", "abcdef", true);
+  CHECK_EQ(5, cache.lookups());
+  CHECK_EQ(3, cache.stores());
+}
+
+
 TEST(SerializeWithHarmonyScoping) {
   FLAG_serialize_toplevel = true;
 
@@ -38,6 +38,7 @@
 #include "src/factory.h"
 #include "src/messages.h"
 #include "src/objects.h"
+#include "src/string-search.h"
 #include "src/unicode-decoder.h"
 #include "test/cctest/cctest.h"
 
@@ -920,6 +921,46 @@ TEST(Utf8Conversion) {
 }
 
 
+TEST(Utf8Decoding) {
+  CcTest::InitializeVM();
+  v8::HandleScope handle_scope(CcTest::isolate());
+  // Long enough to overflow the decoder's internal buffer.
+  const int kRepeat = 300;
+  struct {
+    const char* utf8;
+    uint16_t utf16[3];
+    int utf16_length;
+    bool one_byte;
+  } cases[] = {
+      {"ab", {'a', 'b'}, 2, true},
+      // U+00E9 -> C3 A9
+      {"\xc3\xa9" "a", {0xe9, 'a'}, 2, true},
+      // U+4E2D -> E4 B8 AD
+      {"a\xe4\xb8\xad", {'a', 0x4e2d}, 2, false},
+      // U+1F600 -> F0 9F 98 80
+      {"\xf0\x9f\x98\x80", {0xd83d, 0xde00}, 2, false},
+      // Invalid sequences decode to U+FFFD.
+      {"\xc3" "a", {0xfffd, 'a'}, 2, false},
+  };
+  for (size_t i = 0; i < arraysize(cases); i++) {
+    std::string utf8 = "x";
+    for (int j = 0; j < kRepeat; j++) utf8 += cases[i].utf8;
+    v8::Local<v8::String> string =
+        v8::String::NewFromUtf8(CcTest::isolate(), utf8.c_str(),
+                                v8::NewStringType::kNormal,
+                                static_cast<int>(utf8.length()))
+            .ToLocalChecked();
+    Handle<String> flat = String::Flatten(v8::Utils::OpenHandle(*string));
+    CHECK_EQ(cases[i].one_byte, flat->IsSeqOneByteString());
+    CHECK_EQ(1 + kRepeat * cases[i].utf16_length, flat->length());
+    CHECK_EQ('x', flat->Get(0));
+    for (int j = 0; j < kRepeat * cases[i].utf16_length; j++) {
+      CHECK_EQ(cases[i].utf16[j % cases[i].utf16_length], flat->Get(1 + j));
+    }
+  }
+}
+
+
 TEST(ExternalShortStringAdd) {
   LocalContext context;
   v8::HandleScope handle_scope(CcTest::isolate());
@@ -1351,6 +1392,87 @@ TEST(IsAscii) {
 }
 
 
+TEST(NonOneByteStart) {
+  const int kLength = 40;
+  uc16 chars[kLength];
+  for (int i = 0; i < kLength; i++) chars[i] = 0xff;
+  // Cover every alignment of the start and of the non-one-byte character.
+  for (int start = 0; start < 8; start++) {
+    for (int length = 0; start + length <= kLength; length++) {
+      CHECK_EQ(length, String::NonOneByteStart(chars + start, length));
+      for (int i = 0; i < length; i++) {
+        chars[start + i] = 0x100;
+        CHECK_EQ(i, String::NonOneByteStart(chars + start, length));
+        CHECK(!String::IsOneByte(chars + start, length));
+        chars[start + i] = 0xff;
+      }
+    }
+  }
+}
+
+
+template <typename SubjectChar, typename PatternChar>
+static int NaiveSearch(Vector<const SubjectChar> subject,
+                       Vector<const PatternChar> pattern, int index) {
+  for (int i = index; i <= subject.length() - pattern.length(); i++) {
+    int j = 0;
+    while (j < pattern.length() && subject[i + j] == pattern[j]) j++;
+    if (j == pattern.length()) return i;
+  }
+  return -1;
+}
+
+
+template <typename SubjectChar, typename PatternChar>
+static void CheckStringSearch(MyRandomNumberGenerator* rng,
+                              uint32_t alphabet_base) {
+  Isolate* isolate = CcTest::i_isolate();
+  const int kSubjectLength = 200;
+  SubjectChar subject_chars[kSubjectLength];
+  PatternChar pattern_chars[kSubjectLength];
+  for (int round = 0; round < 200; round++) {
+    // A small alphabet produces many partial matches.
+    int alphabet_size = 2 + rng->next(4);
+    int subject_length = rng->next(kSubjectLength);
+    for (int i = 0; i < subject_length; i++) {
+      subject_chars[i] =
+          static_cast<SubjectChar>(alphabet_base + rng->next(alphabet_size));
+    }
+    Vector<const SubjectChar> subject(subject_chars, subject_length);
+    for (int pattern_length = 1; pattern_length <= 12; pattern_length++) {
+      // Take the pattern from the subject half of the time.
+      int offset = subject_length - pattern_length;
+      bool from_subject = offset >= 0 && rng->next(2) == 0;
+      int pattern_start = from_subject ? rng->next(offset + 1) : 0;
+      for (int i = 0; i < pattern_length; i++) {
+        pattern_chars[i] =
+            from_subject
+                ? static_cast<PatternChar>(subject_chars[pattern_start + i])
+                : static_cast<PatternChar>(alphabet_base +
+                                           rng->next(alphabet_size));
+      }
+      Vector<const PatternChar> pattern(pattern_chars, pattern_length);
+      for (int index = 0; index <= subject_length; index += 1 + rng->next(8)) {
+        CHECK_EQ(NaiveSearch(subject, pattern, index),
+                 SearchString(isolate, subject, pattern, index));
+      }
+    }
+  }
+}
+
+
+TEST(StringSearch) {
+  CcTest::InitializeVM();
+  MyRandomNumberGenerator rng;
+  CheckStringSearch<uint8_t, uint8_t>(&rng, 'a');
+  CheckStringSearch<uint8_t, uc16>(&rng, 0xfd);
+  CheckStringSearch<uc16, uint8_t>(&rng, 0xfd);
+  CheckStringSearch<uc16, uc16>(&rng, 'a');
+  CheckStringSearch<uc16, uc16>(&rng, 0x4e00);
+  CheckStringSearch<uc16, uc16>(&rng, 0xfffd);
+}
+
+
 
 template<typename Op, bool return_first>
 static uint16_t ConvertLatin1(uint16_t c) {
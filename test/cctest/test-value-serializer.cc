@@ -0,0 +1,310 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "test/cctest/cctest.h"
+
+#include "include/v8.h"
+
+using v8::ArrayBuffer;
+using v8::Context;
+using v8::Local;
+using v8::MaybeLocal;
+using v8::SharedArrayBuffer;
+using v8::TryCatch;
+using v8::Value;
+using v8::ValueDeserializer;
+using v8::ValueSerializer;
+
+
+namespace {
+
+// Serializes |value| and returns the wire format, or an empty vector if an
+// exception was thrown.
+std::vector<uint8_t> Serialize(Local<Context> context, Local<Value> value) {
+  ValueSerializer serializer(context->GetIsolate());
+  serializer.WriteHeader();
+  std::vector<uint8_t> result;
+  if (serializer.WriteValue(context, value).IsNothing()) return result;
+  size_t size;
+  uint8_t* buffer = serializer.ReleaseBuffer(&size);
+  result.assign(buffer, buffer + size);
+  ValueSerializer::FreeBuffer(buffer);
+  return result;
+}
+
+
+MaybeLocal<Value> Deserialize(Local<Context> context,
+                              const std::vector<uint8_t>& data) {
+  ValueDeserializer deserializer(context->GetIsolate(), data.data(),
+                                 data.size());
+  if (deserializer.ReadHeader(context).IsNothing()) return MaybeLocal<Value>();
+  CHECK_EQ(1u, deserializer.GetWireFormatVersion());
+  return deserializer.ReadValue(context);
+}
+
+
+// Round-trips the result of |source| into a fresh context, stores it as
+// |result| there and checks that |check| evaluates to true.
+void RoundTripTest(const char* source, const char* check) {
+  v8::Isolate* isolate = CcTest::isolate();
+  v8::HandleScope scope(isolate);
+  Local<Context> serialization_context = Context::New(isolate);
+  Local<Context> deserialization_context = Context::New(isolate);
+
+  std::vector<uint8_t> data;
+  {
+    Context::Scope context_scope(serialization_context);
+    data = Serialize(serialization_context, CompileRun(source));
+    CHECK(!data.empty());
+  }
+  {
+    Context::Scope context_scope(deserialization_context);
+    Local<Value> result =
+        Deserialize(deserialization_context, data).ToLocalChecked();
+    CHECK(deserialization_context->Global()
+              ->Set(deserialization_context, v8_str("result"), result)
+              .FromJust());
+    CHECK(CompileRun(check)->BooleanValue(deserialization_context).FromJust());
+  }
+}
+
+
+void SerializationFailureTest(const char* source) {
+  v8::Isolate* isolate = CcTest::isolate();
+  v8::HandleScope scope(isolate);
+  LocalContext env;
+  TryCatch try_catch(isolate);
+  CHECK(Serialize(env.local(), CompileRun(source)).empty());
+  CHECK(try_catch.HasCaught());
+}
+
+
+void DeserializationFailureTest(const std::vector<uint8_t>& data) {
+  v8::Isolate* isolate = CcTest::isolate();
+  v8::HandleScope scope(isolate);
+  LocalContext env;
+  TryCatch try_catch(isolate);
+  CHECK(Deserialize(env.local(), data).IsEmpty());
+  CHECK(try_catch.HasCaught());
+}
+
+}  // namespace
+
+
+TEST(ValueSerializerPrimitives) {
+  CcTest::InitializeVM();
+  RoundTripTest("undefined", "result === undefined");
+  RoundTripTest("null", "result === null");
+  RoundTripTest("true", "result === true");
+  RoundTripTest("false", "result === false");
+  RoundTripTest("-42", "result === -42");
+  RoundTripTest("0x7fffffff + 1", "result === 2147483648");
+  RoundTripTest("-0", "Object.is(result, -0)");
+  RoundTripTest("NaN", "Number.isNaN(result)");
+  RoundTripTest("1.5e300", "result === 1.5e300");
+}
+
+
+TEST(ValueSerializerStrings) {
+  CcTest::InitializeVM();
+  RoundTripTest("''", "result === ''");
+  RoundTripTest("'hello'", "result === 'hello'");
+  RoundTripTest("'\\xe9t\\xe9'", "result === '\\xe9t\\xe9'");
+  RoundTripTest("'\\u2603 snow'", "result === '\\u2603 snow'");
+  RoundTripTest("'\\ud83d\\udc4a'", "result === '\\ud83d\\udc4a'");
+  RoundTripTest("'abc'.repeat(1000) + 'x'",
+                "result === 'abc'.repeat(1000) + 'x'");
+}
+
+
+TEST(ValueSerializerObjects) {
+  CcTest::InitializeVM();
+  RoundTripTest("({ a: 1, b: 'two', 3: true })",
+                "Object.getPrototypeOf(result) === Object.prototype && "
+                "result.a === 1 && result.b === 'two' && result[3] === true && "
+                "Object.keys(result).join() === '3,a,b'");
+  RoundTripTest("({ nested: { x: [1, 2] } })",
+                "result.nested.x.length === 2 && result.nested.x[1] === 2");
+  // Only own enumerable properties are written.
+  RoundTripTest(
+      "var o = Object.create({ inherited: 1 });"
+      "Object.defineProperty(o, 'hidden', { value: 2 });"
+      "o.visible = 3; o",
+      "!('inherited' in result) && !('hidden' in result) && "
+      "result.visible === 3");
+}
+
+
+TEST(ValueSerializerArrays) {
+  CcTest::InitializeVM();
+  RoundTripTest("[1, 'two', { three: 3 }]",
+                "Array.isArray(result) && result.length === 3 && "
+                "result[1] === 'two' && result[2].three === 3");
+  RoundTripTest("[1, , 3]",
+                "result.length === 3 && !(1 in result) && result[2] === 3");
+  RoundTripTest("var a = [1, 2]; a.extra = 'x'; a",
+                "result.length === 2 && result.extra === 'x'");
+  RoundTripTest("var a = []; a[1000000] = 'far'; a",
+                "result.length === 1000001 && result[1000000] === 'far' && "
+                "Object.keys(result).length === 1");
+}
+
+
+TEST(ValueSerializerReferences) {
+  CcTest::InitializeVM();
+  RoundTripTest("var o = { x: 1 }; [o, o]",
+                "result[0] === result[1] && result[0].x === 1");
+  RoundTripTest("var o = {}; o.self = o; o", "result.self === result");
+  RoundTripTest("var a = []; a.push(a); a", "result[0] === result");
+}
+
+
+TEST(ValueSerializerDates) {
+  CcTest::InitializeVM();
+  RoundTripTest("new Date(1e12)",
+                "result instanceof Date && result.getTime() === 1e12");
+  RoundTripTest("new Date(NaN)", "Number.isNaN(result.getTime())");
+}
+
+
+TEST(ValueSerializerArrayBuffers) {
+  CcTest::InitializeVM();
+  RoundTripTest("new Uint8Array([1, 2, 3]).buffer",
+                "result instanceof ArrayBuffer && result.byteLength === 3 && "
+                "new Uint8Array(result)[2] === 3");
+  RoundTripTest("new Float64Array([0.5, -1]).subarray(1)",
+                "result instanceof Float64Array && result.length === 1 && "
+                "result.byteOffset === 8 && result.buffer.byteLength === 16 && "
+                "result[0] === -1");
+  RoundTripTest("var b = new ArrayBuffer(8);"
+                "[new Int32Array(b), new DataView(b, 4), b]",
+                "result[0].buffer === result[2] && "
+                "result[1] instanceof DataView && "
+                "result[1].buffer === result[2] && "
+                "result[1].byteOffset === 4");
+}
+
+
+TEST(ValueSerializerUnsupported) {
+  i::FLAG_allow_natives_syntax = true;
+  i::FLAG_harmony_sharedarraybuffer = true;
+  CcTest::InitializeVM();
+  SerializationFailureTest("(function() {})");
+  SerializationFailureTest("Symbol()");
+  SerializationFailureTest("[1, { f: function() {} }]");
+  SerializationFailureTest("/x/");
+  SerializationFailureTest(
+      "var b = new ArrayBuffer(4); %ArrayBufferNeuter(b); b");
+  // SharedArrayBuffers can only be transferred.
+  SerializationFailureTest("new SharedArrayBuffer(4)");
+}
+
+
+TEST(ValueSerializerInvalidData) {
+  CcTest::InitializeVM();
+  // No header.
+  DeserializationFailureTest({'T'});
+  // Unsupported version.
+  DeserializationFailureTest({0xff, 0x7f, 'T'});
+  // Truncated data.
+  DeserializationFailureTest({0xff, 0x01});
+  DeserializationFailureTest({0xff, 0x01, '"', 0x05, 'a', 'b'});
+  DeserializationFailureTest({0xff, 0x01, 'o', '"', 0x01, 'a'});
+  // Unknown tag.
+  DeserializationFailureTest({0xff, 0x01, 0xfe});
+  // Reference to an object that doesn't exist.
+  DeserializationFailureTest({0xff, 0x01, '^', 0x07});
+  // Transferred buffer that wasn't passed to the deserializer.
+  DeserializationFailureTest({0xff, 0x01, 't', 0x00});
+}
+
+
+TEST(ValueSerializerTransferArrayBuffer) {
+  CcTest::InitializeVM();
+  v8::Isolate* isolate = CcTest::isolate();
+  v8::HandleScope scope(isolate);
+  LocalContext env;
+  Local<Context> context = env.local();
+
+  Local<ArrayBuffer> array_buffer = ArrayBuffer::New(isolate, 16);
+  CHECK(context->Global()
+            ->Set(context, v8_str("buffer"), array_buffer)
+            .FromJust());
+  Local<Value> value =
+      CompileRun("new Uint8Array(buffer)[5] = 42;"
+                 "({ buffer: buffer, view: new Uint8Array(buffer, 4) })");
+
+  ValueSerializer serializer(isolate);
+  serializer.TransferArrayBuffer(0, array_buffer);
+  serializer.WriteHeader();
+  CHECK(serializer.WriteValue(context, value).FromJust());
+  size_t size;
+  uint8_t* data = serializer.ReleaseBuffer(&size);
+  // Only the transfer id is written for the buffer, not its contents.
+  CHECK_LT(size, 16u);
+
+  ArrayBuffer::Contents contents = array_buffer->Externalize();
+  array_buffer->Neuter();
+
+  ValueDeserializer deserializer(isolate, data, size);
+  Local<ArrayBuffer> new_buffer =
+      ArrayBuffer::New(isolate, contents.Data(), contents.ByteLength(),
+                       v8::ArrayBufferCreationMode::kInternalized);
+  deserializer.TransferArrayBuffer(0, new_buffer);
+  CHECK(deserializer.ReadHeader(context).FromJust());
+  Local<Value> result = deserializer.ReadValue(context).ToLocalChecked();
+  ValueSerializer::FreeBuffer(data);
+
+  CHECK(context->Global()->Set(context, v8_str("result"), result).FromJust());
+  CHECK(context->Global()
+            ->Set(context, v8_str("new_buffer"), new_buffer)
+            .FromJust());
+  CHECK_EQ(contents.Data(), new_buffer->GetContents().Data());
+  CHECK(CompileRun("buffer.byteLength === 0 && "
+                   "result.buffer === new_buffer && "
+                   "result.view.buffer === new_buffer && "
+                   "result.view[1] === 42")
+            ->BooleanValue(context)
+            .FromJust());
+}
+
+
+TEST(ValueSerializerTransferSharedArrayBuffer) {
+  i::FLAG_harmony_sharedarraybuffer = true;
+  CcTest::InitializeVM();
+  v8::Isolate* isolate = CcTest::isolate();
+  v8::HandleScope scope(isolate);
+  LocalContext env;
+  Local<Context> context = env.local();
+
+  Local<SharedArrayBuffer> sab = SharedArrayBuffer::New(isolate, 8);
+  CHECK(context->Global()->Set(context, v8_str("sab"), sab).FromJust());
+  Local<Value> value = CompileRun("[sab, new Int32Array(sab)]");
+
+  ValueSerializer serializer(isolate);
+  serializer.TransferSharedArrayBuffer(3, sab);
+  serializer.WriteHeader();
+  CHECK(serializer.WriteValue(context, value).FromJust());
+  size_t size;
+  uint8_t* data = serializer.ReleaseBuffer(&size);
+
+  // The deserialized buffer shares the original backing store.
+  SharedArrayBuffer::Contents contents = sab->Externalize();
+  Local<SharedArrayBuffer> shared =
+      SharedArrayBuffer::New(isolate, contents.Data(), contents.ByteLength());
+  ValueDeserializer deserializer(isolate, data, size);
+  deserializer.TransferSharedArrayBuffer(3, shared);
+  CHECK(deserializer.ReadHeader(context).FromJust());
+  Local<Value> result = deserializer.ReadValue(context).ToLocalChecked();
+  ValueSerializer::FreeBuffer(data);
+
+  CHECK(context->Global()->Set(context, v8_str("result"), result).FromJust());
+  CHECK(CompileRun("result[1][1] = 7;"
+                   "result[0] !== sab && result[1].buffer === result[0] && "
+                   "new Int32Array(sab)[1] === 7")
+            ->BooleanValue(context)
+            .FromJust());
+  CcTest::array_buffer_allocator()->Free(contents.Data(),
+                                         contents.ByteLength());
+}
@@ -0,0 +1,84 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures how waking waiters on distinct locations of one
+// SharedArrayBuffer scales with the number of workers doing so
+// concurrently. Workers 2k and 2k+1 play ping-pong, each waiting on its own
+// slot and waking its partner's. The score is wakes per millisecond.
+
+var kRounds = 2000;
+var kMaxWorkers = 16;
+// Slots are spread out so that no two of them share a cache line.
+var kSlotStride = 16;
+var kStartSlot = kMaxWorkers;
+
+
+function WorkerMain() {
+  onmessage = function(msg) {
+    var i32a = new Int32Array(msg.sab);
+    var stride = msg.stride;
+    var index = msg.index;
+    var partner = index ^ 1;
+
+    function waitForSignal(slot) {
+      var offset = slot * stride;
+      while (Atomics.load(i32a, offset) == 0) {
+        Atomics.futexWait(i32a, offset, 0);
+      }
+      Atomics.store(i32a, offset, 0);
+    }
+
+    function signal(slot) {
+      var offset = slot * stride;
+      Atomics.store(i32a, offset, 1);
+      Atomics.futexWake(i32a, offset, 1);
+    }
+
+    var start = msg.startSlot * stride;
+    while (Atomics.load(i32a, start) == 0) {
+      Atomics.futexWait(i32a, start, 0);
+    }
+    for (var i = 0; i < msg.rounds; i++) {
+      if (index % 2 == 0) {
+        signal(partner);
+        waitForSignal(index);
+      } else {
+        waitForSignal(index);
+        signal(partner);
+      }
+    }
+    postMessage(Atomics.load(i32a, index * stride));
+  };
+}
+
+
+function Run(workers) {
+  var sab = new SharedArrayBuffer((kMaxWorkers + 1) * kSlotStride * 4);
+  var i32a = new Int32Array(sab);
+  var workerScript = '(' + WorkerMain.toString() + ')()';
+  var pool = [];
+  for (var i = 0; i < workers; i++) {
+    var worker = new Worker(workerScript);
+    worker.postMessage({sab: sab, stride: kSlotStride, index: i,
+                        rounds: kRounds, startSlot: kStartSlot}, [sab]);
+    pool.push(worker);
+  }
+
+  var start = kStartSlot * kSlotStride;
+  var begin = performance.now();
+  Atomics.store(i32a, start, 1);
+  Atomics.futexWake(i32a, start, workers);
+  var success = true;
+  for (var i = 0; i < workers; i++) {
+    if (pool[i].getMessage() !== 0) success = false;
+  }
+  var ms = performance.now() - begin;
+  for (var i = 0; i < workers; i++) pool[i].terminate();
+  return success ? workers * kRounds / ms : 'error';
+}
+
+
+for (var workers = 2; workers <= kMaxWorkers; workers *= 2) {
+  print('Workers' + workers + '-Futex(Score): ' + Run(workers));
+}
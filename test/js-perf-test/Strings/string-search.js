@@ -0,0 +1,73 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+new BenchmarkSuite('StringSearch', [1000], [
+  new Benchmark('IndexOfShortOneByte', false, false, 0,
+                IndexOfShort, OneByteLogSetup, IndexOfShortTearDown),
+  new Benchmark('IndexOfShortTwoByte', false, false, 0,
+                IndexOfShort, TwoByteLogSetup, IndexOfShortTearDown),
+  new Benchmark('IndexOfCharTwoByte', false, false, 0,
+                IndexOfChar, TwoByteLogSetup, IndexOfCharTearDown),
+  new Benchmark('SplitOneByte', false, false, 0,
+                Split, OneByteLogSetup, SplitTearDown),
+  new Benchmark('SplitTwoByte', false, false, 0,
+                Split, TwoByteLogSetup, SplitTearDown),
+  new Benchmark('ReplaceOneByte', false, false, 0,
+                Replace, OneByteLogSetup, ReplaceTearDown),
+]);
+
+
+// A multi-megabyte "log line" in which the needles only occur at the end.
+var LOG_RECORD = "2015-11-02T10:15:42.123Z INFO [worker-7] request " +
+                 "handled status=200 bytes=5123 duration=12ms path=/api/v1/; ";
+var LOG_REPEAT = 1 << 15;
+
+var log;
+var result;
+
+function MakeLog(prefix) {
+  return prefix + LOG_RECORD.repeat(LOG_REPEAT) + "status=503 \u00a7 @";
+}
+
+function OneByteLogSetup() {
+  log = MakeLog("");
+  result = undefined;
+}
+
+function TwoByteLogSetup() {
+  log = MakeLog("\u2603");
+  result = undefined;
+}
+
+function IndexOfShort() {
+  result = log.indexOf("=503");
+}
+
+function IndexOfShortTearDown() {
+  return result === log.length - 8;
+}
+
+function IndexOfChar() {
+  result = log.indexOf("@");
+}
+
+function IndexOfCharTearDown() {
+  return result === log.length - 1;
+}
+
+function Split() {
+  result = log.split("ms p");
+}
+
+function SplitTearDown() {
+  return result.length === LOG_REPEAT + 1;
+}
+
+function Replace() {
+  result = log.replace("=503", "=500");
+}
+
+function ReplaceTearDown() {
+  return result.length === log.length;
+}
@@ -0,0 +1,20 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Flags: --nostress-opt --isolate-benchmark=1,3 --isolate-benchmark-runs=2
+
+// Every run of the benchmark executes this file in a fresh context, on one
+// of several isolates that run at the same time.
+
+assertEquals("undefined", typeof alreadyRun);
+var alreadyRun = true;
+
+var objects = [];
+for (var i = 0; i < 10000; i++) {
+  objects.push({index: i, name: "object" + i});
+}
+assertEquals("object9999", objects[9999].name);
+assertEquals(49995000, objects.reduce(function(sum, o) {
+  return sum + o.index;
+}, 0));
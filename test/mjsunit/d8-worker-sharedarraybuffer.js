@@ -54,6 +54,9 @@ if (this.Worker) {
       ta[i] = i;
     }
 
+    // Transferring a SharedArrayBuffer twice throws.
+    assertThrows(function() { w.postMessage(sab, [sab, sab]); });
+
     // Transfer SharedArrayBuffer
     w.postMessage(sab, [sab]);
     assertEquals(16, sab.byteLength);  // ArrayBuffer should not be neutered.
@@ -0,0 +1,71 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Test that d8 Worker messages keep object identity and transfer array
+// buffer contents. This test only makes sense with d8.
+
+if (this.Worker) {
+  // The worker sends every message straight back.
+  var w = new Worker('onmessage = function(m) { postMessage(m); };');
+
+  // Objects referenced more than once, including cycles.
+  var shared = {x: 1};
+  var cyclic = {shared: shared, list: [shared, shared]};
+  cyclic.self = cyclic;
+  w.postMessage(cyclic);
+  var m = w.getMessage();
+  assertSame(m, m.self);
+  assertSame(m.shared, m.list[0]);
+  assertSame(m.shared, m.list[1]);
+  assertEquals(1, m.shared.x);
+
+  // Strings, numbers, dates and holey arrays.
+  w.postMessage(["☃ snow", "caf\xe9", -0, 1.5, new Date(12345), [1, , 3]]);
+  m = w.getMessage();
+  assertEquals("☃ snow", m[0]);
+  assertEquals("caf\xe9", m[1]);
+  assertEquals(-Infinity, 1 / m[2]);
+  assertEquals(1.5, m[3]);
+  assertInstanceof(m[4], Date);
+  assertEquals(12345, m[4].getTime());
+  assertEquals(3, m[5].length);
+  assertFalse(1 in m[5]);
+
+  // Views of a transferred buffer arrive as views of the same new buffer.
+  var ab = new ArrayBuffer(16);
+  var u32 = new Uint32Array(ab);
+  for (var i = 0; i < 4; ++i) u32[i] = i + 1;
+  w.postMessage({whole: u32, tail: new Uint8Array(ab, 8), dv: new DataView(ab)},
+                [ab]);
+  assertEquals(0, ab.byteLength);
+  m = w.getMessage();
+  assertInstanceof(m.whole, Uint32Array);
+  assertSame(m.whole.buffer, m.tail.buffer);
+  assertSame(m.whole.buffer, m.dv.buffer);
+  assertEquals(16, m.whole.buffer.byteLength);
+  assertEquals(8, m.tail.byteOffset);
+  assertEquals([1, 2, 3, 4], Array.prototype.slice.call(m.whole));
+  assertEquals(3, m.dv.getUint32(8, true));
+
+  // Cloned (not transferred) buffers are copied.
+  var clone = new Uint8Array([7, 8, 9]);
+  w.postMessage(clone);
+  assertEquals(3, clone.buffer.byteLength);
+  m = w.getMessage();
+  assertEquals([7, 8, 9], Array.prototype.slice.call(m));
+
+  // Values that can't be cloned throw, and don't neuter the buffers in the
+  // transfer list.
+  var kept = new ArrayBuffer(8);
+  assertThrows(function() { w.postMessage([kept, function() {}], [kept]); });
+  assertEquals(8, kept.byteLength);
+  assertThrows(function() { w.postMessage(Symbol()); });
+  assertThrows(function() { w.postMessage({}, [{}]); });
+  assertThrows(function() { w.postMessage({}, {}); });
+  // A buffer can't be transferred twice.
+  assertThrows(function() { w.postMessage(kept, [kept, kept]); });
+  assertEquals(8, kept.byteLength);
+
+  w.terminate();
+}
@@ -0,0 +1,101 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Global regexp replace with a function only records match offsets and
+// slices the match and captures right before each call of the function.
+
+function testReplace(subject) {
+  // No captures.
+  var calls = [];
+  var result = subject.replace(/b+/g, function(match, index, s) {
+    assertEquals(3, arguments.length);
+    assertEquals(subject, s);
+    assertEquals(match, s.substring(index, index + match.length));
+    assertEquals(match, RegExp.lastMatch);
+    assertEquals(s.substring(0, index), RegExp.leftContext);
+    assertEquals(s.substring(index + match.length), RegExp.rightContext);
+    assertEquals("", RegExp.lastParen);
+    assertEquals("", RegExp.$1);
+    calls.push(index);
+    return "<" + match.length + ">";
+  });
+  assertEquals(subject.replace(/b+/g, function(m) {
+    return "<" + m.length + ">";
+  }), result);
+  return calls;
+}
+
+assertEquals("a<1>c<2>d<3>", "abcbbdbbb".replace(/b+/g, function(m) {
+  return "<" + m.length + ">";
+}));
+assertEquals([1, 3, 6], testReplace("abcbbdbbb"));
+assertEquals([], testReplace("xyz"));
+
+// Long subjects use the results cache on the second replace.
+var padding = new Array(2001).join("ac");
+var long_subject = padding + "bb" + padding + "b" + padding;
+for (var i = 0; i < 3; i++) {
+  assertEquals([4000, 8002], testReplace(long_subject));
+}
+
+// Captures, including captures that do not participate in the match.
+var seen = [];
+var result = "x1-y-z22".replace(/([a-z])(\d+)?/g,
+                                function(match, c1, c2, index, subject) {
+  assertEquals(5, arguments.length);
+  assertEquals("x1-y-z22", subject);
+  assertEquals(c1, RegExp.$1);
+  assertEquals(c2 === undefined ? "" : c2, RegExp.$2);
+  assertEquals(match, RegExp.lastMatch);
+  seen.push([match, c1, c2, index]);
+  return c1.toUpperCase();
+});
+assertEquals("X-Y-Z", result);
+assertEquals([["x1", "x", "1", 0],
+              ["y", "y", undefined, 3],
+              ["z22", "z", "22", 5]], seen);
+
+// The last match info reflects the last match after the replace.
+"k1v k2v k3v".replace(/k(\d)v/g, function() { return ""; });
+assertEquals("3", RegExp.$1);
+assertEquals("k3v", RegExp.lastMatch);
+assertEquals("k1v k2v ", RegExp.leftContext);
+assertEquals("", RegExp.rightContext);
+
+// Other regexps run by the replace function do not disturb the outer one.
+result = "a1b2c3".replace(/([a-z])(\d)/g, function(match, letter, digit) {
+  var inner = "qq".replace(/q/g, function() { return letter; });
+  assertEquals("q", RegExp.lastMatch);
+  /(z)/.exec("z");
+  assertEquals("z", RegExp.$1);
+  return inner + digit;
+});
+assertEquals("aa1bb2cc3", result);
+
+result = "a1b2".replace(/[a-z]/g, function(match, index) {
+  "nested".replace(/(e)(s)?/g, function() { return ""; });
+  return match + index;
+});
+assertEquals("a01b22", result);
+
+// Empty matches and replacement values that are not strings.
+assertEquals("-a-b-", "ab".replace(/(?:)/g, function() { return "-"; }));
+assertEquals("1a2b3", "ab".replace(/(x)?/g, function(m, c, i) {
+  assertEquals(undefined, c);
+  return i + 1;
+}));
+assertEquals("nullnull", "ab".replace(/[ab]/g, function() { return null; }));
+
+// Two-byte subjects.
+assertEquals("☃-☃-", "☃snow☃snow".replace(/(s)now/g, function(m, s) {
+  assertEquals("s", s);
+  return "-";
+}));
+
+// Exceptions thrown by the replace function propagate, and replace still
+// works afterwards.
+assertThrows(function() {
+  "abc".replace(/b/g, function() { throw new Error("boom"); });
+}, Error);
+assertEquals("aXc", "abc".replace(/b/g, function() { return "X"; }));
@@ -0,0 +1,57 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Subjects long enough to be searched for the literal every match of a
+// regexp requires before the regexp is run.
+
+var padding = new Array(1001).join("-");
+var two_byte_padding = new Array(501).join("-☃");
+
+function check(re, subject, expected) {
+  re.lastIndex = 0;
+  var match = re.exec(subject);
+  assertEquals(expected, match === null ? null : match[0]);
+}
+
+// Literal present or absent in one-byte subjects.
+check(/foo\d+bar/, padding + "foo42bar" + padding, "foo42bar");
+check(/foo\d+bar/, padding + "foo42ba" + padding, null);
+check(/foo\d+bar/, padding + "fo42bar" + padding, null);
+check(/a(bc)d/, padding + "abcd", "abcd");
+check(/a(bc)d/, padding + "abd", null);
+check(/^-+x\by/, padding + "xy", null);
+check(/(?:ab|cd)ef/, padding + "cdef", "cdef");
+check(/q(xyz)+/, padding + "qxyzxyz", "qxyzxyz");
+check(/q(xyz)+/, padding + "qxy", null);
+
+// Two-byte literals and subjects.
+check(/☃snow/, two_byte_padding + "☃snow", "☃snow");
+check(/☃snow/, padding + "snow", null);
+check(/snow/, two_byte_padding + "snow" + two_byte_padding, "snow");
+check(/snow/, two_byte_padding, null);
+
+// The literal must occur at or after lastIndex.
+var re = /lit\w/g;
+var subject = "litA" + padding + "litB" + padding;
+assertEquals("litA", re.exec(subject)[0]);
+assertEquals("litB", re.exec(subject)[0]);
+assertEquals(null, re.exec(subject));
+assertEquals(0, re.lastIndex);
+
+// Global replace, match and split.
+subject = padding + "k1v" + padding + "k2v" + padding;
+assertEquals(["k1v", "k2v"], subject.match(/k\dv/g));
+assertEquals(padding + "X" + padding + "X" + padding,
+             subject.replace(/k\dv/g, "X"));
+assertEquals([padding, padding, padding], subject.split(/k\dv/));
+assertEquals(null, padding.match(/k\dv/g));
+assertEquals(padding, padding.replace(/k\dv/g, "X"));
+
+// Ignore case regexps have no required literal.
+check(/FOO/i, padding + "foo", "foo");
+
+// Captures and last match info are kept for failed matches.
+assertTrue(/(b)c/.test(padding + "bc"));
+assertFalse(/(x)yz/.test(padding));
+assertEquals("b", RegExp.$1);
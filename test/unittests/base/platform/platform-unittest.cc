@@ -4,6 +4,8 @@
 
 #include "src/base/platform/platform.h"
 
+#include <string.h>
+
 #if V8_OS_POSIX
 #include <unistd.h>  // NOLINT
 #endif
@@ -34,6 +36,25 @@ TEST(OS, GetCurrentProcessId) {
 }
 
 
+TEST(OS, MemoryMappedFileReadOnly) {
+  char name[64];
+  OS::SNPrintF(name, sizeof(name), "v8-platform-unittest-%d.bin",
+               OS::GetCurrentProcessId());
+  char data[] = "memory mapped";
+  OS::MemoryMappedFile* file =
+      OS::MemoryMappedFile::create(name, sizeof(data), data);
+  ASSERT_TRUE(file != nullptr);
+  delete file;
+
+  file = OS::MemoryMappedFile::open(name, OS::MemoryMappedFile::kReadOnly);
+  ASSERT_TRUE(file != nullptr);
+  EXPECT_EQ(sizeof(data), file->size());
+  EXPECT_EQ(0, memcmp(data, file->memory(), sizeof(data)));
+  delete file;
+  EXPECT_TRUE(OS::Remove(name));
+}
+
+
 namespace {
 
 class ThreadLocalStorageTest : public Thread, public ::testing::Test {
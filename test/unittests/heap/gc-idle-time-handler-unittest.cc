@@ -25,12 +25,21 @@ class GCIdleTimeHandlerTest : public ::testing::Test {
     result.contexts_disposal_rate = GCIdleTimeHandler::kHighContextDisposalRate;
     result.incremental_marking_stopped = false;
     result.mark_compact_speed_in_bytes_per_ms = kMarkCompactSpeed;
+    result.has_low_allocation_rate = false;
+    result.sweeping_in_progress = false;
+    result.has_pending_sweeping_pages = false;
+    result.sweeping_completed = false;
+    result.sweeping_speed_in_bytes_per_ms = kSweepingSpeed;
+    result.pending_optimized_code_installs = 0;
+    result.from_space_committed = false;
+    result.compilation_cache_needs_aging = false;
     return result;
   }
 
   static const size_t kSizeOfObjects = 100 * MB;
   static const size_t kMarkCompactSpeed = 200 * KB;
   static const size_t kMarkingSpeed = 200 * KB;
+  static const size_t kSweepingSpeed = 1 * MB;
   static const int kMaxNotifications = 100;
 
  private:
@@ -253,5 +262,113 @@ TEST_F(GCIdleTimeHandlerTest, DoneIfNotMakingProgressOnIncrementalMarking) {
   EXPECT_EQ(DONE, action.type);
 }
 
+
+
+TEST(GCIdleTimeHandler, EstimateSweepingTimeInitial) {
+  double time = GCIdleTimeHandler::EstimateSweepingTime(
+      GCIdleTimeHandler::kInitialConservativeSweepingSpeed, 0);
+  EXPECT_EQ(1.0, time);
+}
+
+
+TEST(GCIdleTimeHandler, EstimateSweepingTimeNonZero) {
+  double time = GCIdleTimeHandler::EstimateSweepingTime(2 * MB, 1 * MB);
+  EXPECT_EQ(2.0, time);
+}
+
+
+TEST_F(GCIdleTimeHandlerTest, SweepingStep) {
+  GCIdleTimeHeapState heap_state = DefaultHeapState();
+  heap_state.incremental_marking_stopped = true;
+  heap_state.sweeping_in_progress = true;
+  heap_state.has_pending_sweeping_pages = true;
+  GCIdleTimeAction action = handler()->Compute(10, heap_state);
+  EXPECT_EQ(DO_SWEEPING_STEP, action.type);
+}
+
+
+TEST_F(GCIdleTimeHandlerTest, NoSweepingStepWhileSweeperThreadsAreBusy) {
+  GCIdleTimeHeapState heap_state = DefaultHeapState();
+  heap_state.incremental_marking_stopped = true;
+  heap_state.sweeping_in_progress = true;
+  GCIdleTimeAction action = handler()->Compute(10, heap_state);
+  EXPECT_EQ(DONE, action.type);
+  heap_state.sweeping_completed = true;
+  action = handler()->Compute(10, heap_state);
+  EXPECT_EQ(DO_SWEEPING_STEP, action.type);
+}
+
+
+TEST_F(GCIdleTimeHandlerTest, NoSweepingStepIfPageDoesNotFit) {
+  GCIdleTimeHeapState heap_state = DefaultHeapState();
+  heap_state.incremental_marking_stopped = true;
+  heap_state.sweeping_in_progress = true;
+  heap_state.has_pending_sweeping_pages = true;
+  heap_state.sweeping_speed_in_bytes_per_ms =
+      GCIdleTimeHandler::kSweepingPageSize / 20;
+  GCIdleTimeAction action = handler()->Compute(10, heap_state);
+  EXPECT_EQ(DONE, action.type);
+}
+
+
+TEST_F(GCIdleTimeHandlerTest, IncrementalMarkingBeforeSweeping) {
+  GCIdleTimeHeapState heap_state = DefaultHeapState();
+  heap_state.sweeping_in_progress = true;
+  heap_state.has_pending_sweeping_pages = true;
+  GCIdleTimeAction action = handler()->Compute(10, heap_state);
+  EXPECT_EQ(DO_INCREMENTAL_STEP, action.type);
+}
+
+
+TEST_F(GCIdleTimeHandlerTest, InstallOptimizedCode) {
+  GCIdleTimeHeapState heap_state = DefaultHeapState();
+  heap_state.incremental_marking_stopped = true;
+  heap_state.pending_optimized_code_installs = 4;
+  GCIdleTimeAction action = handler()->Compute(10, heap_state);
+  EXPECT_EQ(DO_INSTALL_OPTIMIZED_CODE, action.type);
+}
+
+
+TEST_F(GCIdleTimeHandlerTest, DontInstallOptimizedCodeIfTooMany) {
+  GCIdleTimeHeapState heap_state = DefaultHeapState();
+  heap_state.incremental_marking_stopped = true;
+  heap_state.pending_optimized_code_installs = 1000;
+  GCIdleTimeAction action = handler()->Compute(10, heap_state);
+  EXPECT_EQ(DONE, action.type);
+}
+
+
+TEST_F(GCIdleTimeHandlerTest, AgeCompilationCache) {
+  GCIdleTimeHeapState heap_state = DefaultHeapState();
+  heap_state.incremental_marking_stopped = true;
+  heap_state.compilation_cache_needs_aging = true;
+  GCIdleTimeAction action = handler()->Compute(10, heap_state);
+  EXPECT_EQ(DO_AGE_COMPILATION_CACHE, action.type);
+}
+
+
+TEST_F(GCIdleTimeHandlerTest, UncommitFromSpaceOnlyWithLowAllocationRate) {
+  GCIdleTimeHeapState heap_state = DefaultHeapState();
+  heap_state.incremental_marking_stopped = true;
+  heap_state.from_space_committed = true;
+  GCIdleTimeAction action = handler()->Compute(10, heap_state);
+  EXPECT_EQ(DONE, action.type);
+  heap_state.has_low_allocation_rate = true;
+  action = handler()->Compute(10, heap_state);
+  EXPECT_EQ(DO_UNCOMMIT_FROM_SPACE, action.type);
+}
+
+
+TEST_F(GCIdleTimeHandlerTest, NoDeferredWorkWithoutIdleTime) {
+  GCIdleTimeHeapState heap_state = DefaultHeapState();
+  heap_state.incremental_marking_stopped = true;
+  heap_state.sweeping_in_progress = true;
+  heap_state.has_pending_sweeping_pages = true;
+  heap_state.pending_optimized_code_installs = 1;
+  heap_state.compilation_cache_needs_aging = true;
+  GCIdleTimeAction action = handler()->Compute(0, heap_state);
+  EXPECT_EQ(DO_NOTHING, action.type);
+}
+
 }  // namespace internal
 }  // namespace v8
@@ -40,9 +40,17 @@ TEST_F(BytecodeArrayBuilderTest, AllBytecodesGenerated) {
   Register reg(0);
   builder.LoadAccumulatorWithRegister(reg).StoreAccumulatorInRegister(reg);
 
+  // Emit a fused Ldar, Add, Star sequence.
+  builder.LoadAccumulatorWithRegister(reg)
+      .BinaryOperation(Token::Value::ADD, reg)
+      .StoreAccumulatorInRegister(reg);
+
   // Emit global load operations.
   builder.LoadGlobal(1);
 
+  // Emit operands which need a Wide or ExtraWide prefix.
+  builder.LoadGlobal(1000).LoadGlobal(100000);
+
   // Emit load / store property operations.
   builder.LoadNamedProperty(reg, 0, LanguageMode::SLOPPY)
       .LoadKeyedProperty(reg, 0, LanguageMode::SLOPPY)
@@ -50,7 +58,7 @@ TEST_F(BytecodeArrayBuilderTest, AllBytecodesGenerated) {
       .StoreKeyedProperty(reg, reg, 0, LanguageMode::SLOPPY);
 
   // Call operations.
-  builder.Call(reg, reg, 0);
+  builder.Call(reg, reg, 0, 1);
 
   // Emit binary operator invocations.
   builder.BinaryOperation(Token::Value::ADD, reg)
@@ -79,12 +87,16 @@ TEST_F(BytecodeArrayBuilderTest, AllBytecodesGenerated) {
   builder.Bind(&start);
   // Short jumps with Imm8 operands
   builder.Jump(&start).JumpIfTrue(&start).JumpIfFalse(&start);
+  builder.CompareOperation(Token::Value::LT, reg, LanguageMode::SLOPPY)
+      .JumpIfFalse(&start);
   // Insert dummy ops to force longer jumps
   for (int i = 0; i < 128; i++) {
     builder.LoadTrue();
   }
   // Longer jumps requiring Constant operand
   builder.Jump(&start).JumpIfTrue(&start).JumpIfFalse(&start);
+  builder.CompareOperation(Token::Value::LT, reg, LanguageMode::SLOPPY)
+      .JumpIfFalse(&start);
   builder.Return();
 
   // Generate BytecodeArray.
@@ -97,10 +109,18 @@ TEST_F(BytecodeArrayBuilderTest, AllBytecodesGenerated) {
   for (int i = 0; i < the_array->length(); i++) {
     uint8_t code = the_array->get(i);
     scorecard[code] += 1;
-    int operands = Bytecodes::NumberOfOperands(Bytecodes::FromByte(code));
+    OperandScale operand_scale = OperandScale::kSingle;
+    if (Bytecodes::IsPrefixScalingBytecode(Bytecodes::FromByte(code))) {
+      operand_scale =
+          Bytecodes::PrefixBytecodeToOperandScale(Bytecodes::FromByte(code));
+      code = the_array->get(++i);
+      scorecard[code] += 1;
+    }
+    Bytecode bytecode = Bytecodes::FromByte(code);
+    int operands = Bytecodes::NumberOfOperands(bytecode);
     CHECK_LE(operands, Bytecodes::MaximumNumberOfOperands());
-    final_bytecode = Bytecodes::FromByte(code);
-    i += operands;
+    final_bytecode = bytecode;
+    i += Bytecodes::Size(bytecode, operand_scale) - 1;
   }
 
   // Check return occurs at the end and only once in the BytecodeArray.
@@ -331,6 +351,145 @@ TEST_F(BytecodeArrayBuilderTest, BackwardJumps) {
 }
 
 
+TEST_F(BytecodeArrayBuilderTest, JumpsWithLargeConstantPool) {
+  static const int kConstantCount = 300;
+
+  BytecodeArrayBuilder builder(isolate(), zone());
+  builder.set_parameter_count(0);
+  builder.set_locals_count(0);
+
+  // The first jump reserves an entry before the constants fill the unprefixed
+  // range, the later ones no longer find one.
+  BytecodeLabel start, far, end;
+  builder.Bind(&start).Jump(&far);
+  for (int i = 0; i < kConstantCount; i++) {
+    builder.LoadLiteral(Smi::FromInt(1000 + i));
+  }
+  builder.Bind(&far).Jump(&end).Jump(&start).Bind(&end).Return();
+
+  Handle<BytecodeArray> array = builder.ToBytecodeArray();
+  CHECK_EQ(array->constant_pool()->length(), kConstantCount + 1);
+
+  BytecodeArrayIterator iterator(array);
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kJumpConstant);
+  CHECK_EQ(iterator.current_operand_scale(), OperandScale::kSingle);
+  CHECK_EQ(iterator.GetIndexOperand(0), 255);
+  CHECK_EQ(
+      array->get(iterator.current_offset() +
+                 Smi::cast(*iterator.GetConstantForIndexOperand(0))->value()),
+      Bytecodes::ToByte(Bytecode::kExtraWide));
+  iterator.Advance();
+  for (int i = 0; i < kConstantCount; i++) {
+    CHECK_EQ(iterator.current_bytecode(), Bytecode::kLdaConstant);
+    iterator.Advance();
+  }
+
+  // Prefixed jump offsets are relative to the bytecode after the prefix.
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kJump);
+  CHECK_EQ(iterator.current_operand_scale(), OperandScale::kQuadruple);
+  CHECK_EQ(array->get(iterator.current_offset() + 1 +
+                      iterator.GetSmi8Operand(0)),
+           Bytecodes::ToByte(Bytecode::kReturn));
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kJump);
+  CHECK_EQ(iterator.current_operand_scale(), OperandScale::kDouble);
+  CHECK_EQ(iterator.current_offset() + 1 + iterator.GetSmi8Operand(0), 0);
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kReturn);
+  iterator.Advance();
+  CHECK(iterator.done());
+}
+
+
+TEST_F(BytecodeArrayBuilderTest, WideOperands) {
+  BytecodeArrayBuilder builder(isolate(), zone());
+  builder.set_parameter_count(0);
+  builder.set_locals_count(300);
+
+  Register reg0(0);
+  Register reg299(299);
+  builder.LoadGlobal(200)
+      .LoadGlobal(300)
+      .LoadGlobal(70000)
+      .StoreAccumulatorInRegister(reg299)
+      .LoadAccumulatorWithRegister(reg0)
+      .Return();
+
+  Handle<BytecodeArray> array = builder.ToBytecodeArray();
+  CHECK_EQ(array->length(), 2 + 4 + 6 + 4 + 2 + 1);
+
+  BytecodeArrayIterator iterator(array);
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kLdaGlobal);
+  CHECK_EQ(iterator.current_operand_scale(), OperandScale::kSingle);
+  CHECK_EQ(iterator.GetIndexOperand(0), 200);
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kLdaGlobal);
+  CHECK_EQ(iterator.current_operand_scale(), OperandScale::kDouble);
+  CHECK_EQ(iterator.current_bytecode_size(), 4);
+  CHECK_EQ(iterator.GetIndexOperand(0), 300);
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kLdaGlobal);
+  CHECK_EQ(iterator.current_operand_scale(), OperandScale::kQuadruple);
+  CHECK_EQ(iterator.current_bytecode_size(), 6);
+  CHECK_EQ(iterator.GetIndexOperand(0), 70000);
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kStar);
+  CHECK_EQ(iterator.current_operand_scale(), OperandScale::kDouble);
+  CHECK_EQ(iterator.GetRegisterOperand(0).index(), reg299.index());
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kLdar);
+  CHECK_EQ(iterator.current_operand_scale(), OperandScale::kSingle);
+  CHECK_EQ(iterator.GetRegisterOperand(0).index(), reg0.index());
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kReturn);
+  iterator.Advance();
+  CHECK(iterator.done());
+}
+
+
+TEST_F(BytecodeArrayBuilderTest, FusedBytecodes) {
+  BytecodeArrayBuilder builder(isolate(), zone());
+  builder.set_parameter_count(0);
+  builder.set_locals_count(3);
+
+  Register reg0(0), reg1(1), reg2(2);
+  BytecodeLabel label, done;
+  builder.LoadAccumulatorWithRegister(reg0)
+      .BinaryOperation(Token::Value::ADD, reg1)
+      .StoreAccumulatorInRegister(reg2)
+      .CompareOperation(Token::Value::LT, reg1, LanguageMode::SLOPPY)
+      .JumpIfFalse(&done)
+      // A label between the bytecodes prevents fusion.
+      .LoadAccumulatorWithRegister(reg0)
+      .Bind(&label)
+      .BinaryOperation(Token::Value::ADD, reg1)
+      .StoreAccumulatorInRegister(reg2)
+      .Bind(&done)
+      .Return();
+
+  Handle<BytecodeArray> array = builder.ToBytecodeArray();
+  BytecodeArrayIterator iterator(array);
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kLdarAddStar);
+  CHECK_EQ(iterator.GetRegisterOperand(0).index(), reg0.index());
+  CHECK_EQ(iterator.GetRegisterOperand(1).index(), reg1.index());
+  CHECK_EQ(iterator.GetRegisterOperand(2).index(), reg2.index());
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kTestLessThanJumpIfFalse);
+  CHECK_EQ(iterator.GetRegisterOperand(0).index(), reg1.index());
+  CHECK_EQ(iterator.GetSmi8Operand(1), 9);
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kLdar);
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kAdd);
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kStar);
+  iterator.Advance();
+  CHECK_EQ(iterator.current_bytecode(), Bytecode::kReturn);
+  iterator.Advance();
+  CHECK(iterator.done());
+}
+
+
 TEST_F(BytecodeArrayBuilderTest, LabelReuse) {
   BytecodeArrayBuilder builder(isolate(), zone());
   builder.set_parameter_count(0);
@@ -58,6 +58,56 @@ TEST(OperandConversion, RegistersParametersNoOverlap) {
   }
 }
 
+
+TEST(OperandConversion, WideRegisters) {
+  int indices[] = {-100000, -1000, -129, 128, 1000, 100000};
+  for (size_t i = 0; i < arraysize(indices); i++) {
+    Register r(indices[i]);
+    Register s = Register::FromRawOperand(r.ToRawOperand());
+    CHECK_EQ(indices[i], s.index());
+  }
+}
+
+
+TEST(Bytecodes, OperandScales) {
+  CHECK_EQ(Bytecodes::OperandScaleForSignedOperand(-128),
+           OperandScale::kSingle);
+  CHECK_EQ(Bytecodes::OperandScaleForSignedOperand(127),
+           OperandScale::kSingle);
+  CHECK_EQ(Bytecodes::OperandScaleForSignedOperand(128),
+           OperandScale::kDouble);
+  CHECK_EQ(Bytecodes::OperandScaleForSignedOperand(-32768),
+           OperandScale::kDouble);
+  CHECK_EQ(Bytecodes::OperandScaleForSignedOperand(-32769),
+           OperandScale::kQuadruple);
+  CHECK_EQ(Bytecodes::OperandScaleForUnsignedOperand(255),
+           OperandScale::kSingle);
+  CHECK_EQ(Bytecodes::OperandScaleForUnsignedOperand(256),
+           OperandScale::kDouble);
+  CHECK_EQ(Bytecodes::OperandScaleForUnsignedOperand(65535),
+           OperandScale::kDouble);
+  CHECK_EQ(Bytecodes::OperandScaleForUnsignedOperand(65536),
+           OperandScale::kQuadruple);
+
+  CHECK_EQ(Bytecodes::OperandScaleToPrefixBytecode(OperandScale::kDouble),
+           Bytecode::kWide);
+  CHECK_EQ(Bytecodes::OperandScaleToPrefixBytecode(OperandScale::kQuadruple),
+           Bytecode::kExtraWide);
+  CHECK_EQ(Bytecodes::PrefixBytecodeToOperandScale(Bytecode::kWide),
+           OperandScale::kDouble);
+  CHECK_EQ(Bytecodes::PrefixBytecodeToOperandScale(Bytecode::kExtraWide),
+           OperandScale::kQuadruple);
+  CHECK(Bytecodes::IsPrefixScalingBytecode(Bytecode::kWide));
+  CHECK(!Bytecodes::IsPrefixScalingBytecode(Bytecode::kLdar));
+
+  CHECK_EQ(Bytecodes::Size(Bytecode::kStoreIC, OperandScale::kSingle), 4);
+  CHECK_EQ(Bytecodes::Size(Bytecode::kStoreIC, OperandScale::kDouble), 7);
+  CHECK_EQ(Bytecodes::Size(Bytecode::kStoreIC, OperandScale::kQuadruple), 13);
+  CHECK_EQ(Bytecodes::GetOperandOffset(Bytecode::kStoreIC, 2,
+                                       OperandScale::kQuadruple),
+           9);
+}
+
 }  // namespace interpreter
 }  // namespace internal
 }  // namespace v8
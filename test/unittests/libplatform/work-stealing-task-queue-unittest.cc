@@ -0,0 +1,172 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdio.h>
+#include <vector>
+
+#include "include/v8-platform.h"
+#include "src/base/atomicops.h"
+#include "src/base/platform/elapsed-timer.h"
+#include "src/base/platform/platform.h"
+#include "src/libplatform/task-queue.h"
+#include "src/libplatform/work-stealing-task-queue.h"
+#include "src/libplatform/worker-thread.h"
+#include "testing/gmock/include/gmock/gmock.h"
+
+using testing::IsNull;
+
+namespace v8 {
+namespace platform {
+
+namespace {
+
+struct MockTask : public Task {
+  MOCK_METHOD0(Run, void());
+};
+
+
+class WorkStealingTaskQueueThread final : public base::Thread {
+ public:
+  WorkStealingTaskQueueThread(WorkStealingTaskQueue* queue, int worker_id)
+      : Thread(Options("libplatform WorkStealingTaskQueueThread")),
+        queue_(queue),
+        worker_id_(worker_id) {}
+
+  virtual void Run() override {
+    EXPECT_THAT(queue_->GetNext(worker_id_), IsNull());
+  }
+
+ private:
+  WorkStealingTaskQueue* queue_;
+  int worker_id_;
+};
+
+
+class CountingTask : public Task {
+ public:
+  explicit CountingTask(base::Atomic32* counter) : counter_(counter) {}
+
+  void Run() override { base::NoBarrier_AtomicIncrement(counter_, 1); }
+
+ private:
+  base::Atomic32* counter_;
+};
+
+
+const int kNumberOfThroughputTasks = 1000000;
+
+
+double RunTaskQueueThroughput(int number_of_workers, base::Atomic32* counter) {
+  base::ElapsedTimer timer;
+  timer.Start();
+  TaskQueue queue;
+  std::vector<WorkerThread*> workers;
+  for (int i = 0; i < number_of_workers; ++i) {
+    workers.push_back(new WorkerThread(&queue));
+  }
+  for (int i = 0; i < kNumberOfThroughputTasks; ++i) {
+    queue.Append(new CountingTask(counter));
+  }
+  queue.Terminate();
+  for (auto i = workers.begin(); i != workers.end(); ++i) delete *i;
+  return timer.Elapsed().InMillisecondsF();
+}
+
+
+double RunWorkStealingTaskQueueThroughput(int number_of_workers,
+                                          base::Atomic32* counter) {
+  base::ElapsedTimer timer;
+  timer.Start();
+  WorkStealingTaskQueue queue(number_of_workers);
+  std::vector<WorkerThread*> workers;
+  for (int i = 0; i < number_of_workers; ++i) {
+    workers.push_back(new WorkerThread(&queue, i));
+  }
+  for (int i = 0; i < kNumberOfThroughputTasks; ++i) {
+    queue.Append(new CountingTask(counter),
+                 (i & 1) ? WorkStealingTaskQueue::kLowPriority
+                         : WorkStealingTaskQueue::kHighPriority);
+  }
+  queue.Terminate();
+  for (auto i = workers.begin(); i != workers.end(); ++i) delete *i;
+  return timer.Elapsed().InMillisecondsF();
+}
+
+}  // namespace
+
+
+TEST(WorkStealingTaskQueueTest, Basic) {
+  WorkStealingTaskQueue queue(1);
+  MockTask task;
+  queue.Append(&task, WorkStealingTaskQueue::kHighPriority);
+  EXPECT_EQ(&task, queue.GetNext(0));
+  queue.Terminate();
+  EXPECT_THAT(queue.GetNext(0), IsNull());
+}
+
+
+TEST(WorkStealingTaskQueueTest, HighPriorityFirst) {
+  WorkStealingTaskQueue queue(1);
+  MockTask low_task;
+  MockTask high_task;
+  queue.Append(&low_task, WorkStealingTaskQueue::kLowPriority);
+  queue.Append(&high_task, WorkStealingTaskQueue::kHighPriority);
+  EXPECT_EQ(&high_task, queue.GetNext(0));
+  EXPECT_EQ(&low_task, queue.GetNext(0));
+  queue.Terminate();
+  EXPECT_THAT(queue.GetNext(0), IsNull());
+}
+
+
+TEST(WorkStealingTaskQueueTest, Steal) {
+  static const int kNumberOfWorkers = 4;
+  WorkStealingTaskQueue queue(kNumberOfWorkers);
+  MockTask tasks[kNumberOfWorkers];
+  for (int i = 0; i < kNumberOfWorkers; ++i) {
+    queue.Append(&tasks[i], WorkStealingTaskQueue::kHighPriority);
+  }
+  // Tasks are distributed over all workers, so a single worker has to steal
+  // the remaining ones.
+  for (int i = 0; i < kNumberOfWorkers; ++i) {
+    EXPECT_THAT(queue.GetNext(0), testing::NotNull());
+  }
+  queue.Terminate();
+  EXPECT_THAT(queue.GetNext(0), IsNull());
+}
+
+
+TEST(WorkStealingTaskQueueTest, TerminateMultipleReaders) {
+  WorkStealingTaskQueue queue(2);
+  WorkStealingTaskQueueThread thread1(&queue, 0);
+  WorkStealingTaskQueueThread thread2(&queue, 1);
+  thread1.Start();
+  thread2.Start();
+  queue.Terminate();
+  thread1.Join();
+  thread2.Join();
+}
+
+
+// Compares the throughput of the work-stealing queue with the single-lock
+// TaskQueue. Run with --gtest_also_run_disabled_tests.
+TEST(WorkStealingTaskQueueTest, DISABLED_Throughput) {
+  static const int kMaxNumberOfWorkers = 32;
+  for (int workers = 1; workers <= kMaxNumberOfWorkers; workers *= 2) {
+    base::Atomic32 task_queue_counter = 0;
+    double task_queue_ms =
+        RunTaskQueueThroughput(workers, &task_queue_counter);
+    EXPECT_EQ(kNumberOfThroughputTasks, task_queue_counter);
+
+    base::Atomic32 work_stealing_counter = 0;
+    double work_stealing_ms =
+        RunWorkStealingTaskQueueThroughput(workers, &work_stealing_counter);
+    EXPECT_EQ(kNumberOfThroughputTasks, work_stealing_counter);
+
+    printf("%2d workers: TaskQueue %8.2f ms, WorkStealingTaskQueue %8.2f ms\n",
+           workers, task_queue_ms, work_stealing_ms);
+  }
+}
+
+}  // namespace platform
+}  // namespace v8
@@ -700,6 +700,8 @@
         '../../src/hashmap.h',
         '../../src/heap/array-buffer-tracker.cc',
         '../../src/heap/array-buffer-tracker.h',
+        '../../src/heap/concurrent-marking.cc',
+        '../../src/heap/concurrent-marking.h',
         '../../src/heap/memory-reducer.cc',
         '../../src/heap/memory-reducer.h',
         '../../src/heap/gc-idle-time-handler.cc',
@@ -822,6 +824,9 @@
         '../../src/isolate.cc',
         '../../src/isolate.h',
         '../../src/json-parser.h',
+        '../../src/json-stream-parser.cc',
+        '../../src/json-stream-parser.h',
+        '../../src/json-stringifier.cc',
         '../../src/json-stringifier.h',
         '../../src/layout-descriptor-inl.h',
         '../../src/layout-descriptor.cc',
@@ -1017,6 +1022,8 @@
         '../../src/v8memory.h',
         '../../src/v8threads.cc',
         '../../src/v8threads.h',
+        '../../src/value-serializer.cc',
+        '../../src/value-serializer.h',
         '../../src/variables.cc',
         '../../src/variables.h',
         '../../src/vector.h',
@@ -1717,6 +1724,8 @@
         '../../src/libplatform/default-platform.h',
         '../../src/libplatform/task-queue.cc',
         '../../src/libplatform/task-queue.h',
+        '../../src/libplatform/work-stealing-task-queue.cc',
+        '../../src/libplatform/work-stealing-task-queue.h',
         '../../src/libplatform/worker-thread.cc',
         '../../src/libplatform/worker-thread.h',
       ],
@@ -0,0 +1,113 @@
+// Copyright 2015 the V8 project authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures the throughput of v8::String::NewFromUtf8 for inputs with
+// different character mixes.
+//
+// Usage: utf8-bench [--size=<bytes>] [--repeat=<n>] [--benchmark=<name>]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "include/libplatform/libplatform.h"
+#include "include/v8.h"
+#include "src/base/platform/elapsed-timer.h"
+
+class ArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
+ public:
+  virtual void* Allocate(size_t length) {
+    void* data = AllocateUninitialized(length);
+    return data == NULL ? data : memset(data, 0, length);
+  }
+  virtual void* AllocateUninitialized(size_t length) { return malloc(length); }
+  virtual void Free(void* data, size_t) { free(data); }
+};
+
+
+struct Input {
+  const char* name;
+  // UTF-8 text repeated to fill the input.
+  const char* text;
+};
+
+
+static const Input kInputs[] = {
+    {"ASCII", "The quick brown fox jumps over the lazy dog. 0123456789\n"},
+    // Mostly ASCII with Latin-1 accents, which still fits a one-byte string.
+    {"Latin1", "Voil\xc3\xa0 un caf\xc3\xa9 cr\xc3\xa8me br\xc3\xbbl\xc3\xa9"
+               "e, s'il vous pla\xc3\xaet. \xc2\xbfQu\xc3\xa9 pasa?\n"},
+    // Three-byte sequences.
+    {"CJK", "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe3\x83\x86"
+            "\xe3\x82\xad\xe3\x82\xb9\xe3\x83\x88\xe4\xb8\xad\xe6\x96\x87 "
+            "\xed\x95\x9c\xea\xb5\xad\xec\x96\xb4\n"},
+    // Four-byte sequences, which decode to surrogate pairs.
+    {"Emoji", "ok \xf0\x9f\x98\x80\xf0\x9f\x8e\x89\xf0\x9f\x91\x8d "
+              "\xf0\x9f\x9a\x80 done \xf0\x9f\x92\xaf\n"},
+};
+
+
+static std::string MakeInput(const char* text, size_t size) {
+  std::string result;
+  result.reserve(size + strlen(text));
+  while (result.size() < size) result += text;
+  return result;
+}
+
+
+int main(int argc, char* argv[]) {
+  v8::V8::SetFlagsFromCommandLine(&argc, argv, true);
+  v8::V8::InitializeICU();
+  v8::Platform* platform = v8::platform::CreateDefaultPlatform();
+  v8::V8::InitializePlatform(platform);
+  v8::V8::Initialize();
+  v8::V8::InitializeExternalStartupData(argv[0]);
+
+  size_t size = 1 << 20;
+  int repeat = 100;
+  std::string benchmark = "Utf8";
+  for (int i = 1; i < argc; ++i) {
+    if (strncmp(argv[i], "--size=", 7) == 0) {
+      size = static_cast<size_t>(atoi(argv[i] + 7));
+    } else if (strncmp(argv[i], "--repeat=", 9) == 0) {
+      repeat = atoi(argv[i] + 9);
+    } else if (strncmp(argv[i], "--benchmark=", 12) == 0) {
+      benchmark = std::string(argv[i] + 12);
+    }
+  }
+
+  ArrayBufferAllocator array_buffer_allocator;
+  v8::Isolate::CreateParams create_params;
+  create_params.array_buffer_allocator = &array_buffer_allocator;
+  v8::Isolate* isolate = v8::Isolate::New(create_params);
+  {
+    v8::Isolate::Scope isolate_scope(isolate);
+    for (size_t i = 0; i < sizeof(kInputs) / sizeof(kInputs[0]); i++) {
+      std::string input = MakeInput(kInputs[i].text, size);
+      int length = static_cast<int>(input.size());
+      v8::base::ElapsedTimer timer;
+      timer.Start();
+      for (int j = 0; j < repeat; j++) {
+        v8::HandleScope handle_scope(isolate);
+        v8::Local<v8::String> string;
+        if (!v8::String::NewFromUtf8(isolate, input.data(),
+                                     v8::NewStringType::kNormal, length)
+                 .ToLocal(&string)) {
+          fprintf(stderr, "NewFromUtf8 failed\n");
+          return 1;
+        }
+      }
+      double seconds = timer.Elapsed().InSecondsF();
+      double megabytes = static_cast<double>(length) * repeat / (1 << 20);
+      printf("%s-%s(Throughput): %.1f MB/s\n", benchmark.c_str(),
+             kInputs[i].name, megabytes / seconds);
+    }
+  }
+  isolate->Dispose();
+  v8::V8::Dispose();
+  v8::V8::ShutdownPlatform();
+  delete platform;
+  return 0;
+}